@@ -50,12 +50,29 @@ typedef struct ImAppWindowParameters
 	ImUiColor				clearColor;
 } ImAppWindowParameters;
 
+typedef enum ImAppRendererFlags
+{
+	ImAppRendererFlags_StreamingBuffers	= 1u << 0u,		// Stream vertex/index data through a mapped, fenced ring buffer instead of copying into new buffers every frame
+	ImAppRendererFlags_UberShader		= 1u << 1u,		// Draw color, texture, font and SDF font commands with one program. The mode is stored per vertex.
+	ImAppRendererFlags_GpuClipping		= 1u << 2u,		// Clip in the fragment shader instead of scissoring, so commands with different clip rects can be merged. Implies ImAppRendererFlags_UberShader.
+	ImAppRendererFlags_InstancedQuads	= 1u << 3u,		// Upload axis aligned quads as one instance each and expand them in the vertex shader. Other geometry stays indexed. Implies ImAppRendererFlags_UberShader.
+	ImAppRendererFlags_CompactBuffers	= 1u << 4u,		// Convert vertices to a 12 byte fixed point layout and indices to 16 bit when the frame allows it. The frame is generated into CPU memory and copied into the stream buffer while converting, worth it when upload bandwidth is the bottleneck.
+	ImAppRendererFlags_DamageTracking	= 1u << 5u,		// Skip presenting unchanged frames and redraw only the changed area when the platform preserves buffer content. GPU renderers generate the frame into CPU memory to hash it and copy it into the stream buffer, worth it for mostly static UIs. Free for the software renderer. Vulkan only skips unchanged frames and redraws changed ones completely.
+	ImAppRendererFlags_GpuTimers		= 1u << 6u,		// Measure the GPU time of every window with timestamp queries, see ImAppRendererStats. Ignored when the driver has no timer queries, GLES needs GL_EXT_disjoint_timer_query and web has none.
+	ImAppRendererFlags_TextureArrays	= 1u << 7u		// Put same sized textures (e.g. image atlas and font pages) into layers of shared texture arrays, so they can be drawn without rebinding. The layer is stored per vertex. Implies ImAppRendererFlags_UberShader.
+} ImAppRendererFlags;
+
 typedef struct ImAppParameters
 {
 	ImUiAllocator			allocator;				// Override memory Allocator. Default: malloc/free
 
 	int						tickIntervalMs;			// Tick interval. Use 0 to disable. Default: 0
 
+	uint32_t				rendererFlags;			// Combination of ImAppRendererFlags. Default: ImAppRendererFlags_StreamingBuffers, with the software renderer also ImAppRendererFlags_DamageTracking
+	uint32_t				textureUploadBudget;	// Bytes of texture data uploaded per tick, at least one texture. Textures, also raw images, stay loading until their upload finished on the GPU. Use 0 to upload synchronously. Default: 4 MiB
+	float					textureUploadBudgetMs;	// Time per tick spent on texture uploads. Use 0 for no limit. Default: 2
+	bool					useRenderThread;		// Draw and present on a separate thread which owns the GL context, while the next frame gets built. Ignored when the platform can't hand the context over (Android, SDL, Web) and by other renderers. Default: false
+
 	const char*				resPath;				// Path where resources loaded from. Use ./ for relative to executable. default: {exe_dir}/assets
 	const char*				defaultResPakName;
 	ImAppBlob				defaultResPakData;
@@ -111,6 +128,10 @@ ImUiContext*				ImAppGetUi( ImAppContext* imapp );
 void						ImAppTrace( const char* format, ... );
 void						ImAppQuit( ImAppContext* imapp, int exitCode );
 
+// Without tickIntervalMs the app sleeps until the next input. Request ticks for animations or for data of other threads.
+void						ImAppRequestRedraw( ImAppContext* imapp );					// Tick again right away. Can be called from any thread.
+void						ImAppRequestRedrawIn( ImAppContext* imapp, uint32_t ms );	// Tick again after ms at the latest. Call it from the main thread, the earliest request wins.
+
 // Create a Window at given coordinates. uiFunc callback will be called every frame to build UI.
 ImAppWindow*				ImAppWindowCreate( ImAppContext* imapp, const ImAppWindowParameters* parameters, ImAppWindowDoUiFunc uiFunc, void* uiContext );
 void						ImAppWindowDestroy( ImAppContext* imapp, ImAppWindow* window );
@@ -128,6 +149,45 @@ void						ImAppWindowSetState( ImAppWindow* window, ImAppWindowState state );
 
 bool						ImAppWindowPopDropData( ImAppWindow* window, ImAppDropData* outData );	// data freed after tick
 
+typedef struct ImAppRendererStats
+{
+	uint32_t			commandCount;		// ImUi draw commands in the last frame
+	uint32_t			drawCallCount;		// Draw calls issued for the last frame after merging compatible commands
+	uint32_t			cacheHitCount;		// Total frames a cached ImUi window was drawn from its texture
+	uint32_t			cacheMissCount;		// Total frames a cached ImUi window had to be drawn from its commands
+	float				gpuTimeMs;			// ImAppRendererFlags_GpuTimers: GPU time of the last measured frame. Results are read without waiting and lag a few frames behind.
+	float				gpuCacheTimeMs;		// ImAppRendererFlags_GpuTimers: part of gpuTimeMs spent drawing cached ImUi windows into their textures
+	uint32_t			programChangeCount;		// Shader program switches in the last frame
+	uint32_t			textureChangeCount;		// Texture binds in the last frame
+	uint32_t			scissorChangeCount;		// Scissor rect changes in the last frame
+	uint32_t			vertexBytesUploaded;	// Vertex, instance and draw info bytes uploaded for the last frame
+	uint32_t			indexBytesUploaded;		// Index bytes uploaded for the last frame
+	uint32_t			textureCount;			// Live textures of the renderer, shared by all windows
+	uint64_t			textureBytesR8;		// Texture memory as stored by the renderer, grouped by source format and shared by all windows. RGB8 is usually stored with 4 bytes per pixel.
+	uint64_t			textureBytesRgb8;
+	uint64_t			textureBytesRgba8;
+} ImAppRendererStats;
+
+// Per frame counters are reset when a window draws a new frame.
+bool						ImAppWindowGetRendererStats( const ImAppContext* imapp, const ImAppWindow* window, ImAppRendererStats* outStats );
+// Sum of the last frame of all windows. Cache and GPU times are summed as well.
+bool						ImAppGetRendererStats( const ImAppContext* imapp, ImAppRendererStats* outStats );
+
+typedef struct ImAppFrameStats
+{
+	uint64_t			tickCount;				// Ticks since start
+	float				lastIntervalMs;			// Time between the last two ticks
+	float				averageIntervalMs;		// Moving average of the tick interval
+	float				lastLatenessMs;			// How late the last tick started after ImAppParameters::tickIntervalMs, 0 for ticks without it (event driven, ImAppRequestRedrawIn, uploads, hidden windows)
+	uint32_t			missedDeadlineCount;	// Ticks which started more than 1 ms after their deadline
+} ImAppFrameStats;
+
+bool						ImAppGetFrameStats( const ImAppContext* imapp, ImAppFrameStats* outStats );
+
+// Draws uiWindow from a texture while its content doesn't change. Call every frame, caching stops when it's not called.
+// Meant for static panels, ignored with ImAppRendererFlags_GpuClipping.
+void						ImAppWindowSetUiWindowCached( ImAppContext* imapp, ImAppWindow* window, ImUiWindow* uiWindow );
+
 //////////////////////////////////////////////////////////////////////////
 // Theme
 
@@ -246,10 +306,16 @@ void						ImAppResPakActivateTheme( ImAppContext* imapp, ImAppResPak* pak, const
 typedef struct ImAppImage ImAppImage;
 
 ImAppImage*					ImAppImageLoadResource( ImAppContext* imapp, const char* resourcePath );
+// RGBA8 pixels, the image stays loading until the upload finished, ready right away when textureUploadBudget is 0.
 ImAppImage*					ImAppImageCreateRaw( ImAppContext* imapp, const void* imageData, size_t imageDataSize, int width, int height );
 ImAppImage*					ImAppImageCreatePng( ImAppContext* imapp, const void* imageData, size_t imageDataSize );
 ImAppImage*					ImAppImageCreateJpeg( ImAppContext* imapp, const void* imageData, size_t imageDataSize );
 ImAppResState				ImAppImageGetState( ImAppContext* imapp, ImAppImage* image );
+// Replace the pixels of an RGBA8 image (e.g. created with ImAppImageCreateRaw) without creating a new texture. imageData is
+// RGBA8 with tightly packed rows of width pixels.
+bool						ImAppImageUpdate( ImAppContext* imapp, ImAppImage* image, const void* imageData, size_t imageDataSize );
+bool						ImAppImageUpdateRegion( ImAppContext* imapp, ImAppImage* image, const void* imageData, size_t imageDataSize, int x, int y, int width, int height );
+// Textures of freed images get reused by new images of the same size for a few frames.
 void						ImAppImageFree( ImAppContext* imapp, ImAppImage* image );
 
 ImUiImage					ImAppImageGetImage( const ImAppImage* image );
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "imapp/imapp.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Headless
+// Only available when imapp is built with the headless platform (use_headless=on). Windows render into offscreen
+// EGL surfaces (memory with use_software_renderer=on, offscreen Vulkan images with use_vulkan=on) and get their
+// input only from the functions below, which is useful for benchmarks and image tests.
+
+// Queue input for the next tick of window. Coordinates are in window pixels.
+void						ImAppHeadlessWindowPushKey( ImAppWindow* window, ImUiInputKey key, bool down );
+void						ImAppHeadlessWindowPushCharacter( ImAppWindow* window, uint32_t character );
+void						ImAppHeadlessWindowPushMouseMove( ImAppWindow* window, int x, int y );
+void						ImAppHeadlessWindowPushMouseButton( ImAppWindow* window, ImUiInputMouseButton button, bool down );
+void						ImAppHeadlessWindowPushMouseScroll( ImAppWindow* window, int x, int y );
+void						ImAppHeadlessWindowPushDrop( ImAppWindow* window, ImAppDropType type, const char* pathOrText );
+void						ImAppHeadlessWindowPushClose( ImAppWindow* window );
+
+// Number of frames presented by window.
+uint64_t					ImAppHeadlessWindowGetFrameCount( const ImAppWindow* window );
+
+// Read the last presented frame as RGBA8 with the top row first. outPixels must hold width * height * 4 bytes. Fails with the OpenGL renderer while the render thread runs.
+bool						ImAppHeadlessWindowReadPixels( ImAppWindow* window, void* outPixels, size_t pixelsSize );
+
+#ifdef __cplusplus
+}
+#endif
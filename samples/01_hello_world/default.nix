@@ -7,14 +7,11 @@ mkShell {
     gcc
     glibc_multi
     bear
-    libGLU
     libGL.dev
-    glew.dev
     dbus.dev
-    #libxkbcommon.dev    
-    #wayland.dev
-    #wayland-scanner
-    xorg.libX11
-    xorg.libXext
+    libxkbcommon.dev
+    wayland.dev
+    wayland-scanner
+    wayland-protocols
   ];
 }
\ No newline at end of file
@@ -20,6 +20,7 @@ void* ImAppProgramInitialize( ImAppParameters* parameters, int argc, char* argv[
 	parameters->defaultWindow.width		= 400;
 	parameters->defaultWindow.height	= 250;
 	parameters->defaultWindow.style		= ImAppWindowStyle_Resizable;
+	parameters->rendererFlags			|= ImAppRendererFlags_GpuTimers;
 
 	ImAppTestProgramContext* context = (ImAppTestProgramContext*)malloc( sizeof( ImAppTestProgramContext ) );
 	context->tickIndex = 0u;
@@ -50,6 +51,14 @@ void ImAppProgramDoDefaultWindowUi( ImAppContext* imapp, void* programContext, I
 
 	ImUiToolboxLabelFormat( uiWindow, "Hello %s for the %d time.", context->nameBuffer, context->tickIndex );
 
+	ImAppFrameStats frameStats;
+	ImAppRendererStats rendererStats;
+	if( ImAppGetFrameStats( imapp, &frameStats ) &&
+		ImAppWindowGetRendererStats( imapp, appWindow, &rendererStats ) )
+	{
+		ImUiToolboxLabelFormat( uiWindow, "Frame: %.2f ms, GPU: %.2f ms, Draw calls: %u", frameStats.averageIntervalMs, rendererStats.gpuTimeMs, rendererStats.drawCallCount );
+	}
+
 	if( ImUiToolboxButtonLabel( uiWindow, "Exit" ) )
 	{
 		ImAppQuit( imapp, 0 );
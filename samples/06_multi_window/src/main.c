@@ -7,13 +7,34 @@
 #include <string.h>
 #include <math.h>
 
+// Benchmark: 06_multi_window --benchmark [window count] [seconds]
+// Opens the windows at once, redraws all of them every tick and prints the frame rate.
+typedef struct ImAppMultiWindowsSampleBenchmark
+{
+	bool						enabled;
+	bool						isStarted;
+	size_t						windowCount;			// including the default window
+	double						duration;
+
+	double						startTime;
+	double						secondStartTime;
+	uint32_t					frameCount;
+	uint32_t					secondFrameCount;
+	float						fps;
+	float						minFps;
+} ImAppMultiWindowsSampleBenchmark;
+
 typedef struct ImAppMultiWindowsSampleContext
 {
 	ImAppWindow*				windows[ 10 ];
 	size_t						windowCount;
+
+	ImAppMultiWindowsSampleBenchmark	benchmark;
 } ImAppMultiWindowsSampleContext;
 
 static void imappMultiWindowSecondWindowUi( ImAppContext* imapp, void* programContext, ImAppWindow* appWindow, ImUiWindow* uiWindow, void* uiContext );
+static ImAppWindow* imappMultiWindowOpenWindow( ImAppContext* imapp, ImAppMultiWindowsSampleContext* context );
+static void imappMultiWindowBenchmarkTick( ImAppContext* imapp, ImAppMultiWindowsSampleContext* context, ImUiWindow* uiWindow );
 
 void* ImAppProgramInitialize( ImAppParameters* parameters, int argc, char* argv[] )
 {
@@ -23,6 +44,22 @@ void* ImAppProgramInitialize( ImAppParameters* parameters, int argc, char* argv[
 	ImAppMultiWindowsSampleContext* context = (ImAppMultiWindowsSampleContext*)malloc( sizeof( ImAppMultiWindowsSampleContext ) );
 	memset( context, 0, sizeof( *context ) );
 
+	if( argc > 1 && strcmp( argv[ 1 ], "--benchmark" ) == 0 )
+	{
+		ImAppMultiWindowsSampleBenchmark* benchmark = &context->benchmark;
+		benchmark->enabled		= true;
+		benchmark->windowCount	= argc > 2 ? (size_t)atoi( argv[ 2 ] ) : 4u;
+		benchmark->duration		= argc > 3 ? atof( argv[ 3 ] ) : 10.0;
+
+		if( benchmark->windowCount < 1u || benchmark->windowCount > 11u )
+		{
+			benchmark->windowCount = 4u;
+		}
+
+		// tick as fast as presentation allows
+		parameters->tickIntervalMs = 1;
+	}
+
 	return context;
 }
 
@@ -38,19 +75,15 @@ void ImAppProgramDoDefaultWindowUi( ImAppContext* imapp, void* programContext, I
 	ImUiWidgetSetLayoutVerticalSpacing( vLayout, 8.0f );
 	ImUiWidgetSetAlign( vLayout, 0.5f, 0.5f );
 
+	if( context->benchmark.enabled )
+	{
+		imappMultiWindowBenchmarkTick( imapp, context, uiWindow );
+	}
+
 	if( context->windowCount < 10 &&
 		ImUiToolboxButtonLabel( uiWindow, "Open Window" ) )
 	{
-		char titleBuffer[ 64 ];
-		snprintf( titleBuffer, sizeof( titleBuffer ), "Sub Window %zu", context->windowCount );
-
-		ImAppWindowParameters winParams = { 0 };
-		winParams.title		= titleBuffer;
-		winParams.width		= 720;
-		winParams.height	= 480;
-		winParams.clearColor	= ImUiColorCreate( 0x18u, 0xa2u, 0x78u, 0xff );
-
-		context->windows[ context->windowCount++ ] = ImAppWindowCreate( imapp, &winParams, imappMultiWindowSecondWindowUi, NULL );
+		context->windows[ context->windowCount++ ] = imappMultiWindowOpenWindow( imapp, context );
 	}
 
 	for( size_t i = 0; i < context->windowCount; ++i )
@@ -78,6 +111,8 @@ void ImAppProgramDoDefaultWindowUi( ImAppContext* imapp, void* programContext, I
 
 static void imappMultiWindowSecondWindowUi( ImAppContext* imapp, void* programContext, ImAppWindow* appWindow, ImUiWindow* uiWindow, void* uiContext )
 {
+	ImAppMultiWindowsSampleContext* context = (ImAppMultiWindowsSampleContext*)programContext;
+
 	ImUiWidget* vLayout = ImUiWidgetBegin( uiWindow );
 	ImUiWidgetSetLayoutVerticalSpacing( vLayout, 8.0f );
 	ImUiWidgetSetAlign( vLayout, 0.5f, 0.5f );
@@ -89,6 +124,15 @@ static void imappMultiWindowSecondWindowUi( ImAppContext* imapp, void* programCo
 		ImUiToolboxLabelEnd( label );
 	}
 
+	if( context->benchmark.enabled )
+	{
+		// changes every tick, so every window draws every tick
+		ImUiWidget* label = ImUiToolboxLabelBeginFormat( uiWindow, "Frame %u", context->benchmark.frameCount );
+		ImUiWidgetSetHAlign( label, 0.5f );
+
+		ImUiToolboxLabelEnd( label );
+	}
+
 	if( ImUiToolboxButtonLabel( uiWindow, "Close" ) )
 	{
 		ImAppWindowDestroy( imapp, appWindow );
@@ -97,6 +141,66 @@ static void imappMultiWindowSecondWindowUi( ImAppContext* imapp, void* programCo
 	ImUiWidgetEnd( vLayout );
 }
 
+static ImAppWindow* imappMultiWindowOpenWindow( ImAppContext* imapp, ImAppMultiWindowsSampleContext* context )
+{
+	char titleBuffer[ 64 ];
+	snprintf( titleBuffer, sizeof( titleBuffer ), "Sub Window %zu", context->windowCount );
+
+	ImAppWindowParameters winParams = { 0 };
+	winParams.title		= titleBuffer;
+	winParams.width		= 720;
+	winParams.height	= 480;
+	winParams.clearColor	= ImUiColorCreate( 0x18u, 0xa2u, 0x78u, 0xff );
+
+	return ImAppWindowCreate( imapp, &winParams, imappMultiWindowSecondWindowUi, NULL );
+}
+
+static void imappMultiWindowBenchmarkTick( ImAppContext* imapp, ImAppMultiWindowsSampleContext* context, ImUiWindow* uiWindow )
+{
+	ImAppMultiWindowsSampleBenchmark* benchmark = &context->benchmark;
+	const double time = ImUiWindowGetTime( uiWindow );
+
+	if( !benchmark->isStarted )
+	{
+		while( context->windowCount + 1u < benchmark->windowCount )
+		{
+			context->windows[ context->windowCount++ ] = imappMultiWindowOpenWindow( imapp, context );
+		}
+
+		benchmark->isStarted		= true;
+		benchmark->startTime		= time;
+		benchmark->secondStartTime	= time;
+		benchmark->minFps			= 0.0f;
+		return;
+	}
+
+	benchmark->frameCount++;
+	benchmark->secondFrameCount++;
+
+	if( time - benchmark->secondStartTime >= 1.0 )
+	{
+		benchmark->fps				= (float)(benchmark->secondFrameCount / (time - benchmark->secondStartTime));
+		benchmark->minFps			= benchmark->minFps == 0.0f || benchmark->fps < benchmark->minFps ? benchmark->fps : benchmark->minFps;
+		benchmark->secondStartTime	= time;
+		benchmark->secondFrameCount	= 0u;
+	}
+
+	{
+		ImUiWidget* label = ImUiToolboxLabelBeginFormat( uiWindow, "%zu windows: %.1f fps", benchmark->windowCount, benchmark->fps );
+		ImUiWidgetSetHAlign( label, 0.5f );
+
+		ImUiToolboxLabelEnd( label );
+	}
+
+	const double elapsed = time - benchmark->startTime;
+	if( benchmark->duration > 0.0 &&
+		elapsed >= benchmark->duration )
+	{
+		printf( "multi window benchmark: %zu windows, %u frames in %.2fs, average %.1f fps, worst second %.1f fps\n", benchmark->windowCount, benchmark->frameCount, elapsed, benchmark->frameCount / elapsed, benchmark->minFps );
+		ImAppQuit( imapp, 0 );
+	}
+}
+
 void ImAppProgramShutdown( ImAppContext* pImAppContext, void* pProgramContext )
 {
 	free( pProgramContext );
@@ -0,0 +1,194 @@
+#include "imapp/imapp.h"
+#include "imapp/imapp_headless.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Image test: 07_headless, needs imapp built with --use_headless=on
+// Draws a square on a known clear color, clicks it with synthetic input and compares the read back pixels before and
+// after. Exits with 0 when all pixels match.
+
+#define IMAPP_HEADLESS_SAMPLE_WIDTH			128
+#define IMAPP_HEADLESS_SAMPLE_HEIGHT		96
+#define IMAPP_HEADLESS_SAMPLE_TIMEOUT		60		// ticks to wait for an expected frame
+#define IMAPP_HEADLESS_SAMPLE_TOLERANCE		2		// per channel
+
+typedef enum ImAppHeadlessSampleStep
+{
+	ImAppHeadlessSampleStep_CheckIdle,
+	ImAppHeadlessSampleStep_Release,
+	ImAppHeadlessSampleStep_CheckClicked,
+	ImAppHeadlessSampleStep_Done
+} ImAppHeadlessSampleStep;
+
+typedef struct ImAppHeadlessSampleContext
+{
+	ImAppHeadlessSampleStep		step;
+	int							stepTickCount;
+	bool						isClicked;
+	ImUiRect					squareRect;
+
+	uint8_t						pixels[ IMAPP_HEADLESS_SAMPLE_WIDTH * IMAPP_HEADLESS_SAMPLE_HEIGHT * 4 ];
+} ImAppHeadlessSampleContext;
+
+static const ImUiColor s_clearColor		= { .red = 0x20u, .green = 0x40u, .blue = 0x80u, .alpha = 0xffu };
+static const ImUiColor s_idleColor		= { .red = 0xe0u, .green = 0x30u, .blue = 0x30u, .alpha = 0xffu };
+static const ImUiColor s_clickedColor	= { .red = 0x30u, .green = 0xc0u, .blue = 0x50u, .alpha = 0xffu };
+
+static bool	imappHeadlessSampleCheckFrame( ImAppHeadlessSampleContext* context, ImAppWindow* appWindow, ImUiColor squareColor );
+static bool	imappHeadlessSampleCheckPixel( const ImAppHeadlessSampleContext* context, int x, int y, ImUiColor expectedColor );
+static void	imappHeadlessSampleFinish( ImAppContext* imapp, ImAppHeadlessSampleContext* context, const char* failure );
+
+void* ImAppProgramInitialize( ImAppParameters* parameters, int argc, char* argv[] )
+{
+	parameters->tickIntervalMs				= 0;
+	parameters->defaultWindow.title			= "I'm App - Headless";
+	parameters->defaultWindow.width			= IMAPP_HEADLESS_SAMPLE_WIDTH;
+	parameters->defaultWindow.height		= IMAPP_HEADLESS_SAMPLE_HEIGHT;
+	parameters->defaultWindow.style			= ImAppWindowStyle_Borderless;
+	parameters->defaultWindow.clearColor	= s_clearColor;
+
+	ImAppHeadlessSampleContext* context = (ImAppHeadlessSampleContext*)malloc( sizeof( ImAppHeadlessSampleContext ) );
+	memset( context, 0, sizeof( *context ) );
+
+	return context;
+}
+
+void ImAppProgramDoDefaultWindowUi( ImAppContext* imapp, void* programContext, ImAppWindow* appWindow, ImUiWindow* uiWindow )
+{
+	ImAppHeadlessSampleContext* context = (ImAppHeadlessSampleContext*)programContext;
+
+	ImUiWidget* layout = ImUiWidgetBegin( uiWindow );
+	ImUiWidgetSetStretchOne( layout );
+	ImUiWidgetSetAlign( layout, 0.5f, 0.5f );
+
+	{
+		ImUiWidget* square = ImUiWidgetBegin( uiWindow );
+		ImUiWidgetSetFixedSize( square, ImUiSizeCreate( 32.0f, 32.0f ) );
+
+		ImUiWidgetInputState inputState;
+		ImUiWidgetGetInputState( square, &inputState );
+		if( inputState.hasMouseReleased )
+		{
+			context->isClicked = true;
+		}
+
+		ImUiWidgetDrawColor( square, context->isClicked ? s_clickedColor : s_idleColor );
+		context->squareRect = ImUiWidgetGetRect( square );
+
+		ImUiWidgetEnd( square );
+	}
+
+	ImUiWidgetEnd( layout );
+
+	// frames are read back one tick later, input pushed now arrives with the next tick
+	const int squareX = (int)(context->squareRect.pos.x + (context->squareRect.size.width * 0.5f));
+	const int squareY = (int)(context->squareRect.pos.y + (context->squareRect.size.height * 0.5f));
+
+	context->stepTickCount++;
+	switch( context->step )
+	{
+	case ImAppHeadlessSampleStep_CheckIdle:
+		if( imappHeadlessSampleCheckFrame( context, appWindow, s_idleColor ) )
+		{
+			ImAppHeadlessWindowPushMouseMove( appWindow, squareX, squareY );
+			ImAppHeadlessWindowPushMouseButton( appWindow, ImUiInputMouseButton_Left, true );
+
+			context->step			= ImAppHeadlessSampleStep_Release;
+			context->stepTickCount	= 0;
+		}
+		else if( context->stepTickCount > IMAPP_HEADLESS_SAMPLE_TIMEOUT )
+		{
+			imappHeadlessSampleFinish( imapp, context, "idle frame doesn't match" );
+		}
+		break;
+
+	case ImAppHeadlessSampleStep_Release:
+		ImAppHeadlessWindowPushMouseButton( appWindow, ImUiInputMouseButton_Left, false );
+
+		context->step			= ImAppHeadlessSampleStep_CheckClicked;
+		context->stepTickCount	= 0;
+		break;
+
+	case ImAppHeadlessSampleStep_CheckClicked:
+		if( imappHeadlessSampleCheckFrame( context, appWindow, s_clickedColor ) )
+		{
+			imappHeadlessSampleFinish( imapp, context, NULL );
+		}
+		else if( context->stepTickCount > IMAPP_HEADLESS_SAMPLE_TIMEOUT )
+		{
+			imappHeadlessSampleFinish( imapp, context, context->isClicked ? "clicked frame doesn't match" : "click didn't arrive" );
+		}
+		break;
+
+	case ImAppHeadlessSampleStep_Done:
+		break;
+	}
+}
+
+void ImAppProgramShutdown( ImAppContext* imapp, void* programContext )
+{
+	free( programContext );
+}
+
+static bool imappHeadlessSampleCheckFrame( ImAppHeadlessSampleContext* context, ImAppWindow* appWindow, ImUiColor squareColor )
+{
+	if( ImAppHeadlessWindowGetFrameCount( appWindow ) == 0u ||
+		!ImAppHeadlessWindowReadPixels( appWindow, context->pixels, sizeof( context->pixels ) ) )
+	{
+		return false;
+	}
+
+	const ImUiRect rect	= context->squareRect;
+	const int left		= (int)rect.pos.x;
+	const int top		= (int)rect.pos.y;
+	const int right		= (int)(rect.pos.x + rect.size.width) - 1;
+	const int bottom	= (int)(rect.pos.y + rect.size.height) - 1;
+
+	// inside the square a pixel away from its edges, the clear color in the corners of the window
+	return imappHeadlessSampleCheckPixel( context, left + 1, top + 1, squareColor ) &&
+		imappHeadlessSampleCheckPixel( context, right - 1, bottom - 1, squareColor ) &&
+		imappHeadlessSampleCheckPixel( context, (left + right) / 2, (top + bottom) / 2, squareColor ) &&
+		imappHeadlessSampleCheckPixel( context, 0, 0, s_clearColor ) &&
+		imappHeadlessSampleCheckPixel( context, IMAPP_HEADLESS_SAMPLE_WIDTH - 1, IMAPP_HEADLESS_SAMPLE_HEIGHT - 1, s_clearColor );
+}
+
+static bool imappHeadlessSampleCheckPixel( const ImAppHeadlessSampleContext* context, int x, int y, ImUiColor expectedColor )
+{
+	if( x < 0 || x >= IMAPP_HEADLESS_SAMPLE_WIDTH ||
+		y < 0 || y >= IMAPP_HEADLESS_SAMPLE_HEIGHT )
+	{
+		return false;
+	}
+
+	const uint8_t* pixel = &context->pixels[ ((y * IMAPP_HEADLESS_SAMPLE_WIDTH) + x) * 4 ];
+	// alpha of the read back frame depends on the renderer
+	const uint8_t expected[ 3 ] = { expectedColor.red, expectedColor.green, expectedColor.blue };
+	for( int i = 0; i < 3; ++i )
+	{
+		const int difference = (int)pixel[ i ] - (int)expected[ i ];
+		if( difference < -IMAPP_HEADLESS_SAMPLE_TOLERANCE || difference > IMAPP_HEADLESS_SAMPLE_TOLERANCE )
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void imappHeadlessSampleFinish( ImAppContext* imapp, ImAppHeadlessSampleContext* context, const char* failure )
+{
+	if( failure )
+	{
+		const ImUiRect rect = context->squareRect;
+		printf( "FAILED: %s (square at %.0f, %.0f size %.0f x %.0f)\n", failure, rect.pos.x, rect.pos.y, rect.size.width, rect.size.height );
+	}
+	else
+	{
+		printf( "OK\n" );
+	}
+
+	context->step = ImAppHeadlessSampleStep_Done;
+	ImAppQuit( imapp, failure ? 1 : 0 );
+}
@@ -4,6 +4,7 @@
 #include "imapp_event_queue.h"
 #include "imapp_internal.h"
 #include "imapp_platform.h"
+#include "imapp_render_thread.h"
 #include "imapp_renderer.h"
 #include "imapp_res_sys.h"
 #include "imapp_window_theme.h"
@@ -15,13 +16,22 @@
 #include <stdio.h>
 #include <string.h>
 
+#define IMAPP_FRAME_DEADLINE_TOLERANCE_MS	1.0f
+#define IMAPP_HIDDEN_KEEP_ALIVE_MS			1000		// tick interval and UI rate while no window is shown
+
 static void		imappFillDefaultParameters( ImAppParameters* parameters );
 static bool		imappInitialize( ImAppContext* imapp, const ImAppParameters* parameters );
 static void		imappCleanup( ImAppContext* imapp );
 static bool		imappHandleWindowEvents( ImAppContext* imapp, ImAppWindow* window, ImUiInput* input );
 static void		imappTick( void* arg );
 static void		imappTickUi( ImAppWindow* appWindow, void* arg );
-static void		imappTickWindowUi( ImAppContext* imapp, ImAppContextWindowInfo* windowInfo );
+static bool		imappTickWindowUi( ImAppContext* imapp, ImAppContextWindowInfo* windowInfo, double time );
+static void		imappLockRenderer( ImAppContext* imapp );
+static void		imappUnlockRenderer( ImAppContext* imapp );
+static void		imappWaitRenderer( ImAppContext* imapp );
+static void		imappUpdateFrameStats( ImAppContext* imapp, sint64 lastTickValue, sint64 deadlineMs );
+static void		imappLockRendererStats( const ImAppContext* imapp );
+static void		imappUnlockRendererStats( const ImAppContext* imapp );
 
 int imappMain( ImAppPlatform* platform, int argc, char* argv[] )
 {
@@ -77,7 +87,9 @@ int imappMain( ImAppPlatform* platform, int argc, char* argv[] )
 			uint16_t themeResIndex = IMAPP_RES_PAK_INVALID_INDEX;
 			while( true )
 			{
-				imappResSysUpdate( imapp->ressys, true );
+				// textures of the theme become ready only after their upload, don't block on the loader then
+				imappResSysUpdate( imapp->ressys, !imappRendererHasPendingUploads( imapp->renderer ) );
+				imappRendererUpdate( imapp->renderer );
 
 				const ImAppResState pakState = ImAppResPakGetState( imapp->defaultResPak );
 				if( pakState == ImAppResState_Loading )
@@ -142,10 +154,49 @@ static void imappTick( void* arg )
 {
 	ImAppContext* imapp = (ImAppContext*)arg;
 
-	imapp->lastTickValue = imappPlatformTick( imapp->platform, imapp->lastTickValue, imapp->tickIntervalMs );
+	bool isAllHidden = imapp->windowsCount > 0u;
+	for( uintsize i = 0u; i < imapp->windowsCount; ++i )
+	{
+		isAllHidden &= imapp->windows[ i ].isHidden;
+	}
+
+	// nothing gets drawn while no window is shown, redraw requests can wait until one is
+	sint64 tickIntervalMs = imapp->tickIntervalMs;
+	if( isAllHidden && tickIntervalMs > 0 )
+	{
+		tickIntervalMs = IMUI_MAX( tickIntervalMs, IMAPP_HIDDEN_KEEP_ALIVE_MS );
+	}
+
+	// keep ticking while textures upload, an event driven loop would wait for the next input otherwise
+	if( tickIntervalMs == 0 && imappRendererHasPendingUploads( imapp->renderer ) )
+	{
+		tickIntervalMs = 1;
+	}
+
+	if( imapp->redrawTime > 0.0 && !isAllHidden )
+	{
+		const double lastTickTime	= imappPlatformTicksToSeconds( imapp->platform, imapp->lastTickValue );
+		const sint64 redrawMs		= IMUI_MAX( (sint64)((imapp->redrawTime - lastTickTime) * 1000.0) + 1, 1 );	// rounded up
+		tickIntervalMs = tickIntervalMs == 0 ? redrawMs : IMUI_MIN( tickIntervalMs, redrawMs );
+	}
+
+	// lateness is measured against the interval of the app only, ticks forced by uploads, redraws or hidden windows have none
+	const sint64 deadlineMs = (tickIntervalMs == imapp->tickIntervalMs && !isAllHidden) ? imapp->tickIntervalMs : 0;
+
+	const sint64 lastTickValue = imapp->lastTickValue;
+	imapp->lastTickValue = imappPlatformTick( imapp->platform, lastTickValue, tickIntervalMs );
+	imappUpdateFrameStats( imapp, lastTickValue, deadlineMs );
 
+	if( imapp->redrawTime > 0.0 &&
+		imappPlatformTicksToSeconds( imapp->platform, imapp->lastTickValue ) >= imapp->redrawTime )
+	{
+		imapp->redrawTime = 0.0;
+	}
+
+	imappLockRenderer( imapp );
 	imappResSysUpdate( imapp->ressys, false );
 	imappRendererUpdate( imapp->renderer );
+	imappUnlockRenderer( imapp );
 
 	for( uintsize i = 0u; i < imapp->windowsCount; ++i )
 	{
@@ -153,8 +204,17 @@ static void imappTick( void* arg )
 
 		if( windowInfo->isDestroyed )
 		{
-			imappRendererDestructWindow( imapp->renderer, &windowInfo->rendererWindow );
+			imappWaitRenderer( imapp );
+
+			imappLockRenderer( imapp );
+			if( windowInfo->isRendererCreated )
+			{
+				imappRendererDestructWindow( imapp->renderer, windowInfo->rendererWindow );
+			}
+			imappUnlockRenderer( imapp );
+
 			imappPlatformWindowDestroy( windowInfo->window );
+			ImUiMemoryFree( &imapp->allocator, windowInfo->rendererWindow );
 
 			IMUI_MEMORY_ARRAY_REMOVE_UNSORTED_ZERO( imapp->windows, imapp->windowsCount, i );
 
@@ -168,6 +228,7 @@ static void imappTick( void* arg )
 		}
 
 		imappPlatformWindowUpdate( windowInfo->window, imappTickUi, imapp );
+		windowInfo->isHidden = imappPlatformWindowIsHidden( windowInfo->window );
 
 		ImUiInput* input = ImUiInputBegin( imapp->imui, windowInfo->inputState );
 
@@ -192,23 +253,63 @@ static void imappTickUi( ImAppWindow* appWindow, void* arg )
 	const double time = imappPlatformTicksToSeconds( imapp->platform, imapp->lastTickValue );
 	imapp->frame = ImUiBegin( imapp->imui, time );
 
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	if( imapp->renderThread != NULL )
+	{
+		imappRenderThreadBeginFrame( imapp->renderThread );
+	}
+#endif
+
+	// one vertical blank per tick instead of one per window, hidden windows don't present
+	uintsize vsyncWindowIndex = imapp->windowsCount;
+	for( uintsize i = 0u; i < imapp->windowsCount; ++i )
+	{
+		if( !imapp->windows[ i ].isHidden )
+		{
+			vsyncWindowIndex = i;
+		}
+	}
+
+	bool hasWaitedForVSync = false;
 	for( uintsize i = 0u; i < imapp->windowsCount; ++i )
 	{
 		ImAppContextWindowInfo* windowInfo = &imapp->windows[ i ];
-		imappTickWindowUi( imapp, windowInfo );
+		windowInfo->waitForVSync = i == vsyncWindowIndex;
+
+		hasWaitedForVSync |= imappTickWindowUi( imapp, windowInfo, time );
+	}
+
+	// the chosen window had no damage and skipped its present, wait anyway so the loop stays paced
+	if( vsyncWindowIndex < imapp->windowsCount &&
+		imapp->renderThread == NULL &&
+		!hasWaitedForVSync )
+	{
+		imappPlatformWaitForVSync( imapp->platform );
+	}
+
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	if( imapp->renderThread != NULL )
+	{
+		imappRenderThreadEndFrame( imapp->renderThread );
 	}
+#endif
 
 	ImUiEnd( imapp->frame );
 	imapp->frame = NULL;
 }
 
-static void imappTickWindowUi( ImAppContext* imapp, ImAppContextWindowInfo* windowInfo )
+// Returns true when the present of the window waited for the vertical blank.
+static bool imappTickWindowUi( ImAppContext* imapp, ImAppContextWindowInfo* windowInfo, double time )
 {
 	ImAppWindow* appWindow = windowInfo->window;
 
 	const ImAppWindowDeviceState deviceState = imappPlatformWindowGetGlContextState( appWindow );
 	if( deviceState == ImAppWindowDeviceState_DeviceLost )
 	{
+		imappWaitRenderer( imapp );
+		imappLockRenderer( imapp );
+
+		// only a real context loss gets here, the context is shared and every window loses its objects
 		for( uintsize i = 0u; i < imapp->windowsCount; ++i )
 		{
 			ImAppContextWindowInfo* otherWindowInfo = &imapp->windows[ i ];
@@ -217,40 +318,61 @@ static void imappTickWindowUi( ImAppContext* imapp, ImAppContextWindowInfo* wind
 				continue;
 			}
 
-			imappRendererDestructWindow( imapp->renderer, &otherWindowInfo->rendererWindow );
+			imappRendererDestructWindow( imapp->renderer, otherWindowInfo->rendererWindow );
 			otherWindowInfo->isRendererCreated = false;
 		}
 
 		imappResSysDestroyDeviceResources( imapp->ressys );
 		imappRendererDestroyResources( imapp->renderer );
 
-		// ???
+		// the platform replaces the lost context in EndRender once nothing references it anymore. Still under the
+		// lock, unlocking releases the new context again so the render thread can take it for the next frame.
 		imappPlatformWindowBeginRender( appWindow );
-		imappPlatformWindowEndRender( appWindow );
-		return;
+		imappPlatformWindowEndRender( appWindow, true, NULL );
+
+		imappUnlockRenderer( imapp );
+		return false;
 	}
 	else if( deviceState == ImAppWindowDeviceState_NewDevice )
 	{
+		imappLockRenderer( imapp );
 		imappRendererCreateResources( imapp->renderer );
 		imappResSysCreateDeviceResources( imapp->ressys );
+		imappUnlockRenderer( imapp );
 	}
 	else if( deviceState == ImAppWindowDeviceState_NoDevice )
 	{
-		return;
+		return false;
 	}
 
+	// a hidden window only builds its UI now and then to keep its state alive, it never gets drawn
+	const bool isDrawn = !windowInfo->isHidden;
+	if( !isDrawn && time < windowInfo->keepAliveTime )
+	{
+		return false;
+	}
+	windowInfo->keepAliveTime = time + (IMAPP_HIDDEN_KEEP_ALIVE_MS / 1000.0);
+
 	int width;
 	int height;
 	imappPlatformWindowGetSize( appWindow, &width, &height );
 
-	imappPlatformWindowBeginRender( appWindow );
-
-	if( !windowInfo->isRendererCreated )
+	const bool isThreaded = imapp->renderThread != NULL;
+	if( !isThreaded && isDrawn )
 	{
-		imappRendererConstructWindow( imapp->renderer, &windowInfo->rendererWindow );
-		windowInfo->isRendererCreated = true;
+		imappPlatformWindowBeginRender( appWindow );
+
+		if( !windowInfo->isRendererCreated )
+		{
+			imappRendererConstructWindow( imapp->renderer, windowInfo->rendererWindow, appWindow );
+			windowInfo->isRendererCreated = true;
+		}
 	}
 
+	bool present = false;
+	ImUiRect damageRect;
+	ImUiRect* presentRect = NULL;
+	ImUiSurface* drawSurface = NULL;
 	if( windowInfo->inputState )
 	{
 		const ImUiSize size		= ImUiSizeCreate( (float)width, (float)height );
@@ -280,8 +402,41 @@ static void imappTickWindowUi( ImAppContext* imapp, ImAppContextWindowInfo* wind
 		}
 
 		ImUiSurfaceEnd( surface );
+		drawSurface = surface;
+	}
+
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	if( isThreaded && isDrawn )
+	{
+		// drawn and presented by the render thread while the next frame gets built
+		if( !imappRenderThreadAddWindow( imapp->renderThread, windowInfo, drawSurface, width, height ) )
+		{
+			ImAppTrace( "[imapp] Failed to queue window for the render thread.\n" );
+		}
+
+		windowInfo->isRendererCreated	= true;
+		windowInfo->cacheRectCount		= 0u;
+	}
+	else
+#endif
+	if( isDrawn )
+	{
+		for( uintsize i = 0u; i < windowInfo->cacheRectCount; ++i )
+		{
+			imappRendererWindowRequestCache( windowInfo->rendererWindow, windowInfo->cacheRects[ i ] );
+		}
+		windowInfo->cacheRectCount = 0u;
+
+		if( drawSurface != NULL )
+		{
+			const int bufferAge = imappPlatformWindowGetBufferAge( appWindow );
+			present = imappRendererDraw( imapp->renderer, windowInfo->rendererWindow, drawSurface, width, height, windowInfo->clearColor, bufferAge, &damageRect );
+			presentRect = &damageRect;
 
-		imappRendererDraw( imapp->renderer, &windowInfo->rendererWindow, surface, width, height, windowInfo->clearColor );
+#if IMAPP_DISABLED( IMAPP_RENDERER_OPENGL )
+			imappPlatformWindowSetPixels( appWindow, windowInfo->rendererWindow->pixels, windowInfo->rendererWindow->width, windowInfo->rendererWindow->height );
+#endif
+		}
 	}
 
 	const ImUiInputMouseCursor cursor = ImUiInputGetMouseCursor( imapp->imui );
@@ -298,7 +453,99 @@ static void imappTickWindowUi( ImAppContext* imapp, ImAppContextWindowInfo* wind
 		ImUiInputSetCopyText( imapp->imui, NULL, 0u );
 	}
 
-	imappPlatformWindowEndRender( appWindow );
+	if( !isThreaded && isDrawn )
+	{
+		imappPlatformWindowSetVSync( appWindow, windowInfo->waitForVSync );
+		imappPlatformWindowEndRender( appWindow, present, presentRect );
+
+		return present && windowInfo->waitForVSync;
+	}
+
+	return false;
+}
+
+static void imappUpdateFrameStats( ImAppContext* imapp, sint64 lastTickValue, sint64 deadlineMs )
+{
+	ImAppFrameStats* stats = &imapp->frameStats;
+	if( lastTickValue == 0 )
+	{
+		// first tick, nothing to measure yet
+		return;
+	}
+
+	const double lastTickTime	= imappPlatformTicksToSeconds( imapp->platform, lastTickValue );
+	const double tickTime		= imappPlatformTicksToSeconds( imapp->platform, imapp->lastTickValue );
+	const float intervalMs		= (float)((tickTime - lastTickTime) * 1000.0);
+
+	stats->tickCount++;
+	stats->lastIntervalMs		= intervalMs;
+	stats->averageIntervalMs	= stats->tickCount == 1u ? intervalMs : stats->averageIntervalMs + ((intervalMs - stats->averageIntervalMs) / 16.0f);
+	stats->lastLatenessMs		= 0.0f;
+
+	if( deadlineMs > 0 )
+	{
+		const float latenessMs = intervalMs - (float)deadlineMs;
+		stats->lastLatenessMs = latenessMs > 0.0f ? latenessMs : 0.0f;
+		if( latenessMs > IMAPP_FRAME_DEADLINE_TOLERANCE_MS )
+		{
+			stats->missedDeadlineCount++;
+		}
+	}
+}
+
+static void imappLockRenderer( ImAppContext* imapp )
+{
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	// borrows the context from the render thread, nothing to do without it
+	imappRendererLockContext( imapp->renderer );
+#else
+	IMAPP_USE( imapp );
+#endif
+}
+
+static void imappUnlockRenderer( ImAppContext* imapp )
+{
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	imappRendererUnlockContext( imapp->renderer );
+#else
+	IMAPP_USE( imapp );
+#endif
+}
+
+static void imappWaitRenderer( ImAppContext* imapp )
+{
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	if( imapp->renderThread != NULL )
+	{
+		imappRenderThreadWaitIdle( imapp->renderThread );
+	}
+#else
+	IMAPP_USE( imapp );
+#endif
+}
+
+static void imappLockRendererStats( const ImAppContext* imapp )
+{
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	if( imapp->renderThread != NULL )
+	{
+		imappRenderThreadLock( imapp->renderThread );
+	}
+#else
+	IMAPP_USE( imapp );
+#endif
+}
+
+static void imappUnlockRendererStats( const ImAppContext* imapp )
+{
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	if( imapp->renderThread != NULL )
+	{
+		imappRenderThreadUnlock( imapp->renderThread );
+	}
+#else
+	IMAPP_USE( imapp );
+#endif
 }
 
 static void imappFillDefaultParameters( ImAppParameters* parameters )
@@ -306,6 +553,13 @@ static void imappFillDefaultParameters( ImAppParameters* parameters )
 	memset( parameters, 0, sizeof( *parameters ) );
 
 	parameters->resPath						= "./assets";
+	parameters->rendererFlags				= ImAppRendererFlags_StreamingBuffers;
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+	// rasterized from CPU memory, tracking damage needs no extra copy
+	parameters->rendererFlags				|= ImAppRendererFlags_DamageTracking;
+#endif
+	parameters->textureUploadBudget			= 4u * 1024u * 1024u;
+	parameters->textureUploadBudgetMs		= 2.0f;
 
 #if IMAPP_ENABLED( IMAPP_PLATFORM_ANDROID )
     parameters->defaultFontName				= "Roboto-Regular.ttf";
@@ -372,12 +626,13 @@ void ImAppDefaultWindowDoUi( ImAppContext* imapp, void* programContext, ImAppWin
 
 static bool imappInitialize( ImAppContext* imapp, const ImAppParameters* parameters )
 {
-	imapp->renderer = imappRendererCreate( &imapp->allocator, imapp->platform );
+	imapp->renderer = imappRendererCreate( &imapp->allocator, imapp->platform, parameters->rendererFlags );
 	if( imapp->renderer == NULL )
 	{
 		imappPlatformShowError( imapp->platform, "Failed to create Renderer." );
 		return false;
 	}
+	imappRendererSetUploadBudget( imapp->renderer, parameters->textureUploadBudget, parameters->textureUploadBudgetMs );
 
 	if( parameters->useDefaultWindow )
 	{
@@ -434,11 +689,26 @@ static bool imappInitialize( ImAppContext* imapp, const ImAppParameters* paramet
 		imapp->defaultResPak = imappResSysOpen( imapp->ressys, buffer );
 	}
 
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	if( parameters->useRenderThread )
+	{
+		imapp->renderThread = imappRenderThreadCreate( &imapp->allocator, imapp->platform, imapp->renderer );
+	}
+#endif
+
 	return true;
 }
 
 static void imappCleanup( ImAppContext* imapp )
 {
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+	if( imapp->renderThread != NULL )
+	{
+		imappRenderThreadDestroy( imapp->renderThread );
+		imapp->renderThread = NULL;
+	}
+#endif
+
 	if( imapp->programContext != NULL )
 	{
 		ImAppProgramShutdown( imapp, imapp->programContext );
@@ -469,10 +739,18 @@ static void imappCleanup( ImAppContext* imapp )
 		imapp->imui = NULL;
 	}
 
-	while( imapp->windowsCount > 0 )
+	for( uintsize i = 0u; i < imapp->windowsCount; ++i )
 	{
-		ImAppWindowDestroy( imapp, imapp->windows[ 0 ].window );
+		ImAppContextWindowInfo* windowInfo = &imapp->windows[ i ];
+		if( windowInfo->isRendererCreated )
+		{
+			imappRendererDestructWindow( imapp->renderer, windowInfo->rendererWindow );
+		}
+
+		imappPlatformWindowDestroy( windowInfo->window );
+		ImUiMemoryFree( &imapp->allocator, windowInfo->rendererWindow );
 	}
+	imapp->windowsCount = 0u;
 	ImUiMemoryFree( &imapp->allocator, imapp->windows );
 	imapp->windows = NULL;
 
@@ -567,16 +845,24 @@ ImAppWindow* ImAppWindowCreate( ImAppContext* imapp, const ImAppWindowParameters
 		return NULL;
 	}
 
+	ImAppRendererWindow* rendererWindow = IMUI_MEMORY_NEW_ZERO( &imapp->allocator, ImAppRendererWindow );
+	if( !rendererWindow )
+	{
+		return NULL;
+	}
+
 	ImAppWindow* window = imappPlatformWindowCreate( imapp->platform, parameters );
 	if( !window )
 	{
+		ImUiMemoryFree( &imapp->allocator, rendererWindow );
 		return NULL;
 	}
 
 	ImAppContextWindowInfo* windowInfo = &imapp->windows[ imapp->windowsCount++ ];
-	windowInfo->window		= window;
-	windowInfo->uiFunc		= uiFunc;
-	windowInfo->uiContext	= uiContext;
+	windowInfo->window			= window;
+	windowInfo->rendererWindow	= rendererWindow;
+	windowInfo->uiFunc			= uiFunc;
+	windowInfo->uiContext		= uiContext;
 
 	windowInfo->clearColor[ 0 ]	= (float)parameters->clearColor.red / 255.0f;
 	windowInfo->clearColor[ 1 ]	= (float)parameters->clearColor.green / 255.0f;
@@ -622,6 +908,80 @@ bool ImAppWindowIsOpen( const ImAppContext* imapp, const ImAppWindow* window )
 	return false;
 }
 
+bool ImAppWindowGetRendererStats( const ImAppContext* imapp, const ImAppWindow* window, ImAppRendererStats* outStats )
+{
+	for( uintsize i = 0; i < imapp->windowsCount; ++i )
+	{
+		const ImAppContextWindowInfo* windowInfo = &imapp->windows[ i ];
+		if( windowInfo->window != window ||
+			!windowInfo->isRendererCreated )
+		{
+			continue;
+		}
+
+		imappLockRendererStats( imapp );
+		*outStats = windowInfo->rendererWindow->stats;
+		imappRendererGetTextureStats( imapp->renderer, outStats );
+		imappUnlockRendererStats( imapp );
+		return true;
+	}
+
+	return false;
+}
+
+bool ImAppGetRendererStats( const ImAppContext* imapp, ImAppRendererStats* outStats )
+{
+	if( imapp->renderer == NULL )
+	{
+		return false;
+	}
+
+	memset( outStats, 0, sizeof( *outStats ) );
+	imappLockRendererStats( imapp );
+	for( uintsize i = 0; i < imapp->windowsCount; ++i )
+	{
+		const ImAppContextWindowInfo* windowInfo = &imapp->windows[ i ];
+		if( !windowInfo->isRendererCreated )
+		{
+			continue;
+		}
+
+		const ImAppRendererStats* windowStats = &windowInfo->rendererWindow->stats;
+		outStats->commandCount			+= windowStats->commandCount;
+		outStats->drawCallCount			+= windowStats->drawCallCount;
+		outStats->cacheHitCount			+= windowStats->cacheHitCount;
+		outStats->cacheMissCount		+= windowStats->cacheMissCount;
+		outStats->gpuTimeMs				+= windowStats->gpuTimeMs;
+		outStats->gpuCacheTimeMs		+= windowStats->gpuCacheTimeMs;
+		outStats->programChangeCount	+= windowStats->programChangeCount;
+		outStats->textureChangeCount	+= windowStats->textureChangeCount;
+		outStats->scissorChangeCount	+= windowStats->scissorChangeCount;
+		outStats->vertexBytesUploaded	+= windowStats->vertexBytesUploaded;
+		outStats->indexBytesUploaded	+= windowStats->indexBytesUploaded;
+	}
+
+	imappRendererGetTextureStats( imapp->renderer, outStats );
+	imappUnlockRendererStats( imapp );
+	return true;
+}
+
+void ImAppWindowSetUiWindowCached( ImAppContext* imapp, ImAppWindow* window, ImUiWindow* uiWindow )
+{
+	for( uintsize i = 0; i < imapp->windowsCount; ++i )
+	{
+		ImAppContextWindowInfo* windowInfo = &imapp->windows[ i ];
+		if( windowInfo->window != window ||
+			windowInfo->cacheRectCount == IMAPP_ARRAY_COUNT( windowInfo->cacheRects ) )
+		{
+			continue;
+		}
+
+		// the renderer window may be in use by the render thread, applied before the draw
+		windowInfo->cacheRects[ windowInfo->cacheRectCount++ ] = ImUiWindowGetRect( uiWindow );
+		return;
+	}
+}
+
 bool ImAppWindowHasFocus( const ImAppWindow* window )
 {
 	return imappPlatformWindowHasFocus( window );
@@ -667,6 +1027,27 @@ ImUiContext* ImAppGetUi( ImAppContext* imapp )
 	return imapp->imui;
 }
 
+void ImAppRequestRedraw( ImAppContext* imapp )
+{
+	imappPlatformWakeUp( imapp->platform );
+}
+
+void ImAppRequestRedrawIn( ImAppContext* imapp, uint32_t ms )
+{
+	const double redrawTime = imappPlatformTicksToSeconds( imapp->platform, imappPlatformGetTickValue( imapp->platform ) ) + (ms / 1000.0);
+	if( imapp->redrawTime == 0.0 ||
+		redrawTime < imapp->redrawTime )
+	{
+		imapp->redrawTime = redrawTime;
+	}
+}
+
+bool ImAppGetFrameStats( const ImAppContext* imapp, ImAppFrameStats* outStats )
+{
+	*outStats = imapp->frameStats;
+	return true;
+}
+
 void ImAppQuit( ImAppContext* imapp, int exitCode )
 {
 #if IMAPP_ENABLED( IMAPP_PLATFORM_WEB )
@@ -734,7 +1115,7 @@ ImAppImage* ImAppImageCreateRaw( ImAppContext* imapp, const void* imageData, siz
 {
 	if( imageDataSize < (size_t)(width * height * 4) )
 	{
-		IMAPP_DEBUG_LOGW( "Insuficiant data to create image." );
+		IMAPP_DEBUG_LOGW( "Insufficient data to create image." );
 		return NULL;
 	}
 
@@ -756,6 +1137,27 @@ ImAppResState ImAppImageGetState( ImAppContext* imapp, ImAppImage* image )
 	return imappResSysImageGetState( imapp->ressys, image );
 }
 
+bool ImAppImageUpdate( ImAppContext* imapp, ImAppImage* image, const void* imageData, size_t imageDataSize )
+{
+	return ImAppImageUpdateRegion( imapp, image, imageData, imageDataSize, 0, 0, (int)image->uiImage.width, (int)image->uiImage.height );
+}
+
+bool ImAppImageUpdateRegion( ImAppContext* imapp, ImAppImage* image, const void* imageData, size_t imageDataSize, int x, int y, int width, int height )
+{
+	if( x < 0 || y < 0 || width <= 0 || height <= 0 )
+	{
+		return false;
+	}
+
+	if( imageDataSize < (size_t)width * (size_t)height * 4u )
+	{
+		IMAPP_DEBUG_LOGW( "Insufficient data to update image." );
+		return false;
+	}
+
+	return imappResSysImageUpdate( imapp->ressys, image, imageData, (uint32)x, (uint32)y, (uint32)width, (uint32)height );
+}
+
 void ImAppImageFree( ImAppContext* imapp, ImAppImage* image )
 {
 	imappResSysImageFree( imapp->ressys, image );
@@ -111,6 +111,31 @@
 #	define IMAPP_PLATFORM_SDL			TIKI_OFF
 #endif
 
+#if !defined( IMAPP_PLATFORM_HEADLESS )
+#	define IMAPP_PLATFORM_HEADLESS		TIKI_OFF
+#endif
+
+// native Linux backend, windows are Wayland surfaces
+#if IMAPP_ENABLED( IMAPP_PLATFORM_LINUX ) && IMAPP_DISABLED( IMAPP_PLATFORM_SDL ) && IMAPP_DISABLED( IMAPP_PLATFORM_HEADLESS )
+#	define IMAPP_PLATFORM_WAYLAND		TIKI_ON
+#else
+#	define IMAPP_PLATFORM_WAYLAND		TIKI_OFF
+#endif
+
+#if !defined( IMAPP_RENDERER_SOFTWARE )
+#	define IMAPP_RENDERER_SOFTWARE		TIKI_OFF
+#endif
+
+#if !defined( IMAPP_RENDERER_VULKAN )
+#	define IMAPP_RENDERER_VULKAN		TIKI_OFF
+#endif
+
+#if IMAPP_DISABLED( IMAPP_RENDERER_SOFTWARE ) && IMAPP_DISABLED( IMAPP_RENDERER_VULKAN )
+#	define IMAPP_RENDERER_OPENGL		TIKI_ON
+#else
+#	define IMAPP_RENDERER_OPENGL		TIKI_OFF
+#endif
+
 #if !defined( IMAPP_POINTER_32 )
 #	define IMAPP_POINTER_32				TIKI_OFF
 #endif
@@ -3,6 +3,7 @@
 #include "imapp/imapp.h"
 
 #include "imapp_defines.h"
+#include "imapp_render_thread.h"
 #include "imapp_renderer.h"
 
 #include "imui/../../src/imui_internal.h"
@@ -15,6 +16,7 @@
 typedef struct ImAppFont ImAppFont;
 typedef struct ImAppPlatform ImAppPlatform;
 typedef struct ImAppRenderer ImAppRenderer;
+typedef struct ImAppRenderThread ImAppRenderThread;
 typedef struct ImAppRendererWindow ImAppRendererWindow;
 typedef struct ImAppResSys ImAppResSys;
 typedef struct ImAppWindow ImAppWindow;
@@ -27,11 +29,16 @@ typedef struct ImAppContextWindowInfo
 	ImAppWindowDoUiFunc		uiFunc;
 	void*					uiContext;
 
-	ImAppRendererWindow		rendererWindow;
+	ImAppRendererWindow*	rendererWindow;		// on the heap, a queued frame of the render thread points to it
 	float					clearColor[ 4u ];
+	ImUiRect				cacheRects[ IMAPP_RENDERER_MAX_CACHE_ENTRIES ];	// applied before the next draw
+	uintsize				cacheRectCount;
 
 	bool					isRendererCreated;
 	bool					isDestroyed;
+	bool					isHidden;			// not shown by the compositor, neither built nor drawn
+	double					keepAliveTime;		// next time a hidden window builds its UI
+	bool					waitForVSync;		// only the last visible window of a tick blocks in its present, the tick waits once if it has no damage
 } ImAppContextWindowInfo;
 
 struct ImAppContext
@@ -42,6 +49,8 @@ struct ImAppContext
 	int						exitCode;
 	int64_t					tickIntervalMs;
 	int64_t					lastTickValue;
+	double					redrawTime;			// ImAppRequestRedrawIn, 0 if none
+	ImAppFrameStats			frameStats;
 	ImUiInputMouseCursor	lastCursor;
 	double					lastFocusExecuteTime;
 
@@ -49,6 +58,7 @@ struct ImAppContext
 	ImUiContext*			imui;
 	ImAppRenderer*			renderer;
 	ImAppResSys*			ressys;
+	ImAppRenderThread*		renderThread;		// NULL: rendering on the main thread
 
 	ImAppContextWindowInfo*	windows;
 	uintsize				windowsCount;
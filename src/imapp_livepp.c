@@ -9,6 +9,7 @@
 
 static bool s_livePlusPlusAgentEnabled = false;
 static LppSynchronizedAgent s_livePlusPlusAgent;
+static uint32_t s_livePlusPlusReloadCount = 0u;
 
 static void imappLivePlusPlusConnectionCallback( void* /*context*/, LppConnectionStatus status );
 
@@ -38,6 +39,7 @@ void imappLivePlusPlusUpdate()
 	if( s_livePlusPlusAgent.WantsReload( LPP_RELOAD_OPTION_SYNCHRONIZE_WITH_RELOAD ) )
 	{
 		s_livePlusPlusAgent.Reload( LPP_RELOAD_BEHAVIOUR_WAIT_UNTIL_CHANGES_ARE_APPLIED );
+		s_livePlusPlusReloadCount++;
 	}
 
 	if( s_livePlusPlusAgent.WantsRestart() )
@@ -54,6 +56,12 @@ void imappLivePlusPlusForceHotReload()
 	}
 
 	s_livePlusPlusAgent.Reload( LPP_RELOAD_BEHAVIOUR_WAIT_UNTIL_CHANGES_ARE_APPLIED );
+	s_livePlusPlusReloadCount++;
+}
+
+uint32_t imappLivePlusPlusGetReloadCount()
+{
+	return s_livePlusPlusReloadCount;
 }
 
 static void imappLivePlusPlusConnectionCallback( void* context, LppConnectionStatus status )
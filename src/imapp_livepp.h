@@ -8,4 +8,7 @@ bool	imappLivePlusPlusEnable( const wchar_t* basePath );
 void	imappLivePlusPlusUpdate();
 void	imappLivePlusPlusForceHotReload();
 
+// Incremented after every applied patch, code and constant data can have changed since.
+uint32_t	imappLivePlusPlusGetReloadCount();
+
 #endif
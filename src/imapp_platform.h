@@ -5,6 +5,10 @@
 #include "imapp_types.h"
 #include "imapp_main.h"
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_VULKAN )
+#	include <vulkan/vulkan.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 // Core
 
@@ -15,6 +19,9 @@ void					imappPlatformShutdown( ImAppPlatform* platform );
 
 sint64					imappPlatformTick( ImAppPlatform* platform, sint64 lastTickValue, sint64 tickIntervalMs );
 double					imappPlatformTicksToSeconds( ImAppPlatform* platform, sint64 tickValue );
+sint64					imappPlatformGetTickValue( ImAppPlatform* platform );	// current time in the unit of imappPlatformTick
+void					imappPlatformWakeUp( ImAppPlatform* platform );		// thread safe, the current or next wait of imappPlatformTick returns right away
+void					imappPlatformWaitForVSync( ImAppPlatform* platform );	// for a tick in which no present waited, call it on the rendering thread
 
 void					imappPlatformShowError( ImAppPlatform* platform, const char* message );
 
@@ -28,16 +35,22 @@ void					imappPlatformGetClipboardText( ImAppPlatform* platform, ImUiContext* im
 typedef struct ImAppEventQueue ImAppEventQueue;
 typedef struct ImAppWindow ImAppWindow;
 
+// All windows render with one GL context owned by the platform, windows only own their surface.
 typedef enum ImAppWindowDeviceState
 {
 	ImAppWindowDeviceState_Ok,
-	ImAppWindowDeviceState_NewDevice,
-	ImAppWindowDeviceState_NoDevice,
-	ImAppWindowDeviceState_DeviceLost
+	ImAppWindowDeviceState_NewDevice,		// context got (re)created, resources need to be created
+	ImAppWindowDeviceState_NoDevice,		// window has no surface right now, the context and resources stay
+	ImAppWindowDeviceState_DeviceLost		// shared context is lost for all windows, a broken surface is recreated by the platform without it
 } ImAppWindowDeviceState;
 
 typedef void(*ImAppPlatformWindowUpdateCallback)( ImAppWindow* window, void* arg );
 
+// The context is current on one thread at a time. Acquire makes it current on the calling thread without a window surface, false
+// when the platform can't. Release leaves it current on no thread, so an other thread can take it.
+bool					imappPlatformAcquireGlContext( ImAppPlatform* platform );
+void					imappPlatformReleaseGlContext( ImAppPlatform* platform );
+
 ImAppWindow*			imappPlatformWindowCreate( ImAppPlatform* platform, const ImAppWindowParameters* parameters );
 void					imappPlatformWindowDestroy( ImAppWindow* window );
 
@@ -45,7 +58,10 @@ ImAppWindowDeviceState	imappPlatformWindowGetGlContextState( const ImAppWindow*
 
 void					imappPlatformWindowUpdate( ImAppWindow* window, ImAppPlatformWindowUpdateCallback callback, void* arg );
 bool					imappPlatformWindowBeginRender( ImAppWindow* window );
-bool					imappPlatformWindowEndRender( ImAppWindow* window );
+int						imappPlatformWindowGetBufferAge( const ImAppWindow* window );		// age of the back buffer content in frames, 0 if undefined
+bool					imappPlatformWindowEndRender( ImAppWindow* window, bool present, const ImUiRect* damageRect );	// damageRect NULL: whole window
+void					imappPlatformWindowSetVSync( ImAppWindow* window, bool wait );		// applied by the next present, call it on the rendering thread. Default: true
+void					imappPlatformWindowSetPixels( ImAppWindow* window, const uint32_t* pixels, int width, int height );	// software renderer: BGRA8 frame, top row first, presented by EndRender
 
 ImAppEventQueue*		imappPlatformWindowGetEventQueue( ImAppWindow* window );
 
@@ -53,6 +69,7 @@ bool					imappPlatformWindowPopDropData( ImAppWindow* window, ImAppDropData* out
 
 void					imappPlatformWindowGetViewRect( const ImAppWindow* window, int* outX, int* outY, int* outWidth, int* outHeight );
 bool					imappPlatformWindowHasFocus( const ImAppWindow* window );
+bool					imappPlatformWindowIsHidden( const ImAppWindow* window );		// not shown by the compositor: minimized, suspended or occluded
 void					imappPlatformWindowGetSize( const ImAppWindow* window, int* outWidth, int* outHeight );
 void					imappPlatformWindowSetSize( ImAppWindow* window, int width, int height );
 void					imappPlatformWindowGetPosition( const ImAppWindow* window, int* outX, int* outY );
@@ -66,6 +83,11 @@ void					imappPlatformWindowSetTitleBounds( ImAppWindow* window, int height, int
 float					imappPlatformWindowGetDpiScale( const ImAppWindow* window );
 void					imappPlatformWindowClose( ImAppWindow* window );
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_VULKAN )
+const char* const*		imappPlatformGetVulkanInstanceExtensions( ImAppPlatform* platform, uint32_t* outCount );	// none: windows have no surface and render offscreen
+bool					imappPlatformWindowCreateVulkanSurface( ImAppWindow* window, VkInstance instance, VkSurfaceKHR* outSurface );
+#endif
+
 //////////////////////////////////////////////////////////////////////////
 // Files/Resources
 
@@ -87,6 +109,9 @@ void					imappPlatformResourceClose( ImAppPlatform* platform, ImAppFile* file );
 ImAppBlob				imappPlatformResourceLoadSystemFont( ImAppPlatform* platform, const char* fontName );
 void					imappPlatformResourceFree( ImAppPlatform* platform, ImAppBlob blob );
 
+// Path of fileName in a writable per user cache directory, which gets created. Returns false when there is none.
+bool					imappPlatformGetCachePath( ImAppPlatform* platform, char* outPath, uintsize pathCapacity, const char* fileName );
+
 ImAppFileWatcher*		imappPlatformFileWatcherCreate( ImAppPlatform* platform );
 void					imappPlatformFileWatcherDestroy( ImAppPlatform* platform, ImAppFileWatcher* watcher );
 void					imappPlatformFileWatcherAddPath( ImAppFileWatcher* watcher, const char* path );
@@ -10,11 +10,13 @@
 #include <android/native_activity.h>
 
 #include <EGL/egl.h>
+#include <EGL/eglext.h>
 #include <dlfcn.h>
 #include <errno.h>
 #include <jni.h>
 #include <pthread.h>
 #include <semaphore.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -630,6 +632,31 @@ sint64 imappPlatformTick( ImAppPlatform* platform, sint64 lastTickValue, sint64
 	return currentTickValue;
 }
 
+void imappPlatformWakeUp( ImAppPlatform* platform )
+{
+	// thread safe, interrupts a poll of the looper
+	if( platform->pLooper )
+	{
+		ALooper_wake( platform->pLooper );
+	}
+}
+
+void imappPlatformWaitForVSync( ImAppPlatform* platform )
+{
+	// one window whose swap paces the loop, unchanged frames wait in the looper for the next event
+	IMAPP_USE( platform );
+}
+
+sint64 imappPlatformGetTickValue( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+
+	struct timespec currentTime;
+	clock_gettime( CLOCK_REALTIME, &currentTime );
+
+	return ((int64_t)currentTime.tv_sec * 1000ll) + ((int64_t)currentTime.tv_nsec / 1000000ll);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // Window
 
@@ -645,15 +672,22 @@ struct ImAppWindow
 	bool				isOpen;
 
 	EGLDisplay			display;
-	EGLSurface			surface;
-	EGLContext			context;
-	bool				hasDeviceLost;
+	EGLConfig			config;
+	EGLSurface			surface;			// EGL_NO_SURFACE while the activity has no native window
+	EGLContext			context;			// survives the surface, resources only get reloaded when it's lost
+	bool				hasBufferAge;
+	PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC	swapBuffersWithDamage;
+	bool				hasDeviceLost;		// EGL_CONTEXT_LOST, everything gets reloaded
+	bool				hasSurfaceLost;		// only the surface broke, it gets recreated with the context kept
 	bool				hasDeviceChange;
 
 	int					width;
 	int					height;
 };
 
+static void	ImAppPlatformWindowDestroySurface( ImAppWindow* window );
+static void	ImAppPlatformWindowHandleEglError( ImAppWindow* window );
+static void	ImAppPlatformWindowRecreateLostSurface( ImAppWindow* window );
 static void	ImAppPlatformWindowHandleWindowChangedEvent( ImAppWindow* window, const ImAppAndroidEvent* pSystemEvent );
 static void	ImAppPlatformWindowHandleWindowResizeEvent( ImAppWindow* window, const ImAppAndroidEvent* pSystemEvent );
 static void	ImAppPlatformWindowHandleInputChangedEvent( ImAppWindow* window, const ImAppAndroidEvent* pSystemEvent );
@@ -707,36 +741,49 @@ void imappPlatformWindowDestroy( ImAppWindow* window )
 bool ImAppPlatformWindowCreateGlContext( ImAppWindow* window )
 {
 	IMAPP_ASSERT( window->pNativeWindow != NULL );
-	IMAPP_ASSERT( window->display == EGL_NO_DISPLAY );
-
-	window->display = eglGetDisplay( EGL_DEFAULT_DISPLAY );
-	eglInitialize( window->display, NULL, NULL );
+	IMAPP_ASSERT( window->surface == EGL_NO_SURFACE );
 
-	const EGLint displayAttributes[] = {
-		EGL_SURFACE_TYPE,	EGL_WINDOW_BIT,
-		EGL_BLUE_SIZE,		8,
-		EGL_GREEN_SIZE,		8,
-		EGL_RED_SIZE,		8,
-		EGL_NONE
-	};
+	if( window->display == EGL_NO_DISPLAY )
+	{
+		window->display = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+		eglInitialize( window->display, NULL, NULL );
+
+		const EGLint displayAttributes[] = {
+			EGL_SURFACE_TYPE,	EGL_WINDOW_BIT,
+			EGL_BLUE_SIZE,		8,
+			EGL_GREEN_SIZE,		8,
+			EGL_RED_SIZE,		8,
+			EGL_NONE
+		};
+
+		EGLint configCount;
+		eglChooseConfig( window->display, displayAttributes, &window->config, 1, &configCount );
+
+		const EGLint contextAttributes[] = {
+			EGL_CONTEXT_CLIENT_VERSION,	3,
+			EGL_NONE
+		};
+
+		window->context = eglCreateContext( window->display, window->config, NULL, contextAttributes );
+		if( window->context == EGL_NO_CONTEXT )
+		{
+			ImAppPlatformWindowDestroyGlContext( window );
+			return false;
+		}
 
-	EGLint configCount;
-	EGLConfig config;
-	eglChooseConfig( window->display, displayAttributes, &config, 1, &configCount );
+		window->hasDeviceChange = true;
+	}
 
 	EGLint format;
-	eglGetConfigAttrib( window->display, config, EGL_NATIVE_VISUAL_ID, &format );
+	eglGetConfigAttrib( window->display, window->config, EGL_NATIVE_VISUAL_ID, &format );
 
 	ANativeWindow_setBuffersGeometry( window->pNativeWindow, 0, 0, format );
 
-	window->surface = eglCreateWindowSurface( window->display, config, window->pNativeWindow, NULL );
-
-	const EGLint contextAttributes[] = {
-		EGL_CONTEXT_CLIENT_VERSION,	3,
-		EGL_NONE
-	};
-
-	window->context = eglCreateContext( window->display, config, NULL, contextAttributes );
+	window->surface = eglCreateWindowSurface( window->display, window->config, window->pNativeWindow, NULL );
+	if( window->surface == EGL_NO_SURFACE )
+	{
+		return false;
+	}
 
 	if( eglMakeCurrent( window->display, window->surface, window->surface, window->context ) == EGL_FALSE )
 	{
@@ -746,6 +793,19 @@ bool ImAppPlatformWindowCreateGlContext( ImAppWindow* window )
 	eglQuerySurface( window->display, window->surface, EGL_WIDTH, &window->width );
 	eglQuerySurface( window->display, window->surface, EGL_HEIGHT, &window->height );
 
+	// partial presentation, the KHR and EXT variant share the signature
+	const char* extensions = eglQueryString( window->display, EGL_EXTENSIONS );
+	window->hasBufferAge			= extensions && strstr( extensions, "EGL_EXT_buffer_age" ) != NULL;
+	window->swapBuffersWithDamage	= NULL;
+	if( extensions && strstr( extensions, "EGL_KHR_swap_buffers_with_damage" ) )
+	{
+		window->swapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress( "eglSwapBuffersWithDamageKHR" );
+	}
+	else if( extensions && strstr( extensions, "EGL_EXT_swap_buffers_with_damage" ) )
+	{
+		window->swapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress( "eglSwapBuffersWithDamageEXT" );
+	}
+
 	ImAppAndroidUpdateViewBoundsAndDpiScale( window->platform );
 
 	return true;
@@ -758,7 +818,7 @@ void ImAppPlatformWindowDestroyGlContext( ImAppWindow* window )
 		return;
 	}
 
-	eglMakeCurrent( window->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+	ImAppPlatformWindowDestroySurface( window );
 
 	if( window->context != EGL_NO_CONTEXT )
 	{
@@ -766,16 +826,33 @@ void ImAppPlatformWindowDestroyGlContext( ImAppWindow* window )
 		window->context = EGL_NO_CONTEXT;
 	}
 
-	if( window->surface != EGL_NO_SURFACE )
+	eglTerminate( window->display );
+	window->display = EGL_NO_DISPLAY;
+}
+
+static void ImAppPlatformWindowDestroySurface( ImAppWindow* window )
+{
+	if( window->surface == EGL_NO_SURFACE )
 	{
-		eglDestroySurface( window->display, window->surface );
-		window->surface = EGL_NO_SURFACE;
+		return;
 	}
 
-	eglTerminate( window->display );
-	window->display = EGL_NO_DISPLAY;
+	eglMakeCurrent( window->display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
 
-	window->pNativeWindow = NULL;
+	eglDestroySurface( window->display, window->surface );
+	window->surface = EGL_NO_SURFACE;
+}
+
+bool imappPlatformAcquireGlContext( ImAppPlatform* platform )
+{
+	// the context gets recreated with the native window, it stays on the main thread
+	IMAPP_USE( platform );
+	return false;
+}
+
+void imappPlatformReleaseGlContext( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
 }
 
 ImAppWindowDeviceState imappPlatformWindowGetGlContextState( const ImAppWindow* window )
@@ -788,6 +865,11 @@ ImAppWindowDeviceState imappPlatformWindowGetGlContextState( const ImAppWindow*
 	{
 		return ImAppWindowDeviceState_DeviceLost;
 	}
+	else if( window->surface == EGL_NO_SURFACE )
+	{
+		// in background, the context and all resources stay
+		return ImAppWindowDeviceState_NoDevice;
+	}
 	else if( window->hasDeviceChange )
 	{
 		return ImAppWindowDeviceState_NewDevice;
@@ -852,14 +934,11 @@ static void ImAppPlatformWindowHandleWindowChangedEvent( ImAppWindow* window, co
 
 	if( !window->pNativeWindow )
 	{
-		window->hasDeviceLost = true;
-		window->isOpen = false;
+		ImAppPlatformWindowDestroySurface( window );
 	}
-	else if( window->hasDeviceLost )
+	else if( window->surface == EGL_NO_SURFACE )
 	{
 		window->isOpen = ImAppPlatformWindowCreateGlContext( window );
-		window->hasDeviceLost = false;
-		window->hasDeviceChange = true;
 	}
 }
 
@@ -1021,13 +1100,31 @@ void imappPlatformWindowBeginRender( ImAppWindow* window )
 
 	if( eglMakeCurrent( window->display, window->surface, window->surface, window->context ) == EGL_FALSE )
 	{
+		ImAppPlatformWindowHandleEglError( window );
 		return false;
 	}
 
 	return true;
 }
 
-bool imappPlatformWindowEndRender( ImAppWindow* window )
+int imappPlatformWindowGetBufferAge( const ImAppWindow* window )
+{
+	if( window->display == EGL_NO_DISPLAY ||
+		!window->hasBufferAge )
+	{
+		return 0;
+	}
+
+	EGLint bufferAge = 0;
+	if( !eglQuerySurface( window->display, window->surface, EGL_BUFFER_AGE_EXT, &bufferAge ) )
+	{
+		return 0;
+	}
+
+	return bufferAge;
+}
+
+bool imappPlatformWindowEndRender( ImAppWindow* window, bool present, const ImUiRect* damageRect )
 {
 	if( window->display == EGL_NO_DISPLAY )
 	{
@@ -1036,16 +1133,93 @@ bool imappPlatformWindowEndRender( ImAppWindow* window )
 
 	if( window->hasDeviceLost )
 	{
+		// the renderer released its resources, start over with a new context
 		ImAppPlatformWindowDestroyGlContext( window );
+		window->hasDeviceLost = false;
+		if( window->pNativeWindow != NULL )
+		{
+			window->isOpen = ImAppPlatformWindowCreateGlContext( window );
+		}
+		return false;
+	}
+	else if( window->hasSurfaceLost )
+	{
+		ImAppPlatformWindowRecreateLostSurface( window );
 		return false;
 	}
 
 	window->hasDeviceChange = false;
 
-	eglSwapBuffers( window->display, window->surface );
+	if( !present )
+	{
+		return true;
+	}
+
+	if( damageRect && window->swapBuffersWithDamage )
+	{
+		// EGL rects start bottom left
+		EGLint rect[ 4u ];
+		rect[ 0u ] = (EGLint)damageRect->pos.x;
+		rect[ 1u ] = (EGLint)(window->height - (damageRect->pos.y + damageRect->size.height));
+		rect[ 2u ] = (EGLint)damageRect->size.width;
+		rect[ 3u ] = (EGLint)damageRect->size.height;
+
+		if( window->swapBuffersWithDamage( window->display, window->surface, rect, 1 ) == EGL_FALSE )
+		{
+			ImAppPlatformWindowHandleEglError( window );
+			ImAppPlatformWindowRecreateLostSurface( window );
+			return false;
+		}
+		return true;
+	}
+
+	if( eglSwapBuffers( window->display, window->surface ) == EGL_FALSE )
+	{
+		ImAppPlatformWindowHandleEglError( window );
+		ImAppPlatformWindowRecreateLostSurface( window );
+		return false;
+	}
 	return true;
 }
 
+static void ImAppPlatformWindowHandleEglError( ImAppWindow* window )
+{
+	const EGLint error = eglGetError();
+	if( error == EGL_CONTEXT_LOST )
+	{
+		window->hasDeviceLost = true;
+	}
+	else if( error == EGL_BAD_SURFACE ||
+			 error == EGL_BAD_NATIVE_WINDOW ||
+			 error == EGL_BAD_CURRENT_SURFACE )
+	{
+		window->hasSurfaceLost = true;
+	}
+}
+
+static void ImAppPlatformWindowRecreateLostSurface( ImAppWindow* window )
+{
+	if( !window->hasSurfaceLost )
+	{
+		return;
+	}
+
+	// the context and all resources stay, the next frame draws everything into the new surface
+	ImAppPlatformWindowDestroySurface( window );
+	window->hasSurfaceLost = false;
+	if( window->pNativeWindow != NULL )
+	{
+		window->isOpen = ImAppPlatformWindowCreateGlContext( window );
+	}
+}
+
+void imappPlatformWindowSetVSync( ImAppWindow* window, bool wait )
+{
+	// there is only one window, it always waits
+	IMAPP_USE( window );
+	IMAPP_USE( wait );
+}
+
 ImAppEventQueue* imappPlatformWindowGetEventQueue( ImAppWindow* window )
 {
 	return &window->eventQueue;
@@ -1075,6 +1249,11 @@ bool imappPlatformWindowHasFocus( const ImAppWindow* window )
     return true;
 }
 
+bool imappPlatformWindowIsHidden( const ImAppWindow* window )
+{
+    return false;
+}
+
 void imappPlatformWindowGetSize( const ImAppWindow* window, int* pWidth, int* pHeight )
 {
 	*pWidth		= window->width;
@@ -1284,6 +1463,18 @@ void imappPlatformResourceFree( ImAppPlatform* platform, ImAppBlob blob )
 	ImUiMemoryFree( platform->allocator, blob.data );
 }
 
+bool imappPlatformGetCachePath( ImAppPlatform* platform, char* outPath, uintsize pathCapacity, const char* fileName )
+{
+	const char* dataPath = platform->pActivity->internalDataPath;
+	if( !dataPath )
+	{
+		return false;
+	}
+
+	const int length = snprintf( outPath, pathCapacity, "%s/%s", dataPath, fileName );
+	return length >= 0 && (uintsize)length < pathCapacity;
+}
+
 ImAppFileWatcher* imappPlatformFileWatcherCreate( ImAppPlatform* platform )
 {
 	return NULL;
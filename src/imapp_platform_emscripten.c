@@ -79,6 +79,17 @@ sint64 imappPlatformTick( ImAppPlatform* platform, sint64 lastTickValue, sint64
 	return 1;
 }
 
+void imappPlatformWakeUp( ImAppPlatform* platform )
+{
+	// the browser calls the main loop every frame
+	IMAPP_USE( platform );
+}
+
+sint64 imappPlatformGetTickValue( ImAppPlatform* platform )
+{
+	return 1;
+}
+
 void imappPlatformShowError( ImAppPlatform* platform, const char* message )
 {
 	EM_ASM( {
@@ -266,6 +277,18 @@ void ImAppPlatformWindowDestroyGlContext( ImAppWindow* window )
 	window->eglDisplay = EGL_NO_DISPLAY;
 }
 
+bool imappPlatformAcquireGlContext( ImAppPlatform* platform )
+{
+	// WebGL contexts belong to the browser thread
+	IMAPP_USE( platform );
+	return false;
+}
+
+void imappPlatformReleaseGlContext( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+}
+
 ImAppWindowDeviceState imappPlatformWindowGetGlContextState( const ImAppWindow* window )
 {
 	if( window->eglContext == EGL_NO_CONTEXT )
@@ -296,6 +319,13 @@ bool ImAppPlatformWindowPresent( ImAppWindow* window )
 	return true;
 }
 
+void imappPlatformWindowSetVSync( ImAppWindow* window, bool wait )
+{
+	// the browser paces the frames
+	IMAPP_USE( window );
+	IMAPP_USE( wait );
+}
+
 ImAppEventQueue* imappPlatformWindowGetEventQueue( ImAppWindow* window )
 {
 	return &window->eventQueue;
@@ -322,6 +352,11 @@ bool imappPlatformWindowHasFocus( const ImAppWindow* window )
 	return true;
 }
 
+bool imappPlatformWindowIsHidden( const ImAppWindow* window )
+{
+	return false;
+}
+
 void imappPlatformWindowGetSize( const ImAppWindow* window, int* outWidth, int* outHeight )
 {
 	*outWidth	= window->width;
@@ -430,6 +465,12 @@ void imappPlatformResourceFree( ImAppPlatform* platform, ImAppBlob blob )
 	// TODO
 }
 
+bool imappPlatformGetCachePath( ImAppPlatform* platform, char* outPath, uintsize pathCapacity, const char* fileName )
+{
+	// no persistent file system
+	return false;
+}
+
 ImAppFileWatcher* imappPlatformFileWatcherCreate( ImAppPlatform* platform )
 {
 	return NULL;
@@ -0,0 +1,1087 @@
+#include "imapp_platform.h"
+
+#if IMAPP_ENABLED( IMAPP_PLATFORM_HEADLESS )
+
+#include "imapp/imapp_headless.h"
+
+#include "imapp_debug.h"
+#include "imapp_event_queue.h"
+#include "imapp_internal.h"
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+#	include <EGL/egl.h>
+#	include <EGL/eglext.h>
+#	include <GLES3/gl3.h>
+#endif
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL ) && !defined( EGL_PLATFORM_SURFACELESS_MESA )
+#	define EGL_PLATFORM_SURFACELESS_MESA	0x31DD
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Main
+
+struct ImAppPlatform
+{
+	ImUiAllocator*		allocator;
+
+	char*				resourceBasePath;
+	uintsize			resourceBasePathLength;
+
+	char*				clipboardText;
+	uintsize			clipboardTextCapacity;
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	EGLDisplay			eglDisplay;
+	EGLConfig			eglConfig;
+	EGLContext			eglContext;
+	EGLSurface			eglSurface;		// 1x1 pbuffer to keep the context current without a window
+#endif
+};
+
+#include "imapp_platform_posix.h"
+#include "imapp_platform_pthread.h"
+
+typedef struct ImAppWindowDrop ImAppWindowDrop;
+typedef struct ImAppWindowDrop
+{
+	ImAppWindowDrop*	nextDrop;
+
+	ImAppDropType		type;
+	char				pathOrText[ 1u ];
+} ImAppWindowDrop;
+
+struct ImAppWindow
+{
+	ImAppPlatform*		platform;
+	ImAppEventQueue		eventQueue;
+
+	ImAppWindowDrop*	firstNewDrop;
+	ImAppWindowDrop*	firstPoppedDrop;
+
+#if IMAPP_DISABLED( IMAPP_RENDERER_OPENGL )
+	const uint32_t*		pixels;			// BGRA8 frame of the software or offscreen Vulkan renderer, owned by the renderer
+#else
+	EGLSurface			eglSurface;
+#endif
+	int					surfaceWidth;
+	int					surfaceHeight;
+	bool				hasContent;		// the pbuffer keeps the last presented frame
+	uint64_t			frameCount;
+
+	int					x;
+	int					y;
+	int					width;
+	int					height;
+	ImAppWindowState	state;
+	ImAppWindowStyle	style;
+	char*				title;
+	uintsize			titleCapacity;
+};
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+static bool				imappPlatformCreateDisplay( ImAppPlatform* platform );
+static EGLSurface		imappPlatformCreatePbuffer( ImAppPlatform* platform, int width, int height );
+#endif
+static bool				imappPlatformSetResourcePath( ImAppPlatform* platform, const char* resourcePath );
+static bool				imappPlatformWindowPushDrop( ImAppWindow* window, ImAppDropType type, const char* pathOrText );
+
+int main( int argc, char* argv[] )
+{
+	ImAppPlatform platform = { 0 };
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	platform.eglDisplay	= EGL_NO_DISPLAY;
+	platform.eglContext	= EGL_NO_CONTEXT;
+	platform.eglSurface	= EGL_NO_SURFACE;
+#endif
+
+	const int result = imappMain( &platform, argc, argv );
+
+	return result;
+}
+
+bool imappPlatformInitialize( ImAppPlatform* platform, ImUiAllocator* allocator, const char* resourcePath )
+{
+	platform->allocator = allocator;
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	if( !imappPlatformCreateDisplay( platform ) )
+	{
+		return false;
+	}
+#endif
+
+	return imappPlatformSetResourcePath( platform, resourcePath );
+}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+static bool imappPlatformCreateDisplay( ImAppPlatform* platform )
+{
+	// surfaceless needs neither a compositor nor a GPU, Mesa falls back to llvmpipe
+	const char* clientExtensions = eglQueryString( EGL_NO_DISPLAY, EGL_EXTENSIONS );
+	if( clientExtensions && strstr( clientExtensions, "EGL_MESA_platform_surfaceless" ) )
+	{
+		PFNEGLGETPLATFORMDISPLAYEXTPROC eglGetPlatformDisplayEXT = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+		if( eglGetPlatformDisplayEXT )
+		{
+			platform->eglDisplay = eglGetPlatformDisplayEXT( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL );
+		}
+	}
+
+	if( platform->eglDisplay == EGL_NO_DISPLAY )
+	{
+		platform->eglDisplay = eglGetDisplay( EGL_DEFAULT_DISPLAY );
+	}
+
+	if( platform->eglDisplay == EGL_NO_DISPLAY )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to get EGL display." );
+		return false;
+	}
+
+	EGLint major;
+	EGLint minor;
+	if( eglInitialize( platform->eglDisplay, &major, &minor ) != EGL_TRUE )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to initialize EGL." );
+		platform->eglDisplay = EGL_NO_DISPLAY;
+		return false;
+	}
+
+	if( eglBindAPI( EGL_OPENGL_ES_API ) != EGL_TRUE )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to bind OpenGL ES." );
+		return false;
+	}
+
+	const EGLint configAttributes[] =
+	{
+		EGL_SURFACE_TYPE,		EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE,	EGL_OPENGL_ES3_BIT_KHR,
+		EGL_RED_SIZE,			8,
+		EGL_GREEN_SIZE,			8,
+		EGL_BLUE_SIZE,			8,
+		EGL_ALPHA_SIZE,			8,
+		EGL_NONE
+	};
+
+	EGLint configCount = 0;
+	if( !eglChooseConfig( platform->eglDisplay, configAttributes, &platform->eglConfig, 1, &configCount ) ||
+		configCount == 0 )
+	{
+		IMAPP_DEBUG_LOGE( "No EGL config with pbuffer and OpenGL ES 3 support." );
+		return false;
+	}
+
+	// all windows share one context, only the pbuffer changes
+	const EGLint contextAttributes[] = { EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE };
+	platform->eglContext = eglCreateContext( platform->eglDisplay, platform->eglConfig, EGL_NO_CONTEXT, contextAttributes );
+	if( platform->eglContext == EGL_NO_CONTEXT )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to create GL context." );
+		return false;
+	}
+
+	platform->eglSurface = imappPlatformCreatePbuffer( platform, 1, 1 );
+	if( platform->eglSurface == EGL_NO_SURFACE )
+	{
+		return false;
+	}
+
+	if( eglMakeCurrent( platform->eglDisplay, platform->eglSurface, platform->eglSurface, platform->eglContext ) != EGL_TRUE )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to activate GL context." );
+		return false;
+	}
+
+	return true;
+}
+#endif
+
+static bool imappPlatformSetResourcePath( ImAppPlatform* platform, const char* resourcePath )
+{
+	const bool isRelativePath		= strstr( resourcePath, "./" ) == resourcePath;
+	const uintsize sourceLength		= strlen( resourcePath );
+	const bool needsSeperatorEnd	= sourceLength == 0u || resourcePath[ sourceLength - 1u ] != '/';
+
+	char exePath[ PATH_MAX ];
+	uintsize exeDirLength = 0u;
+	if( isRelativePath )
+	{
+		const ssize_t exeLinkResult = readlink( "/proc/self/exe", exePath, sizeof( exePath ) - 1u );
+		if( exeLinkResult < 0 )
+		{
+			return false;
+		}
+		exePath[ exeLinkResult ] = '\0';
+
+		const char* exeDirEnd = strrchr( exePath, '/' );
+		exeDirLength = exeDirEnd ? (uintsize)(exeDirEnd - exePath) + 1u : 0u;
+
+		resourcePath += 2u;
+	}
+
+	const uintsize pathLength = exeDirLength + strlen( resourcePath ) + (needsSeperatorEnd ? 1u : 0u);
+	platform->resourceBasePath = (char*)ImUiMemoryAlloc( platform->allocator, pathLength + 1u );
+	if( !platform->resourceBasePath )
+	{
+		return false;
+	}
+
+	memcpy( platform->resourceBasePath, exePath, exeDirLength );
+	strcpy( platform->resourceBasePath + exeDirLength, resourcePath );
+	if( needsSeperatorEnd )
+	{
+		platform->resourceBasePath[ pathLength - 1u ] = '/';
+		platform->resourceBasePath[ pathLength ] = '\0';
+	}
+	platform->resourceBasePathLength = pathLength;
+
+	return true;
+}
+
+void imappPlatformShutdown( ImAppPlatform* platform )
+{
+	ImUiMemoryFree( platform->allocator, platform->resourceBasePath );
+	platform->resourceBasePath = NULL;
+	platform->resourceBasePathLength = 0;
+
+	IMUI_MEMORY_ARRAY_FREE( platform->allocator, platform->clipboardText, platform->clipboardTextCapacity );
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	if( platform->eglDisplay != EGL_NO_DISPLAY )
+	{
+		eglMakeCurrent( platform->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+
+		if( platform->eglSurface != EGL_NO_SURFACE )
+		{
+			eglDestroySurface( platform->eglDisplay, platform->eglSurface );
+			platform->eglSurface = EGL_NO_SURFACE;
+		}
+
+		if( platform->eglContext != EGL_NO_CONTEXT )
+		{
+			eglDestroyContext( platform->eglDisplay, platform->eglContext );
+			platform->eglContext = EGL_NO_CONTEXT;
+		}
+
+		eglTerminate( platform->eglDisplay );
+		platform->eglDisplay = EGL_NO_DISPLAY;
+	}
+#endif
+
+	platform->allocator = NULL;
+}
+
+sint64 imappPlatformTick( ImAppPlatform* platform, sint64 lastTickValue, sint64 tickIntervalMs )
+{
+	IMAPP_USE( platform );
+
+	struct timespec timeSpec;
+	clock_gettime( CLOCK_MONOTONIC, &timeSpec );
+
+	sint64 currentTick		= ((sint64)timeSpec.tv_sec * 1000000000) + timeSpec.tv_nsec;
+	const sint64 deltaTicks	= currentTick - lastTickValue;
+	const sint64 timeToWait	= IMUI_MAX( tickIntervalMs * 1000000, deltaTicks ) - deltaTicks;
+
+	// no input can arrive from outside, so an event driven loop runs as fast as it can
+	if( tickIntervalMs > 0 && timeToWait > 1000 )
+	{
+		const struct timespec sleepSpec = { (time_t)(timeToWait / 1000000000), (long)(timeToWait % 1000000000) };
+		nanosleep( &sleepSpec, NULL );
+
+		clock_gettime( CLOCK_MONOTONIC, &timeSpec );
+		currentTick = ((sint64)timeSpec.tv_sec * 1000000000) + timeSpec.tv_nsec;
+	}
+
+	return currentTick;
+}
+
+void imappPlatformWakeUp( ImAppPlatform* platform )
+{
+	// ticks never wait for events
+	IMAPP_USE( platform );
+}
+
+void imappPlatformWaitForVSync( ImAppPlatform* platform )
+{
+	// pbuffers are never synchronized to a display
+	IMAPP_USE( platform );
+}
+
+double imappPlatformTicksToSeconds( ImAppPlatform* platform, sint64 tickValue )
+{
+	IMAPP_USE( platform );
+
+	return (double)tickValue / 1000000000.0;
+}
+
+sint64 imappPlatformGetTickValue( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+
+	struct timespec timeSpec;
+	clock_gettime( CLOCK_MONOTONIC, &timeSpec );
+
+	return ((sint64)timeSpec.tv_sec * 1000000000) + timeSpec.tv_nsec;
+}
+
+void imappPlatformShowError( ImAppPlatform* platform, const char* message )
+{
+	IMAPP_USE( platform );
+
+	fprintf( stderr, "Error: %s\n", message );
+}
+
+void imappPlatformSetMouseCursor( ImAppPlatform* platform, ImUiInputMouseCursor cursor )
+{
+	IMAPP_USE( platform );
+	IMAPP_USE( cursor );
+}
+
+void imappPlatformSetClipboardText( ImAppPlatform* platform, const char* text )
+{
+	// process local clipboard, tests must not touch the one of the session
+	const uintsize textLength = strlen( text ) + 1u;
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( platform->allocator, platform->clipboardText, platform->clipboardTextCapacity, textLength ) )
+	{
+		IMAPP_DEBUG_LOGW( "Failed to allocate Clipboard memory." );
+		return;
+	}
+
+	memcpy( platform->clipboardText, text, textLength );
+}
+
+void imappPlatformGetClipboardText( ImAppPlatform* platform, ImUiContext* imui )
+{
+	if( !platform->clipboardText )
+	{
+		return;
+	}
+
+	const uintsize textLength = strlen( platform->clipboardText );
+
+	char* text = ImUiInputBeginWritePasteText( imui, textLength );
+	if( !text )
+	{
+		return;
+	}
+
+	memcpy( text, platform->clipboardText, textLength );
+
+	ImUiInputEndWritePasteText( imui, textLength );
+}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+static EGLSurface imappPlatformCreatePbuffer( ImAppPlatform* platform, int width, int height )
+{
+	const EGLint surfaceAttributes[] =
+	{
+		EGL_WIDTH,	IMUI_MAX( width, 1 ),
+		EGL_HEIGHT,	IMUI_MAX( height, 1 ),
+		EGL_NONE
+	};
+
+	const EGLSurface surface = eglCreatePbufferSurface( platform->eglDisplay, platform->eglConfig, surfaceAttributes );
+	if( surface == EGL_NO_SURFACE )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to create %dx%d pbuffer. Error: 0x%04x", width, height, eglGetError() );
+	}
+
+	return surface;
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Window
+
+ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const ImAppWindowParameters* parameters )
+{
+	ImAppWindow* window = IMUI_MEMORY_NEW_ZERO( platform->allocator, ImAppWindow );
+	if( window == NULL )
+	{
+		return NULL;
+	}
+
+	window->platform	= platform;
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	window->eglSurface	= EGL_NO_SURFACE;
+#endif
+	window->x			= parameters->x == IMAPP_WINDOW_DEFAULT_POSITION ? 0 : parameters->x;
+	window->y			= parameters->y == IMAPP_WINDOW_DEFAULT_POSITION ? 0 : parameters->y;
+	window->width		= IMUI_MAX( parameters->width, 1 );
+	window->height		= IMUI_MAX( parameters->height, 1 );
+	window->state		= parameters->state;
+	window->style		= parameters->style;
+
+	imappEventQueueConstruct( &window->eventQueue, platform->allocator );
+
+	const uintsize windowTitleLength = strlen( parameters->title ) + 1u;
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( platform->allocator, window->title, window->titleCapacity, windowTitleLength ) )
+	{
+		IMAPP_DEBUG_LOGE( "Can't allocate title." );
+		imappPlatformWindowDestroy( window );
+		return NULL;
+	}
+
+	memcpy( window->title, parameters->title, windowTitleLength );
+
+	return window;
+}
+
+void imappPlatformWindowDestroy( ImAppWindow* window )
+{
+	ImAppPlatform* platform = window->platform;
+
+	while( window->firstNewDrop )
+	{
+		ImAppWindowDrop* drop = window->firstNewDrop;
+		window->firstNewDrop = drop->nextDrop;
+
+		ImUiMemoryFree( platform->allocator, drop );
+	}
+
+	while( window->firstPoppedDrop )
+	{
+		ImAppWindowDrop* drop = window->firstPoppedDrop;
+		window->firstPoppedDrop = drop->nextDrop;
+
+		ImUiMemoryFree( platform->allocator, drop );
+	}
+
+	imappEventQueueDestruct( &window->eventQueue );
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	if( window->eglSurface != EGL_NO_SURFACE )
+	{
+		if( eglGetCurrentSurface( EGL_DRAW ) == window->eglSurface )
+		{
+			eglMakeCurrent( platform->eglDisplay, platform->eglSurface, platform->eglSurface, platform->eglContext );
+		}
+
+		eglDestroySurface( platform->eglDisplay, window->eglSurface );
+		window->eglSurface = EGL_NO_SURFACE;
+	}
+#endif
+
+	if( window->title )
+	{
+		ImUiMemoryFree( platform->allocator, window->title );
+		window->title = NULL;
+	}
+
+	ImUiMemoryFree( platform->allocator, window );
+}
+
+bool imappPlatformAcquireGlContext( ImAppPlatform* platform )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	return eglMakeCurrent( platform->eglDisplay, platform->eglSurface, platform->eglSurface, platform->eglContext ) == EGL_TRUE;
+#else
+	IMAPP_USE( platform );
+	return false;
+#endif
+}
+
+void imappPlatformReleaseGlContext( ImAppPlatform* platform )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	eglMakeCurrent( platform->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+#else
+	IMAPP_USE( platform );
+#endif
+}
+
+ImAppWindowDeviceState imappPlatformWindowGetGlContextState( const ImAppWindow* window )
+{
+	IMAPP_USE( window );
+	return ImAppWindowDeviceState_Ok;
+}
+
+void imappPlatformWindowUpdate( ImAppWindow* window, ImAppPlatformWindowUpdateCallback callback, void* arg )
+{
+	IMAPP_USE( callback );
+	IMAPP_USE( arg );
+
+	while( window->firstPoppedDrop )
+	{
+		ImAppWindowDrop* drop = window->firstPoppedDrop;
+		window->firstPoppedDrop = drop->nextDrop;
+
+		ImUiMemoryFree( window->platform->allocator, drop );
+	}
+}
+
+bool imappPlatformWindowBeginRender( ImAppWindow* window )
+{
+#if IMAPP_DISABLED( IMAPP_RENDERER_OPENGL )
+	// the renderer draws into its own memory
+	IMAPP_USE( window );
+	return true;
+#else
+	ImAppPlatform* platform = window->platform;
+
+	if( window->eglSurface != EGL_NO_SURFACE &&
+		(window->surfaceWidth != window->width || window->surfaceHeight != window->height) )
+	{
+		eglMakeCurrent( platform->eglDisplay, platform->eglSurface, platform->eglSurface, platform->eglContext );
+		eglDestroySurface( platform->eglDisplay, window->eglSurface );
+		window->eglSurface = EGL_NO_SURFACE;
+	}
+
+	if( window->eglSurface == EGL_NO_SURFACE )
+	{
+		window->eglSurface = imappPlatformCreatePbuffer( platform, window->width, window->height );
+		if( window->eglSurface == EGL_NO_SURFACE )
+		{
+			return false;
+		}
+
+		window->surfaceWidth	= window->width;
+		window->surfaceHeight	= window->height;
+		window->hasContent		= false;
+	}
+
+	if( eglMakeCurrent( platform->eglDisplay, window->eglSurface, window->eglSurface, platform->eglContext ) != EGL_TRUE )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to activate GL context." );
+		return false;
+	}
+
+	return true;
+#endif
+}
+
+int imappPlatformWindowGetBufferAge( const ImAppWindow* window )
+{
+	// single buffered, the pbuffer still holds the last frame
+	return window->hasContent ? 1 : 0;
+}
+
+void imappPlatformWindowSetPixels( ImAppWindow* window, const uint32_t* pixels, int width, int height )
+{
+#if IMAPP_DISABLED( IMAPP_RENDERER_OPENGL )
+	window->pixels			= pixels;
+	window->surfaceWidth	= width;
+	window->surfaceHeight	= height;
+#else
+	IMAPP_USE( window );
+	IMAPP_USE( pixels );
+	IMAPP_USE( width );
+	IMAPP_USE( height );
+#endif
+}
+
+bool imappPlatformWindowEndRender( ImAppWindow* window, bool present, const ImUiRect* damageRect )
+{
+	IMAPP_USE( damageRect );
+
+	if( !present )
+	{
+		return true;
+	}
+
+#if IMAPP_DISABLED( IMAPP_RENDERER_OPENGL )
+	if( window->pixels == NULL )
+	{
+		return false;
+	}
+#else
+	// nothing paces the frames, wait for the GPU so frame times include the rendering
+	glFinish();
+#endif
+
+	window->hasContent = true;
+	window->frameCount++;
+
+	return true;
+}
+
+void imappPlatformWindowSetVSync( ImAppWindow* window, bool wait )
+{
+	// pbuffers are never synchronized to a display
+	IMAPP_USE( window );
+	IMAPP_USE( wait );
+}
+
+ImAppEventQueue* imappPlatformWindowGetEventQueue( ImAppWindow* window )
+{
+	return &window->eventQueue;
+}
+
+bool imappPlatformWindowPopDropData( ImAppWindow* window, ImAppDropData* outData )
+{
+	if( !window->firstNewDrop )
+	{
+		return false;
+	}
+
+	ImAppWindowDrop* drop = window->firstNewDrop;
+	outData->type		= drop->type;
+	outData->pathOrText	= drop->pathOrText;
+
+	window->firstNewDrop = drop->nextDrop;
+
+	drop->nextDrop = window->firstPoppedDrop;
+	window->firstPoppedDrop = drop;
+
+	return true;
+}
+
+void imappPlatformWindowGetViewRect( const ImAppWindow* window, int* outX, int* outY, int* outWidth, int* outHeight )
+{
+	*outX = 0;
+	*outY = 0;
+
+	imappPlatformWindowGetSize( window, outWidth, outHeight );
+}
+
+bool imappPlatformWindowHasFocus( const ImAppWindow* window )
+{
+	IMAPP_USE( window );
+	return true;
+}
+
+bool imappPlatformWindowIsHidden( const ImAppWindow* window )
+{
+	IMAPP_USE( window );
+	return false;
+}
+
+void imappPlatformWindowGetSize( const ImAppWindow* window, int* outWidth, int* outHeight )
+{
+	*outWidth	= window->width;
+	*outHeight	= window->height;
+}
+
+void imappPlatformWindowSetSize( ImAppWindow* window, int width, int height )
+{
+	// the pbuffer gets recreated with the next frame
+	window->width	= IMUI_MAX( width, 1 );
+	window->height	= IMUI_MAX( height, 1 );
+}
+
+void imappPlatformWindowGetPosition( const ImAppWindow* window, int* outX, int* outY )
+{
+	*outX = window->x;
+	*outY = window->y;
+}
+
+void imappPlatformWindowSetPosition( const ImAppWindow* window, int x, int y )
+{
+	ImAppWindow* mutableWindow = (ImAppWindow*)window;
+	mutableWindow->x = x;
+	mutableWindow->y = y;
+}
+
+ImAppWindowStyle imappPlatformWindowGetStyle( const ImAppWindow* window )
+{
+	return window->style;
+}
+
+ImAppWindowState imappPlatformWindowGetState( const ImAppWindow* window )
+{
+	return window->state;
+}
+
+void imappPlatformWindowSetState( ImAppWindow* window, ImAppWindowState state )
+{
+	window->state = state;
+}
+
+const char* imappPlatformWindowGetTitle( const ImAppWindow* window )
+{
+	return window->title;
+}
+
+void imappPlatformWindowSetTitle( ImAppWindow* window, const char* title )
+{
+	const uintsize windowTitleLength = strlen( title ) + 1u;
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( window->platform->allocator, window->title, window->titleCapacity, windowTitleLength ) )
+	{
+		IMAPP_DEBUG_LOGE( "Can't allocate title." );
+		return;
+	}
+
+	memcpy( window->title, title, windowTitleLength );
+}
+
+void imappPlatformWindowSetTitleBounds( ImAppWindow* window, int height, int buttonsX )
+{
+	IMAPP_USE( window );
+	IMAPP_USE( height );
+	IMAPP_USE( buttonsX );
+}
+
+float imappPlatformWindowGetDpiScale( const ImAppWindow* window )
+{
+	IMAPP_USE( window );
+
+	// fixed, so images don't depend on the machine
+	return 1.0f;
+}
+
+void imappPlatformWindowClose( ImAppWindow* window )
+{
+	ImAppHeadlessWindowPushClose( window );
+}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_VULKAN )
+const char* const* imappPlatformGetVulkanInstanceExtensions( ImAppPlatform* platform, uint32_t* outCount )
+{
+	// no window system, the renderer draws offscreen and reads back into the window pixels
+	IMAPP_USE( platform );
+
+	*outCount = 0u;
+	return NULL;
+}
+
+bool imappPlatformWindowCreateVulkanSurface( ImAppWindow* window, VkInstance instance, VkSurfaceKHR* outSurface )
+{
+	IMAPP_USE( window );
+	IMAPP_USE( instance );
+
+	*outSurface = VK_NULL_HANDLE;
+	return false;
+}
+#endif
+
+static bool imappPlatformWindowPushDrop( ImAppWindow* window, ImAppDropType type, const char* pathOrText )
+{
+	const uintsize length = strlen( pathOrText );
+
+	ImAppWindowDrop* drop = (ImAppWindowDrop*)ImUiMemoryAlloc( window->platform->allocator, sizeof( ImAppWindowDrop ) + length );
+	if( !drop )
+	{
+		return false;
+	}
+
+	drop->type = type;
+	memcpy( drop->pathOrText, pathOrText, length + 1u );
+
+	// keep the push order
+	ImAppWindowDrop** lastDrop = &window->firstNewDrop;
+	while( *lastDrop )
+	{
+		lastDrop = &(*lastDrop)->nextDrop;
+	}
+
+	drop->nextDrop	= NULL;
+	*lastDrop		= drop;
+
+	return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Headless
+
+void ImAppHeadlessWindowPushKey( ImAppWindow* window, ImUiInputKey key, bool down )
+{
+	const ImAppEvent keyEvent = { .key = { .type = down ? ImAppEventType_KeyDown : ImAppEventType_KeyUp, .key = key, .repeat = false } };
+	imappEventQueuePush( &window->eventQueue, &keyEvent );
+}
+
+void ImAppHeadlessWindowPushCharacter( ImAppWindow* window, uint32_t character )
+{
+	const ImAppEvent characterEvent = { .character = { .type = ImAppEventType_Character, .character = character } };
+	imappEventQueuePush( &window->eventQueue, &characterEvent );
+}
+
+void ImAppHeadlessWindowPushMouseMove( ImAppWindow* window, int x, int y )
+{
+	const ImAppEvent motionEvent = { .motion = { .type = ImAppEventType_Motion, .x = x, .y = y } };
+	imappEventQueuePush( &window->eventQueue, &motionEvent );
+}
+
+void ImAppHeadlessWindowPushMouseButton( ImAppWindow* window, ImUiInputMouseButton button, bool down )
+{
+	const ImAppEvent buttonEvent = { .button = { .type = down ? ImAppEventType_ButtonDown : ImAppEventType_ButtonUp, .button = button, .repeateCount = 1u } };
+	imappEventQueuePush( &window->eventQueue, &buttonEvent );
+}
+
+void ImAppHeadlessWindowPushMouseScroll( ImAppWindow* window, int x, int y )
+{
+	const ImAppEvent scrollEvent = { .scroll = { .type = ImAppEventType_Scroll, .x = x, .y = y } };
+	imappEventQueuePush( &window->eventQueue, &scrollEvent );
+}
+
+void ImAppHeadlessWindowPushDrop( ImAppWindow* window, ImAppDropType type, const char* pathOrText )
+{
+	if( !imappPlatformWindowPushDrop( window, type, pathOrText ) )
+	{
+		IMAPP_DEBUG_LOGW( "Failed to allocate drop." );
+	}
+}
+
+void ImAppHeadlessWindowPushClose( ImAppWindow* window )
+{
+	const ImAppEvent closeEvent = { .window = { .type = ImAppEventType_WindowClose } };
+	imappEventQueuePush( &window->eventQueue, &closeEvent );
+}
+
+uint64_t ImAppHeadlessWindowGetFrameCount( const ImAppWindow* window )
+{
+	return window->frameCount;
+}
+
+bool ImAppHeadlessWindowReadPixels( ImAppWindow* window, void* outPixels, size_t pixelsSize )
+{
+	const uintsize rowSize = (uintsize)window->surfaceWidth * 4u;
+	if( !window->hasContent ||
+		pixelsSize < rowSize * (uintsize)window->surfaceHeight )
+	{
+		return false;
+	}
+
+#if IMAPP_DISABLED( IMAPP_RENDERER_OPENGL )
+	// BGRA8 to RGBA8, the renderer already stores top down
+	const uintsize pixelCount = (uintsize)window->surfaceWidth * (uintsize)window->surfaceHeight;
+	uint8_t* targetPixels = (uint8_t*)outPixels;
+	for( uintsize i = 0u; i < pixelCount; ++i )
+	{
+		const uint32_t pixel = window->pixels[ i ];
+		targetPixels[ (i * 4u) + 0u ] = (uint8_t)(pixel >> 16u);
+		targetPixels[ (i * 4u) + 1u ] = (uint8_t)(pixel >> 8u);
+		targetPixels[ (i * 4u) + 2u ] = (uint8_t)pixel;
+		targetPixels[ (i * 4u) + 3u ] = (uint8_t)(pixel >> 24u);
+	}
+
+	return true;
+#else
+	ImAppPlatform* platform = window->platform;
+
+	// the render thread owns the context while it runs
+	if( eglGetCurrentContext() != platform->eglContext )
+	{
+		return false;
+	}
+
+	// can be called while an other window renders
+	const EGLSurface currentSurface = eglGetCurrentSurface( EGL_DRAW );
+	if( currentSurface != window->eglSurface &&
+		eglMakeCurrent( platform->eglDisplay, window->eglSurface, window->eglSurface, platform->eglContext ) != EGL_TRUE )
+	{
+		return false;
+	}
+
+	glBindFramebuffer( GL_READ_FRAMEBUFFER, 0 );
+	glPixelStorei( GL_PACK_ALIGNMENT, 1 );
+	glReadPixels( 0, 0, window->surfaceWidth, window->surfaceHeight, GL_RGBA, GL_UNSIGNED_BYTE, outPixels );
+
+	if( currentSurface != window->eglSurface )
+	{
+		const EGLSurface restoreSurface = currentSurface != EGL_NO_SURFACE ? currentSurface : platform->eglSurface;
+		eglMakeCurrent( platform->eglDisplay, restoreSurface, restoreSurface, platform->eglContext );
+	}
+
+	// GL reads bottom up
+	uint8_t* pixels = (uint8_t*)outPixels;
+	for( uintsize top = 0u, bottom = (uintsize)window->surfaceHeight - 1u; top < bottom; ++top, --bottom )
+	{
+		uint8_t* topRow		= pixels + (top * rowSize);
+		uint8_t* bottomRow	= pixels + (bottom * rowSize);
+		for( uintsize i = 0u; i < rowSize; ++i )
+		{
+			const uint8_t pixel = topRow[ i ];
+			topRow[ i ]		= bottomRow[ i ];
+			bottomRow[ i ]	= pixel;
+		}
+	}
+
+	return true;
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Files/Resources
+
+void imappPlatformResourceGetPath( ImAppPlatform* platform, char* outPath, uintsize pathCapacity, const char* resourceName )
+{
+	const size_t resourceNameLength = strlen( resourceName );
+	if( platform->resourceBasePathLength + resourceNameLength >= pathCapacity )
+	{
+		ImAppTrace( "Error: Resource path buffer too small!\n" );
+		return;
+	}
+	memcpy( outPath, platform->resourceBasePath, platform->resourceBasePathLength );
+	memcpy( outPath + platform->resourceBasePathLength, resourceName, resourceNameLength );
+	outPath[ platform->resourceBasePathLength + resourceNameLength ] = '\0';
+}
+
+ImAppBlob imappPlatformResourceLoad( ImAppPlatform* platform, const char* resourceName )
+{
+	return imappPlatformResourceLoadRange( platform, resourceName, 0u, (uintsize)-1 );
+}
+
+ImAppBlob imappPlatformResourceLoadRange( ImAppPlatform* platform, const char* resourceName, uintsize offset, uintsize length )
+{
+	ImAppBlob result = { NULL, 0u };
+
+	ImAppFile* file = imappPlatformResourceOpen( platform, resourceName );
+	if( !file )
+	{
+		return result;
+	}
+
+	if( length == (uintsize)-1 )
+	{
+		struct stat fileStats;
+		if( fstat( fileno( (FILE*)file ), &fileStats ) != 0 )
+		{
+			imappPlatformResourceClose( platform, file );
+			return result;
+		}
+
+		length = (uintsize)fileStats.st_size - offset;
+		if( length > (uintsize)fileStats.st_size )
+		{
+			length = 0;
+		}
+	}
+
+	void* memory = ImUiMemoryAlloc( platform->allocator, length );
+	if( !memory )
+	{
+		imappPlatformResourceClose( platform, file );
+		return result;
+	}
+
+	const uintsize readResult = imappPlatformResourceRead( file, memory, length, offset );
+	imappPlatformResourceClose( platform, file );
+
+	if( readResult != length )
+	{
+		ImUiMemoryFree( platform->allocator, memory );
+		return result;
+	}
+
+	result.data	= memory;
+	result.size	= length;
+	return result;
+}
+
+ImAppFile* imappPlatformResourceOpen( ImAppPlatform* platform, const char* resourceName )
+{
+	char resourcePath[ PATH_MAX ];
+	imappPlatformResourceGetPath( platform, resourcePath, sizeof( resourcePath ), resourceName );
+
+	FILE* file = fopen( resourcePath, "rb" );
+	if( !file )
+	{
+		ImAppTrace( "Error: Failed to open '%s'\n", resourcePath );
+		return NULL;
+	}
+
+	return (ImAppFile*)file;
+}
+
+uintsize imappPlatformResourceRead( ImAppFile* file, void* outData, uintsize length, uintsize offset )
+{
+	FILE* nativeFile = (FILE*)file;
+
+	if( fseek( nativeFile, (long)offset, SEEK_SET ) == -1 )
+	{
+		return 0u;
+	}
+
+	return fread( outData, 1u, length, nativeFile );
+}
+
+void imappPlatformResourceClose( ImAppPlatform* platform, ImAppFile* file )
+{
+	IMAPP_USE( platform );
+
+	fclose( (FILE*)file );
+}
+
+ImAppBlob imappPlatformResourceLoadSystemFont( ImAppPlatform* platform, const char* fontName )
+{
+	ImAppBlob result = { NULL, 0u };
+
+	// build machines have no font config, fonts must come with the resources
+	char fontPath[ PATH_MAX ];
+	imappPlatformResourceGetPath( platform, fontPath, sizeof( fontPath ), fontName );
+
+	FILE* file = fopen( fontPath, "rb" );
+	if( !file )
+	{
+		ImAppTrace( "Error: Failed to open '%s'\n", fontPath );
+		return result;
+	}
+
+	struct stat fileStats;
+	if( fstat( fileno( file ), &fileStats ) != 0 )
+	{
+		fclose( file );
+		return result;
+	}
+
+	void* memory = ImUiMemoryAlloc( platform->allocator, (size_t)fileStats.st_size );
+	if( !memory )
+	{
+		fclose( file );
+		return result;
+	}
+
+	const size_t readResult = fread( memory, 1u, (size_t)fileStats.st_size, file );
+	fclose( file );
+
+	if( readResult != (size_t)fileStats.st_size )
+	{
+		ImUiMemoryFree( platform->allocator, memory );
+		return result;
+	}
+
+	result.data	= memory;
+	result.size	= (size_t)fileStats.st_size;
+	return result;
+}
+
+void imappPlatformResourceFree( ImAppPlatform* platform, ImAppBlob blob )
+{
+	ImUiMemoryFree( platform->allocator, blob.data );
+}
+
+ImAppFileWatcher* imappPlatformFileWatcherCreate( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+
+	// resources don't change during a run
+	return NULL;
+}
+
+void imappPlatformFileWatcherDestroy( ImAppPlatform* platform, ImAppFileWatcher* watcher )
+{
+	IMAPP_USE( platform );
+	IMAPP_USE( watcher );
+}
+
+void imappPlatformFileWatcherAddPath( ImAppFileWatcher* watcher, const char* path )
+{
+	IMAPP_USE( watcher );
+	IMAPP_USE( path );
+}
+
+void imappPlatformFileWatcherRemovePath( ImAppFileWatcher* watcher, const char* path )
+{
+	IMAPP_USE( watcher );
+	IMAPP_USE( path );
+}
+
+bool imappPlatformFileWatcherPopEvent( ImAppFileWatcher* watcher, ImAppFileWatchEvent* outEvent )
+{
+	IMAPP_USE( watcher );
+	IMAPP_USE( outEvent );
+
+	return false;
+}
+
+#endif
@@ -1,27 +1,51 @@
 #include "imapp_platform.h"
 
-#if IMAPP_ENABLED( IMAPP_PLATFORM_LINUX ) && IMAPP_DISABLED( IMAPP_PLATFORM_SDL )
+#if IMAPP_ENABLED( IMAPP_PLATFORM_WAYLAND )
 
 #include "imapp_debug.h"
-#include "imapp_drop_queue.h"
 #include "imapp_event_queue.h"
 #include "imapp_internal.h"
 
-#include <EGL/egl.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <linux/input-event-codes.h>
 #include <linux/limits.h>
+#include <math.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/timerfd.h>
 #include <sys/unistd.h>
+#include <time.h>
 #include <unistd.h>
-#include <wayland-egl.h>
+#include <wayland-client.h>
 #include <xkbcommon/xkbcommon.h>
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+#	include <EGL/egl.h>
+#	include <EGL/eglext.h>
+#	include <wayland-egl.h>
+#endif
+
 #include "xdg-shell.h"
 #include "xdg-decoration-unstable-v1-client-protocol.h"
+#include "presentation-time-client-protocol.h"
+
+#define IMAPP_PLATFORM_LINUX_SPIN_NS		200000		// the timer wakes this early, the rest is spun to hit the deadline
+#define IMAPP_PLATFORM_LINUX_FRAME_WAIT_NS	50000000	// longest wait of a present for the last frame to be shown
+#define IMAPP_PLATFORM_LINUX_HIDDEN_NS		250000000	// frame callback overdue for longer: the compositor doesn't show the window
+#define IMAPP_PLATFORM_LINUX_REFRESH_NS		16666667	// vertical blank interval until presentation feedback reports one
+#define IMAPP_PLATFORM_LINUX_SHM_BUFFERS	3			// software renderer: the compositor holds one or two until it releases them
+
+#if defined( XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION )
+#	define IMAPP_PLATFORM_LINUX_XDG_VERSION	XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION
+#else
+#	define IMAPP_PLATFORM_LINUX_XDG_VERSION	2
+#endif
 
 //////////////////////////////////////////////////////////////////////////
 // Main
@@ -61,11 +85,25 @@ struct ImAppPlatform
 	struct xdg_wm_base*			xdgWmBase;
 	struct zxdg_decoration_manager_v1* zxdgDecorationManager;
 
+	struct wp_presentation*		wpPresentation;
+	bool						isPresentationMonotonic;	// feedback times are only used in the clock of the ticks
+	sint64						lastPresentTime;			// of the latest presented frame of any window, 0 if unknown
+	sint64						refreshDuration;			// ns between two vertical blanks, 0 if unknown
+
 	struct xkb_context*			xkbContext;
 	struct xkb_keymap*			xkbKeymap;
 	struct xkb_state*			xkbState;
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
 	EGLDisplay					eglDisplay;
+	EGLConfig					eglConfig;
+	EGLContext					eglContext;			// shared by all windows, current without a surface between the windows
+	bool						hasBufferAge;
+	PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC	eglSwapBuffersWithDamage;
+#endif
+
+	int							wakeEventFd;		// imappPlatformWakeUp, written from any thread
+	int							tickTimerFd;		// end of the tick interval
 
 	ImAppWindow**				windows;
 	uintsize					windowsCapacity;
@@ -77,26 +115,53 @@ struct ImAppPlatform
 	//SDL_Cursor*		systemCursors[ ImUiInputMouseCursor_MAX ];
 };
 
+#include "imapp_platform_posix.h"
 #include "imapp_platform_pthread.h"
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+typedef struct ImAppPlatformLinuxShmBuffer
+{
+	struct wl_buffer*			wlBuffer;
+	uint32_t*					pixels;				// mapped shared memory, XRGB8888 is BGRA8 in memory
+	uintsize					size;
+	int							width;
+	int							height;
+	int							damage[ 4u ];		// left, top, right, bottom of the content older than the frame
+	uint32_t					age;				// presents since it got attached
+	bool						isBusy;				// attached until the compositor releases it
+} ImAppPlatformLinuxShmBuffer;
+#endif
+
 struct ImAppWindow
 {
 	ImUiAllocator*				allocator;
 	ImAppPlatform*				platform;
 	ImAppEventQueue				eventQueue;
-	ImAppWindowDoUiFunc			uiFunc;
 
-	struct wl_egl_window*		wlWindow;
 	struct wl_surface*			wlSurface;
 	//struct wl_shell_surface*	wlShellSurface;
-	//struct wl_callback*			wlDrawCallback;
+	struct wl_event_queue*		wlFrameQueue;		// frame callbacks only, a present waits on it without dispatching input
+	struct wl_callback*			wlFrameCallback;	// pending until the compositor shows the last present
+	sint64						frameRequestTick;
+	bool						isSuspended;
 
 	struct xdg_surface*			xdgSurface;
 	struct xdg_toplevel*		xdgToplevel;
 	struct zxdg_toplevel_decoration_v1* xdgDecoration;
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+	const uint32_t*				pixels;				// BGRA8 frame of the software renderer, owned by the renderer
+	int							pixelsWidth;
+	int							pixelsHeight;
+	ImAppPlatformLinuxShmBuffer	shmBuffers[ IMAPP_PLATFORM_LINUX_SHM_BUFFERS ];
+#else
+	struct wl_egl_window*		wlWindow;
 	EGLSurface					eglSurface;
-	EGLContext					eglContext;
+	int							swapInterval;		// of eglSurface, -1 if unknown
+#endif
+	int							surfaceWidth;		// size of the surface, resized by the next render
+	int							surfaceHeight;
+	bool						waitForVSync;
 
 	bool						isInitialized;
 	int							x;
@@ -108,8 +173,6 @@ struct ImAppWindow
 	char*						title;
 	uintsize					titleCapacity;
 	float						dpiScale;
-
-	ImAppWindowDropQueue		drops;
 };
 
 // static const SDL_SystemCursor s_sdlSystemCursorMapping[] =
@@ -138,7 +201,7 @@ static void ImAppPlatformWaylandRegistryGlobalRemoveCallback( void* data, struct
 //static void ImAppPlatformWaylandShellSurfacePopupDoneCallback( void* data, struct wl_shell_surface* shell_surface );
 
 //static void ImAppPlatformWaylandHandleWindowConfigCallback( void* data, struct wl_callback* callback, uint32_t time );
-//static void ImAppPlatformWaylandHandleWindowDrawCallback( void* data, struct wl_callback* callback, uint32_t time );
+static void ImAppPlatformWaylandHandleWindowFrameCallback( void* data, struct wl_callback* callback, uint32_t time );
 
 static void ImAppPlatformWaylandHandlePointerEnter( void* data, struct wl_pointer* pointer, uint32_t serial, struct wl_surface* surface, wl_fixed_t surface_x, wl_fixed_t surface_y );
 static void ImAppPlatformWaylandHandlePointerLeave( void* data, struct wl_pointer* pointer, uint32_t serial, struct wl_surface* surface );
@@ -165,6 +228,28 @@ static void ImAppPlatformWaylandHandleXdgToplevelWmCapabilities( void* data, str
 
 static void ImAppPlatformWaylandHandleXdgDecorationConfigure( void* data, struct zxdg_toplevel_decoration_v1* zxdg_toplevel_decoration_v1, uint32_t mode );
 
+static void ImAppPlatformWaylandHandlePresentationClockId( void* data, struct wp_presentation* wp_presentation, uint32_t clk_id );
+
+static void ImAppPlatformWaylandHandlePresentationFeedbackSyncOutput( void* data, struct wp_presentation_feedback* wp_presentation_feedback, struct wl_output* output );
+static void ImAppPlatformWaylandHandlePresentationFeedbackPresented( void* data, struct wp_presentation_feedback* wp_presentation_feedback, uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec, uint32_t refresh, uint32_t seq_hi, uint32_t seq_lo, uint32_t flags );
+static void ImAppPlatformWaylandHandlePresentationFeedbackDiscarded( void* data, struct wp_presentation_feedback* wp_presentation_feedback );
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+static void ImAppPlatformWaylandHandleBufferRelease( void* data, struct wl_buffer* wl_buffer );
+#endif
+
+static bool ImAppPlatformLinuxCreateGlContext( ImAppPlatform* platform );
+static bool ImAppPlatformLinuxCreateWindowSurface( ImAppWindow* window );
+static void ImAppPlatformLinuxDestroyWindowSurface( ImAppWindow* window );
+static bool ImAppPlatformLinuxPresentPixels( ImAppWindow* window, const ImUiRect* damageRect );
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+static bool ImAppPlatformLinuxHasFreeShmBuffer( const ImAppWindow* window );
+#endif
+static sint64 ImAppPlatformLinuxAlignToVBlank( const ImAppPlatform* platform, sint64 currentTick, sint64 nextTick );
+static void ImAppPlatformLinuxWaitForFrame( ImAppWindow* window );
+static bool ImAppPlatformLinuxIsFrameShown( const ImAppWindow* window );
+static bool ImAppPlatformLinuxWaitForFrameQueue( ImAppWindow* window, bool (*isDone)( const ImAppWindow* window ) );
+
 static const struct wl_registry_listener s_wlRegistryListener =
 {
 	&ImAppPlatformWaylandRegistryGlobalCallback,
@@ -183,10 +268,17 @@ static const struct wl_registry_listener s_wlRegistryListener =
 //	ImAppPlatformWaylandHandleWindowConfigCallback
 //};
 
-//static const struct wl_callback_listener s_wlWindowDrawCallbackListener =
-//{
-//	&ImAppPlatformWaylandHandleWindowDrawCallback
-//};
+static const struct wl_callback_listener s_wlWindowFrameCallbackListener =
+{
+	&ImAppPlatformWaylandHandleWindowFrameCallback
+};
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+static const struct wl_buffer_listener s_wlBufferListener =
+{
+	&ImAppPlatformWaylandHandleBufferRelease
+};
+#endif
 
 static const struct wl_pointer_listener s_wlWindowPointerListener =
 {
@@ -234,6 +326,18 @@ static const struct zxdg_toplevel_decoration_v1_listener s_xdgDecorationListener
 	&ImAppPlatformWaylandHandleXdgDecorationConfigure
 };
 
+static const struct wp_presentation_listener s_wpPresentationListener =
+{
+	&ImAppPlatformWaylandHandlePresentationClockId
+};
+
+static const struct wp_presentation_feedback_listener s_wpPresentationFeedbackListener =
+{
+	&ImAppPlatformWaylandHandlePresentationFeedbackSyncOutput,
+	&ImAppPlatformWaylandHandlePresentationFeedbackPresented,
+	&ImAppPlatformWaylandHandlePresentationFeedbackDiscarded
+};
+
 int main( int argc, char* argv[] )
 {
 	ImAppPlatform platform = { 0 };
@@ -368,6 +472,15 @@ bool imappPlatformInitialize( ImAppPlatform* platform, ImUiAllocator* allocator,
 {
 	platform->allocator = allocator;
 
+	// the main loop sleeps in poll until one of these or the display has something
+	platform->wakeEventFd	= eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+	platform->tickTimerFd	= timerfd_create( CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK );
+	if( platform->wakeEventFd < 0 || platform->tickTimerFd < 0 )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to create wake up descriptors." );
+		return false;
+	}
+
 	//ImAppPlatformLinuxReadFontConfig( platform );
 
 	platform->wlDisplay = wl_display_connect( NULL );
@@ -381,6 +494,13 @@ bool imappPlatformInitialize( ImAppPlatform* platform, ImUiAllocator* allocator,
 	wl_registry_add_listener( platform->wlRegistry, &s_wlRegistryListener, platform );
 	wl_display_roundtrip( platform->wlDisplay );
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+	if( !platform->wlShm )
+	{
+		IMAPP_DEBUG_LOGE( "Wayland server has no shared memory buffers." );
+		return false;
+	}
+#else
 	platform->eglDisplay = eglGetDisplay( (EGLNativeDisplayType)platform->wlDisplay );
 	if( platform->eglDisplay == EGL_NO_DISPLAY )
 	{
@@ -393,9 +513,18 @@ bool imappPlatformInitialize( ImAppPlatform* platform, ImUiAllocator* allocator,
 	const EGLBoolean initResult = eglInitialize( platform->eglDisplay, &major, &minor );
 	if( initResult != EGL_TRUE )
 	{
-		IMAPP_DEBUG_LOGE( "Failed toinitialize EGL." );
+		IMAPP_DEBUG_LOGE( "Failed to initialize EGL." );
+		return false;
+	}
+
+	// the renderer is created before the first window
+	if( !ImAppPlatformLinuxCreateGlContext( platform ) ||
+		!imappPlatformAcquireGlContext( platform ) )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to activate GL context." );
 		return false;
 	}
+#endif
 
 	//wl_display_dispatch( platform->wlDisplay );
 
@@ -554,11 +683,32 @@ void imappPlatformShutdown( ImAppPlatform* platform )
 	//platform->fontsCount = 0;
 	//IMUI_MEMORY_ARRAY_FREE( platform->allocator, platform->fonts, platform->fontsCapacity );
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	if( platform->eglContext != EGL_NO_CONTEXT )
+	{
+		eglMakeCurrent( platform->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+		eglDestroyContext( platform->eglDisplay, platform->eglContext );
+		platform->eglContext = EGL_NO_CONTEXT;
+	}
+
 	if( platform->eglDisplay != EGL_NO_DISPLAY )
 	{
 		eglTerminate( platform->eglDisplay );
 		platform->eglDisplay = EGL_NO_DISPLAY;
 	}
+#endif
+
+	if( platform->wlShm )
+	{
+		wl_shm_destroy( platform->wlShm );
+		platform->wlShm = NULL;
+	}
+
+	if( platform->wpPresentation )
+	{
+		wp_presentation_destroy( platform->wpPresentation );
+		platform->wpPresentation = NULL;
+	}
 
 	if( platform->wlDisplay )
 	{
@@ -566,35 +716,142 @@ void imappPlatformShutdown( ImAppPlatform* platform )
 		platform->wlDisplay = NULL;
 	}
 
+	if( platform->tickTimerFd >= 0 )
+	{
+		close( platform->tickTimerFd );
+		platform->tickTimerFd = -1;
+	}
+
+	if( platform->wakeEventFd >= 0 )
+	{
+		close( platform->wakeEventFd );
+		platform->wakeEventFd = -1;
+	}
+
 	platform->allocator = NULL;
 }
 
 sint64 imappPlatformTick( ImAppPlatform* platform, sint64 lastTickValue, sint64 tickIntervalMs )
 {
-	wl_display_dispatch_pending( platform->wlDisplay );
+	const sint64 currentTick	= imappPlatformGetTickValue( platform );
+	const sint64 nextTick		= tickIntervalMs > 0 ? ImAppPlatformLinuxAlignToVBlank( platform, currentTick, lastTickValue + (tickIntervalMs * 1000000) ) : 0;
+	const bool wait				= tickIntervalMs == 0 || currentTick < nextTick;
 
-	struct timespec timeSpec;
-	clock_gettime( CLOCK_REALTIME, &timeSpec );
+	// without an interval only events, redraw requests and resources wake the loop
+	struct itimerspec timerSpec;
+	memset( &timerSpec, 0, sizeof( timerSpec ) );
+	if( tickIntervalMs > 0 && wait )
+	{
+		const sint64 timerTick = IMUI_MAX( nextTick - IMAPP_PLATFORM_LINUX_SPIN_NS, 1 );
+		timerSpec.it_value.tv_sec	= (time_t)(timerTick / 1000000000);
+		timerSpec.it_value.tv_nsec	= (long)(timerTick % 1000000000);
+	}
+	timerfd_settime( platform->tickTimerFd, TFD_TIMER_ABSTIME, &timerSpec, NULL );
 
-	sint64 currentTick		= ((sint64)timeSpec.tv_sec*  1000000000) + timeSpec.tv_nsec;
-	const sint64 deltaTicks	= currentTick - lastTickValue;
-	sint64 timeToWait		= IMUI_MAX( tickIntervalMs*  1000000, deltaTicks ) - deltaTicks;
+	// queued events must be dispatched before reading, poll would miss them otherwise
+	while( wl_display_prepare_read( platform->wlDisplay ) != 0 )
+	{
+		wl_display_dispatch_pending( platform->wlDisplay );
+	}
+	wl_display_flush( platform->wlDisplay );
+
+	struct pollfd pollFds[ 3u ];
+	pollFds[ 0u ].fd		= wl_display_get_fd( platform->wlDisplay );
+	pollFds[ 0u ].events	= POLLIN;
+	pollFds[ 1u ].fd		= platform->wakeEventFd;
+	pollFds[ 1u ].events	= POLLIN;
+	pollFds[ 2u ].fd		= platform->tickTimerFd;
+	pollFds[ 2u ].events	= POLLIN;
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( pollFds ); ++i )
+	{
+		pollFds[ i ].revents = 0;
+	}
 
-	//if( tickIntervalMs == 0 )
-	//{
-	//	timeToWait = INT_MAX;
-	//}
+	const int pollResult = poll( pollFds, IMAPP_ARRAY_COUNT( pollFds ), wait ? -1 : 0 );
+	if( pollResult > 0 && (pollFds[ 0u ].revents & POLLIN) )
+	{
+		wl_display_read_events( platform->wlDisplay );
+	}
+	else
+	{
+		wl_display_cancel_read( platform->wlDisplay );
+	}
 
-	if( timeToWait > 1 )
+	// drain both, a wake up while the tick runs leaves the eventfd readable for the next wait
+	uint64_t counter;
+	for( uintsize i = 1u; i < IMAPP_ARRAY_COUNT( pollFds ); ++i )
 	{
-		// TODO: use event loop
-		usleep( (useconds_t)timeToWait / 1000 );
+		if( pollResult > 0 && (pollFds[ i ].revents & POLLIN) )
+		{
+			const ssize_t readResult = read( pollFds[ i ].fd, &counter, sizeof( counter ) );
+			IMAPP_USE( readResult );
+		}
+	}
+
+	wl_display_dispatch_pending( platform->wlDisplay );
+	for( uintsize i = 0u; i < platform->windowsCount; ++i )
+	{
+		wl_display_dispatch_queue_pending( platform->wlDisplay, platform->windows[ i ]->wlFrameQueue );
+	}
 
-		clock_gettime( CLOCK_REALTIME, &timeSpec );
-		currentTick = (sint64)timeSpec.tv_nsec;
+	// only the timer woke us, the scheduler is too coarse for the rest
+	const bool isTimerOnly = pollResult == 1 && (pollFds[ 2u ].revents & POLLIN);
+	sint64 tickValue = imappPlatformGetTickValue( platform );
+	while( isTimerOnly && tickValue < nextTick )
+	{
+		tickValue = imappPlatformGetTickValue( platform );
 	}
 
-	return currentTick;
+	return tickValue;
+}
+
+static sint64 ImAppPlatformLinuxAlignToVBlank( const ImAppPlatform* platform, sint64 currentTick, sint64 nextTick )
+{
+	if( platform->refreshDuration == 0 ||
+		platform->lastPresentTime == 0 ||
+		platform->lastPresentTime > nextTick )
+	{
+		return nextTick;
+	}
+
+	// start building on the last vertical blank before the deadline, so a full refresh is left until the next one
+	const sint64 vblankTick = nextTick - ((nextTick - platform->lastPresentTime) % platform->refreshDuration);
+	return vblankTick > currentTick ? vblankTick : nextTick;
+}
+
+void imappPlatformWakeUp( ImAppPlatform* platform )
+{
+	// eventfd sums up the writes, the next tick reads them at once
+	const uint64_t value = 1u;
+	const ssize_t writeResult = write( platform->wakeEventFd, &value, sizeof( value ) );
+	IMAPP_USE( writeResult );
+}
+
+void imappPlatformWaitForVSync( ImAppPlatform* platform )
+{
+	// a frame callback of a present without wait is the next vertical blank
+	for( uintsize i = 0u; i < platform->windowsCount; ++i )
+	{
+		ImAppWindow* window = platform->windows[ i ];
+		if( window->wlFrameCallback && !imappPlatformWindowIsHidden( window ) )
+		{
+			ImAppPlatformLinuxWaitForFrame( window );
+			return;
+		}
+	}
+
+	// nothing committed, the compositor has no reason to answer. Sleep until the vertical blank instead
+	const sint64 currentTick		= imappPlatformGetTickValue( platform );
+	const sint64 refreshDuration	= platform->refreshDuration > 0 ? platform->refreshDuration : IMAPP_PLATFORM_LINUX_REFRESH_NS;
+	const sint64 lastVBlankTick		= platform->lastPresentTime > 0 && platform->lastPresentTime <= currentTick ? platform->lastPresentTime : currentTick;
+	const sint64 nextVBlankTick		= currentTick + refreshDuration - ((currentTick - lastVBlankTick) % refreshDuration);
+
+	struct timespec wakeSpec;
+	wakeSpec.tv_sec		= (time_t)(nextVBlankTick / 1000000000);
+	wakeSpec.tv_nsec	= (long)(nextVBlankTick % 1000000000);
+	while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeSpec, NULL ) == EINTR )
+	{
+	}
 }
 
 double imappPlatformTicksToSeconds( ImAppPlatform* platform, sint64 tickValue )
@@ -602,6 +859,16 @@ double imappPlatformTicksToSeconds( ImAppPlatform* platform, sint64 tickValue )
 	return (double)tickValue / 1000000000.0;
 }
 
+sint64 imappPlatformGetTickValue( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+
+	struct timespec timeSpec;
+	clock_gettime( CLOCK_MONOTONIC, &timeSpec );
+
+	return ((sint64)timeSpec.tv_sec * 1000000000) + timeSpec.tv_nsec;
+}
+
 static void ImAppPlatformWaylandRegistryGlobalCallback( void* data, struct wl_registry* registry, uint32_t name, const char* interface, uint32_t version )
 {
 	ImAppPlatform* platform = (ImAppPlatform*)data;
@@ -628,6 +895,7 @@ static void ImAppPlatformWaylandRegistryGlobalCallback( void* data, struct wl_re
 	}
 	else if( strcmp( interface, "wl_shm" ) == 0 )
 	{
+		platform->wlShm = (struct wl_shm*)wl_registry_bind( registry, name, &wl_shm_interface, 1 );
 		//d->shm = static_cast<wl_shm*>(wl_registry_bind( registry, name, &wl_shm_interface, 1 ));
 		//d->cursor_theme = wl_cursor_theme_load( NULL, 32, d->shm );
 		//d->default_cursor = wl_cursor_theme_get_cursor( d->cursor_theme, "left_ptr" );
@@ -635,11 +903,16 @@ static void ImAppPlatformWaylandRegistryGlobalCallback( void* data, struct wl_re
 	else if( strcmp( interface, "zxdg_decoration_manager_v1" ) == 0 )
 	{
 		platform->zxdgDecorationManager = wl_registry_bind( registry, name, &zxdg_decoration_manager_v1_interface, 1 );
-		xdg_wm_base_add_listener( platform->xdgWmBase, &s_xdgWmBaseListener, platform );
 	}
 	else if( strcmp( interface, xdg_wm_base_interface.name ) == 0 )
 	{
-		platform->xdgWmBase = (struct xdg_wm_base*)wl_registry_bind( registry, name, &xdg_wm_base_interface, IMUI_MIN( version, 2 ) );
+		platform->xdgWmBase = (struct xdg_wm_base*)wl_registry_bind( registry, name, &xdg_wm_base_interface, IMUI_MIN( version, IMAPP_PLATFORM_LINUX_XDG_VERSION ) );
+		xdg_wm_base_add_listener( platform->xdgWmBase, &s_xdgWmBaseListener, platform );
+	}
+	else if( strcmp( interface, wp_presentation_interface.name ) == 0 )
+	{
+		platform->wpPresentation = (struct wp_presentation*)wl_registry_bind( registry, name, &wp_presentation_interface, 1 );
+		wp_presentation_add_listener( platform->wpPresentation, &s_wpPresentationListener, platform );
 	}
 }
 
@@ -648,6 +921,32 @@ static void ImAppPlatformWaylandRegistryGlobalRemoveCallback( void* data, struct
 
 }
 
+static void ImAppPlatformWaylandHandlePresentationClockId( void* data, struct wp_presentation* wp_presentation, uint32_t clk_id )
+{
+	ImAppPlatform* platform = (ImAppPlatform*)data;
+	platform->isPresentationMonotonic = clk_id == CLOCK_MONOTONIC;
+}
+
+static void ImAppPlatformWaylandHandlePresentationFeedbackSyncOutput( void* data, struct wp_presentation_feedback* wp_presentation_feedback, struct wl_output* output )
+{
+}
+
+static void ImAppPlatformWaylandHandlePresentationFeedbackPresented( void* data, struct wp_presentation_feedback* wp_presentation_feedback, uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec, uint32_t refresh, uint32_t seq_hi, uint32_t seq_lo, uint32_t flags )
+{
+	ImAppPlatform* platform = (ImAppPlatform*)data;
+
+	const sint64 seconds = (sint64)(((uint64)tv_sec_hi << 32u) | tv_sec_lo);
+	platform->lastPresentTime	= (seconds * 1000000000) + tv_nsec;
+	platform->refreshDuration	= refresh;		// 0 when the output has no constant rate
+
+	wp_presentation_feedback_destroy( wp_presentation_feedback );
+}
+
+static void ImAppPlatformWaylandHandlePresentationFeedbackDiscarded( void* data, struct wp_presentation_feedback* wp_presentation_feedback )
+{
+	wp_presentation_feedback_destroy( wp_presentation_feedback );
+}
+
 void imappPlatformShowError( ImAppPlatform* pPlatform, const char* message )
 {
 	//int fd_pipe[ 2 ]; /* fd_pipe[0]: read end of pipe, fd_pipe[1]: write end of pipe* /
@@ -770,7 +1069,7 @@ void imappPlatformGetClipboardText( ImAppPlatform* platform, ImUiContext* imui )
 	//ImUiInputSetPasteText( imui, clipboardText );
 }
 
-ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const char* windowTitle, int x, int y, int width, int height, ImAppWindowStyle style, ImAppWindowState state, ImAppWindowDoUiFunc uiFunc )
+ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const ImAppWindowParameters* parameters )
 {
 	if( !platform->wlCompositor )
 	{
@@ -788,12 +1087,31 @@ ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const char* win
 		return NULL;
 	}
 
-	window->allocator	= platform->allocator;
-	window->platform	= platform;
-	window->uiFunc		= uiFunc;
-	window->width		= width;
-	window->height		= height;
-	window->dpiScale	= 1.0f;
+	window->allocator		= platform->allocator;
+	window->platform		= platform;
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	window->eglSurface		= EGL_NO_SURFACE;
+	window->swapInterval	= -1;
+#endif
+	window->waitForVSync	= true;
+	window->x				= parameters->x == IMAPP_WINDOW_DEFAULT_POSITION ? 0 : parameters->x;
+	window->y				= parameters->y == IMAPP_WINDOW_DEFAULT_POSITION ? 0 : parameters->y;
+	window->width			= IMUI_MAX( parameters->width, 1 );
+	window->height			= IMUI_MAX( parameters->height, 1 );
+	window->state			= parameters->state;
+	window->style			= parameters->style;
+	window->dpiScale		= 1.0f;
+
+	imappEventQueueConstruct( &window->eventQueue, platform->allocator );
+
+	const uintsize windowTitleLength = strlen( parameters->title ) + 1u;
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( platform->allocator, window->title, window->titleCapacity, windowTitleLength ) )
+	{
+		IMAPP_DEBUG_LOGE( "Can't allocate title." );
+		imappPlatformWindowDestroy( window );
+		return NULL;
+	}
+	memcpy( window->title, parameters->title, windowTitleLength );
 
 	window->wlSurface = wl_compositor_create_surface( platform->wlCompositor );
 	if( !window->wlSurface )
@@ -803,6 +1121,14 @@ ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const char* win
 		return NULL;
 	}
 
+	window->wlFrameQueue = wl_display_create_queue( platform->wlDisplay );
+	if( !window->wlFrameQueue )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to create Wayland event queue." );
+		imappPlatformWindowDestroy( window );
+		return NULL;
+	}
+
 	if( platform->xdgWmBase )
 	{
 		window->xdgSurface = xdg_wm_base_get_xdg_surface( platform->xdgWmBase, window->wlSurface );
@@ -811,33 +1137,22 @@ ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const char* win
 		window->xdgToplevel = xdg_surface_get_toplevel( window->xdgSurface );
 		xdg_toplevel_add_listener( window->xdgToplevel, &s_xdgToplevelListener, window );
 
-		xdg_toplevel_set_title( window->xdgToplevel, windowTitle );
-		xdg_toplevel_set_app_id( window->xdgToplevel, windowTitle );
+		xdg_toplevel_set_title( window->xdgToplevel, window->title );
+		xdg_toplevel_set_app_id( window->xdgToplevel, window->title );
 	}
 
-	window->wlWindow = wl_egl_window_create( window->wlSurface, width, height );
-	if( !window->wlWindow )
+	window->surfaceWidth	= window->width;
+	window->surfaceHeight	= window->height;
+
+	if( !ImAppPlatformLinuxCreateWindowSurface( window ) )
 	{
-		IMAPP_DEBUG_LOGE( "Failed to create Wayland Window." );
 		imappPlatformWindowDestroy( window );
 		return NULL;
 	}
 
-	if( window->xdgToplevel )
+	if( window->state != ImAppWindowState_Default )
 	{
-		switch( state )
-		{
-		case ImAppWindowState_Default:
-			break;
-
-		case ImAppWindowState_Minimized:
-			xdg_toplevel_set_maximized( window->xdgToplevel );
-			break;
-
-		case ImAppWindowState_Maximized:
-			xdg_toplevel_set_minimized( window->xdgToplevel );
-			break;
-		}
+		imappPlatformWindowSetState( window, window->state );
 	}
 
 	if( platform->xdgWmBase )
@@ -852,7 +1167,7 @@ ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const char* win
 			}
 		}
 
-		if( style != ImAppWindowStyle_Borderless &&
+		if( window->style != ImAppWindowStyle_Borderless &&
 			window->xdgToplevel &&
 			platform->zxdgDecorationManager )
 		{
@@ -911,16 +1226,12 @@ ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const char* win
 	//	return NULL;
 	//}
 
-	imappEventQueueConstruct( &window->eventQueue, platform->allocator );
-
 	platform->windows[ platform->windowsCount++ ] = window;
 	return window;
 }
 
 void imappPlatformWindowDestroy( ImAppWindow* window )
 {
-	IMAPP_ASSERT( window->eglContext == EGL_NO_CONTEXT );
-
 	ImAppPlatform* platform = window->platform;
 
 	//while( window->firstNewDrop )
@@ -941,10 +1252,30 @@ void imappPlatformWindowDestroy( ImAppWindow* window )
 
 	imappEventQueueDestruct( &window->eventQueue );
 
-	if( window->wlWindow )
+	if( window->wlFrameCallback )
 	{
-		wl_egl_window_destroy( window->wlWindow );
-		window->wlWindow = NULL;
+		wl_callback_destroy( window->wlFrameCallback );
+		window->wlFrameCallback = NULL;
+	}
+
+	ImAppPlatformLinuxDestroyWindowSurface( window );
+
+	if( window->xdgDecoration )
+	{
+		zxdg_toplevel_decoration_v1_destroy( window->xdgDecoration );
+		window->xdgDecoration = NULL;
+	}
+
+	if( window->xdgToplevel )
+	{
+		xdg_toplevel_destroy( window->xdgToplevel );
+		window->xdgToplevel = NULL;
+	}
+
+	if( window->xdgSurface )
+	{
+		xdg_surface_destroy( window->xdgSurface );
+		window->xdgSurface = NULL;
 	}
 
 	//if( window->wlShellSurface )
@@ -959,6 +1290,12 @@ void imappPlatformWindowDestroy( ImAppWindow* window )
 		window->wlSurface = NULL;
 	}
 
+	if( window->wlFrameQueue )
+	{
+		wl_event_queue_destroy( window->wlFrameQueue );
+		window->wlFrameQueue = NULL;
+	}
+
 	for( uintsize i = 0; i < platform->windowsCount; ++i )
 	{
 		if( platform->windows[ i ] != window )
@@ -970,6 +1307,12 @@ void imappPlatformWindowDestroy( ImAppWindow* window )
 		break;
 	}
 
+	if( window->title )
+	{
+		ImUiMemoryFree( window->allocator, window->title );
+		window->title = NULL;
+	}
+
 	ImUiMemoryFree( window->allocator, window );
 }
 
@@ -1008,50 +1351,19 @@ void imappPlatformWindowDestroy( ImAppWindow* window )
 //
 //	//window->configured = 1;
 //
-//	if( !window->wlDrawCallback )
+//	if( !window->wlFrameCallback )
 //	{
-//		ImAppPlatformWaylandHandleWindowDrawCallback( data, NULL, time );
+//		ImAppPlatformWaylandHandleWindowFrameCallback( data, NULL, time );
 //	}
 //}
 
-//static void ImAppPlatformWaylandHandleWindowDrawCallback( void* data, struct wl_callback* callback, uint32_t time )
-//{
-//	//ImAppWindow* window = (ImAppWindow*)data;
-//
-//	if( callback )
-//	{
-//		wl_callback_destroy( callback );
-//	}
-//
-//	//struct wl_region* region;
-//	//
-//	//assert( window->callback == callback );
-//	//window->callback = NULL;
-//
-//
-//	//if( !window->configured )
-//	//	return;
-//
-//	//window->drawPtr( window );
-//
-//	//if( window->opaque || window->fullscreen )
-//	//{
-//	//	region = wl_compositor_create_region( window->display->compositor );
-//	//	wl_region_add( region, 0, 0, window->geometry.width,
-//	//					window->geometry.height );
-//	//	wl_surface_set_opaque_region( window->surface, region );
-//	//	wl_region_destroy( region );
-//	//}
-//	//else
-//	//{
-//	//	wl_surface_set_opaque_region( window->surface, NULL );
-//	//}
-//
-//	//window->wlDrawCallback = wl_surface_frame( window->wlSurface );
-//	//wl_callback_add_listener( window->wlDrawCallback, &s_wlWindowDrawCallbackListener, window );
-//
-//	//eglSwapBuffers( window->platform->eglDisplay, window->eglSurface );
-//}
+static void ImAppPlatformWaylandHandleWindowFrameCallback( void* data, struct wl_callback* callback, uint32_t time )
+{
+	ImAppWindow* window = (ImAppWindow*)data;
+
+	wl_callback_destroy( callback );
+	window->wlFrameCallback = NULL;
+}
 
 static void ImAppPlatformWaylandHandlePointerEnter( void* data, struct wl_pointer* pointer, uint32_t serial, struct wl_surface* surface, wl_fixed_t surface_x, wl_fixed_t surface_y )
 {
@@ -1263,10 +1575,36 @@ static void ImAppPlatformWaylandHandleXdgSurfaceConfigure( void* data, struct xd
 
 static void ImAppPlatformWaylandHandleXdgToplevelConfigure( void* data, struct xdg_toplevel* xdg_toplevel, int32_t width, int32_t height, struct wl_array* states )
 {
+	ImAppWindow* window = (ImAppWindow*)data;
+
+	bool isSuspended = false;
+	bool isMaximized = false;
+	const uint32_t* state;
+	wl_array_for_each( state, states )
+	{
+#if defined( XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION )
+		isSuspended |= *state == XDG_TOPLEVEL_STATE_SUSPENDED;
+#endif
+		isMaximized |= *state == XDG_TOPLEVEL_STATE_MAXIMIZED;
+	}
+
+	window->isSuspended	= isSuspended;
+	window->state		= isMaximized ? ImAppWindowState_Maximized : ImAppWindowState_Default;
+
+	// 0 leaves the size to us, the next render resizes the surface
+	if( width > 0 && height > 0 )
+	{
+		window->width	= width;
+		window->height	= height;
+	}
 }
 
 static void ImAppPlatformWaylandHandleXdgToplevelClose( void* data, struct xdg_toplevel* xdg_toplevel )
 {
+	ImAppWindow* window = (ImAppWindow*)data;
+
+	const ImAppEvent closeEvent = { .window = { .type = ImAppEventType_WindowClose } };
+	imappEventQueuePush( &window->eventQueue, &closeEvent );
 }
 
 static void ImAppPlatformWaylandHandleXdgToplevelConfigureBounds( void* data, struct xdg_toplevel* xdg_toplevel, int32_t width, int32_t height )
@@ -1281,74 +1619,153 @@ static void ImAppPlatformWaylandHandleXdgDecorationConfigure( void* data, struct
 {
 }
 
-bool ImAppPlatformWindowCreateGlContext( ImAppWindow* window )
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+static bool ImAppPlatformLinuxCreateGlContext( ImAppPlatform* platform )
 {
-	// Choose config
-	EGLint attribList[] =
+	if( eglBindAPI( EGL_OPENGL_ES_API ) != EGL_TRUE )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to bind OpenGL ES." );
+		return false;
+	}
+
+	const EGLint configAttributes[] =
 	{
+		EGL_SURFACE_TYPE,		EGL_WINDOW_BIT,
+		EGL_RENDERABLE_TYPE,	EGL_OPENGL_ES3_BIT_KHR,
 		EGL_RED_SIZE,			8,
 		EGL_GREEN_SIZE,			8,
 		EGL_BLUE_SIZE,			8,
 		EGL_ALPHA_SIZE,			8,
-		EGL_COLOR_BUFFER_TYPE,	EGL_RGB_BUFFER,
-		//EGL_ALPHA_SIZE,	 (flags & ES_WINDOW_ALPHA) ? 8 : EGL_DONT_CARE,
-		//EGL_SAMPLE_BUFFERS, (flags & ES_WINDOW_MULTISAMPLE) ? 1 : 0,
 		EGL_NONE
 	};
-	//EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE, EGL_NONE };
 
-	EGLConfig config;
-	EGLint numConfigs;
-	if( !eglChooseConfig( window->platform->eglDisplay, attribList, &config, 1, &numConfigs ) )
+	EGLint configCount = 0;
+	if( !eglChooseConfig( platform->eglDisplay, configAttributes, &platform->eglConfig, 1, &configCount ) ||
+		configCount == 0 )
 	{
-		ImAppPlatformWindowDestroyGlContext( window );
+		IMAPP_DEBUG_LOGE( "No EGL config with window and OpenGL ES 3 support." );
 		return false;
 	}
 
-	// Create a surface
-	window->eglSurface = eglCreateWindowSurface( window->platform->eglDisplay, config, (EGLNativeWindowType)window->wlWindow, NULL );
-	if( window->eglSurface == EGL_NO_SURFACE )
+	// textures, programs and buffers live in it for all windows
+	const EGLint contextAttributes[] = { EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE };
+	platform->eglContext = eglCreateContext( platform->eglDisplay, platform->eglConfig, EGL_NO_CONTEXT, contextAttributes );
+	if( platform->eglContext == EGL_NO_CONTEXT )
 	{
-		ImAppPlatformWindowDestroyGlContext( window );
+		IMAPP_DEBUG_LOGE( "Failed to create GL context." );
 		return false;
 	}
 
-	// Create a GL context
-	EGLint contextAttribs[] = { EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE, EGL_NONE };
-	window->eglContext = eglCreateContext( window->platform->eglDisplay, config, EGL_NO_CONTEXT, contextAttribs );
-	if( window->eglContext == EGL_NO_CONTEXT )
+	// partial presentation, the KHR and EXT variant share the signature
+	const char* extensions = eglQueryString( platform->eglDisplay, EGL_EXTENSIONS );
+	platform->hasBufferAge				= extensions && strstr( extensions, "EGL_EXT_buffer_age" ) != NULL;
+	platform->eglSwapBuffersWithDamage	= NULL;
+	if( extensions && strstr( extensions, "EGL_KHR_swap_buffers_with_damage" ) )
+	{
+		platform->eglSwapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress( "eglSwapBuffersWithDamageKHR" );
+	}
+	else if( extensions && strstr( extensions, "EGL_EXT_swap_buffers_with_damage" ) )
 	{
-		ImAppPlatformWindowDestroyGlContext( window );
+		platform->eglSwapBuffersWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress( "eglSwapBuffersWithDamageEXT" );
+	}
+
+	return true;
+}
+
+static bool ImAppPlatformLinuxCreateWindowSurface( ImAppWindow* window )
+{
+	ImAppPlatform* platform = window->platform;
+
+	window->wlWindow = wl_egl_window_create( window->wlSurface, window->width, window->height );
+	if( !window->wlWindow )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to create Wayland Window." );
 		return false;
 	}
 
-	const EGLBoolean makeCurrentResult = eglMakeCurrent( window->platform->eglDisplay, window->eglSurface, window->eglSurface, window->eglContext );
-	if( makeCurrentResult != EGL_TRUE )
+	window->eglSurface = eglCreateWindowSurface( platform->eglDisplay, platform->eglConfig, (EGLNativeWindowType)window->wlWindow, NULL );
+	if( window->eglSurface == EGL_NO_SURFACE )
 	{
-		IMAPP_DEBUG_LOGE( "Failed to set GL context. Result: %d", makeCurrentResult );
-		ImAppPlatformWindowDestroyGlContext( window );
+		IMAPP_DEBUG_LOGE( "Failed to create EGL window surface." );
 		return false;
 	}
 
 	return true;
 }
 
-void ImAppPlatformWindowDestroyGlContext( ImAppWindow* window )
+// Only the surface belongs to the window, the context stays for the other windows.
+static void ImAppPlatformLinuxDestroyWindowSurface( ImAppWindow* window )
 {
-	eglMakeCurrent( window->platform->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+	ImAppPlatform* platform = window->platform;
+	if( window->eglSurface != EGL_NO_SURFACE )
+	{
+		if( eglGetCurrentSurface( EGL_DRAW ) == window->eglSurface )
+		{
+			imappPlatformAcquireGlContext( platform );
+		}
 
-	if( window->eglContext != NULL )
+		eglDestroySurface( platform->eglDisplay, window->eglSurface );
+		window->eglSurface = EGL_NO_SURFACE;
+	}
+
+	if( window->wlWindow )
 	{
-		eglDestroyContext( window->platform->eglDisplay, window->eglContext );
-		window->eglContext = EGL_NO_CONTEXT;
+		wl_egl_window_destroy( window->wlWindow );
+		window->wlWindow = NULL;
 	}
+}
+#else
+static bool ImAppPlatformLinuxCreateWindowSurface( ImAppWindow* window )
+{
+	// shared memory buffers get created with the first frame
+	IMAPP_USE( window );
+	return true;
+}
 
-	if( window->eglSurface )
+static void ImAppPlatformLinuxDestroyWindowSurface( ImAppWindow* window )
+{
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( window->shmBuffers ); ++i )
 	{
-		eglDestroySurface( window->platform->eglDisplay, window->eglSurface );
-		window->eglSurface = EGL_NO_SURFACE;
+		ImAppPlatformLinuxShmBuffer* buffer = &window->shmBuffers[ i ];
+		if( buffer->wlBuffer )
+		{
+			wl_buffer_destroy( buffer->wlBuffer );
+		}
+
+		if( buffer->pixels )
+		{
+			munmap( buffer->pixels, buffer->size );
+		}
+
+		memset( buffer, 0, sizeof( *buffer ) );
 	}
 }
+#endif
+
+bool imappPlatformAcquireGlContext( ImAppPlatform* platform )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	if( platform->eglContext == EGL_NO_CONTEXT )
+	{
+		return false;
+	}
+
+	// fails without EGL_KHR_surfaceless_context
+	return eglMakeCurrent( platform->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, platform->eglContext ) == EGL_TRUE;
+#else
+	IMAPP_USE( platform );
+	return false;
+#endif
+}
+
+void imappPlatformReleaseGlContext( ImAppPlatform* platform )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	eglMakeCurrent( platform->eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+#else
+	IMAPP_USE( platform );
+#endif
+}
 
 ImAppWindowDeviceState imappPlatformWindowGetGlContextState( const ImAppWindow* window )
 {
@@ -1490,19 +1907,390 @@ void imappPlatformWindowUpdate( ImAppWindow* window, ImAppPlatformWindowUpdateCa
 //	}
 }
 
-bool ImAppPlatformWindowPresent( ImAppWindow* window )
+bool imappPlatformWindowBeginRender( ImAppWindow* window )
 {
-	if( window->eglContext == EGL_NO_CONTEXT )
+	// takes effect with the next present, the content of the old size is undefined
+	if( window->surfaceWidth != window->width ||
+		window->surfaceHeight != window->height )
+	{
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+		wl_egl_window_resize( window->wlWindow, window->width, window->height, 0, 0 );
+#endif
+		if( window->xdgSurface )
+		{
+			xdg_surface_set_window_geometry( window->xdgSurface, 0, 0, window->width, window->height );
+		}
+
+		window->surfaceWidth	= window->width;
+		window->surfaceHeight	= window->height;
+	}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	ImAppPlatform* platform = window->platform;
+	if( window->eglSurface == EGL_NO_SURFACE )
 	{
 		return false;
 	}
 
+	if( eglMakeCurrent( platform->eglDisplay, window->eglSurface, window->eglSurface, platform->eglContext ) != EGL_TRUE )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to activate GL context." );
+		return false;
+	}
+#endif
+
+	return true;
+}
+
+int imappPlatformWindowGetBufferAge( const ImAppWindow* window )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	if( window->eglSurface == EGL_NO_SURFACE ||
+		!window->platform->hasBufferAge )
+	{
+		return 0;
+	}
+
+	EGLint bufferAge = 0;
+	if( !eglQuerySurface( window->platform->eglDisplay, window->eglSurface, EGL_BUFFER_AGE_EXT, &bufferAge ) )
+	{
+		return 0;
+	}
+
+	return bufferAge;
+#else
+	// the renderer keeps its frame, every present copies all of it
+	IMAPP_USE( window );
+	return 1;
+#endif
+}
+
+void imappPlatformWindowSetPixels( ImAppWindow* window, const uint32_t* pixels, int width, int height )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+	window->pixels			= pixels;
+	window->pixelsWidth		= width;
+	window->pixelsHeight	= height;
+#else
+	IMAPP_USE( window );
+	IMAPP_USE( pixels );
+	IMAPP_USE( width );
+	IMAPP_USE( height );
+#endif
+}
+
+bool imappPlatformWindowEndRender( ImAppWindow* window, bool present, const ImUiRect* damageRect )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	if( window->eglSurface == EGL_NO_SURFACE )
+	{
+		return false;
+	}
+#endif
+
+	if( !present )
+	{
+		return true;
+	}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	// with an interval EGL blocks the swap until the compositor shows the last frame, forever for a hidden window. Swap
+	// without one and wait for our own frame callback with a timeout instead
+	if( window->swapInterval != 0 &&
+		eglSwapInterval( window->platform->eglDisplay, 0 ) == EGL_TRUE )
+	{
+		window->swapInterval = 0;
+	}
+#endif
+
+	if( window->waitForVSync )
+	{
+		ImAppPlatformLinuxWaitForFrame( window );
+	}
+
+	// the swap commits the surface, the callback and feedback belong to this frame
+	ImAppPlatform* platform = window->platform;
+	if( !window->wlFrameCallback )
+	{
+		window->wlFrameCallback = wl_surface_frame( window->wlSurface );
+		wl_proxy_set_queue( (struct wl_proxy*)window->wlFrameCallback, window->wlFrameQueue );
+		wl_callback_add_listener( window->wlFrameCallback, &s_wlWindowFrameCallbackListener, window );
+		window->frameRequestTick = imappPlatformGetTickValue( platform );
+	}
+
+	if( platform->wpPresentation &&
+		platform->isPresentationMonotonic )
+	{
+		struct wp_presentation_feedback* feedback = wp_presentation_feedback( platform->wpPresentation, window->wlSurface );
+		wp_presentation_feedback_add_listener( feedback, &s_wpPresentationFeedbackListener, platform );
+	}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+	return ImAppPlatformLinuxPresentPixels( window, damageRect );
+#else
+	if( damageRect && platform->eglSwapBuffersWithDamage )
+	{
+		// EGL rects start bottom left
+		EGLint rect[ 4u ];
+		rect[ 0u ] = (EGLint)damageRect->pos.x;
+		rect[ 1u ] = (EGLint)(window->surfaceHeight - (damageRect->pos.y + damageRect->size.height));
+		rect[ 2u ] = (EGLint)damageRect->size.width;
+		rect[ 3u ] = (EGLint)damageRect->size.height;
+
+		return platform->eglSwapBuffersWithDamage( platform->eglDisplay, window->eglSurface, rect, 1 ) == EGL_TRUE;
+	}
+
 	if( !eglSwapBuffers( window->platform->eglDisplay, window->eglSurface ) )
 	{
 		return false;
 	}
 
 	return true;
+#endif
+}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+static bool ImAppPlatformLinuxCreateShmBuffer( ImAppWindow* window, ImAppPlatformLinuxShmBuffer* buffer, int width, int height )
+{
+	ImAppPlatform* platform = window->platform;
+
+	const int stride	= width * 4;
+	const uintsize size	= (uintsize)stride * (uintsize)height;
+
+	// POSIX shared memory, the name is gone before anyone else could open it
+	static uint32_t s_shmCounter = 0u;
+	char shmName[ 64u ];
+	snprintf( shmName, sizeof( shmName ), "/imapp-%d-%u", (int)getpid(), s_shmCounter++ );
+
+	const int fd = shm_open( shmName, O_RDWR | O_CREAT | O_EXCL, 0600 );
+	if( fd < 0 )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to create shared memory." );
+		return false;
+	}
+	shm_unlink( shmName );
+
+	if( ftruncate( fd, (off_t)size ) != 0 )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to resize shared memory." );
+		close( fd );
+		return false;
+	}
+
+	void* pixels = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	if( pixels == MAP_FAILED )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to map shared memory." );
+		close( fd );
+		return false;
+	}
+
+	struct wl_shm_pool* pool = wl_shm_create_pool( platform->wlShm, fd, (int32_t)size );
+	buffer->wlBuffer = wl_shm_pool_create_buffer( pool, 0, width, height, stride, WL_SHM_FORMAT_XRGB8888 );
+	wl_shm_pool_destroy( pool );
+	close( fd );
+
+	wl_proxy_set_queue( (struct wl_proxy*)buffer->wlBuffer, window->wlFrameQueue );
+	wl_buffer_add_listener( buffer->wlBuffer, &s_wlBufferListener, buffer );
+
+	buffer->pixels	= (uint32_t*)pixels;
+	buffer->size	= size;
+	buffer->width	= width;
+	buffer->height	= height;
+	buffer->isBusy	= false;
+	return true;
+}
+
+static bool ImAppPlatformLinuxPresentPixels( ImAppWindow* window, const ImUiRect* damageRect )
+{
+	if( window->pixels == NULL )
+	{
+		return false;
+	}
+
+	// the compositor releases a buffer once it shows a newer one, wait for that instead of dropping the frame
+	ImAppPlatformLinuxWaitForFrameQueue( window, ImAppPlatformLinuxHasFreeShmBuffer );
+
+	ImAppPlatformLinuxShmBuffer* buffer = NULL;
+	ImAppPlatformLinuxShmBuffer* oldestBuffer = NULL;
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( window->shmBuffers ); ++i )
+	{
+		ImAppPlatformLinuxShmBuffer* candidate = &window->shmBuffers[ i ];
+		if( oldestBuffer == NULL || candidate->age > oldestBuffer->age )
+		{
+			oldestBuffer = candidate;
+		}
+
+		if( candidate->isBusy )
+		{
+			continue;
+		}
+
+		buffer = candidate;
+		if( candidate->width == window->pixelsWidth && candidate->height == window->pixelsHeight )
+		{
+			break;
+		}
+	}
+
+	if( buffer == NULL )
+	{
+		// still all on screen, reuse the oldest. The compositor may show it partly updated but gets the frame
+		buffer = oldestBuffer;
+	}
+
+	if( buffer->width != window->pixelsWidth ||
+		buffer->height != window->pixelsHeight )
+	{
+		if( buffer->wlBuffer )
+		{
+			wl_buffer_destroy( buffer->wlBuffer );
+			munmap( buffer->pixels, buffer->size );
+			memset( buffer, 0, sizeof( *buffer ) );
+		}
+
+		if( !ImAppPlatformLinuxCreateShmBuffer( window, buffer, window->pixelsWidth, window->pixelsHeight ) )
+		{
+			return false;
+		}
+
+		buffer->damage[ 2u ] = buffer->width;
+		buffer->damage[ 3u ] = buffer->height;
+	}
+
+	int damage[ 4u ] = { 0, 0, buffer->width, buffer->height };
+	if( damageRect )
+	{
+		damage[ 0u ] = IMUI_MAX( (int)damageRect->pos.x, 0 );
+		damage[ 1u ] = IMUI_MAX( (int)damageRect->pos.y, 0 );
+		damage[ 2u ] = IMUI_MIN( (int)ceilf( damageRect->pos.x + damageRect->size.width ), buffer->width );
+		damage[ 3u ] = IMUI_MIN( (int)ceilf( damageRect->pos.y + damageRect->size.height ), buffer->height );
+	}
+
+	// buffers rotate, each one misses the damage of all frames since it got written
+	const bool hasDamage = damage[ 0u ] < damage[ 2u ] && damage[ 1u ] < damage[ 3u ];
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( window->shmBuffers ); ++i )
+	{
+		ImAppPlatformLinuxShmBuffer* other = &window->shmBuffers[ i ];
+		if( other->wlBuffer == NULL )
+		{
+			continue;
+		}
+
+		other->age++;
+		if( !hasDamage )
+		{
+			continue;
+		}
+		else if( other->damage[ 0u ] >= other->damage[ 2u ] ||
+			other->damage[ 1u ] >= other->damage[ 3u ] )
+		{
+			memcpy( other->damage, damage, sizeof( other->damage ) );
+			continue;
+		}
+
+		other->damage[ 0u ] = IMUI_MIN( other->damage[ 0u ], damage[ 0u ] );
+		other->damage[ 1u ] = IMUI_MIN( other->damage[ 1u ], damage[ 1u ] );
+		other->damage[ 2u ] = IMUI_MAX( other->damage[ 2u ], damage[ 2u ] );
+		other->damage[ 3u ] = IMUI_MAX( other->damage[ 3u ], damage[ 3u ] );
+	}
+
+	// only what changed since this buffer got written last
+	const int* copyRect = buffer->damage;
+	for( int y = copyRect[ 1u ]; y < copyRect[ 3u ]; ++y )
+	{
+		const uintsize offset = ((uintsize)y * (uintsize)buffer->width) + (uintsize)copyRect[ 0u ];
+		memcpy( buffer->pixels + offset, window->pixels + offset, (uintsize)(copyRect[ 2u ] - copyRect[ 0u ]) * sizeof( uint32_t ) );
+	}
+
+	memset( buffer->damage, 0, sizeof( buffer->damage ) );
+	buffer->age		= 0u;
+	buffer->isBusy	= true;
+
+	wl_surface_attach( window->wlSurface, buffer->wlBuffer, 0, 0 );
+	wl_surface_damage_buffer( window->wlSurface, damage[ 0u ], damage[ 1u ], damage[ 2u ] - damage[ 0u ], damage[ 3u ] - damage[ 1u ] );
+	wl_surface_commit( window->wlSurface );
+	wl_display_flush( window->platform->wlDisplay );
+
+	return true;
+}
+
+static bool ImAppPlatformLinuxHasFreeShmBuffer( const ImAppWindow* window )
+{
+	// hidden windows don't get their buffers back, no need to wait
+	if( imappPlatformWindowIsHidden( window ) )
+	{
+		return true;
+	}
+
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( window->shmBuffers ); ++i )
+	{
+		if( !window->shmBuffers[ i ].isBusy )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void ImAppPlatformWaylandHandleBufferRelease( void* data, struct wl_buffer* wl_buffer )
+{
+	ImAppPlatformLinuxShmBuffer* buffer = (ImAppPlatformLinuxShmBuffer*)data;
+	buffer->isBusy = false;
+}
+#endif
+
+static void ImAppPlatformLinuxWaitForFrame( ImAppWindow* window )
+{
+	ImAppPlatformLinuxWaitForFrameQueue( window, ImAppPlatformLinuxIsFrameShown );
+}
+
+static bool ImAppPlatformLinuxIsFrameShown( const ImAppWindow* window )
+{
+	return !window->wlFrameCallback ||
+		imappPlatformWindowIsHidden( window );
+}
+
+// Dispatches frame callbacks and buffer releases until isDone or the frame wait timed out. Returns the last isDone.
+static bool ImAppPlatformLinuxWaitForFrameQueue( ImAppWindow* window, bool (*isDone)( const ImAppWindow* window ) )
+{
+	ImAppPlatform* platform = window->platform;
+	const sint64 endTick = imappPlatformGetTickValue( platform ) + IMAPP_PLATFORM_LINUX_FRAME_WAIT_NS;
+
+	while( true )
+	{
+		while( wl_display_prepare_read_queue( platform->wlDisplay, window->wlFrameQueue ) != 0 )
+		{
+			wl_display_dispatch_queue_pending( platform->wlDisplay, window->wlFrameQueue );
+		}
+
+		const bool done = isDone( window );
+		const sint64 currentTick = imappPlatformGetTickValue( platform );
+		if( done ||
+			currentTick >= endTick )
+		{
+			wl_display_cancel_read( platform->wlDisplay );
+			return done;
+		}
+		wl_display_flush( platform->wlDisplay );
+
+		// events of the other queues get read as well, the next tick dispatches them
+		struct pollfd pollFd;
+		pollFd.fd		= wl_display_get_fd( platform->wlDisplay );
+		pollFd.events	= POLLIN;
+		pollFd.revents	= 0;
+
+		const int timeoutMs = (int)((endTick - currentTick + 999999) / 1000000);
+		if( poll( &pollFd, 1, timeoutMs ) > 0 && (pollFd.revents & POLLIN) )
+		{
+			wl_display_read_events( platform->wlDisplay );
+		}
+		else
+		{
+			wl_display_cancel_read( platform->wlDisplay );
+		}
+	}
 }
 
 ImAppEventQueue* imappPlatformWindowGetEventQueue( ImAppWindow* window )
@@ -1510,9 +2298,9 @@ ImAppEventQueue* imappPlatformWindowGetEventQueue( ImAppWindow* window )
 	return &window->eventQueue;
 }
 
-ImAppWindowDoUiFunc ImAppPlatformWindowGetUiFunc( ImAppWindow* window )
+void imappPlatformWindowSetVSync( ImAppWindow* window, bool wait )
 {
-	return window->uiFunc;
+	window->waitForVSync = wait;
 }
 
 bool imappPlatformWindowPopDropData( ImAppWindow* window, ImAppDropData* outData )
@@ -1549,6 +2337,18 @@ bool imappPlatformWindowHasFocus( const ImAppWindow* window )
 		window->platform->keyboardFocusWindow == window;
 }
 
+bool imappPlatformWindowIsHidden( const ImAppWindow* window )
+{
+	if( window->isSuspended )
+	{
+		return true;
+	}
+
+	// minimized or occluded windows aren't reported, the compositor just stops to answer frame callbacks
+	return window->wlFrameCallback != NULL &&
+		imappPlatformGetTickValue( window->platform ) - window->frameRequestTick > IMAPP_PLATFORM_LINUX_HIDDEN_NS;
+}
+
 void imappPlatformWindowGetSize( const ImAppWindow* window, int* outWidth, int* outHeight )
 {
 	*outWidth	= window->width;
@@ -1557,15 +2357,16 @@ void imappPlatformWindowGetSize( const ImAppWindow* window, int* outWidth, int*
 
 void imappPlatformWindowSetSize( ImAppWindow* window, int width, int height )
 {
-	window->width	= width;
-	window->height	= height;
-
-	wl_egl_window_resize( window->wlWindow, width, height, 0, 0 );
+	// the surface follows with the next render
+	window->width	= IMUI_MAX( width, 1 );
+	window->height	= IMUI_MAX( height, 1 );
 }
 
 void imappPlatformWindowGetPosition( const ImAppWindow* window, int* outX, int* outY )
 {
-	//SDL_GetWindowPosition( window->sdlWindow, outX, outY );
+	// Wayland doesn't tell clients where their windows are
+	*outX = window->x;
+	*outY = window->y;
 }
 
 void imappPlatformWindowSetPosition( const ImAppWindow* window, int x, int y )
@@ -1573,32 +2374,59 @@ void imappPlatformWindowSetPosition( const ImAppWindow* window, int x, int y )
 
 }
 
-ImAppWindowState imappPlatformWindowGetState( const ImAppWindow* pWindow )
+ImAppWindowStyle imappPlatformWindowGetStyle( const ImAppWindow* window )
 {
-	//const Uint32 flags = SDL_GetWindowFlags( pWindow->sdlWindow );
-	//if( flags & SDL_WINDOW_MINIMIZED )
-	//{
-	//	return ImAppWindowState_Minimized;
-	//}
-	//if( flags & SDL_WINDOW_MAXIMIZED )
-	//{
-	//	return ImAppWindowState_Maximized;
-	//}
+	return window->style;
+}
 
-	return ImAppWindowState_Default;
+ImAppWindowState imappPlatformWindowGetState( const ImAppWindow* window )
+{
+	return window->state;
 }
 
 void imappPlatformWindowSetState( ImAppWindow* window, ImAppWindowState state )
 {
+	if( !window->xdgToplevel )
+	{
+		return;
+	}
+
+	// minimized windows can't be detected, the compositor only reports maximized
+	switch( state )
+	{
+	case ImAppWindowState_Default:
+		xdg_toplevel_unset_maximized( window->xdgToplevel );
+		break;
+
+	case ImAppWindowState_Minimized:
+		xdg_toplevel_set_minimized( window->xdgToplevel );
+		break;
+
+	case ImAppWindowState_Maximized:
+		xdg_toplevel_set_maximized( window->xdgToplevel );
+		break;
+	}
 }
 
 const char* imappPlatformWindowGetTitle( const ImAppWindow* window )
 {
-	return NULL;
+	return window->title;
 }
 
 void imappPlatformWindowSetTitle( ImAppWindow* window, const char* title )
 {
+	const uintsize titleLength = strlen( title ) + 1u;
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( window->allocator, window->title, window->titleCapacity, titleLength ) )
+	{
+		return;
+	}
+
+	memcpy( window->title, title, titleLength );
+
+	if( window->xdgToplevel )
+	{
+		xdg_toplevel_set_title( window->xdgToplevel, window->title );
+	}
 }
 
 void imappPlatformWindowSetTitleBounds( ImAppWindow* window, int height, int buttonsX )
@@ -1694,18 +2522,23 @@ ImAppFile* imappPlatformResourceOpen( ImAppPlatform* platform, const char* resou
 	const size_t resourcePathLength = platform->resourceBasePathLength + resourceNameLength + 1;
 
 	char* resourcePath = ImUiMemoryAlloc( platform->allocator, resourcePathLength );
+	if( !resourcePath )
+	{
+		return NULL;
+	}
 	memcpy( resourcePath, platform->resourceBasePath, platform->resourceBasePathLength );
 	memcpy( resourcePath + platform->resourceBasePathLength, resourceName, resourceNameLength + 1 );
 
-	FILE* file = fopen( platform->resourceBasePath, "rb" );
+	FILE* file = fopen( resourcePath, "rb" );
 	if( !file )
 	{
-		ImAppTrace( "Error: Failed to open '%s'\n", platform->resourceBasePath );
-		return NULL;
+		ImAppTrace( "Error: Failed to open '%s'\n", resourcePath );
 	}
 
+	ImUiMemoryFree( platform->allocator, resourcePath );
 	return (ImAppFile*)file;
 }
+
 uintsize imappPlatformResourceRead( ImAppFile* file, void* outData, uintsize length, uintsize offset )
 {
 	FILE* nativeFile = (FILE*)file;
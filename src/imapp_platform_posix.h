@@ -0,0 +1,47 @@
+#pragma once
+
+#include "imapp_platform.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+
+bool imappPlatformGetCachePath( ImAppPlatform* platform, char* outPath, uintsize pathCapacity, const char* fileName )
+{
+	IMAPP_USE( platform );
+
+	// $XDG_CACHE_HOME/imapp, $HOME/.cache/imapp when unset or not absolute
+	int directoryLength;
+	const char* cacheHome = getenv( "XDG_CACHE_HOME" );
+	if( cacheHome && cacheHome[ 0 ] == '/' )
+	{
+		directoryLength = snprintf( outPath, pathCapacity, "%s/imapp", cacheHome );
+	}
+	else
+	{
+		const char* home = getenv( "HOME" );
+		if( !home || home[ 0 ] == '\0' )
+		{
+			return false;
+		}
+
+		directoryLength = snprintf( outPath, pathCapacity, "%s/.cache", home );
+		if( directoryLength < 0 || (uintsize)directoryLength >= pathCapacity )
+		{
+			return false;
+		}
+		mkdir( outPath, 0700 );
+
+		directoryLength = snprintf( outPath, pathCapacity, "%s/.cache/imapp", home );
+	}
+
+	if( directoryLength < 0 || (uintsize)directoryLength >= pathCapacity ||
+		(mkdir( outPath, 0700 ) != 0 && errno != EEXIST) )
+	{
+		return false;
+	}
+
+	const int fileNameLength = snprintf( outPath + directoryLength, pathCapacity - (uintsize)directoryLength, "/%s", fileName );
+	return fileNameLength >= 0 && (uintsize)(directoryLength + fileNameLength) < pathCapacity;
+}
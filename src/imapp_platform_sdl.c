@@ -24,8 +24,11 @@
 #	define IMAPP_PLATFORM_SDL_PATH_SEPERATOR '/'
 #endif
 
+#define IMAPP_PLATFORM_SDL_SPIN_MS	2		// waits end this early, the rest is spun to hit the deadline
+
 #include <assert.h>
 #include <limits.h>
+#include <stdio.h>
 
 //////////////////////////////////////////////////////////////////////////
 // Main
@@ -43,6 +46,11 @@ struct ImAppPlatform
 	size_t			fontBasePathLength;
 
 	SDL_Cursor*		systemCursors[ ImUiInputMouseCursor_MAX ];
+
+	SDL_GLContext	glContext;		// shared by all windows, created with the first one
+	int				swapInterval;	// of the shared context
+	Uint32			wakeEventType;	// imappPlatformWakeUp, (Uint32)-1 if not registered
+	Uint64			tickFrequency;	// ticks are performance counter values
 };
 
 typedef struct ImAppWindowDrop ImAppWindowDrop;
@@ -62,7 +70,8 @@ struct ImAppWindow
 	ImAppWindowDoUiFunc uiFunc;
 
 	SDL_Window*			sdlWindow;
-	SDL_GLContext		glContext;
+	SDL_GLContext		glContext;		// context of the platform while the window can render
+	bool				waitForVSync;
 
 	ImAppWindowDrop*	firstNewDrop;
 	ImAppWindowDrop*	firstPoppedDrop;
@@ -271,7 +280,9 @@ int main( int argc, char* argv[] )
 
 bool imappPlatformInitialize( ImAppPlatform* platform, ImUiAllocator* allocator, const char* resourcePath )
 {
-	platform->allocator = allocator;
+	platform->allocator		= allocator;
+	platform->wakeEventType	= SDL_RegisterEvents( 1 );
+	platform->tickFrequency	= SDL_GetPerformanceFrequency();
 
 	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( platform->systemCursors ); ++i )
 	{
@@ -349,33 +360,72 @@ void imappPlatformShutdown( ImAppPlatform* platform )
 		platform->systemCursors[ i ] = NULL;
 	}
 
+	if( platform->glContext != NULL )
+	{
+		SDL_GL_DeleteContext( platform->glContext );
+		platform->glContext = NULL;
+	}
+
 	platform->allocator = NULL;
 }
 
 sint64 imappPlatformTick( ImAppPlatform* platform, sint64 lastTickValue, sint64 tickInterval )
 {
-	sint64 currentTick		= (sint64)SDL_GetTicks64();
-	const sint64 deltaTicks	= currentTick - lastTickValue;
-	sint64 timeToWait		= IMUI_MAX( tickInterval, deltaTicks ) - deltaTicks;
-
 	if( tickInterval == 0 )
 	{
-		timeToWait = INT_MAX;
+		SDL_WaitEvent( NULL );
+		return (sint64)SDL_GetPerformanceCounter();
+	}
+
+	const sint64 frequency	= (sint64)platform->tickFrequency;
+	const sint64 nextTick	= lastTickValue + ((tickInterval * frequency) / 1000);
+	sint64 currentTick		= (sint64)SDL_GetPerformanceCounter();
+	if( currentTick >= nextTick )
+	{
+		return currentTick;
 	}
 
-	if( timeToWait > 1 )
+	// SDL waits in milliseconds and the scheduler oversleeps, the last ones are spun
+	const sint64 waitMs = (((nextTick - currentTick) * 1000) / frequency) - IMAPP_PLATFORM_SDL_SPIN_MS;
+	if( waitMs > 0 &&
+		SDL_WaitEventTimeout( NULL, (int)waitMs ) == 1 )
 	{
-		SDL_WaitEventTimeout( NULL, (int)timeToWait - 1 );
+		return (sint64)SDL_GetPerformanceCounter();
+	}
+
+	while( currentTick < nextTick )
+	{
+		currentTick = (sint64)SDL_GetPerformanceCounter();
+	}
+
+	return currentTick;
+}
 
-		currentTick = (sint64)SDL_GetTicks64();
+void imappPlatformWakeUp( ImAppPlatform* platform )
+{
+	if( platform->wakeEventType == (Uint32)-1 )
+	{
+		return;
 	}
 
-	return (sint64)currentTick;
+	// SDL_PushEvent is thread safe, the window update drops the event
+	SDL_Event sdlEvent;
+	memset( &sdlEvent, 0, sizeof( sdlEvent ) );
+	sdlEvent.type = platform->wakeEventType;
+
+	SDL_PushEvent( &sdlEvent );
 }
 
 double imappPlatformTicksToSeconds( ImAppPlatform* platform, sint64 tickValue )
 {
-	return tickValue / 1000.0;
+	return tickValue / (double)platform->tickFrequency;
+}
+
+sint64 imappPlatformGetTickValue( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+
+	return (sint64)SDL_GetPerformanceCounter();
 }
 
 void imappPlatformShowError( ImAppPlatform* pPlatform, const char* pMessage )
@@ -407,8 +457,9 @@ ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const char* win
 		return NULL;
 	}
 
-	window->platform	= platform;
-	window->uiFunc		= uiFunc;
+	window->platform		= platform;
+	window->uiFunc			= uiFunc;
+	window->waitForVSync	= true;
 
 	Uint32 flags = SDL_WINDOW_OPENGL | SDL_WINDOW_SHOWN;
 	switch( style )
@@ -492,6 +543,19 @@ void imappPlatformWindowDestroy( ImAppWindow* window )
 
 bool ImAppPlatformWindowCreateGlContext( ImAppWindow* pWindow )
 {
+	ImAppPlatform* platform = pWindow->platform;
+	if( platform->glContext != NULL )
+	{
+		// textures, programs and buffers already exist in the shared context
+		if( SDL_GL_MakeCurrent( pWindow->sdlWindow, platform->glContext ) != 0 )
+		{
+			return false;
+		}
+
+		pWindow->glContext = platform->glContext;
+		return true;
+	}
+
 	SDL_GL_SetAttribute( SDL_GL_CONTEXT_MAJOR_VERSION, 3 );
 	SDL_GL_SetAttribute( SDL_GL_CONTEXT_MINOR_VERSION, 0 );
 #if IMAPP_ENABLED( IMAPP_PLATFORM_ANDROID ) || IMAPP_ENABLED( IMAPP_PLATFORM_WEB )
@@ -500,27 +564,45 @@ bool ImAppPlatformWindowCreateGlContext( ImAppWindow* pWindow )
 	SDL_GL_SetAttribute( SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_COMPATIBILITY );
 #endif
 
-	pWindow->glContext = SDL_GL_CreateContext( pWindow->sdlWindow );
-	if( pWindow->glContext == NULL )
+	platform->glContext = SDL_GL_CreateContext( pWindow->sdlWindow );
+	if( platform->glContext == NULL )
 	{
 		return false;
 	}
+	pWindow->glContext = platform->glContext;
 
 	if( SDL_GL_SetSwapInterval( 1 ) < 0 )
 	{
 		ImAppTrace( "[renderer] Unable to set VSync! SDL Error: %s\n", SDL_GetError() );
 	}
+	platform->swapInterval = 1;
 
 	return true;
 }
 
+// The context belongs to the platform and stays for the other windows.
 void ImAppPlatformWindowDestroyGlContext( ImAppWindow* window )
 {
-	if( window->glContext != NULL )
+	if( window->glContext != NULL &&
+		SDL_GL_GetCurrentWindow() == window->sdlWindow )
 	{
-		SDL_GL_DeleteContext( window->glContext );
-		window->glContext = NULL;
+		SDL_GL_MakeCurrent( NULL, NULL );
 	}
+
+	window->glContext = NULL;
+}
+
+bool imappPlatformAcquireGlContext( ImAppPlatform* platform )
+{
+	// SDL can only make a context current with a window
+	IMAPP_USE( platform );
+	return false;
+}
+
+void imappPlatformReleaseGlContext( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+	SDL_GL_MakeCurrent( NULL, NULL );
 }
 
 ImAppWindowDeviceState imappPlatformWindowGetGlContextState( const ImAppWindow* window )
@@ -675,10 +757,24 @@ void imappPlatformWindowUpdate( ImAppWindow* window, ImAppPlatformWindowUpdateCa
 
 bool ImAppPlatformWindowPresent( ImAppWindow* window )
 {
+	// the interval belongs to the shared context
+	ImAppPlatform* platform = window->platform;
+	const int swapInterval = window->waitForVSync ? 1 : 0;
+	if( platform->swapInterval != swapInterval &&
+		SDL_GL_SetSwapInterval( swapInterval ) == 0 )
+	{
+		platform->swapInterval = swapInterval;
+	}
+
 	SDL_GL_SwapWindow( window->sdlWindow );
 	return true;
 }
 
+void imappPlatformWindowSetVSync( ImAppWindow* window, bool wait )
+{
+	window->waitForVSync = wait;
+}
+
 ImAppEventQueue* imappPlatformWindowGetEventQueue( ImAppWindow* window )
 {
 	return &window->eventQueue;
@@ -721,6 +817,11 @@ bool imappPlatformWindowHasFocus( const ImAppWindow* window )
 	return (SDL_GetWindowFlags( window->sdlWindow ) & SDL_WINDOW_INPUT_FOCUS) != 0;
 }
 
+bool imappPlatformWindowIsHidden( const ImAppWindow* window )
+{
+	return (SDL_GetWindowFlags( window->sdlWindow ) & (SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN)) != 0;
+}
+
 void imappPlatformWindowGetSize( const ImAppWindow* window, int* outWidth, int* outHeight )
 {
 	SDL_GetWindowSize( window->sdlWindow, outWidth, outHeight );
@@ -954,6 +1055,23 @@ void imappPlatformResourceFree( ImAppPlatform* platform, ImAppBlob blob )
 	ImUiMemoryFree( platform->allocator, blob.data );
 }
 
+bool imappPlatformGetCachePath( ImAppPlatform* platform, char* outPath, uintsize pathCapacity, const char* fileName )
+{
+	IMAPP_USE( platform );
+
+	char* prefPath = SDL_GetPrefPath( "imapp", "cache" );
+	if( !prefPath )
+	{
+		return false;
+	}
+
+	// the preference path ends with a separator
+	const int length = snprintf( outPath, pathCapacity, "%s%s", prefPath, fileName );
+	SDL_free( prefPath );
+
+	return length >= 0 && (uintsize)length < pathCapacity;
+}
+
 ImAppFileWatcher* imappPlatformFileWatcherCreate( ImAppPlatform* platform )
 {
 	// not implemented
@@ -9,6 +9,7 @@
 #include "imapp_platform_windows_resources.h"
 
 #include <math.h>
+#include <stdio.h>
 #include <windows.h>
 #include <dwmapi.h>
 #include <windowsx.h>
@@ -23,16 +24,30 @@
 #	include <crtdbg.h>
 #endif
 
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#	define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION	0x00000002
+#endif
+
+#define IMAPP_PLATFORM_WINDOWS_SPIN_US	500		// the timer wakes this early, the rest is spun to hit the deadline
+
 typedef struct ImAppFileWatcherPath ImAppFileWatcherPath;
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+typedef BOOL (WINAPI *ImAppWglSwapIntervalFunc)( int interval );
+#endif
+
 struct ImAppPlatform
 {
 	ImUiAllocator*		allocator;
 
 	HINSTANCE			hInstance;
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
 	HWND				contextHwnd;
 	HDC					contextDc;
 	HGLRC				contextGlrc;
+	ImAppWglSwapIntervalFunc	wglSwapInterval;	// WGL_EXT_swap_control, NULL if not supported
+	int					swapInterval;			// of the shared context, -1 if unknown
+#endif
 
 	uint8				inputKeyMapping[ 223u ];
 
@@ -50,6 +65,8 @@ struct ImAppPlatform
 	uintsize			windowSize;
 
 	int64_t				tickFrequency;
+	HANDLE				wakeEvent;		// imappPlatformWakeUp, set from any thread
+	HANDLE				tickTimer;		// end of the tick interval, high resolution if supported
 };
 
 typedef struct ImAppWindowDrop ImAppWindowDrop;
@@ -73,8 +90,13 @@ struct ImAppWindow
 
 	HWND				hwnd;
 	HDC					hdc;
-	HGLRC				hglrc;
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+	const uint32_t*		pixels;			// BGRA8 frame of the software renderer, owned by the renderer
+	int					pixelsWidth;
+	int					pixelsHeight;
+#endif
 
+	bool				waitForVSync;
 	bool				hasFocus;
 	bool				hasTracking;
 	bool				hasSizeChanged;
@@ -140,7 +162,11 @@ struct ImAppThread
 
 static void					imappPlatformSetupKeyboard( ImAppPlatform* platform );
 
-static HGLRC				imappPlatformWindowCreateGlContext( HDC windowDc );
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+static void					imappPlatformWindowPresentPixels( ImAppWindow* window, int x, int y, int width, int height );
+#elif IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+static bool					imappPlatformWindowSetGlPixelFormat( HDC windowDc );
+#endif
 static void					imappPlatformWindowUpdateController( ImAppWindow* window );
 static LRESULT CALLBACK		imappPlatformWindowProc( HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam );
 static ImUiInputKey			imappPlatformWindowMapKey( ImAppWindow* window, WPARAM wParam, LPARAM lParam );
@@ -261,6 +287,7 @@ bool imappPlatformInitialize( ImAppPlatform* platform, ImUiAllocator* allocator,
 		platform->fontBasePathLength += IMAPP_ARRAY_COUNT( fontsPath ) - 1u;
 	}
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
 	// dummy GL context
 	{
 		WNDCLASSEXW windowClass = { 0 };
@@ -286,7 +313,13 @@ bool imappPlatformInitialize( ImAppPlatform* platform, ImUiAllocator* allocator,
 
 		platform->contextDc = GetDC( platform->contextHwnd );
 
-		platform->contextGlrc = imappPlatformWindowCreateGlContext( platform->contextDc );
+		// all windows render with this context, they only need the same pixel format
+		if( !imappPlatformWindowSetGlPixelFormat( platform->contextDc ) )
+		{
+			return false;
+		}
+
+		platform->contextGlrc = wglCreateContext( platform->contextDc );
 		if( !platform->contextGlrc )
 		{
 			IMAPP_DEBUG_LOGE( "Failed to create GL dummy GL context." );
@@ -298,7 +331,11 @@ bool imappPlatformInitialize( ImAppPlatform* platform, ImUiAllocator* allocator,
 			IMAPP_DEBUG_LOGE( "Failed to activate dummy GL context." );
 			return false;
 		}
+
+		platform->wglSwapInterval	= (ImAppWglSwapIntervalFunc)wglGetProcAddress( "wglSwapIntervalEXT" );
+		platform->swapInterval		= -1;
 	}
+#endif
 
 	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( platform->cursors ); ++i )
 	{
@@ -378,6 +415,20 @@ bool imappPlatformInitialize( ImAppPlatform* platform, ImUiAllocator* allocator,
 	QueryPerformanceFrequency( &performanceCounterFrequency );
 	platform->tickFrequency = performanceCounterFrequency.QuadPart;
 
+	platform->wakeEvent = CreateEventW( NULL, FALSE, FALSE, NULL );
+	if( !platform->wakeEvent )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to create wake up event." );
+		return false;
+	}
+
+	// high resolution timers exist since Windows 10 1803, the others wait in steps of the system timer
+	platform->tickTimer = CreateWaitableTimerExW( NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS );
+	if( !platform->tickTimer )
+	{
+		platform->tickTimer = CreateWaitableTimerW( NULL, FALSE, NULL );
+	}
+
 	return true;
 }
 
@@ -389,6 +440,7 @@ void imappPlatformShutdown( ImAppPlatform* platform )
 		platform->cursors[ i ] = NULL;
 	}
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
 	if( platform->contextGlrc )
 	{
 		wglMakeCurrent( NULL, NULL );
@@ -404,6 +456,19 @@ void imappPlatformShutdown( ImAppPlatform* platform )
 		DestroyWindow( platform->contextHwnd );
 		platform->contextHwnd = NULL;
 	}
+#endif
+
+	if( platform->tickTimer )
+	{
+		CloseHandle( platform->tickTimer );
+		platform->tickTimer = NULL;
+	}
+
+	if( platform->wakeEvent )
+	{
+		CloseHandle( platform->wakeEvent );
+		platform->wakeEvent = NULL;
+	}
 
 	OleUninitialize();
 
@@ -413,8 +478,6 @@ void imappPlatformShutdown( ImAppPlatform* platform )
 
 sint64 imappPlatformTick( ImAppPlatform* platform, sint64 lastTickValue, sint64 tickIntervalMs )
 {
-	IMAPP_USE( platform );
-
 #if IMAPP_ENABLED( IMAPP_LIVEPP )
 	imappLivePlusPlusUpdate();
 #endif
@@ -422,28 +485,85 @@ sint64 imappPlatformTick( ImAppPlatform* platform, sint64 lastTickValue, sint64
 	LARGE_INTEGER currentPerformanceCounterValue;
 	QueryPerformanceCounter( &currentPerformanceCounterValue );
 
-	const sint64 deltaTicksMs	= (currentPerformanceCounterValue.QuadPart - lastTickValue) / (platform->tickFrequency / 1000);
-	sint64 waitTicks			= IMUI_MAX( tickIntervalMs, deltaTicksMs ) - deltaTicksMs;
+	if( tickIntervalMs == 0 )
+	{
+		MsgWaitForMultipleObjects( 1, &platform->wakeEvent, FALSE, INFINITE, QS_ALLEVENTS );
+		QueryPerformanceCounter( &currentPerformanceCounterValue );
+		return currentPerformanceCounterValue.QuadPart;
+	}
 
-	if( tickIntervalMs == 0u )
+	const sint64 nextTick	= lastTickValue + ((tickIntervalMs * platform->tickFrequency) / 1000);
+	const sint64 spinTicks	= (IMAPP_PLATFORM_WINDOWS_SPIN_US * platform->tickFrequency) / 1000000;
+	const sint64 waitTicks	= nextTick - currentPerformanceCounterValue.QuadPart - spinTicks;
+	if( waitTicks > 0 )
 	{
-		waitTicks = INFINITE;
+		// the timer wakes close to the deadline, the rest is spun
+		HANDLE handles[ 2u ] = { platform->wakeEvent, platform->tickTimer };
+		DWORD handleCount	= 1u;
+		DWORD timeoutMs		= (DWORD)((waitTicks * 1000) / platform->tickFrequency);
+		if( platform->tickTimer )
+		{
+			LARGE_INTEGER dueTime;
+			dueTime.QuadPart = -((waitTicks * 10000000) / platform->tickFrequency);	// relative in 100ns
+
+			SetWaitableTimer( platform->tickTimer, &dueTime, 0, NULL, NULL, FALSE );
+			handleCount	= 2u;
+			timeoutMs	= INFINITE;
+		}
+
+		const DWORD waitResult = MsgWaitForMultipleObjects( handleCount, handles, FALSE, timeoutMs, QS_ALLEVENTS );
+		if( waitResult != WAIT_OBJECT_0 + 1u &&
+			waitResult != WAIT_TIMEOUT )
+		{
+			// input or a wake up, no need to hit the deadline
+			if( platform->tickTimer )
+			{
+				CancelWaitableTimer( platform->tickTimer );
+			}
+
+			QueryPerformanceCounter( &currentPerformanceCounterValue );
+			return currentPerformanceCounterValue.QuadPart;
+		}
 	}
 
-	if( waitTicks > 1u )
+	do
 	{
-		MsgWaitForMultipleObjects( 0, NULL, FALSE, (DWORD)waitTicks - 1u, QS_ALLEVENTS );
 		QueryPerformanceCounter( &currentPerformanceCounterValue );
 	}
+	while( currentPerformanceCounterValue.QuadPart < nextTick );
 
 	return currentPerformanceCounterValue.QuadPart;
 }
 
+void imappPlatformWakeUp( ImAppPlatform* platform )
+{
+	// auto reset, the wait consumes it
+	SetEvent( platform->wakeEvent );
+}
+
+void imappPlatformWaitForVSync( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+
+	// DWM composes once per vertical blank, like a swap with interval
+	DwmFlush();
+}
+
 double imappPlatformTicksToSeconds( ImAppPlatform* platform, sint64 tickValue )
 {
 	return tickValue / (double)platform->tickFrequency;
 }
 
+sint64 imappPlatformGetTickValue( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+
+	LARGE_INTEGER currentPerformanceCounterValue;
+	QueryPerformanceCounter( &currentPerformanceCounterValue );
+
+	return currentPerformanceCounterValue.QuadPart;
+}
+
 void imappPlatformShowError( ImAppPlatform* platform, const char* message )
 {
 	IMAPP_USE( platform );
@@ -674,10 +794,11 @@ ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const ImAppWind
 		return NULL;
 	}
 
-	window->platform	= platform;
-	window->hasFocus	= true;
-	window->state		= parameters->state;
-	window->style		= parameters->style;
+	window->platform		= platform;
+	window->hasFocus		= true;
+	window->waitForVSync	= true;
+	window->state			= parameters->state;
+	window->style			= parameters->style;
 
 	window->titleHeight = 32;
 
@@ -794,21 +915,14 @@ ImAppWindow* imappPlatformWindowCreate( ImAppPlatform* platform, const ImAppWind
 		IMAPP_DEBUG_LOGW( "Failed to register drop target. Result: 0x%08x", dropRegisterResult );
 	}
 
-	// create GL context
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	// the window renders with the context of the platform, no context and no resources per window
+	if( !imappPlatformWindowSetGlPixelFormat( window->hdc ) )
 	{
-		window->hglrc = imappPlatformWindowCreateGlContext( window->hdc );
-		if( !window->hglrc )
-		{
-			IMAPP_DEBUG_LOGE( "Failed to create GL context." );
-			return false;
-		}
-
-		if( !wglShareLists( window->platform->contextGlrc, window->hglrc ) )
-		{
-			IMAPP_DEBUG_LOGE( "Failed to share GL context." );
-			return false;
-		}
+		imappPlatformWindowDestroy( window );
+		return NULL;
 	}
+#endif
 
 	return window;
 }
@@ -833,13 +947,13 @@ void imappPlatformWindowDestroy( ImAppWindow* window )
 
 	imappEventQueueDestruct( &window->eventQueue );
 
-	if( window->hglrc )
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	if( window->hdc && wglGetCurrentDC() == window->hdc )
 	{
+		// keep the shared context current without the surface of the window
 		wglMakeCurrent( window->platform->contextDc, window->platform->contextGlrc );
-
-		wglDeleteContext( window->hglrc );
-		window->hglrc = NULL;
 	}
+#endif
 
 	if( window->hwnd )
 	{
@@ -858,7 +972,8 @@ void imappPlatformWindowDestroy( ImAppWindow* window )
 	ImUiMemoryFree( window->platform->allocator, window );
 }
 
-static HGLRC imappPlatformWindowCreateGlContext( HDC windowDc )
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+static bool imappPlatformWindowSetGlPixelFormat( HDC windowDc )
 {
 	PIXELFORMATDESCRIPTOR pixelFormat;
 	ZeroMemory( &pixelFormat, sizeof( pixelFormat ) );
@@ -874,12 +989,36 @@ static HGLRC imappPlatformWindowCreateGlContext( HDC windowDc )
 	if( !SetPixelFormat( windowDc, format, &pixelFormat ) )
 	{
 		IMAPP_DEBUG_LOGE( "Failed to set pixel format." );
-		return NULL;
+		return false;
 	}
 
-	return wglCreateContext( windowDc );
+	return true;
+}
+
+bool imappPlatformAcquireGlContext( ImAppPlatform* platform )
+{
+	// the dummy window has the pixel format of all windows
+	return wglMakeCurrent( platform->contextDc, platform->contextGlrc ) != FALSE;
+}
+
+void imappPlatformReleaseGlContext( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+	wglMakeCurrent( NULL, NULL );
+}
+#else
+bool imappPlatformAcquireGlContext( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+	return false;
 }
 
+void imappPlatformReleaseGlContext( ImAppPlatform* platform )
+{
+	IMAPP_USE( platform );
+}
+#endif
+
 ImAppWindowDeviceState imappPlatformWindowGetGlContextState( const ImAppWindow* window )
 {
 	IMAPP_USE( window );
@@ -915,26 +1054,126 @@ void imappPlatformWindowUpdate( ImAppWindow* window, ImAppPlatformWindowUpdateCa
 
 bool imappPlatformWindowBeginRender( ImAppWindow* window )
 {
-	if( !wglMakeCurrent( window->hdc, window->hglrc ) )
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	if( !wglMakeCurrent( window->hdc, window->platform->contextGlrc ) )
 	{
 		IMAPP_DEBUG_LOGE( "Failed to activate GL context." );
 		return false;
 	}
+#else
+	// the renderer draws into its own memory or swapchain
+	IMAPP_USE( window );
+#endif
 
 	return true;
 }
 
-bool imappPlatformWindowEndRender( ImAppWindow* window )
+int imappPlatformWindowGetBufferAge( const ImAppWindow* window )
+{
+	IMAPP_USE( window );
+
+	// WGL doesn't tell if the back buffer got swapped or copied
+	return 0;
+}
+
+void imappPlatformWindowSetPixels( ImAppWindow* window, const uint32_t* pixels, int width, int height )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+	window->pixels			= pixels;
+	window->pixelsWidth		= width;
+	window->pixelsHeight	= height;
+#else
+	IMAPP_USE( window );
+	IMAPP_USE( pixels );
+	IMAPP_USE( width );
+	IMAPP_USE( height );
+#endif
+}
+
+bool imappPlatformWindowEndRender( ImAppWindow* window, bool present, const ImUiRect* damageRect )
 {
+	if( !present )
+	{
+		return true;
+	}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+	if( window->pixels == NULL )
+	{
+		return false;
+	}
+
+	// only the damage goes through GDI, the window keeps the rest
+	if( damageRect )
+	{
+		imappPlatformWindowPresentPixels( window, (int)damageRect->pos.x, (int)damageRect->pos.y, (int)damageRect->size.width, (int)damageRect->size.height );
+	}
+	else
+	{
+		imappPlatformWindowPresentPixels( window, 0, 0, window->pixelsWidth, window->pixelsHeight );
+	}
+#elif IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+	IMAPP_USE( damageRect );
+
+	// the interval is state of the shared context, DWM composes windows without tearing
+	ImAppPlatform* platform = window->platform;
+	const int swapInterval = window->waitForVSync ? 1 : 0;
+	if( platform->wglSwapInterval &&
+		platform->swapInterval != swapInterval )
+	{
+		platform->wglSwapInterval( swapInterval );
+		platform->swapInterval = swapInterval;
+	}
+
 	if( !wglSwapLayerBuffers( window->hdc, WGL_SWAP_MAIN_PLANE ) )
 	{
 		IMAPP_DEBUG_LOGE( "Failed to present." );
 		return false;
 	}
+#else
+	// the renderer presents its swapchain
+	IMAPP_USE( window );
+	IMAPP_USE( damageRect );
+#endif
 
 	return true;
 }
 
+void imappPlatformWindowSetVSync( ImAppWindow* window, bool wait )
+{
+	window->waitForVSync = wait;
+}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+static void imappPlatformWindowPresentPixels( ImAppWindow* window, int x, int y, int width, int height )
+{
+	const int left		= IMUI_MAX( x, 0 );
+	const int top		= IMUI_MAX( y, 0 );
+	const int right		= IMUI_MIN( x + width, window->pixelsWidth );
+	const int bottom	= IMUI_MIN( y + height, window->pixelsHeight );
+	if( left >= right || top >= bottom )
+	{
+		return;
+	}
+
+	// rows of the rect as top down DIB, so the source offset doesn't depend on the DIB orientation
+	BITMAPINFO bitmapInfo;
+	ZeroMemory( &bitmapInfo, sizeof( bitmapInfo ) );
+	bitmapInfo.bmiHeader.biSize			= sizeof( bitmapInfo.bmiHeader );
+	bitmapInfo.bmiHeader.biWidth		= window->pixelsWidth;
+	bitmapInfo.bmiHeader.biHeight		= -(bottom - top);
+	bitmapInfo.bmiHeader.biPlanes		= 1;
+	bitmapInfo.bmiHeader.biBitCount		= 32;
+	bitmapInfo.bmiHeader.biCompression	= BI_RGB;
+
+	const uint32_t* rows = window->pixels + ((uintsize)top * (uintsize)window->pixelsWidth);
+	if( !SetDIBitsToDevice( window->hdc, left, top, (DWORD)(right - left), (DWORD)(bottom - top), left, 0, 0u, (UINT)(bottom - top), rows, &bitmapInfo, DIB_RGB_COLORS ) )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to present." );
+	}
+}
+#endif
+
 ImAppEventQueue* imappPlatformWindowGetEventQueue( ImAppWindow* window )
 {
 	return &window->eventQueue;
@@ -972,6 +1211,18 @@ bool imappPlatformWindowHasFocus( const ImAppWindow* window )
 	return window->hasFocus;
 }
 
+bool imappPlatformWindowIsHidden( const ImAppWindow* window )
+{
+	if( IsIconic( window->hwnd ) )
+	{
+		return true;
+	}
+
+	// cloaked by DWM, e.g. on another virtual desktop
+	DWORD cloaked = 0u;
+	return SUCCEEDED( DwmGetWindowAttribute( window->hwnd, DWMWA_CLOAKED, &cloaked, sizeof( cloaked ) ) ) && cloaked != 0u;
+}
+
 void imappPlatformWindowGetSize( const ImAppWindow* window, int* outWidth, int* outHeight )
 {
 	*outWidth	= window->width;
@@ -1066,6 +1317,40 @@ void imappPlatformWindowClose( ImAppWindow* window )
 	SendMessage( window->hwnd, WM_CLOSE, 0, 0 );
 }
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_VULKAN )
+static const char* const s_vulkanInstanceExtensions[] =
+{
+	VK_KHR_SURFACE_EXTENSION_NAME,
+	VK_KHR_WIN32_SURFACE_EXTENSION_NAME
+};
+
+const char* const* imappPlatformGetVulkanInstanceExtensions( ImAppPlatform* platform, uint32_t* outCount )
+{
+	IMAPP_USE( platform );
+
+	*outCount = IMAPP_ARRAY_COUNT( s_vulkanInstanceExtensions );
+	return s_vulkanInstanceExtensions;
+}
+
+bool imappPlatformWindowCreateVulkanSurface( ImAppWindow* window, VkInstance instance, VkSurfaceKHR* outSurface )
+{
+	VkWin32SurfaceCreateInfoKHR createInfo;
+	ZeroMemory( &createInfo, sizeof( createInfo ) );
+	createInfo.sType		= VK_STRUCTURE_TYPE_WIN32_SURFACE_CREATE_INFO_KHR;
+	createInfo.hinstance	= window->platform->hInstance;
+	createInfo.hwnd			= window->hwnd;
+
+	const VkResult result = vkCreateWin32SurfaceKHR( instance, &createInfo, NULL, outSurface );
+	if( result != VK_SUCCESS )
+	{
+		IMAPP_DEBUG_LOGE( "Failed to create Vulkan surface. Result: %d", result );
+		return false;
+	}
+
+	return true;
+}
+#endif
+
 static const WORD s_controllerButtonsXInput[] =
 {
 	XINPUT_GAMEPAD_DPAD_UP,
@@ -1263,6 +1548,17 @@ static LRESULT CALLBACK imappPlatformWindowProc( HWND hWnd, UINT message, WPARAM
 		{
 			window->updateCallback( window, window->updateCallbackArg );
 		}
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+		else if( window->pixels )
+		{
+			// unchanged frames are not presented again, restore exposed parts from the last one
+			PAINTSTRUCT paint;
+			BeginPaint( hWnd, &paint );
+			imappPlatformWindowPresentPixels( window, paint.rcPaint.left, paint.rcPaint.top, paint.rcPaint.right - paint.rcPaint.left, paint.rcPaint.bottom - paint.rcPaint.top );
+			EndPaint( hWnd, &paint );
+			return 0;
+		}
+#endif
 		break;
 
 	case WM_NCACTIVATE:
@@ -2018,6 +2314,28 @@ void imappPlatformResourceFree( ImAppPlatform* platform, ImAppBlob blob )
 	ImUiMemoryFree( platform->allocator, blob.data );
 }
 
+bool imappPlatformGetCachePath( ImAppPlatform* platform, char* outPath, uintsize pathCapacity, const char* fileName )
+{
+	IMAPP_USE( platform );
+
+	char localAppDataPath[ MAX_PATH ];
+	const DWORD localAppDataLength = GetEnvironmentVariableA( "LOCALAPPDATA", localAppDataPath, sizeof( localAppDataPath ) );
+	if( localAppDataLength == 0u || localAppDataLength >= sizeof( localAppDataPath ) )
+	{
+		return false;
+	}
+
+	const int directoryLength = snprintf( outPath, pathCapacity, "%s\\imapp", localAppDataPath );
+	if( directoryLength < 0 || (uintsize)directoryLength >= pathCapacity ||
+		(!CreateDirectoryA( outPath, NULL ) && GetLastError() != ERROR_ALREADY_EXISTS) )
+	{
+		return false;
+	}
+
+	const int fileNameLength = snprintf( outPath + directoryLength, pathCapacity - (uintsize)directoryLength, "\\%s", fileName );
+	return fileNameLength >= 0 && (uintsize)(directoryLength + fileNameLength) < pathCapacity;
+}
+
 ImAppFileWatcher* imappPlatformFileWatcherCreate( ImAppPlatform* platform )
 {
 	ImAppFileWatcher* watcher = IMUI_MEMORY_NEW( platform->allocator, ImAppFileWatcher );
@@ -0,0 +1,339 @@
+#include "imapp_render_thread.h"
+
+#if IMAPP_ENABLED( IMAPP_RENDER_THREAD )
+
+#include "imapp_debug.h"
+#include "imapp_internal.h"
+#include "imapp_platform.h"
+#include "imapp_renderer.h"
+
+#include <string.h>
+
+typedef struct ImAppRenderThreadWindow
+{
+	ImAppWindow*				window;
+	ImAppRendererWindow*		rendererWindow;
+	bool						construct;
+	bool						draw;				// false: keep the last presented frame
+	bool						waitForVSync;
+	int							width;
+	int							height;
+	float						clearColor[ 4u ];
+	ImUiRect					cacheRects[ IMAPP_RENDERER_MAX_CACHE_ENTRIES ];
+	uintsize					cacheRectCount;
+	ImAppRendererDrawPacket		packet;
+} ImAppRenderThreadWindow;
+
+typedef struct ImAppRenderThreadFrame
+{
+	ImAppRenderThreadWindow*	windows;			// packet buffers are kept for the next frames
+	uintsize					windowCapacity;
+	uintsize					windowCount;
+} ImAppRenderThreadFrame;
+
+struct ImAppRenderThread
+{
+	ImUiAllocator*				allocator;
+	ImAppPlatform*				platform;
+	ImAppRenderer*				renderer;
+
+	ImAppThread*				thread;
+	ImAppMutex*					contextMutex;
+	ImAppSemaphore*				queuedSemaphore;	// frames waiting for the render thread
+	ImAppSemaphore*				freeSemaphore;		// frames which can be filled by the main thread
+	bool						stop;
+
+	ImAppRenderThreadFrame		frames[ IMAPP_RENDER_THREAD_FRAME_COUNT ];
+	uintsize					fillIndex;			// main thread
+	bool						isFilling;
+	uintsize					drawIndex;			// render thread
+};
+
+static void		imappRenderThreadEntry( void* arg );
+static bool		imappRenderThreadDrawWindow( ImAppRenderThread* thread, ImAppRenderThreadWindow* renderWindow );
+static bool		imappRenderThreadCopyDrawData( ImAppRenderThread* thread, ImAppRendererDrawPacket* packet, ImUiSurface* surface );
+
+ImAppRenderThread* imappRenderThreadCreate( ImUiAllocator* allocator, ImAppPlatform* platform, ImAppRenderer* renderer )
+{
+	ImAppRenderThread* thread = IMUI_MEMORY_NEW_ZERO( allocator, ImAppRenderThread );
+	if( thread == NULL )
+	{
+		return NULL;
+	}
+
+	thread->allocator	= allocator;
+	thread->platform	= platform;
+	thread->renderer	= renderer;
+
+	thread->contextMutex	= imappPlatformMutexCreate( platform );
+	thread->queuedSemaphore	= imappPlatformSemaphoreCreate( platform );
+	thread->freeSemaphore	= imappPlatformSemaphoreCreate( platform );
+	if( !thread->contextMutex || !thread->queuedSemaphore || !thread->freeSemaphore )
+	{
+		imappRenderThreadDestroy( thread );
+		return NULL;
+	}
+
+	for( uintsize i = 0u; i < IMAPP_RENDER_THREAD_FRAME_COUNT; ++i )
+	{
+		imappPlatformSemaphoreInc( thread->freeSemaphore );
+	}
+
+	// the other thread needs to take the context without a window
+	if( !imappPlatformAcquireGlContext( platform ) )
+	{
+		ImAppTrace( "[imapp] The GL context can't be handed to an other thread. Rendering on the main thread.\n" );
+		imappRenderThreadDestroy( thread );
+		return NULL;
+	}
+
+	imappPlatformReleaseGlContext( platform );
+	imappRendererSetContextMutex( renderer, thread->contextMutex );
+
+	thread->thread = imappPlatformThreadCreate( platform, "imapp render", imappRenderThreadEntry, thread );
+	if( thread->thread == NULL )
+	{
+		ImAppTrace( "[imapp] Failed to create render thread. Rendering on the main thread.\n" );
+		imappRenderThreadDestroy( thread );
+		return NULL;
+	}
+
+	return thread;
+}
+
+void imappRenderThreadDestroy( ImAppRenderThread* thread )
+{
+	if( thread->thread != NULL )
+	{
+		imappRenderThreadWaitIdle( thread );
+
+		thread->stop = true;
+		imappPlatformSemaphoreInc( thread->queuedSemaphore );
+
+		imappPlatformThreadDestroy( thread->thread );
+		thread->thread = NULL;
+	}
+
+	if( thread->contextMutex != NULL )
+	{
+		// back to the main thread
+		imappPlatformAcquireGlContext( thread->platform );
+		imappRendererSetContextMutex( thread->renderer, NULL );
+
+		imappPlatformMutexDestroy( thread->platform, thread->contextMutex );
+		thread->contextMutex = NULL;
+	}
+
+	if( thread->freeSemaphore != NULL )
+	{
+		imappPlatformSemaphoreDestroy( thread->platform, thread->freeSemaphore );
+		thread->freeSemaphore = NULL;
+	}
+
+	if( thread->queuedSemaphore != NULL )
+	{
+		imappPlatformSemaphoreDestroy( thread->platform, thread->queuedSemaphore );
+		thread->queuedSemaphore = NULL;
+	}
+
+	for( uintsize i = 0u; i < IMAPP_RENDER_THREAD_FRAME_COUNT; ++i )
+	{
+		ImAppRenderThreadFrame* frame = &thread->frames[ i ];
+		for( uintsize j = 0u; j < frame->windowCapacity; ++j )
+		{
+			ImAppRendererDrawPacket* packet = &frame->windows[ j ].packet;
+			IMUI_MEMORY_ARRAY_FREE( thread->allocator, packet->commands, packet->commandCapacity );
+			IMUI_MEMORY_ARRAY_FREE( thread->allocator, packet->vertexData, packet->vertexCapacity );
+			IMUI_MEMORY_ARRAY_FREE( thread->allocator, packet->indexData, packet->indexCapacity );
+		}
+
+		IMUI_MEMORY_ARRAY_FREE( thread->allocator, frame->windows, frame->windowCapacity );
+	}
+
+	ImUiMemoryFree( thread->allocator, thread );
+}
+
+void imappRenderThreadLock( ImAppRenderThread* thread )
+{
+	imappPlatformMutexLock( thread->contextMutex );
+}
+
+void imappRenderThreadUnlock( ImAppRenderThread* thread )
+{
+	imappPlatformMutexUnlock( thread->contextMutex );
+}
+
+void imappRenderThreadWaitIdle( ImAppRenderThread* thread )
+{
+	// all frames are free when nothing is queued or drawing, except the one getting filled
+	const uintsize frameCount = IMAPP_RENDER_THREAD_FRAME_COUNT - (thread->isFilling ? 1u : 0u);
+	for( uintsize i = 0u; i < frameCount; ++i )
+	{
+		imappPlatformSemaphoreDec( thread->freeSemaphore, true );
+	}
+
+	for( uintsize i = 0u; i < frameCount; ++i )
+	{
+		imappPlatformSemaphoreInc( thread->freeSemaphore );
+	}
+}
+
+void imappRenderThreadBeginFrame( ImAppRenderThread* thread )
+{
+	IMAPP_ASSERT( !thread->isFilling );
+
+	imappPlatformSemaphoreDec( thread->freeSemaphore, true );
+
+	thread->frames[ thread->fillIndex ].windowCount = 0u;
+	thread->isFilling = true;
+}
+
+bool imappRenderThreadAddWindow( ImAppRenderThread* thread, ImAppContextWindowInfo* windowInfo, ImUiSurface* surface, int width, int height )
+{
+	IMAPP_ASSERT( thread->isFilling );
+
+	ImAppRenderThreadFrame* frame = &thread->frames[ thread->fillIndex ];
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY_ZERO( thread->allocator, frame->windows, frame->windowCapacity, frame->windowCount + 1u ) )
+	{
+		return false;
+	}
+
+	ImAppRenderThreadWindow* renderWindow = &frame->windows[ frame->windowCount ];
+	if( surface != NULL &&
+		!imappRenderThreadCopyDrawData( thread, &renderWindow->packet, surface ) )
+	{
+		return false;
+	}
+
+	renderWindow->window			= windowInfo->window;
+	renderWindow->rendererWindow	= windowInfo->rendererWindow;
+	renderWindow->construct			= !windowInfo->isRendererCreated;
+	renderWindow->draw				= surface != NULL;
+	renderWindow->waitForVSync		= windowInfo->waitForVSync;
+	renderWindow->width				= width;
+	renderWindow->height			= height;
+	renderWindow->cacheRectCount	= windowInfo->cacheRectCount;
+	memcpy( renderWindow->clearColor, windowInfo->clearColor, sizeof( renderWindow->clearColor ) );
+	memcpy( renderWindow->cacheRects, windowInfo->cacheRects, sizeof( renderWindow->cacheRects[ 0u ] ) * windowInfo->cacheRectCount );
+
+	frame->windowCount++;
+	return true;
+}
+
+void imappRenderThreadEndFrame( ImAppRenderThread* thread )
+{
+	IMAPP_ASSERT( thread->isFilling );
+
+	thread->fillIndex = (thread->fillIndex + 1u) % IMAPP_RENDER_THREAD_FRAME_COUNT;
+	thread->isFilling = false;
+
+	imappRendererQueueFrame( thread->renderer );
+	imappPlatformSemaphoreInc( thread->queuedSemaphore );
+}
+
+static void imappRenderThreadEntry( void* arg )
+{
+	ImAppRenderThread* thread = (ImAppRenderThread*)arg;
+
+	while( true )
+	{
+		imappPlatformSemaphoreDec( thread->queuedSemaphore, true );
+		if( thread->stop )
+		{
+			break;
+		}
+
+		ImAppRenderThreadFrame* frame = &thread->frames[ thread->drawIndex ];
+		thread->drawIndex = (thread->drawIndex + 1u) % IMAPP_RENDER_THREAD_FRAME_COUNT;
+
+		imappPlatformMutexLock( thread->contextMutex );
+
+		bool hasWaitedForVSync = false;
+		for( uintsize i = 0u; i < frame->windowCount; ++i )
+		{
+			hasWaitedForVSync |= imappRenderThreadDrawWindow( thread, &frame->windows[ i ] );
+		}
+
+		if( frame->windowCount == 0u )
+		{
+			// retired textures get deleted with the context
+			imappPlatformAcquireGlContext( thread->platform );
+		}
+
+		imappRendererFinishFrame( thread->renderer );
+
+		imappPlatformReleaseGlContext( thread->platform );
+		imappPlatformMutexUnlock( thread->contextMutex );
+
+		// no window with damage waited in its present, the next frame must not start right away
+		if( frame->windowCount > 0u && !hasWaitedForVSync )
+		{
+			imappPlatformWaitForVSync( thread->platform );
+		}
+
+		imappPlatformSemaphoreInc( thread->freeSemaphore );
+	}
+}
+
+// Returns true when the present waited for the vertical blank.
+static bool imappRenderThreadDrawWindow( ImAppRenderThread* thread, ImAppRenderThreadWindow* renderWindow )
+{
+	imappPlatformWindowBeginRender( renderWindow->window );
+
+	if( renderWindow->construct )
+	{
+		imappRendererConstructWindow( thread->renderer, renderWindow->rendererWindow, renderWindow->window );
+	}
+
+	for( uintsize i = 0u; i < renderWindow->cacheRectCount; ++i )
+	{
+		imappRendererWindowRequestCache( renderWindow->rendererWindow, renderWindow->cacheRects[ i ] );
+	}
+
+	// nothing drawn, the back buffer has no frame to present
+	bool present = false;
+	ImUiRect damageRect;
+	ImUiRect* presentRect = NULL;
+	if( renderWindow->draw )
+	{
+		const int bufferAge = imappPlatformWindowGetBufferAge( renderWindow->window );
+		present = imappRendererDrawPacket( thread->renderer, renderWindow->rendererWindow, &renderWindow->packet, renderWindow->width, renderWindow->height, renderWindow->clearColor, bufferAge, &damageRect );
+		presentRect = &damageRect;
+	}
+
+	imappPlatformWindowSetVSync( renderWindow->window, renderWindow->waitForVSync );
+	imappPlatformWindowEndRender( renderWindow->window, present, presentRect );
+
+	return present && renderWindow->waitForVSync;
+}
+
+static bool imappRenderThreadCopyDrawData( ImAppRenderThread* thread, ImAppRendererDrawPacket* packet, ImUiSurface* surface )
+{
+	uintsize vertexDataSize = 0u;
+	uintsize indexDataSize = 0u;
+	ImUiSurfaceGetMaxBufferSizes( surface, &vertexDataSize, &indexDataSize );
+
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( thread->allocator, packet->vertexData, packet->vertexCapacity, vertexDataSize ) ||
+		!IMUI_MEMORY_ARRAY_CHECK_CAPACITY( thread->allocator, packet->indexData, packet->indexCapacity, indexDataSize ) )
+	{
+		return false;
+	}
+
+	const ImUiDrawData* drawData = ImUiSurfaceGenerateDrawData( surface, packet->vertexData, &vertexDataSize, packet->indexData, &indexDataSize );
+	if( drawData == NULL ||
+		!IMUI_MEMORY_ARRAY_CHECK_CAPACITY( thread->allocator, packet->commands, packet->commandCapacity, drawData->commandCount ) )
+	{
+		return false;
+	}
+
+	// commands belong to the ImUi frame
+	memcpy( packet->commands, drawData->commands, sizeof( *packet->commands ) * drawData->commandCount );
+
+	packet->drawData			= *drawData;
+	packet->drawData.commands	= packet->commands;
+	packet->vertexDataSize		= vertexDataSize;
+	packet->indexDataSize		= indexDataSize;
+	return true;
+}
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "imapp/imapp.h"
+
+#include "imapp_defines.h"
+#include "imapp_types.h"
+
+#include <stdbool.h>
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL ) && IMAPP_DISABLED( IMAPP_PLATFORM_WEB )
+#	define IMAPP_RENDER_THREAD				TIKI_ON
+#else
+#	define IMAPP_RENDER_THREAD				TIKI_OFF
+#endif
+
+#define IMAPP_RENDER_THREAD_FRAME_COUNT		2u		// one frame gets built while the other one draws
+
+typedef struct ImAppContextWindowInfo ImAppContextWindowInfo;
+typedef struct ImAppPlatform ImAppPlatform;
+typedef struct ImAppRenderer ImAppRenderer;
+typedef struct ImAppRenderThread ImAppRenderThread;
+typedef struct ImUiAllocator ImUiAllocator;
+typedef struct ImUiSurface ImUiSurface;
+
+// Draws and presents frames while the main thread builds the next one. Rules while it runs:
+// - The GL context is current on one thread at a time, guarded by the context lock of the renderer. The render thread holds it
+//   for a whole frame. Texture functions and imappRendererUpdate borrow it on the main thread and wait for a running frame.
+// - Draw data gets copied out of the ImUi frame and drawn in order. Destroyed textures stay alive until the frames which can
+//   reference them are finished.
+// - Windows, their renderer state and the device resources only change on the main thread while the render thread is idle.
+
+ImAppRenderThread*	imappRenderThreadCreate( ImUiAllocator* allocator, ImAppPlatform* platform, ImAppRenderer* renderer );	// NULL when the context can't be handed over
+void				imappRenderThreadDestroy( ImAppRenderThread* thread );		// the context is current on the calling thread again
+
+void				imappRenderThreadLock( ImAppRenderThread* thread );			// keeps the render thread from drawing, without the context
+void				imappRenderThreadUnlock( ImAppRenderThread* thread );
+void				imappRenderThreadWaitIdle( ImAppRenderThread* thread );
+
+void				imappRenderThreadBeginFrame( ImAppRenderThread* thread );	// waits for a free frame
+bool				imappRenderThreadAddWindow( ImAppRenderThread* thread, ImAppContextWindowInfo* windowInfo, ImUiSurface* surface, int width, int height );	// surface NULL: present without drawing
+void				imappRenderThreadEndFrame( ImAppRenderThread* thread );		// hands the frame to the render thread
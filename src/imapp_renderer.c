@@ -1,16 +1,25 @@
 #include "imapp_renderer.h"
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+
 #include "imapp_debug.h"
 #include "imapp_internal.h"
+#include "imapp_livepp.h"
 #include "imapp_platform.h"
 #include "imapp_res_pak.h"
 
+#include <assert.h>
+#include <float.h>
+#include <limits.h>
+#include <stdio.h>
 #include <string.h>
 
 #if IMAPP_ENABLED( IMAPP_PLATFORM_WINDOWS )
 #	include <GL/glew.h>
-#elif IMAPP_ENABLED( IMAPP_PLATFORM_ANDROID )
+#elif IMAPP_ENABLED( IMAPP_PLATFORM_ANDROID ) || IMAPP_ENABLED( IMAPP_PLATFORM_HEADLESS ) || IMAPP_ENABLED( IMAPP_PLATFORM_WAYLAND )
+#	include <EGL/egl.h>
 #	include <GLES3/gl3.h>
+#	include <GLES2/gl2ext.h>
 #elif IMAPP_ENABLED( IMAPP_PLATFORM_WEB )
 #	include <GL/glew.h>
 #	include <GLES/gl.h>
@@ -21,44 +30,309 @@
 #	error "Platform not supported"
 #endif
 
+#if IMAPP_ENABLED( IMAPP_PLATFORM_ANDROID ) || IMAPP_ENABLED( IMAPP_PLATFORM_HEADLESS ) || IMAPP_ENABLED( IMAPP_PLATFORM_WAYLAND )
+#	define IMAPP_RENDERER_GLES			TIKI_ON
+#else
+#	define IMAPP_RENDERER_GLES			TIKI_OFF
+#endif
+
+#if IMAPP_ENABLED( IMAPP_PLATFORM_WEB )
+#	define IMAPP_RENDERER_STREAMING		TIKI_OFF
+#	define IMAPP_RENDERER_PROGRAM_CACHE	TIKI_OFF
+#else
+#	define IMAPP_RENDERER_STREAMING		TIKI_ON
+#	define IMAPP_RENDERER_PROGRAM_CACHE	TIKI_ON
+#endif
+
+// GLES has timer queries as extension loaded at runtime, WebGL only through the browser
+#if IMAPP_ENABLED( IMAPP_PLATFORM_WEB )
+#	define IMAPP_RENDERER_TIMER_QUERIES	TIKI_OFF
+#else
+#	define IMAPP_RENDERER_TIMER_QUERIES	TIKI_ON
+#endif
+
+// WebGL has no texture swizzle, alpha textures get expanded to RGBA
+#if IMAPP_ENABLED( IMAPP_PLATFORM_WEB )
+#	define IMAPP_RENDERER_TEXTURE_SWIZZLE	TIKI_OFF
+#else
+#	define IMAPP_RENDERER_TEXTURE_SWIZZLE	TIKI_ON
+#endif
+
+#define IMAPP_RENDERER_PROGRAM_CACHE_MAGIC	0x32504d49u	// 'IMP2'
+#define IMAPP_RENDERER_PROGRAM_SOURCE_SEED	0x9e3779b9u
+#define IMAPP_RENDERER_PIXEL_BUFFER_COUNT	4u
+
+enum
+{
+	ImAppRendererAttribute_Position,
+	ImAppRendererAttribute_TexCoord,
+	ImAppRendererAttribute_Color,
+	ImAppRendererAttribute_DrawInfo
+};
+
+// GPU timestamps written per measured frame
+typedef enum ImAppRendererTimestamp
+{
+	ImAppRendererTimestamp_Begin,
+	ImAppRendererTimestamp_Cleared,
+	ImAppRendererTimestamp_CacheFilled,
+	ImAppRendererTimestamp_End
+} ImAppRendererTimestamp;
+
+typedef enum ImAppRendererDrawMode
+{
+	ImAppRendererDrawMode_Color,
+	ImAppRendererDrawMode_Texture,
+	ImAppRendererDrawMode_Font,
+	ImAppRendererDrawMode_FontSdf
+} ImAppRendererDrawMode;
+
 typedef struct ImAppRendererShader
 {
+	GLuint						vertexShader;
 	GLuint						fragmentShader;
 	GLuint						program;
+	GLint						uniformProjection;
+	uint32						mask;
 } ImAppRendererShader;
 
+// File layout of a cached program binary, followed by driverInfoSize bytes of driver info and size bytes of binary data
+typedef struct ImAppRendererProgramCacheHeader
+{
+	uint32_t					magic;
+	uint32_t					key;
+	uint32_t					sourceHash;			// hashed with a different seed than key, both have to match
+	uint32_t					driverInfoSize;
+	uint32_t					format;
+	uint32_t					size;
+} ImAppRendererProgramCacheHeader;
+
+typedef struct ImAppRendererVertex
+{
+	float						position[ 2u ];
+	float						uv[ 2u ];
+	uint32_t					color;
+} ImAppRendererVertex;
+
+// GPU layout of ImAppRendererFlags_CompactBuffers, converted from ImAppRendererVertex
+typedef struct ImAppRendererCompactVertex
+{
+	int16_t						position[ 2u ];		// fixed point with IMAPP_RENDERER_COMPACT_POSITION_SCALE steps per pixel
+	uint16_t					uv[ 2u ];			// unorm16
+	uint32_t					color;
+} ImAppRendererCompactVertex;
+
+typedef struct ImAppRendererQuadInstance
+{
+	float						rect[ 4u ];			// left, top, right, bottom
+	uint16_t					uvRect[ 4u ];		// unorm16 uv of top left and bottom right corner
+	uint32_t					color;
+	uint8_t						drawInfo[ 4u ];
+} ImAppRendererQuadInstance;
+
+// A range of one draw command, a command can be split into quad instances and indexed geometry
+typedef struct ImAppRendererDrawItem
+{
+	uint32						commandIndex;
+	bool						instanced;
+	uintsize					first;				// element byte offset or first instance
+	uintsize					count;				// element or instance count
+} ImAppRendererDrawItem;
+
+typedef struct ImAppRendererBatch
+{
+	const ImAppRendererShader*	shader;
+	GLuint						texture;
+	GLuint						textureArray;		// 0: any array, no vertex of the batch samples one
+	bool						alphaBlend;
+	bool						instanced;
+	ImAppRendererCacheEntry*	cacheEntry;			// composite of a cached window instead of geometry
+	GLenum						topology;
+	GLint						scissor[ 4u ];
+	uintsize					first;
+	uintsize					count;
+} ImAppRendererBatch;
+
+typedef struct ImAppRendererFrame
+{
+	const ImUiDrawData*			drawData;
+	const ImAppRendererVertex*	vertices;			// CPU copy of the vertices, NULL when generated into GPU memory only
+	const uint32_t*				indices;			// CPU copy of the indices, NULL when generated into GPU memory only
+	uintsize					vertexCount;
+	uintsize					indexCount;
+	uintsize					vertexSize;			// size of a vertex in the vertex buffer
+	uintsize					indexSize;			// size of an index in the element buffer
+	uintsize					vertexOffset;
+	uintsize					elementOffset;
+	uintsize					drawInfoOffset;
+	uintsize					instanceOffset;
+	uintsize					itemCount;
+	int							width;
+	int							height;
+	GLint						redrawRect[ 4u ];	// x, y, width, height of the area to redraw, everything else stays from the last frames
+} ImAppRendererFrame;
+
+// Same sized textures of ImAppRendererFlags_TextureArrays share the layers of one RGBA8 array
+typedef struct ImAppRendererTextureArray
+{
+	GLuint						handle;
+	uint32						width;
+	uint32						height;
+	uint32						layerMask;			// used layers
+} ImAppRendererTextureArray;
+
+// GL storage of an ImAppRendererFormat. Uploads only use pairs drivers copy without conversion, rows are tightly packed.
+typedef struct ImAppRendererTextureFormat
+{
+	GLenum						internalFormat;
+	GLenum						uploadFormat;
+	uint32						uploadBytesPerPixel;
+	uint32						dataBytesPerPixel;	// of the source data, expanded to RGBA8 when it differs
+	bool						isAlphaSwizzled;	// red channel gets sampled as alpha
+} ImAppRendererTextureFormat;
+
+static const ImAppRendererTextureFormat s_textureFormats[] =
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_TEXTURE_SWIZZLE )
+	{ GL_R8,	GL_RED,		1u,	1u,	true },		// ImAppRendererFormat_R8
+#else
+	{ GL_RGBA8,	GL_RGBA,	4u,	1u,	false },	// ImAppRendererFormat_R8: expanded to (0, 0, 0, a)
+#endif
+	{ GL_RGBA8,	GL_RGBA,	4u,	3u,	false },	// ImAppRendererFormat_RGB8: padded to (r, g, b, 255)
+	{ GL_RGBA8,	GL_RGBA,	4u,	4u,	false }		// ImAppRendererFormat_RGBA8
+};
+static_assert( IMAPP_ARRAY_COUNT( s_textureFormats ) == ImAppRendererFormat_RGBA8 + 1u, "more formats" );
+
+// Persistent pixel unpack buffer. Texture data gets written into a free buffer and copied to the texture when the upload is issued.
+typedef struct ImAppRendererPixelBuffer
+{
+	GLuint						handle;
+	uintsize					size;				// grows to the largest upload
+	GLsync						fence;				// NULL when the GPU doesn't read from the buffer
+	bool						isUsed;				// owned by an upload until its fence signaled
+} ImAppRendererPixelBuffer;
+
+// Texture data waiting for a pixel buffer, waiting in a pixel buffer or being copied to the texture
+typedef struct ImAppRendererUpload
+{
+	ImAppRendererTexture*		texture;
+	void*						data;				// CPU copy in the upload format while all pixel buffers were used, NULL once written
+	uintsize					dataSize;
+	uint32						pixelBufferIndex;	// valid once written
+	bool						isIssued;			// the texture is ready when the fence of the pixel buffer signaled
+} ImAppRendererUpload;
+
 struct ImAppRenderer
 {
 	ImUiAllocator*				allocator;
+	ImAppPlatform*				platform;
+	uint32_t					flags;
 
-#if IMAPP_ENABLED( IMAPP_DEBUG )
-	ImUiHash					shaderHash;
+#if IMAPP_ENABLED( IMAPP_LIVEPP )
+	ImUiHash					shaderHash;			// shader code can only change with a Live++ patch
+	uint32_t					codeReloadCount;
 #endif
 
+	bool						isProgramCacheSupported;
+	ImUiHash					driverHash;			// vendor, renderer and version, binaries are only valid for the same driver
+	char*						driverInfo;			// the full strings, compared on load because the hash could collide
+	uint32_t					driverInfoSize;
+
 	GLuint						vertexShader;
+	GLuint						vertexShaderUber;
+	GLuint						vertexShaderUberInstanced;
 	ImAppRendererShader			shaderTexture;
 	ImAppRendererShader			shaderColor;
 	ImAppRendererShader			shaderFont;
 	ImAppRendererShader			shaderFontSdf;
-	GLint						programUniformProjection;
-	GLint						programUniformTexture;
+	ImAppRendererShader			shaderUber;
+	ImAppRendererShader			shaderUberInstanced;
+	GLuint						vertexShaderCache;
+	ImAppRendererShader			shaderCache;
+	GLint						uniformCacheRect;
+
+	uint32						stateGeneration;	// invalidates window state caches
+	uint32						contentGeneration;	// last generation handed to a texture, unique so reused texture memory can't match
+	ImAppRendererWindow*		stateWindow;		// drew last, all windows share one context and its state
+
+	ImAppRendererBatch*			batches;
+	uintsize					batchCapacity;
+
+	uint16_t*					commandClipIndices;
+	uintsize					commandClipIndexCapacity;
+
+	ImAppRendererDrawItem*		items;
+	uintsize					itemCapacity;
+
+	uint32_t*					vertexRemap;
+	uintsize					vertexRemapCapacity;
+
+	ImAppRendererDamageCommand*	damageCommands;		// swapped with the window after every compare
+	uintsize					damageCommandCapacity;
+
+	bool						isTextureStorageSupported;
+	bool						isUploadAsyncSupported;
+#if IMAPP_ENABLED( IMAPP_RENDERER_GLES ) && IMAPP_ENABLED( IMAPP_RENDERER_TIMER_QUERIES )
+	PFNGLQUERYCOUNTEREXTPROC			queryCounter;			// GL_EXT_disjoint_timer_query, NULL without
+	PFNGLGETQUERYOBJECTUI64VEXTPROC		getQueryObjectui64v;
+#endif
+	uint32_t					uploadBudget;		// bytes issued per update, 0: upload synchronously
+	float						uploadBudgetMs;		// 0: no time limit
+	ImAppRendererUpload*		uploads;			// in creation order
+	uintsize					uploadCapacity;
+	uintsize					uploadCount;
+	ImAppRendererPixelBuffer	pixelBuffers[ IMAPP_RENDERER_PIXEL_BUFFER_COUNT ];
+
+	ImAppRendererTextureArray**	textureArrays;
+	uintsize					textureArrayCapacity;
+	uintsize					textureArrayCount;
+
+	uint32_t					textureCount;
+	uint64_t					textureBytes[ ImAppRendererFormat_RGBA8 + 1u ];	// by ImAppRendererFormat
+
+	ImAppMutex*					contextMutex;		// render thread: guards the context and the renderer, NULL without
+	uint32						contextLockCount;	// nested locks of the main thread
+	uint64						queuedFrameCount;	// frames the main thread handed to the render thread
+	uint64						finishedFrameCount;	// frames the render thread finished
+	ImAppRendererTexture**		retiredTextures;	// destroyed while frames were queued
+	uintsize					retiredTextureCapacity;
+	uintsize					retiredTextureCount;
 };
 
 struct ImAppRendererTexture
 {
-	GLuint						handle;
+	GLuint						handle;				// 0 when the texture is a layer of array
+	ImAppRendererTextureArray*	array;
+	uint32						layer;
 
 	uint32						width;
 	uint32						height;
 
 	uint8						flags;
+	bool						isUploading;		// data is queued or the upload fence didn't signal yet
+	uint32						contentGeneration;	// changes with the data, commands sampling the texture get damaged
+
+	ImAppRendererFormat			format;
+	uintsize					dataSize;			// counted in the renderer stats, 0 without data
+
+	uint64						retireFrameCount;	// retired: released once finishedFrameCount reaches it
 };
 
 #if IMAPP_ENABLED( IMAPP_PLATFORM_LINUX ) || IMAPP_ENABLED( IMAPP_PLATFORM_ANDROID ) || IMAPP_ENABLED( IMAPP_PLATFORM_WEB )
-#	define IMAPP_RENDERER_GLSL_VERSION "#version 300 es\n#line " IMAPP_STRINGIZE( __LINE__ ) "\n"
+#	define IMAPP_RENDERER_GLSL_VERSION_LINE	"#version 300 es\n"
+#	define IMAPP_RENDERER_GLSL_LINE			"#line " IMAPP_STRINGIZE( __LINE__ ) "\n"
 #else
-#	define IMAPP_RENDERER_GLSL_VERSION "#version 330\n#line " IMAPP_STRINGIZE( (__LINE__ + 1) ) "\n"
+#	define IMAPP_RENDERER_GLSL_VERSION_LINE	"#version 330\n"
+#	define IMAPP_RENDERER_GLSL_LINE			"#line " IMAPP_STRINGIZE( (__LINE__ + 1) ) "\n"
 #endif
+#define IMAPP_RENDERER_GLSL_VERSION			IMAPP_RENDERER_GLSL_VERSION_LINE IMAPP_RENDERER_GLSL_LINE
+
+#define IMAPP_RENDERER_COMPACT_POSITION_SCALE	8.0f
+#define IMAPP_RENDERER_CACHE_STABLE_FRAMES	3u
+#define IMAPP_RENDERER_CLIP_TEXTURE_WIDTH	256u
+#define IMAPP_RENDERER_MAX_CLIP_RECTS		0xffffu
+#define IMAPP_RENDERER_TEXTURE_ARRAY_LAYERS	4u
+#define IMAPP_RENDERER_TEXTURE_ARRAY_MIN_SIZE	256u	// smaller textures keep their own texture, most of a layer would be wasted
 
 static const char s_vertexShader[] =
 	IMAPP_RENDERER_GLSL_VERSION
@@ -131,21 +405,204 @@ static const char s_fragmentShaderFontSdf[] =
 	"	fbColor = vec4(vtfColor.rgb, vtfColor.a * charAlpha);\n"
 	"}\n";
 
+// Composites a cached window texture, Rect is in normalized device coordinates
+static const char s_vertexShaderCache[] =
+	IMAPP_RENDERER_GLSL_VERSION
+	"uniform vec4 Rect;\n"
+	"out vec2 vtfUV;\n"
+	"void main() {\n"
+	"	vec2 corner	= vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));\n"
+	"	vtfUV		= corner;\n"
+	"	gl_Position	= vec4(mix(Rect.xy, Rect.zw, corner), 0, 1);\n"
+	"}\n";
+
+static const char s_fragmentShaderCache[] =
+	IMAPP_RENDERER_GLSL_VERSION
+	"precision mediump float;\n"
+	"uniform sampler2D Texture;\n"
+	"in vec2 vtfUV;\n"
+	"out vec4 fbColor;\n"
+	"void main() {\n"
+	"	fbColor = texture(Texture, vtfUV);\n"
+	"}\n";
+
+// Uber shaders are compiled with defines, the version line gets prepended.
+// DrawInfo.x: ImAppRendererDrawMode, DrawInfo.y: texture array layer + 1 or 0 for Texture, DrawInfo.zw: clip rect index
+static const char s_vertexShaderUber[] =
+	IMAPP_RENDERER_GLSL_LINE
+	"uniform mat4 ProjectionMatrix;\n"
+	"#if IMAPP_INSTANCED\n"
+	"in vec4 InstanceRect;\n"
+	"in vec4 InstanceUvRect;\n"
+	"#else\n"
+	"in vec2 Position;\n"
+	"in vec2 TexCoord;\n"
+	"#endif\n"
+	"in vec4 Color;\n"
+	"in uvec4 DrawInfo;\n"
+	"out vec2 vtfUV;\n"
+	"out vec4 vtfColor;\n"
+	"flat out uint vtfMode;\n"
+	"#if IMAPP_TEXTURE_ARRAYS\n"
+	"flat out float vtfLayer;\n"
+	"#endif\n"
+	"#if IMAPP_GPU_CLIPPING\n"
+	"uniform highp sampler2D ClipRects;\n"
+	"flat out highp vec4 vtfClipRect;\n"
+	"#endif\n"
+	"void main() {\n"
+	"#if IMAPP_INSTANCED\n"
+	"	vec2 corner		= vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1));\n"
+	"	vec2 Position	= mix(InstanceRect.xy, InstanceRect.zw, corner);\n"
+	"	vec2 TexCoord	= mix(InstanceUvRect.xy, InstanceUvRect.zw, corner);\n"
+	"#endif\n"
+	"	vtfUV		= TexCoord;\n"
+	"	vtfColor	= Color;\n"
+	"	vtfMode		= DrawInfo.x;\n"
+	"#if IMAPP_TEXTURE_ARRAYS\n"
+	"	vtfLayer	= float(DrawInfo.y);\n"
+	"#endif\n"
+	"#if IMAPP_GPU_CLIPPING\n"
+	"	uint clipIndex = DrawInfo.z | (DrawInfo.w << 8u);\n"
+	"	vtfClipRect	= texelFetch(ClipRects, ivec2(int(clipIndex & 255u), int(clipIndex >> 8u)), 0);\n"
+	"#endif\n"
+	"	gl_Position	= ProjectionMatrix * vec4(Position.xy, 0, 1);\n"
+	"}\n";
+
+// texture and derivatives are evaluated outside of the mode branches to keep them in uniform control flow
+static const char s_fragmentShaderUber[] =
+	IMAPP_RENDERER_GLSL_LINE
+	"precision mediump float;\n"
+	"uniform sampler2D Texture;\n"
+	"in vec2 vtfUV;\n"
+	"in vec4 vtfColor;\n"
+	"flat in uint vtfMode;\n"
+	"#if IMAPP_TEXTURE_ARRAYS\n"
+	"uniform mediump sampler2DArray TextureArray;\n"
+	"flat in float vtfLayer;\n"
+	"#endif\n"
+	"#if IMAPP_GPU_CLIPPING\n"
+	"flat in highp vec4 vtfClipRect;\n"
+	"#endif\n"
+	"out vec4 fbColor;\n"
+	"float median(vec3 v) {\n"
+	"	return max(min(v.r, v.g), min(max(v.r, v.g), v.b));\n"
+	"}\n"
+	"void main() {\n"
+	"	vec4 texColor = texture(Texture, vtfUV.xy);\n"
+	"	vec2 texSize = vec2(textureSize(Texture, 0));\n"
+	"#if IMAPP_TEXTURE_ARRAYS\n"
+	"	vec4 layerColor = texture(TextureArray, vec3(vtfUV.xy, max(vtfLayer - 1.0, 0.0)));\n"
+	"	texColor = vtfLayer > 0.0 ? layerColor : texColor;\n"
+	"	texSize = vtfLayer > 0.0 ? vec2(textureSize(TextureArray, 0).xy) : texSize;\n"
+	"#endif\n"
+	"	vec2 screenTexSize = vec2(1.0) / fwidth(vtfUV);\n"
+	"#if IMAPP_GPU_CLIPPING\n"
+	"	if( any(lessThan(gl_FragCoord.xy, vtfClipRect.xy)) || any(greaterThanEqual(gl_FragCoord.xy, vtfClipRect.zw)) ) {\n"
+	"		discard;\n"
+	"	}\n"
+	"#endif\n"
+	"	if( vtfMode == 0u ) {\n"
+	"		fbColor = vtfColor;\n"
+	"	}\n"
+	"	else if( vtfMode == 1u ) {\n"
+	"		fbColor = vtfColor * texColor;\n"
+	"	}\n"
+	"	else if( vtfMode == 2u ) {\n"
+	"		fbColor = vec4(vtfColor.rgb, vtfColor.a * texColor.a);\n"
+	"	}\n"
+	"	else {\n"
+	"		vec2 unitRange = vec2(2.0) / texSize;\n"
+	"		float screenPixelRange = max( 0.5 * dot(unitRange, screenTexSize), 1.0 );\n"
+	"		float charDistance = screenPixelRange * (median( texColor.rgb ) - 0.5);\n"
+	"		float charAlpha = clamp(charDistance + 0.5, 0.0, 1.0);\n"
+	"		fbColor = vec4(vtfColor.rgb, vtfColor.a * charAlpha);\n"
+	"	}\n"
+	"}\n";
+
 static const struct ImUiVertexElement s_vertexLayout[] = {
 	{ 1u,	ImUiVertexElementType_Float2,	ImUiVertexElementSemantic_PositionScreenSpace },
 	{ 1u,	ImUiVertexElementType_Float2,	ImUiVertexElementSemantic_TextureCoordinate },
 	{ 1u,	ImUiVertexElementType_UInt,		ImUiVertexElementSemantic_ColorABGR },
 };
 
-#if IMAPP_ENABLED( IMAPP_DEBUG )
+#if IMAPP_ENABLED( IMAPP_LIVEPP )
 static ImUiHash	imappRendererGetShaderHash();
 #endif
 
-static bool		imappRendererCompileShader( GLuint shader, const char* shaderCode );
-static bool		imappRendererCreateShaderProgram( ImAppRenderer* renderer, ImAppRendererShader* shader, const char* shaderCode );
+static bool		imappRendererCompileShader( GLuint shader, const char* defines, const char* shaderCode );
+static bool		imappRendererCreateShaderProgram( ImAppRenderer* renderer, ImAppRendererShader* shader, GLuint* vertexShader, const char* vertexShaderCode, const char* defines, const char* shaderCode, uint32 mask );
+static bool		imappRendererLoadProgramBinary( ImAppRenderer* renderer, GLuint program, ImUiHash key, ImUiHash sourceHash );
+static void		imappRendererSaveProgramBinary( ImAppRenderer* renderer, GLuint program, ImUiHash key, ImUiHash sourceHash );
 static void		imappRendererDestroyShaderProgram( ImAppRenderer* renderer, ImAppRendererShader* shader );
 
-static void		imappRendererDrawCommands( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, int width, int height );
+#if IMAPP_ENABLED( IMAPP_RENDERER_GLES )
+static bool		imappRendererHasExtension( const char* name );
+#endif
+static bool		imappRendererIsStreamingSupported();
+static bool		imappRendererIsTextureStorageSupported();
+static const void*	imappRendererTextureConvertData( ImAppRenderer* renderer, ImAppRendererFormat format, const ImAppRendererTextureFormat* targetFormat, const void* data, uintsize pixelCount, void** outConvertedData );
+static bool		imappRendererTextureInitializeData( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t width, uint32_t height, ImAppRendererFormat format, uint8_t flags );
+static bool		imappRendererTextureUploadRegion( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height );
+static void		imappRendererTextureDeleteData( ImAppRenderer* renderer, ImAppRendererTexture* texture );
+static void		imappRendererTextureRelease( ImAppRenderer* renderer, ImAppRendererTexture* texture );
+static void		imappRendererReleaseRetiredTextures( ImAppRenderer* renderer, bool all );
+static void		imappRendererTextureConvertDataTo( ImAppRendererFormat format, const ImAppRendererTextureFormat* targetFormat, const void* data, uintsize pixelCount, void* target );
+static bool		imappRendererTextureEnqueueUpload( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uintsize pixelCount );
+static ImAppRendererPixelBuffer*	imappRendererAcquirePixelBuffer( ImAppRenderer* renderer, uintsize size );
+static bool		imappRendererWritePixelBuffer( ImAppRenderer* renderer, ImAppRendererPixelBuffer* pixelBuffer, const ImAppRendererTexture* texture, const void* data, uintsize pixelCount, bool isConverted );
+static void		imappRendererDestroyPixelBuffers( ImAppRenderer* renderer );
+static void		imappRendererUpdateUploads( ImAppRenderer* renderer );
+static bool		imappRendererWriteUpload( ImAppRenderer* renderer, ImAppRendererUpload* upload );
+static void		imappRendererIssueUpload( ImAppRenderer* renderer, ImAppRendererUpload* upload );
+static void		imappRendererReleaseUpload( ImAppRenderer* renderer, ImAppRendererUpload* upload );
+static void		imappRendererCancelUploads( ImAppRenderer* renderer, const ImAppRendererTexture* texture );
+static void		imappRendererFlushUploads( ImAppRenderer* renderer, const ImAppRendererTexture* texture );
+static bool		imappRendererTextureArrayInsert( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data );
+static bool		imappRendererTextureArrayUpload( ImAppRenderer* renderer, const ImAppRendererTexture* texture, const void* data, uint32 x, uint32 y, uint32 width, uint32 height );
+static void		imappRendererTextureArrayRemove( ImAppRenderer* renderer, ImAppRendererTexture* texture );
+static bool		imappRendererBufferPrepareData( ImAppRenderer* renderer, ImAppRendererBuffer* buffer, uintsize size );
+static void		imappRendererBufferPrepareStream( ImAppRendererBuffer* buffer, GLenum target, uintsize size );
+static void		imappRendererWindowSetVertexOffset( ImAppRendererWindow* window, uintsize vertexOffset, uintsize drawInfoOffset, bool compact );
+static void		imappRendererWindowSetInstanceOffset( ImAppRendererWindow* window, uintsize offset );
+static void		imappRendererWindowDestroyStreamFences( ImAppRendererWindow* window );
+static void		imappRendererWindowWaitStreamFence( ImAppRendererWindow* window, uintsize frameIndex );
+static void*	imappRendererWindowMapBuffer( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererBuffer* buffer, GLenum target, uintsize size, uintsize* offset );
+static bool		imappRendererWindowUnmapBuffer( ImAppRendererWindow* window, ImAppRendererBuffer* buffer, GLenum target, uintsize mappedSize, uintsize usedSize );
+static bool		imappRendererDrawFrame( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, const ImAppRendererDrawPacket* packet, int width, int height, const float* clearColor, int bufferAge, ImUiRect* outDamageRect );
+static bool		imappRendererWindowGenerateFrame( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, const ImAppRendererDrawPacket* packet, ImAppRendererFrame* frame );
+static bool		imappRendererWindowPrepareItems( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererFrame* frame );
+static uint8_t	imappRendererGetDrawMode( const ImUiDrawCommand* command );
+static uint8_t	imappRendererGetDrawLayer( const ImUiDrawCommand* command );
+static void		imappRendererFillDrawInfo( ImAppRenderer* renderer, const ImAppRendererFrame* frame, uint8_t* drawInfo );
+static bool		imappRendererBuildQuadInstance( const ImAppRendererVertex* vertices, uintsize vertexCount, const uint32_t* indices, ImAppRendererQuadInstance* instance );
+static bool		imappRendererAddItem( ImAppRenderer* renderer, ImAppRendererFrame* frame, uint32 commandIndex, bool instanced, uintsize first, uintsize count );
+static bool		imappRendererWindowConvertQuads( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererFrame* frame );
+static void		imappRendererFrameChooseFormat( ImAppRenderer* renderer, ImAppRendererFrame* frame );
+static void		imappRendererFrameWriteVertex( const ImAppRendererFrame* frame, void* vertices, uintsize index, const ImAppRendererVertex* sourceVertex );
+static void		imappRendererFrameWriteIndex( const ImAppRendererFrame* frame, void* indices, uintsize index, uint32_t value );
+static bool		imappRendererWindowConvertVertices( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererFrame* frame );
+static void		imappRendererGetScissorRect( const ImUiDrawCommand* command, int height, GLint* scissor );
+static bool		imappRendererWindowPrepareClipRects( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame );
+static void		imappRendererWindowUploadClipRects( ImAppRendererWindow* window );
+
+static void		imappRendererWindowValidateStateCache( ImAppRenderer* renderer, ImAppRendererWindow* window );
+static void		imappRendererInvalidateTextureBinding( ImAppRenderer* renderer );
+static void		imappRendererWindowBeginTimer( ImAppRenderer* renderer, ImAppRendererWindow* window );
+static void		imappRendererWindowWriteTimestamp( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererTimestamp timestamp );
+static void		imappRendererWindowReadTimers( ImAppRenderer* renderer, ImAppRendererWindow* window );
+static void		imappRendererWindowResetFrameStats( ImAppRendererWindow* window );
+static uintsize	imappRendererMergeCommands( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame, const ImAppRendererCacheEntry* fillEntry );
+static bool		imappRendererDrawCommands( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, const ImAppRendererDrawPacket* packet, int width, int height, const float* clearColor, int bufferAge, GLint* damageRect );
+static bool		imappRendererWindowUpdateDamage( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererFrame* frame, const float* clearColor, int bufferAge, GLint* damageRect, bool hasCommandHashes );
+static void		imappRendererGetFramebufferBounds( const ImAppRendererFrame* frame, float left, float top, float right, float bottom, int* bounds );
+static void		imappRendererGetCommandBounds( const ImAppRendererFrame* frame, const ImUiDrawCommand* command, const uint32_t* indices, int* bounds );
+static void		imappRendererIntersectRect( GLint* rect, const GLint* otherRect );
+static void		imappRendererWindowDrawBatches( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame, uintsize batchCount, const GLint* target );
+static bool		imappRendererHashCommands( ImAppRenderer* renderer, const ImAppRendererFrame* frame );
+static void		imappRendererWindowUpdateCache( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame, bool hasCommandHashes );
+static bool		imappRendererWindowFillCache( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame, ImAppRendererCacheEntry* entry );
+static void		imappRendererWindowReleaseCaches( ImAppRenderer* renderer, ImAppRendererWindow* window );
 
 ImUiVertexFormat imappRendererGetVertexFormat()
 {
@@ -153,7 +610,7 @@ ImUiVertexFormat imappRendererGetVertexFormat()
 	return result;
 }
 
-ImAppRenderer* imappRendererCreate( ImUiAllocator* allocator, ImAppPlatform* platform )
+ImAppRenderer* imappRendererCreate( ImUiAllocator* allocator, ImAppPlatform* platform, uint32_t flags )
 {
 	IMAPP_ASSERT( platform != NULL );
 
@@ -163,9 +620,17 @@ ImAppRenderer* imappRendererCreate( ImUiAllocator* allocator, ImAppPlatform* pla
 		return NULL;
 	}
 
-	renderer->allocator = allocator;
+	renderer->allocator	= allocator;
+	renderer->platform	= platform;
+	renderer->flags		= flags;
+
+	// clip rect indices, instance modes and texture layers are stored like the draw mode
+	if( renderer->flags & (ImAppRendererFlags_GpuClipping | ImAppRendererFlags_InstancedQuads | ImAppRendererFlags_TextureArrays) )
+	{
+		renderer->flags |= ImAppRendererFlags_UberShader;
+	}
 
-#if IMAPP_ENABLED( IMAPP_PLATFORM_LINUX ) || IMAPP_ENABLED( IMAPP_PLATFORM_WEB ) || IMAPP_ENABLED( IMAPP_PLATFORM_WINDOWS )
+#if IMAPP_DISABLED( IMAPP_RENDERER_GLES )
 	if( glewInit() != GLEW_OK )
 	{
 		imappPlatformShowError( platform, "Failed to initialize GLEW.\n" );
@@ -174,26 +639,160 @@ ImAppRenderer* imappRendererCreate( ImUiAllocator* allocator, ImAppPlatform* pla
 	}
 #endif
 
-#if IMAPP_ENABLED( IMAPP_DEBUG )
-	renderer->shaderHash = imappRendererGetShaderHash();
+#if IMAPP_ENABLED( IMAPP_LIVEPP )
+	renderer->shaderHash		= imappRendererGetShaderHash();
+	renderer->codeReloadCount	= imappLivePlusPlusGetReloadCount();
+#endif
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_PROGRAM_CACHE )
+#	if IMAPP_ENABLED( IMAPP_RENDERER_GLES )
+	GLint binaryFormatCount = 0;
+	glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount );
+#	else
+	GLint binaryFormatCount = 0;
+	if( GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary )
+	{
+		glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount );
+	}
+#	endif
+
+	char cachePath[ 256u ];
+	renderer->isProgramCacheSupported = binaryFormatCount > 0 && imappPlatformGetCachePath( platform, cachePath, sizeof( cachePath ), "" );
+	if( renderer->isProgramCacheSupported )
+	{
+		static const GLenum s_driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+		const char* driverStrings[ IMAPP_ARRAY_COUNT( s_driverStrings ) ];
+		uintsize driverInfoSize = 0u;
+		for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( s_driverStrings ); ++i )
+		{
+			driverStrings[ i ] = (const char*)glGetString( s_driverStrings[ i ] );
+			if( !driverStrings[ i ] )
+			{
+				driverStrings[ i ] = "";
+			}
+			driverInfoSize += strlen( driverStrings[ i ] ) + 1u;
+		}
+
+		// "vendor\nrenderer\nversion\n"
+		renderer->driverInfo = (char*)ImUiMemoryAlloc( renderer->allocator, driverInfoSize );
+		renderer->isProgramCacheSupported = renderer->driverInfo != NULL;
+		if( renderer->driverInfo )
+		{
+			char* target = renderer->driverInfo;
+			for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( driverStrings ); ++i )
+			{
+				const uintsize length = strlen( driverStrings[ i ] );
+				memcpy( target, driverStrings[ i ], length );
+				target[ length ] = '\n';
+				target += length + 1u;
+			}
+			renderer->driverInfoSize	= (uint32_t)driverInfoSize;
+			renderer->driverHash		= ImUiHashCreate( renderer->driverInfo, driverInfoSize );
+		}
+	}
 #endif
+
 	if( !imappRendererCreateResources( renderer ) )
 	{
 		imappRendererDestroy( renderer );
 		return NULL;
 	}
 
+	if( (renderer->flags & ImAppRendererFlags_StreamingBuffers) && !imappRendererIsStreamingSupported() )
+	{
+		ImAppTrace( "[renderer] Buffer streaming not supported. Falling back to staging buffers.\n" );
+		renderer->flags &= ~ImAppRendererFlags_StreamingBuffers;
+	}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_TIMER_QUERIES ) && IMAPP_ENABLED( IMAPP_RENDERER_GLES )
+	if( (renderer->flags & ImAppRendererFlags_GpuTimers) &&
+		imappRendererHasExtension( "GL_EXT_disjoint_timer_query" ) )
+	{
+		renderer->queryCounter			= (PFNGLQUERYCOUNTEREXTPROC)eglGetProcAddress( "glQueryCounterEXT" );
+		renderer->getQueryObjectui64v	= (PFNGLGETQUERYOBJECTUI64VEXTPROC)eglGetProcAddress( "glGetQueryObjectui64vEXT" );
+	}
+	const bool isTimerQuerySupported = renderer->queryCounter != NULL && renderer->getQueryObjectui64v != NULL;
+#elif IMAPP_ENABLED( IMAPP_RENDERER_TIMER_QUERIES )
+	const bool isTimerQuerySupported = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+#else
+	const bool isTimerQuerySupported = false;
+#endif
+	if( (renderer->flags & ImAppRendererFlags_GpuTimers) && !isTimerQuerySupported )
+	{
+		ImAppTrace( "[renderer] Timer queries not supported. GPU times stay zero.\n" );
+		renderer->flags &= ~ImAppRendererFlags_GpuTimers;
+	}
+
+	// pixel unpack buffers need the same mapping and sync objects as streaming
+	renderer->isUploadAsyncSupported = imappRendererIsStreamingSupported();
+
+	// immutable storage skips the completeness checks and format guesses of glTexImage2D
+	renderer->isTextureStorageSupported = imappRendererIsTextureStorageSupported();
+
 	return renderer;
 }
 
+static bool imappRendererIsStreamingSupported()
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_STREAMING )
+#	if IMAPP_ENABLED( IMAPP_RENDERER_GLES )
+	return true;
+#	else
+	return GLEW_VERSION_3_2 || (GLEW_ARB_map_buffer_range && GLEW_ARB_sync);
+#	endif
+#else
+	return false;
+#endif
+}
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_GLES )
+static bool imappRendererHasExtension( const char* name )
+{
+	GLint extensionCount = 0;
+	glGetIntegerv( GL_NUM_EXTENSIONS, &extensionCount );
+	for( GLint i = 0; i < extensionCount; ++i )
+	{
+		const char* extension = (const char*)glGetStringi( GL_EXTENSIONS, (GLuint)i );
+		if( extension && strcmp( extension, name ) == 0 )
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+#endif
+
+static bool imappRendererIsTextureStorageSupported()
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_GLES ) || IMAPP_ENABLED( IMAPP_PLATFORM_WEB )
+	return true;
+#else
+	return GLEW_VERSION_4_2 || GLEW_ARB_texture_storage;
+#endif
+}
+
 void imappRendererDestroy( ImAppRenderer* renderer )
 {
+	imappRendererReleaseRetiredTextures( renderer, true );
+	imappRendererCancelUploads( renderer, NULL );
+	imappRendererDestroyPixelBuffers( renderer );
 	imappRendererDestroyResources( renderer );
 
+	ImUiMemoryFree( renderer->allocator, renderer->batches );
+	ImUiMemoryFree( renderer->allocator, renderer->commandClipIndices );
+	ImUiMemoryFree( renderer->allocator, renderer->items );
+	ImUiMemoryFree( renderer->allocator, renderer->vertexRemap );
+	ImUiMemoryFree( renderer->allocator, renderer->damageCommands );
+	ImUiMemoryFree( renderer->allocator, renderer->uploads );
+	ImUiMemoryFree( renderer->allocator, renderer->textureArrays );
+	ImUiMemoryFree( renderer->allocator, renderer->retiredTextures );
+	ImUiMemoryFree( renderer->allocator, renderer->driverInfo );
+
 	ImUiMemoryFree( renderer->allocator, renderer );
 }
 
-#if IMAPP_ENABLED( IMAPP_DEBUG )
+#if IMAPP_ENABLED( IMAPP_LIVEPP )
 static ImUiHash imappRendererGetShaderHash()
 {
 	ImUiHash shaderHash = 0;
@@ -202,6 +801,10 @@ static ImUiHash imappRendererGetShaderHash()
 	shaderHash = ImUiHashCreateSeed( s_fragmentShaderColor, sizeof( s_fragmentShaderColor ), shaderHash );
 	shaderHash = ImUiHashCreateSeed( s_fragmentShaderFont, sizeof( s_fragmentShaderFont ), shaderHash );
 	shaderHash = ImUiHashCreateSeed( s_fragmentShaderFontSdf, sizeof( s_fragmentShaderFontSdf ), shaderHash );
+	shaderHash = ImUiHashCreateSeed( s_vertexShaderUber, sizeof( s_vertexShaderUber ), shaderHash );
+	shaderHash = ImUiHashCreateSeed( s_fragmentShaderUber, sizeof( s_fragmentShaderUber ), shaderHash );
+	shaderHash = ImUiHashCreateSeed( s_vertexShaderCache, sizeof( s_vertexShaderCache ), shaderHash );
+	shaderHash = ImUiHashCreateSeed( s_fragmentShaderCache, sizeof( s_fragmentShaderCache ), shaderHash );
 
 	return shaderHash;
 }
@@ -209,24 +812,137 @@ static ImUiHash imappRendererGetShaderHash()
 
 void imappRendererUpdate( ImAppRenderer* renderer )
 {
-	IMAPP_USE( renderer );
+	imappRendererLockContext( renderer );
 
-#if IMAPP_ENABLED( IMAPP_DEBUG )
-	const ImUiHash shaderHash = imappRendererGetShaderHash();
-	if( shaderHash != renderer->shaderHash )
+#if IMAPP_ENABLED( IMAPP_LIVEPP )
+	const uint32_t codeReloadCount = imappLivePlusPlusGetReloadCount();
+	if( codeReloadCount != renderer->codeReloadCount )
 	{
-		imappRendererDestroyResources( renderer );
-		imappRendererCreateResources( renderer );
+		renderer->codeReloadCount = codeReloadCount;
 
-		renderer->shaderHash = shaderHash;
+		const ImUiHash shaderHash = imappRendererGetShaderHash();
+		if( shaderHash != renderer->shaderHash )
+		{
+			imappRendererDestroyResources( renderer );
+			imappRendererCreateResources( renderer );
+
+			renderer->shaderHash = shaderHash;
+		}
 	}
 #endif
+
+	imappRendererUpdateUploads( renderer );
+
+	imappRendererUnlockContext( renderer );
+}
+
+void imappRendererSetUploadBudget( ImAppRenderer* renderer, uint32_t budget, float budgetMs )
+{
+	renderer->uploadBudget		= budget;
+	renderer->uploadBudgetMs	= budgetMs;
+}
+
+bool imappRendererHasPendingUploads( const ImAppRenderer* renderer )
+{
+	return renderer->uploadCount > 0u;
+}
+
+void imappRendererSetContextMutex( ImAppRenderer* renderer, ImAppMutex* mutex )
+{
+	IMAPP_ASSERT( renderer->contextLockCount == 0u );
+
+	renderer->contextMutex = mutex;
+	if( mutex == NULL )
+	{
+		// no frame is queued anymore
+		imappRendererReleaseRetiredTextures( renderer, true );
+	}
+}
+
+void imappRendererLockContext( ImAppRenderer* renderer )
+{
+	if( renderer->contextMutex == NULL ||
+		renderer->contextLockCount++ > 0u )
+	{
+		return;
+	}
+
+	// waits until the render thread presented its current frame
+	imappPlatformMutexLock( renderer->contextMutex );
+	if( !imappPlatformAcquireGlContext( renderer->platform ) )
+	{
+		ImAppTrace( "[renderer] Failed to borrow the GL context.\n" );
+	}
+}
+
+void imappRendererUnlockContext( ImAppRenderer* renderer )
+{
+	if( renderer->contextMutex == NULL )
+	{
+		return;
+	}
+
+	IMAPP_ASSERT( renderer->contextLockCount > 0u );
+	if( --renderer->contextLockCount > 0u )
+	{
+		return;
+	}
+
+	imappPlatformReleaseGlContext( renderer->platform );
+	imappPlatformMutexUnlock( renderer->contextMutex );
+}
+
+void imappRendererQueueFrame( ImAppRenderer* renderer )
+{
+	renderer->queuedFrameCount++;
+}
+
+void imappRendererFinishFrame( ImAppRenderer* renderer )
+{
+	renderer->finishedFrameCount++;
+	imappRendererReleaseRetiredTextures( renderer, false );
+}
+
+static void imappRendererReleaseRetiredTextures( ImAppRenderer* renderer, bool all )
+{
+	for( uintsize i = 0u; i < renderer->retiredTextureCount; ++i )
+	{
+		ImAppRendererTexture* texture = renderer->retiredTextures[ i ];
+		if( !all &&
+			texture->retireFrameCount > renderer->finishedFrameCount )
+		{
+			continue;
+		}
+
+		imappRendererTextureRelease( renderer, texture );
+
+		IMUI_MEMORY_ARRAY_REMOVE_UNSORTED( renderer->retiredTextures, renderer->retiredTextureCount, i );
+		i--;
+	}
 }
 
-static bool imappRendererCompileShader( GLuint shader, const char* pShaderCode )
+void imappRendererGetTextureStats( const ImAppRenderer* renderer, ImAppRendererStats* stats )
 {
-	glShaderSource( shader, 1, &pShaderCode, 0 );
+	stats->textureCount			= renderer->textureCount;
+	stats->textureBytesR8		= renderer->textureBytes[ ImAppRendererFormat_R8 ];
+	stats->textureBytesRgb8		= renderer->textureBytes[ ImAppRendererFormat_RGB8 ];
+	stats->textureBytesRgba8	= renderer->textureBytes[ ImAppRendererFormat_RGBA8 ];
+}
+
+static bool imappRendererCompileShader( GLuint shader, const char* defines, const char* pShaderCode )
+{
+	if( defines )
+	{
+		const char* sources[] = { IMAPP_RENDERER_GLSL_VERSION_LINE, defines, pShaderCode };
+		glShaderSource( shader, IMAPP_ARRAY_COUNT( sources ), sources, 0 );
+	}
+	else
+	{
+		glShaderSource( shader, 1, &pShaderCode, 0 );
+	}
+#if IMAPP_DISABLED( IMAPP_RENDERER_GLES )
 	glObjectLabel( GL_SHADER, shader, sizeof( __FILE__ ), __FILE__ );
+#endif
 	glCompileShader( shader );
 
 	GLint shaderStatus;
@@ -270,20 +986,9 @@ static bool imappRendererCompileShader( GLuint shader, const char* pShaderCode )
 	return true;
 }
 
-static bool imappRendererCreateShaderProgram( ImAppRenderer* renderer, ImAppRendererShader* shader, const char* shaderCode )
+static bool imappRendererCreateShaderProgram( ImAppRenderer* renderer, ImAppRendererShader* shader, GLuint* vertexShader, const char* vertexShaderCode, const char* defines, const char* shaderCode, uint32 mask )
 {
-	shader->fragmentShader = glCreateShader( GL_FRAGMENT_SHADER );
-	if( !shader->fragmentShader )
-	{
-		ImAppTrace( "[renderer] Failed to create GL Shader.\n" );
-		return false;
-	}
-
-	if( !imappRendererCompileShader( shader->fragmentShader, shaderCode ) )
-	{
-		ImAppTrace( "[renderer] Failed to compile GL Shader.\n" );
-		return false;
-	}
+	shader->mask = mask;
 
 	shader->program = glCreateProgram();
 	if( !shader->program )
@@ -292,61 +997,300 @@ static bool imappRendererCreateShaderProgram( ImAppRenderer* renderer, ImAppRend
 		return false;
 	}
 
-	glAttachShader( shader->program, renderer->vertexShader );
-	glAttachShader( shader->program, shader->fragmentShader );
-	glLinkProgram( shader->program );
-
-	GLint programStatus;
-	glGetProgramiv( shader->program, GL_LINK_STATUS, &programStatus );
-	if( programStatus != GL_TRUE )
+	ImUiHash key = renderer->driverHash;
+	ImUiHash sourceHash = IMAPP_RENDERER_PROGRAM_SOURCE_SEED;
+	key			= ImUiHashCreateSeed( vertexShaderCode, strlen( vertexShaderCode ), key );
+	key			= ImUiHashCreateSeed( shaderCode, strlen( shaderCode ), key );
+	sourceHash	= ImUiHashCreateSeed( vertexShaderCode, strlen( vertexShaderCode ), sourceHash );
+	sourceHash	= ImUiHashCreateSeed( shaderCode, strlen( shaderCode ), sourceHash );
+	if( defines )
 	{
-		ImAppTrace( "[renderer] Failed to link GL Program.\n" );
-		return false;
+		key			= ImUiHashCreateSeed( defines, strlen( defines ), key );
+		sourceHash	= ImUiHashCreateSeed( defines, strlen( defines ), sourceHash );
 	}
 
-	return true;
-}
-
-static void imappRendererDestroyShaderProgram( ImAppRenderer* renderer, ImAppRendererShader* shader )
-{
-	if( shader->program != 0u )
+	if( !imappRendererLoadProgramBinary( renderer, shader->program, key, sourceHash ) )
 	{
-		glDetachShader( shader->program, shader->fragmentShader );
-		glDetachShader( shader->program, renderer->vertexShader );
-		glDeleteProgram( shader->program );
+		// vertex shaders are shared and only compiled when a program isn't cached
+		if( *vertexShader == 0u )
+		{
+			*vertexShader = glCreateShader( GL_VERTEX_SHADER );
+			if( !*vertexShader ||
+				!imappRendererCompileShader( *vertexShader, defines, vertexShaderCode ) )
+			{
+				ImAppTrace( "[renderer] Failed to create Vertex Shader.\n" );
+				return false;
+			}
+		}
+		shader->vertexShader = *vertexShader;
 
-		shader->program = 0u;
-	}
+		shader->fragmentShader = glCreateShader( GL_FRAGMENT_SHADER );
+		if( !shader->fragmentShader )
+		{
+			ImAppTrace( "[renderer] Failed to create GL Shader.\n" );
+			return false;
+		}
 
-	if( shader->fragmentShader != 0u )
-	{
-		glDeleteShader( shader->fragmentShader );
-		shader->fragmentShader = 0u;
-	}
-}
+		if( !imappRendererCompileShader( shader->fragmentShader, defines, shaderCode ) )
+		{
+			ImAppTrace( "[renderer] Failed to compile GL Shader.\n" );
+			return false;
+		}
 
-bool imappRendererCreateResources( ImAppRenderer* renderer )
+		glAttachShader( shader->program, shader->vertexShader );
+		glAttachShader( shader->program, shader->fragmentShader );
+
+		// all programs share one vertex layout
+		glBindAttribLocation( shader->program, ImAppRendererAttribute_Position, "Position" );
+		glBindAttribLocation( shader->program, ImAppRendererAttribute_Position, "InstanceRect" );
+		glBindAttribLocation( shader->program, ImAppRendererAttribute_TexCoord, "TexCoord" );
+		glBindAttribLocation( shader->program, ImAppRendererAttribute_TexCoord, "InstanceUvRect" );
+		glBindAttribLocation( shader->program, ImAppRendererAttribute_Color, "Color" );
+		glBindAttribLocation( shader->program, ImAppRendererAttribute_DrawInfo, "DrawInfo" );
+#if IMAPP_ENABLED( IMAPP_RENDERER_PROGRAM_CACHE )
+		if( renderer->isProgramCacheSupported )
+		{
+			glProgramParameteri( shader->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
+		}
+#endif
+		glLinkProgram( shader->program );
+
+		GLint programStatus;
+		glGetProgramiv( shader->program, GL_LINK_STATUS, &programStatus );
+		if( programStatus != GL_TRUE )
+		{
+			ImAppTrace( "[renderer] Failed to link GL Program.\n" );
+			return false;
+		}
+
+		imappRendererSaveProgramBinary( renderer, shader->program, key, sourceHash );
+	}
+
+	shader->uniformProjection = glGetUniformLocation( shader->program, "ProjectionMatrix" );
+
+	glUseProgram( shader->program );
+	glUniform1i( glGetUniformLocation( shader->program, "Texture" ), 0 );
+	glUniform1i( glGetUniformLocation( shader->program, "ClipRects" ), 1 );
+	glUniform1i( glGetUniformLocation( shader->program, "TextureArray" ), 2 );
+	glUseProgram( 0 );
+
+	return true;
+}
+
+static bool imappRendererLoadProgramBinary( ImAppRenderer* renderer, GLuint program, ImUiHash key, ImUiHash sourceHash )
 {
-	// Shader
-	renderer->vertexShader = glCreateShader( GL_VERTEX_SHADER );
-	if( !renderer->vertexShader ||
-		!imappRendererCompileShader( renderer->vertexShader, s_vertexShader ) )
+#if IMAPP_ENABLED( IMAPP_RENDERER_PROGRAM_CACHE )
+	if( !renderer->isProgramCacheSupported )
+	{
+		return false;
+	}
+
+	char fileName[ 32u ];
+	snprintf( fileName, sizeof( fileName ), "program_%08x.bin", (unsigned int)key );
+
+	char path[ 256u ];
+	if( !imappPlatformGetCachePath( renderer->platform, path, sizeof( path ), fileName ) )
+	{
+		return false;
+	}
+
+	FILE* file = fopen( path, "rb" );
+	if( !file )
 	{
-		ImAppTrace( "[renderer] Failed to create Vertex Shader.\n" );
 		return false;
 	}
 
-	if( !imappRendererCreateShaderProgram( renderer, &renderer->shaderTexture, s_fragmentShaderTexture ) ||
-		!imappRendererCreateShaderProgram( renderer, &renderer->shaderColor, s_fragmentShaderColor ) ||
-		!imappRendererCreateShaderProgram( renderer, &renderer->shaderFont, s_fragmentShaderFont ) ||
-		!imappRendererCreateShaderProgram( renderer, &renderer->shaderFontSdf, s_fragmentShaderFontSdf ) )
+	bool result = false;
+	ImAppRendererProgramCacheHeader header;
+	if( fread( &header, sizeof( header ), 1u, file ) == 1u &&
+		header.magic == IMAPP_RENDERER_PROGRAM_CACHE_MAGIC &&
+		header.key == key &&
+		header.sourceHash == sourceHash &&
+		header.driverInfoSize == renderer->driverInfoSize &&
+		header.size > 0u )
+	{
+		// driver info and binary in one allocation
+		char* data = (char*)ImUiMemoryAlloc( renderer->allocator, (uintsize)header.driverInfoSize + header.size );
+		if( data &&
+			fread( data, (uintsize)header.driverInfoSize + header.size, 1u, file ) == 1u &&
+			memcmp( data, renderer->driverInfo, header.driverInfoSize ) == 0 )
+		{
+			glProgramBinary( program, (GLenum)header.format, data + header.driverInfoSize, (GLsizei)header.size );
+
+			// drivers reject binaries of other versions, the program gets compiled then
+			GLint programStatus;
+			glGetProgramiv( program, GL_LINK_STATUS, &programStatus );
+			result = programStatus == GL_TRUE;
+		}
+		ImUiMemoryFree( renderer->allocator, data );
+	}
+
+	fclose( file );
+	return result;
+#else
+	IMAPP_USE( renderer );
+	IMAPP_USE( program );
+	IMAPP_USE( key );
+	IMAPP_USE( sourceHash );
+
+	return false;
+#endif
+}
+
+static void imappRendererSaveProgramBinary( ImAppRenderer* renderer, GLuint program, ImUiHash key, ImUiHash sourceHash )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_PROGRAM_CACHE )
+	if( !renderer->isProgramCacheSupported )
+	{
+		return;
+	}
+
+	GLint binarySize = 0;
+	glGetProgramiv( program, GL_PROGRAM_BINARY_LENGTH, &binarySize );
+	if( binarySize <= 0 )
+	{
+		return;
+	}
+
+	void* binary = ImUiMemoryAlloc( renderer->allocator, (uintsize)binarySize );
+	if( !binary )
+	{
+		return;
+	}
+
+	ImAppRendererProgramCacheHeader header;
+	header.magic			= IMAPP_RENDERER_PROGRAM_CACHE_MAGIC;
+	header.key				= key;
+	header.sourceHash		= sourceHash;
+	header.driverInfoSize	= renderer->driverInfoSize;
+
+	GLenum format = 0u;
+	GLsizei size = 0;
+	glGetProgramBinary( program, binarySize, &size, &format, binary );
+	header.format	= format;
+	header.size		= (uint32_t)size;
+
+	char fileName[ 32u ];
+	snprintf( fileName, sizeof( fileName ), "program_%08x.bin", (unsigned int)key );
+
+	// written next to the target and renamed, so a crash or a second process never leaves a torn file
+	char tempFileName[ 64u ];
+	snprintf( tempFileName, sizeof( tempFileName ), "program_%08x.%llx.tmp", (unsigned int)key, (unsigned long long)imappPlatformGetTickValue( renderer->platform ) );
+
+	char path[ 256u ];
+	char tempPath[ 256u ];
+	FILE* file = NULL;
+	if( size > 0 &&
+		imappPlatformGetCachePath( renderer->platform, path, sizeof( path ), fileName ) &&
+		imappPlatformGetCachePath( renderer->platform, tempPath, sizeof( tempPath ), tempFileName ) )
+	{
+		file = fopen( tempPath, "wb" );
+	}
+
+	if( file )
+	{
+		bool written = fwrite( &header, sizeof( header ), 1u, file ) == 1u &&
+			fwrite( renderer->driverInfo, header.driverInfoSize, 1u, file ) == 1u &&
+			fwrite( binary, header.size, 1u, file ) == 1u;
+		written = fclose( file ) == 0 && written;
+
+		if( written && rename( tempPath, path ) != 0 )
+		{
+			// Windows doesn't replace existing files
+			remove( path );
+			written = rename( tempPath, path ) == 0;
+		}
+
+		if( !written )
+		{
+			ImAppTrace( "[renderer] Failed to write program cache '%s'.\n", path );
+			remove( tempPath );
+		}
+	}
+
+	ImUiMemoryFree( renderer->allocator, binary );
+#else
+	IMAPP_USE( renderer );
+	IMAPP_USE( program );
+	IMAPP_USE( key );
+	IMAPP_USE( sourceHash );
+#endif
+}
+
+static void imappRendererDestroyShaderProgram( ImAppRenderer* renderer, ImAppRendererShader* shader )
+{
+	IMAPP_USE( renderer );
+
+	if( shader->program != 0u )
+	{
+		// programs loaded from a binary have no shaders attached
+		if( shader->fragmentShader != 0u )
+		{
+			glDetachShader( shader->program, shader->fragmentShader );
+		}
+		if( shader->vertexShader != 0u )
+		{
+			glDetachShader( shader->program, shader->vertexShader );
+		}
+		glDeleteProgram( shader->program );
+
+		shader->program			= 0u;
+		shader->vertexShader	= 0u;
+	}
+
+	if( shader->fragmentShader != 0u )
+	{
+		glDeleteShader( shader->fragmentShader );
+		shader->fragmentShader = 0u;
+	}
+}
+
+bool imappRendererCreateResources( ImAppRenderer* renderer )
+{
+	renderer->stateGeneration++;
+
+	// Shader
+	if( !imappRendererCreateShaderProgram( renderer, &renderer->shaderTexture, &renderer->vertexShader, s_vertexShader, NULL, s_fragmentShaderTexture, 1u << 0u ) ||
+		!imappRendererCreateShaderProgram( renderer, &renderer->shaderColor, &renderer->vertexShader, s_vertexShader, NULL, s_fragmentShaderColor, 1u << 1u ) ||
+		!imappRendererCreateShaderProgram( renderer, &renderer->shaderFont, &renderer->vertexShader, s_vertexShader, NULL, s_fragmentShaderFont, 1u << 2u ) ||
+		!imappRendererCreateShaderProgram( renderer, &renderer->shaderFontSdf, &renderer->vertexShader, s_vertexShader, NULL, s_fragmentShaderFontSdf, 1u << 3u ) )
 	{
 		ImAppTrace( "[renderer] Failed to compile programs.\n" );
 		return false;
 	}
 
-	renderer->programUniformProjection	= glGetUniformLocation( renderer->shaderTexture.program, "ProjectionMatrix" );
-	renderer->programUniformTexture		= glGetUniformLocation( renderer->shaderTexture.program, "Texture" );
+	if( !imappRendererCreateShaderProgram( renderer, &renderer->shaderCache, &renderer->vertexShaderCache, s_vertexShaderCache, NULL, s_fragmentShaderCache, 1u << 6u ) )
+	{
+		ImAppTrace( "[renderer] Failed to compile cache program.\n" );
+		return false;
+	}
+	renderer->uniformCacheRect = glGetUniformLocation( renderer->shaderCache.program, "Rect" );
+
+	const int gpuClipping = (renderer->flags & ImAppRendererFlags_GpuClipping) ? 1 : 0;
+	const int textureArrays = (renderer->flags & ImAppRendererFlags_TextureArrays) ? 1 : 0;
+	if( renderer->flags & ImAppRendererFlags_UberShader )
+	{
+		char defines[ 128u ];
+		snprintf( defines, sizeof( defines ), "#define IMAPP_GPU_CLIPPING %d\n#define IMAPP_INSTANCED 0\n#define IMAPP_TEXTURE_ARRAYS %d\n", gpuClipping, textureArrays );
+
+		if( !imappRendererCreateShaderProgram( renderer, &renderer->shaderUber, &renderer->vertexShaderUber, s_vertexShaderUber, defines, s_fragmentShaderUber, 1u << 4u ) )
+		{
+			ImAppTrace( "[renderer] Failed to compile uber program.\n" );
+			return false;
+		}
+	}
+
+	if( renderer->flags & ImAppRendererFlags_InstancedQuads )
+	{
+		char defines[ 128u ];
+		snprintf( defines, sizeof( defines ), "#define IMAPP_GPU_CLIPPING %d\n#define IMAPP_INSTANCED 1\n#define IMAPP_TEXTURE_ARRAYS %d\n", gpuClipping, textureArrays );
+
+		if( !imappRendererCreateShaderProgram( renderer, &renderer->shaderUberInstanced, &renderer->vertexShaderUberInstanced, s_vertexShaderUber, defines, s_fragmentShaderUber, 1u << 5u ) )
+		{
+			ImAppTrace( "[renderer] Failed to compile instanced uber program.\n" );
+			return false;
+		}
+	}
 
 	return true;
 }
@@ -357,62 +1301,314 @@ void imappRendererDestroyResources( ImAppRenderer* renderer )
 	imappRendererDestroyShaderProgram( renderer, &renderer->shaderColor );
 	imappRendererDestroyShaderProgram( renderer, &renderer->shaderFont );
 	imappRendererDestroyShaderProgram( renderer, &renderer->shaderFontSdf );
+	imappRendererDestroyShaderProgram( renderer, &renderer->shaderUber );
+	imappRendererDestroyShaderProgram( renderer, &renderer->shaderUberInstanced );
+	imappRendererDestroyShaderProgram( renderer, &renderer->shaderCache );
 
 	if( renderer->vertexShader != 0u )
 	{
 		glDeleteShader( renderer->vertexShader );
 		renderer->vertexShader = 0u;
 	}
+
+	if( renderer->vertexShaderUber != 0u )
+	{
+		glDeleteShader( renderer->vertexShaderUber );
+		renderer->vertexShaderUber = 0u;
+	}
+
+	if( renderer->vertexShaderUberInstanced != 0u )
+	{
+		glDeleteShader( renderer->vertexShaderUberInstanced );
+		renderer->vertexShaderUberInstanced = 0u;
+	}
+
+	if( renderer->vertexShaderCache != 0u )
+	{
+		glDeleteShader( renderer->vertexShaderCache );
+		renderer->vertexShaderCache = 0u;
+	}
 }
 
-void imappRendererConstructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window )
+void imappRendererConstructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppWindow* platformWindow )
 {
-	glGenBuffers( 1, &window->vertexBuffer );
-	glGenBuffers( 1, &window->elementBuffer );
+	IMAPP_USE( platformWindow );
+
+	window->isStreaming			= (renderer->flags & ImAppRendererFlags_StreamingBuffers) != 0u;
+	window->streamFrameIndex	= 0u;
+	window->stateCache.generation	= renderer->stateGeneration - 1u;
+
+	glGenBuffers( 1, &window->vertexBuffer.buffer );
+	glGenBuffers( 1, &window->elementBuffer.buffer );
 	glGenVertexArrays( 1, &window->vertexArray );
 
 	glBindVertexArray( window->vertexArray );
-	glBindBuffer( GL_ARRAY_BUFFER, window->vertexBuffer );
-	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, window->elementBuffer );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, window->elementBuffer.buffer );
+
+	glEnableVertexAttribArray( ImAppRendererAttribute_Position );
+	glEnableVertexAttribArray( ImAppRendererAttribute_TexCoord );
+	glEnableVertexAttribArray( ImAppRendererAttribute_Color );
+
+	if( renderer->flags & ImAppRendererFlags_UberShader )
+	{
+		glGenBuffers( 1, &window->drawInfoBuffer.buffer );
+		glEnableVertexAttribArray( ImAppRendererAttribute_DrawInfo );
+	}
 
-	const GLuint attributePosition	= (GLuint)glGetAttribLocation( renderer->shaderTexture.program, "Position" );
-	const GLuint attributeTexCoord	= (GLuint)glGetAttribLocation( renderer->shaderTexture.program, "TexCoord" );
-	const GLuint attributeColor		= (GLuint)glGetAttribLocation( renderer->shaderTexture.program, "Color" );
-	glEnableVertexAttribArray( attributePosition );
-	glEnableVertexAttribArray( attributeTexCoord );
-	glEnableVertexAttribArray( attributeColor );
+	if( renderer->flags & ImAppRendererFlags_GpuClipping )
+	{
+		glGenTextures( 1, &window->clipTexture );
+		glActiveTexture( GL_TEXTURE1 );
+		glBindTexture( GL_TEXTURE_2D, window->clipTexture );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+		glActiveTexture( GL_TEXTURE0 );
+
+		window->clipTextureHeight = 0u;
+	}
+
+	imappRendererWindowSetVertexOffset( window, 0u, 0u, false );
+
+	memset( window->timerPending, 0, sizeof( window->timerPending ) );
+	window->timerFrameIndex	= 0u;
+	window->timerStampCount	= IMAPP_RENDERER_TIMER_STAMP_COUNT;
+	if( renderer->flags & ImAppRendererFlags_GpuTimers )
+	{
+		glGenQueries( IMAPP_RENDERER_TIMER_FRAME_COUNT * IMAPP_RENDERER_TIMER_STAMP_COUNT, &window->timerQueries[ 0u ][ 0u ] );
+	}
+
+	if( renderer->flags & ImAppRendererFlags_InstancedQuads )
+	{
+		glGenBuffers( 1, &window->instanceBuffer.buffer );
+		glGenVertexArrays( 1, &window->instanceArray );
+
+		glBindVertexArray( window->instanceArray );
+		glEnableVertexAttribArray( ImAppRendererAttribute_Position );
+		glEnableVertexAttribArray( ImAppRendererAttribute_TexCoord );
+		glEnableVertexAttribArray( ImAppRendererAttribute_Color );
+		glEnableVertexAttribArray( ImAppRendererAttribute_DrawInfo );
+		glVertexAttribDivisor( ImAppRendererAttribute_Position, 1u );
+		glVertexAttribDivisor( ImAppRendererAttribute_TexCoord, 1u );
+		glVertexAttribDivisor( ImAppRendererAttribute_Color, 1u );
+		glVertexAttribDivisor( ImAppRendererAttribute_DrawInfo, 1u );
+		imappRendererWindowSetInstanceOffset( window, 0u );
+	}
 
-	const GLsizei vertexSize	= 20u;
-	size_t vertexPositionOffset	= 0u;
-	size_t vertexUvOffset		= 8u;
-	size_t vertexColorOffset	= 16u;
-	glVertexAttribPointer( attributePosition, 2, GL_FLOAT, GL_FALSE, vertexSize, (void*)vertexPositionOffset );
-	glVertexAttribPointer( attributeTexCoord, 2, GL_FLOAT, GL_FALSE, vertexSize, (void*)vertexUvOffset );
-	glVertexAttribPointer( attributeColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, vertexSize, (void*)vertexColorOffset );
+	glBindVertexArray( 0 );
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
 }
 
 void imappRendererDestructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window )
 {
+	if( renderer->stateWindow == window )
+	{
+		renderer->stateWindow = NULL;
+	}
+
+	imappRendererWindowDestroyStreamFences( window );
+
 	if( window->vertexArray != 0u )
 	{
 		glDeleteVertexArrays( 1, &window->vertexArray );
 		window->vertexArray = 0u;
 	}
 
-	if( window->elementBuffer != 0u )
+	if( window->elementBuffer.buffer != 0u )
+	{
+		glDeleteBuffers( 1, &window->elementBuffer.buffer );
+	}
+
+	if( window->vertexBuffer.buffer != 0u )
+	{
+		glDeleteBuffers( 1, &window->vertexBuffer.buffer );
+	}
+
+	if( window->drawInfoBuffer.buffer != 0u )
+	{
+		glDeleteBuffers( 1, &window->drawInfoBuffer.buffer );
+	}
+
+	if( window->instanceArray != 0u )
+	{
+		glDeleteVertexArrays( 1, &window->instanceArray );
+		window->instanceArray = 0u;
+	}
+
+	for( uintsize i = 0u; i < window->cacheEntryCount; ++i )
+	{
+		window->cacheEntries[ i ].isRequested = false;
+	}
+	imappRendererWindowReleaseCaches( renderer, window );
+
+	if( window->cacheArray != 0u )
+	{
+		glDeleteVertexArrays( 1, &window->cacheArray );
+		window->cacheArray = 0u;
+	}
+
+	if( window->instanceBuffer.buffer != 0u )
+	{
+		glDeleteBuffers( 1, &window->instanceBuffer.buffer );
+	}
+
+	if( window->clipTexture != 0u )
+	{
+		glDeleteTextures( 1, &window->clipTexture );
+		window->clipTexture = 0u;
+	}
+
+	if( window->timerQueries[ 0u ][ 0u ] != 0u )
+	{
+		glDeleteQueries( IMAPP_RENDERER_TIMER_FRAME_COUNT * IMAPP_RENDERER_TIMER_STAMP_COUNT, &window->timerQueries[ 0u ][ 0u ] );
+		memset( window->timerQueries, 0, sizeof( window->timerQueries ) );
+	}
+
+	ImUiMemoryFree( renderer->allocator, window->clipRects );
+	window->clipRects			= NULL;
+	window->clipRectCapacity	= 0u;
+	window->clipRectCount		= 0u;
+
+	ImUiMemoryFree( renderer->allocator, window->vertexBuffer.data );
+	ImUiMemoryFree( renderer->allocator, window->elementBuffer.data );
+	ImUiMemoryFree( renderer->allocator, window->drawInfoBuffer.data );
+	ImUiMemoryFree( renderer->allocator, window->instanceBuffer.data );
+	ImUiMemoryFree( renderer->allocator, window->vertexScratch.data );
+	ImUiMemoryFree( renderer->allocator, window->elementScratch.data );
+	ImUiMemoryFree( renderer->allocator, window->damageCommands );
+	window->damageCommands			= NULL;
+	window->damageCommandCapacity	= 0u;
+	window->damageCommandCount		= 0u;
+	window->isDamageValid			= false;
+
+	memset( &window->vertexBuffer, 0, sizeof( window->vertexBuffer ) );
+	memset( &window->elementBuffer, 0, sizeof( window->elementBuffer ) );
+	memset( &window->drawInfoBuffer, 0, sizeof( window->drawInfoBuffer ) );
+	memset( &window->instanceBuffer, 0, sizeof( window->instanceBuffer ) );
+	memset( &window->vertexScratch, 0, sizeof( window->vertexScratch ) );
+	memset( &window->elementScratch, 0, sizeof( window->elementScratch ) );
+}
+
+static bool imappRendererBufferPrepareData( ImAppRenderer* renderer, ImAppRendererBuffer* buffer, uintsize size )
+{
+	if( size <= buffer->dataSize &&
+		buffer->dataSize <= size * 2 )
+	{
+		return true;
+	}
+
+	size = IMUI_NEXT_POWER_OF_TWO( size );
+	void* data = ImUiMemoryRealloc( renderer->allocator, buffer->data, buffer->dataSize, size );
+	if( data == NULL && size > 0u )
+	{
+		return false;
+	}
+
+	buffer->data		= data;
+	buffer->dataSize	= size;
+	return true;
+}
+
+static void imappRendererBufferPrepareStream( ImAppRendererBuffer* buffer, GLenum target, uintsize size )
+{
+	if( size <= buffer->size )
+	{
+		return;
+	}
+
+	// re-specifying the storage orphans the old one, pending frames keep reading from it
+	buffer->size = IMUI_NEXT_POWER_OF_TWO( size );
+	glBindBuffer( target, buffer->buffer );
+	glBufferData( target, (GLsizeiptr)(buffer->size * IMAPP_RENDERER_STREAM_FRAME_COUNT), NULL, GL_STREAM_DRAW );
+}
+
+static void imappRendererWindowSetVertexOffset( ImAppRendererWindow* window, uintsize vertexOffset, uintsize drawInfoOffset, bool compact )
+{
+	glBindBuffer( GL_ARRAY_BUFFER, window->vertexBuffer.buffer );
+	if( compact )
+	{
+		// positions stay fixed point, the projection removes the scale
+		const GLsizei vertexSize	= sizeof( ImAppRendererCompactVertex );
+		size_t vertexPositionOffset	= vertexOffset + 0u;
+		size_t vertexUvOffset		= vertexOffset + 4u;
+		size_t vertexColorOffset	= vertexOffset + 8u;
+		glVertexAttribPointer( ImAppRendererAttribute_Position, 2, GL_SHORT, GL_FALSE, vertexSize, (void*)vertexPositionOffset );
+		glVertexAttribPointer( ImAppRendererAttribute_TexCoord, 2, GL_UNSIGNED_SHORT, GL_TRUE, vertexSize, (void*)vertexUvOffset );
+		glVertexAttribPointer( ImAppRendererAttribute_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, vertexSize, (void*)vertexColorOffset );
+	}
+	else
+	{
+		const GLsizei vertexSize	= sizeof( ImAppRendererVertex );
+		size_t vertexPositionOffset	= vertexOffset + 0u;
+		size_t vertexUvOffset		= vertexOffset + 8u;
+		size_t vertexColorOffset	= vertexOffset + 16u;
+		glVertexAttribPointer( ImAppRendererAttribute_Position, 2, GL_FLOAT, GL_FALSE, vertexSize, (void*)vertexPositionOffset );
+		glVertexAttribPointer( ImAppRendererAttribute_TexCoord, 2, GL_FLOAT, GL_FALSE, vertexSize, (void*)vertexUvOffset );
+		glVertexAttribPointer( ImAppRendererAttribute_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, vertexSize, (void*)vertexColorOffset );
+	}
+	window->isCompactVertexFormat = compact;
+
+	if( window->drawInfoBuffer.buffer != 0u )
+	{
+		glBindBuffer( GL_ARRAY_BUFFER, window->drawInfoBuffer.buffer );
+		glVertexAttribIPointer( ImAppRendererAttribute_DrawInfo, 4, GL_UNSIGNED_BYTE, 4, (void*)drawInfoOffset );
+		glBindBuffer( GL_ARRAY_BUFFER, window->vertexBuffer.buffer );
+	}
+}
+
+static void imappRendererWindowSetInstanceOffset( ImAppRendererWindow* window, uintsize offset )
+{
+	const GLsizei instanceSize = sizeof( ImAppRendererQuadInstance );
+	glBindBuffer( GL_ARRAY_BUFFER, window->instanceBuffer.buffer );
+	glVertexAttribPointer( ImAppRendererAttribute_Position, 4, GL_FLOAT, GL_FALSE, instanceSize, (void*)(offset + 0u) );
+	glVertexAttribPointer( ImAppRendererAttribute_TexCoord, 4, GL_UNSIGNED_SHORT, GL_TRUE, instanceSize, (void*)(offset + 16u) );
+	glVertexAttribPointer( ImAppRendererAttribute_Color, 4, GL_UNSIGNED_BYTE, GL_TRUE, instanceSize, (void*)(offset + 24u) );
+	glVertexAttribIPointer( ImAppRendererAttribute_DrawInfo, 4, GL_UNSIGNED_BYTE, instanceSize, (void*)(offset + 28u) );
+}
+
+static void imappRendererWindowDestroyStreamFences( ImAppRendererWindow* window )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_STREAMING )
+	for( uintsize i = 0u; i < IMAPP_RENDERER_STREAM_FRAME_COUNT; ++i )
+	{
+		if( window->streamFences[ i ] == NULL )
+		{
+			continue;
+		}
+
+		glDeleteSync( (GLsync)window->streamFences[ i ] );
+		window->streamFences[ i ] = NULL;
+	}
+#else
+	IMAPP_USE( window );
+#endif
+}
+
+static void imappRendererWindowWaitStreamFence( ImAppRendererWindow* window, uintsize frameIndex )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_STREAMING )
+	const GLsync fence = (GLsync)window->streamFences[ frameIndex ];
+	if( fence == NULL )
 	{
-		glDeleteBuffers( 1, &window->elementBuffer );
-		window->elementBuffer = 0u;
+		return;
 	}
 
-	if( window->vertexBuffer != 0u )
+	// one second per try, GL_TIMEOUT_IGNORED is not allowed for client waits
+	GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	GLenum waitResult = GL_TIMEOUT_EXPIRED;
+	do
 	{
-		glDeleteBuffers( 1, &window->vertexBuffer );
-		window->vertexBuffer = 0u;
+		waitResult = glClientWaitSync( fence, waitFlags, 1000000000u );
+		waitFlags = 0u;
 	}
+	while( waitResult == GL_TIMEOUT_EXPIRED );
 
-	ImUiMemoryFree( renderer->allocator, window->vertexBufferData );
-	ImUiMemoryFree( renderer->allocator, window->elementBufferData );
+	glDeleteSync( fence );
+	window->streamFences[ frameIndex ] = NULL;
+#else
+	IMAPP_USE( window );
+	IMAPP_USE( frameIndex );
+#endif
 }
 
 ImAppRendererTexture* imappRendererTextureCreate( ImAppRenderer* renderer )
@@ -439,8 +1635,15 @@ ImAppRendererTexture* imappRendererTextureCreateFromMemory( ImAppRenderer* rende
 
 bool imappRendererTextureInitializeDataFromMemory( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t width, uint32_t height, ImAppRendererFormat format, uint8_t flags )
 {
-	IMAPP_USE( renderer );
+	imappRendererLockContext( renderer );
+	const bool result = imappRendererTextureInitializeData( renderer, texture, data, width, height, format, flags );
+	imappRendererUnlockContext( renderer );
+
+	return result;
+}
 
+static bool imappRendererTextureInitializeData( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t width, uint32_t height, ImAppRendererFormat format, uint8_t flags )
+{
 	if( texture == NULL )
 	{
 		return false;
@@ -449,204 +1652,2549 @@ bool imappRendererTextureInitializeDataFromMemory( ImAppRenderer* renderer, ImAp
 	texture->width		= width;
 	texture->height		= height;
 	texture->flags		= flags;
+	texture->format		= format;
 
-	GLenum sourceFormat = GL_RGBA;
-	GLint targetFormat = GL_RGBA8;
-	switch( format )
+	// array layers are RGBA8 and uploaded right away
+	const ImAppRendererTextureFormat* textureFormat = &s_textureFormats[ format ];
+	const bool isArrayLayer = (renderer->flags & ImAppRendererFlags_TextureArrays) && imappRendererTextureArrayInsert( renderer, texture, data );
+	if( !isArrayLayer )
 	{
-	case ImAppRendererFormat_R8:
-		sourceFormat	= GL_ALPHA;
-		targetFormat	= GL_ALPHA8;
-		break;
+		glGenTextures( 1, &texture->handle );
+		glBindTexture( GL_TEXTURE_2D, texture->handle );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+
+		const GLint wrapMode = flags & ImAppResPakTextureFlags_Repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode );
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_TEXTURE_SWIZZLE )
+		if( textureFormat->isAlphaSwizzled )
+		{
+			// samples like the legacy alpha format: (0, 0, 0, r)
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_R, GL_ZERO );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_ZERO );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_ZERO );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_A, GL_RED );
+		}
+#endif
 
-	case ImAppRendererFormat_RGB8:
-		sourceFormat	= GL_RGB;
-		targetFormat	= GL_RGB8;
-		break;
+		if( width > 0u && height > 0u )
+		{
+			if( renderer->isTextureStorageSupported )
+			{
+				glTexStorage2D( GL_TEXTURE_2D, 1, textureFormat->internalFormat, (GLsizei)width, (GLsizei)height );
+			}
+			else
+			{
+				glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0 );
+				glTexImage2D( GL_TEXTURE_2D, 0, (GLint)textureFormat->internalFormat, (GLsizei)width, (GLsizei)height, 0, textureFormat->uploadFormat, GL_UNSIGNED_BYTE, NULL );
+			}
+
+			// queued data goes straight into a free pixel buffer or waits as CPU copy, synchronous only without budget
+			const uintsize pixelCount	= (uintsize)width * height;
+			const bool isAsync			= data != NULL && renderer->isUploadAsyncSupported && renderer->uploadBudget > 0u;
+			if( !isAsync || !imappRendererTextureEnqueueUpload( renderer, texture, data, pixelCount ) )
+			{
+				void* convertedData = NULL;
+				const void* uploadData = imappRendererTextureConvertData( renderer, format, textureFormat, data, pixelCount, &convertedData );
+				if( uploadData != NULL )
+				{
+					glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+					glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, (GLsizei)width, (GLsizei)height, textureFormat->uploadFormat, GL_UNSIGNED_BYTE, uploadData );
+					glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+				}
 
-	case ImAppRendererFormat_RGBA8:
-		sourceFormat	= GL_RGBA;
-		targetFormat	= GL_RGBA8;
-		break;
+				ImUiMemoryFree( renderer->allocator, convertedData );
+			}
+		}
+		glBindTexture( GL_TEXTURE_2D, 0 );
 	}
 
-	glGenTextures( 1, &texture->handle );
-	glBindTexture( GL_TEXTURE_2D, texture->handle );
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	// texture binding of the current context changed
+	imappRendererInvalidateTextureBinding( renderer );
+	texture->contentGeneration = ++renderer->contentGeneration;
 
-	const GLint wrapMode = flags & ImAppResPakTextureFlags_Repeat ? GL_REPEAT : GL_CLAMP_TO_EDGE;
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode );
-	glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode );
-	glTexImage2D( GL_TEXTURE_2D, 0, targetFormat, (GLsizei)width, (GLsizei)height, 0, sourceFormat, GL_UNSIGNED_BYTE, data );
-	glBindTexture( GL_TEXTURE_2D, 0 );
+	texture->dataSize = (uintsize)width * height * (isArrayLayer ? 4u : textureFormat->uploadBytesPerPixel);
+	renderer->textureCount++;
+	renderer->textureBytes[ format ] += texture->dataSize;
 
 	return true;
 }
 
-void imappRendererTextureDestroyData( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+bool imappRendererTextureIsReady( ImAppRenderer* renderer, const ImAppRendererTexture* texture )
 {
 	IMAPP_USE( renderer );
 
-	if( texture->handle != 0u )
-	{
-		glDeleteTextures( 1u, &texture->handle );
-		texture->handle = 0u;
-	}
+	return !texture->isUploading;
 }
 
-void imappRendererTextureDestroy( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+bool imappRendererTextureUpdateRegion( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height )
 {
-	if( texture == NULL )
-	{
-		return;
-	}
-
-	imappRendererTextureDestroyData( renderer, texture );
+	imappRendererLockContext( renderer );
+	const bool result = imappRendererTextureUploadRegion( renderer, texture, data, x, y, width, height );
+	imappRendererUnlockContext( renderer );
 
-	ImUiMemoryFree( renderer->allocator, texture );
+	return result;
 }
 
-void imappRendererDraw( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, int width, int height, float clearColor[ 4 ] )
+static bool imappRendererTextureUploadRegion( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height )
 {
+	if( x + width > texture->width ||
+		y + height > texture->height )
+	{
+		return false;
+	}
+
+	if( texture->array != NULL )
+	{
+		// arrays are bound to unit 2 for draws, the binding on unit 0 isn't cached
+		const bool result = imappRendererTextureArrayUpload( renderer, texture, data, x, y, width, height );
+		texture->contentGeneration = ++renderer->contentGeneration;
+		return result;
+	}
+
+	if( texture->handle == 0u )
+	{
+		return false;
+	}
+
+	if( texture->isUploading )
+	{
+		// a queued upload would overwrite the region later
+		imappRendererFlushUploads( renderer, texture );
+	}
+
+	const ImAppRendererTextureFormat* textureFormat = &s_textureFormats[ texture->format ];
+
+	void* convertedData = NULL;
+	const void* uploadData = imappRendererTextureConvertData( renderer, texture->format, textureFormat, data, (uintsize)width * height, &convertedData );
+	if( uploadData == NULL )
+	{
+		return false;
+	}
+
+	glBindTexture( GL_TEXTURE_2D, texture->handle );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	glTexSubImage2D( GL_TEXTURE_2D, 0, (GLint)x, (GLint)y, (GLsizei)width, (GLsizei)height, textureFormat->uploadFormat, GL_UNSIGNED_BYTE, uploadData );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+
+	ImUiMemoryFree( renderer->allocator, convertedData );
+
+	imappRendererInvalidateTextureBinding( renderer );
+	texture->contentGeneration = ++renderer->contentGeneration;
+
+	return true;
+}
+
+static bool imappRendererTextureArrayInsert( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data )
+{
+	// wrapping is sampler state of the whole array
+	const uint32 width	= texture->width;
+	const uint32 height	= texture->height;
+	if( (texture->flags & ImAppResPakTextureFlags_Repeat) ||
+		width < IMAPP_RENDERER_TEXTURE_ARRAY_MIN_SIZE ||
+		height < IMAPP_RENDERER_TEXTURE_ARRAY_MIN_SIZE ||
+		(width & (width - 1u)) != 0u ||
+		(height & (height - 1u)) != 0u )
+	{
+		return false;
+	}
+
+	const uint32 fullMask = (1u << IMAPP_RENDERER_TEXTURE_ARRAY_LAYERS) - 1u;
+
+	ImAppRendererTextureArray* array = NULL;
+	for( uintsize i = 0u; i < renderer->textureArrayCount; ++i )
+	{
+		ImAppRendererTextureArray* candidate = renderer->textureArrays[ i ];
+		if( candidate->width == width &&
+			candidate->height == height &&
+			candidate->layerMask != fullMask )
+		{
+			array = candidate;
+			break;
+		}
+	}
+
+	if( array == NULL )
+	{
+		if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->textureArrays, renderer->textureArrayCapacity, renderer->textureArrayCount + 1u ) )
+		{
+			return false;
+		}
+
+		array = IMUI_MEMORY_NEW_ZERO( renderer->allocator, ImAppRendererTextureArray );
+		if( array == NULL )
+		{
+			return false;
+		}
+
+		array->width	= width;
+		array->height	= height;
+
+		glGenTextures( 1, &array->handle );
+		glBindTexture( GL_TEXTURE_2D_ARRAY, array->handle );
+		glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+		if( renderer->isTextureStorageSupported )
+		{
+			glTexStorage3D( GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, (GLsizei)width, (GLsizei)height, IMAPP_RENDERER_TEXTURE_ARRAY_LAYERS );
+		}
+		else
+		{
+			glTexParameteri( GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0 );
+			glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, (GLsizei)width, (GLsizei)height, IMAPP_RENDERER_TEXTURE_ARRAY_LAYERS, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+		}
+		glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+
+		renderer->textureArrays[ renderer->textureArrayCount++ ] = array;
+	}
+
+	uint32 layer = 0u;
+	while( array->layerMask & (1u << layer) )
+	{
+		layer++;
+	}
+
+	array->layerMask	|= 1u << layer;
+	texture->array		= array;
+	texture->layer		= layer;
+
+	if( !imappRendererTextureArrayUpload( renderer, texture, data, 0u, 0u, width, height ) )
+	{
+		imappRendererTextureArrayRemove( renderer, texture );
+		return false;
+	}
+
+	return true;
+}
+
+static bool imappRendererTextureArrayUpload( ImAppRenderer* renderer, const ImAppRendererTexture* texture, const void* data, uint32 x, uint32 y, uint32 width, uint32 height )
+{
+	if( data == NULL )
+	{
+		return true;
+	}
+
+	// layers are RGBA8, other formats get expanded the way GL samples them
+	void* convertedData = NULL;
+	const void* uploadData = imappRendererTextureConvertData( renderer, texture->format, &s_textureFormats[ ImAppRendererFormat_RGBA8 ], data, (uintsize)width * height, &convertedData );
+	if( uploadData == NULL )
+	{
+		return false;
+	}
+
+	glBindTexture( GL_TEXTURE_2D_ARRAY, texture->array->handle );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	glTexSubImage3D( GL_TEXTURE_2D_ARRAY, 0, (GLint)x, (GLint)y, (GLint)texture->layer, (GLsizei)width, (GLsizei)height, 1, GL_RGBA, GL_UNSIGNED_BYTE, uploadData );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+
+	ImUiMemoryFree( renderer->allocator, convertedData );
+	return true;
+}
+
+// Returns data in the upload format of targetFormat, NULL when the conversion buffer can't be allocated. Free *outConvertedData after the upload.
+static const void* imappRendererTextureConvertData( ImAppRenderer* renderer, ImAppRendererFormat format, const ImAppRendererTextureFormat* targetFormat, const void* data, uintsize pixelCount, void** outConvertedData )
+{
+	*outConvertedData = NULL;
+
+	const uint32 dataBytesPerPixel = s_textureFormats[ format ].dataBytesPerPixel;
+	if( data == NULL ||
+		dataBytesPerPixel == targetFormat->uploadBytesPerPixel )
+	{
+		return data;
+	}
+
+	void* rgbaData = ImUiMemoryAlloc( renderer->allocator, pixelCount * 4u );
+	if( rgbaData == NULL )
+	{
+		return NULL;
+	}
+
+	imappRendererTextureConvertDataTo( format, targetFormat, data, pixelCount, rgbaData );
+
+	*outConvertedData = rgbaData;
+	return rgbaData;
+}
+
+// Writes pixelCount pixels of data in the upload format of targetFormat to target.
+static void imappRendererTextureConvertDataTo( ImAppRendererFormat format, const ImAppRendererTextureFormat* targetFormat, const void* data, uintsize pixelCount, void* target )
+{
+	const uint32 dataBytesPerPixel = s_textureFormats[ format ].dataBytesPerPixel;
+	if( dataBytesPerPixel == targetFormat->uploadBytesPerPixel )
+	{
+		memcpy( target, data, pixelCount * dataBytesPerPixel );
+		return;
+	}
+
+	// only expansion to RGBA8 is needed, the way GL would sample the source format
+	uint8_t* rgbaData = (uint8_t*)target;
+	const uint8_t* sourceData = (const uint8_t*)data;
+	if( format == ImAppRendererFormat_R8 )
+	{
+		memset( rgbaData, 0, pixelCount * 4u );
+		for( uintsize i = 0u; i < pixelCount; ++i )
+		{
+			rgbaData[ (i * 4u) + 3u ] = sourceData[ i ];
+		}
+	}
+	else
+	{
+		for( uintsize i = 0u; i < pixelCount; ++i )
+		{
+			rgbaData[ (i * 4u) + 0u ] = sourceData[ (i * 3u) + 0u ];
+			rgbaData[ (i * 4u) + 1u ] = sourceData[ (i * 3u) + 1u ];
+			rgbaData[ (i * 4u) + 2u ] = sourceData[ (i * 3u) + 2u ];
+			rgbaData[ (i * 4u) + 3u ] = 0xffu;
+		}
+	}
+}
+
+static void imappRendererTextureArrayRemove( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+{
+	ImAppRendererTextureArray* array = texture->array;
+	array->layerMask &= ~(1u << texture->layer);
+
+	texture->array	= NULL;
+	texture->layer	= 0u;
+
+	if( array->layerMask != 0u )
+	{
+		return;
+	}
+
+	glDeleteTextures( 1, &array->handle );
+
+	for( uintsize i = 0u; i < renderer->textureArrayCount; ++i )
+	{
+		if( renderer->textureArrays[ i ] == array )
+		{
+			renderer->textureArrays[ i ] = renderer->textureArrays[ --renderer->textureArrayCount ];
+			break;
+		}
+	}
+
+	ImUiMemoryFree( renderer->allocator, array );
+}
+
+static bool imappRendererTextureEnqueueUpload( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uintsize pixelCount )
+{
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->uploads, renderer->uploadCapacity, renderer->uploadCount + 1u ) )
+	{
+		return false;
+	}
+
+	const ImAppRendererTextureFormat* textureFormat = &s_textureFormats[ texture->format ];
+	const uintsize dataSize = pixelCount * textureFormat->uploadBytesPerPixel;
+
+	ImAppRendererUpload* upload = &renderer->uploads[ renderer->uploadCount ];
+	memset( upload, 0, sizeof( *upload ) );
+	upload->texture		= texture;
+	upload->dataSize	= dataSize;
+
+	// the caller releases data right after the texture got created, it goes into a free buffer now or gets copied until one frees up
+	ImAppRendererPixelBuffer* pixelBuffer = imappRendererAcquirePixelBuffer( renderer, dataSize );
+	if( pixelBuffer != NULL &&
+		imappRendererWritePixelBuffer( renderer, pixelBuffer, texture, data, pixelCount, false ) )
+	{
+		upload->pixelBufferIndex	= (uint32)(pixelBuffer - renderer->pixelBuffers);
+		pixelBuffer->isUsed			= true;
+	}
+	else
+	{
+		upload->data = ImUiMemoryAlloc( renderer->allocator, dataSize );
+		if( upload->data == NULL )
+		{
+			return false;
+		}
+
+		imappRendererTextureConvertDataTo( texture->format, textureFormat, data, pixelCount, upload->data );
+	}
+
+	renderer->uploadCount++;
+	texture->isUploading = true;
+
+	return true;
+}
+
+// data is in the source format of texture or already converted to the upload format. Fails when the buffer content got lost.
+static bool imappRendererWritePixelBuffer( ImAppRenderer* renderer, ImAppRendererPixelBuffer* pixelBuffer, const ImAppRendererTexture* texture, const void* data, uintsize pixelCount, bool isConverted )
+{
+	IMAPP_USE( renderer );
+
+	const ImAppRendererTextureFormat* textureFormat = &s_textureFormats[ texture->format ];
+	const uintsize dataSize = pixelCount * textureFormat->uploadBytesPerPixel;
+
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, pixelBuffer->handle );
+	bool isWritten = false;
+	void* mappedData = glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)dataSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT );
+	if( mappedData )
+	{
+		if( isConverted )
+		{
+			memcpy( mappedData, data, dataSize );
+		}
+		else
+		{
+			imappRendererTextureConvertDataTo( texture->format, textureFormat, data, pixelCount, mappedData );
+		}
+
+		// false when the buffer content got lost
+		isWritten = glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER ) == GL_TRUE;
+	}
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+
+	return isWritten;
+}
+
+// Returns a buffer of at least size bytes the GPU doesn't read from, NULL when all buffers are used.
+static ImAppRendererPixelBuffer* imappRendererAcquirePixelBuffer( ImAppRenderer* renderer, uintsize size )
+{
+	ImAppRendererPixelBuffer* pixelBuffer = NULL;
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( renderer->pixelBuffers ); ++i )
+	{
+		ImAppRendererPixelBuffer* candidate = &renderer->pixelBuffers[ i ];
+		if( candidate->isUsed )
+		{
+			continue;
+		}
+
+		if( candidate->fence != NULL )
+		{
+			if( glClientWaitSync( candidate->fence, 0u, 0u ) == GL_TIMEOUT_EXPIRED )
+			{
+				continue;
+			}
+
+			glDeleteSync( candidate->fence );
+			candidate->fence = NULL;
+		}
+
+		// prefer buffers that don't need to grow
+		if( pixelBuffer == NULL ||
+			(pixelBuffer->size < size && candidate->size > pixelBuffer->size) )
+		{
+			pixelBuffer = candidate;
+		}
+	}
+
+	if( pixelBuffer == NULL )
+	{
+		return NULL;
+	}
+
+	if( pixelBuffer->handle == 0u )
+	{
+		glGenBuffers( 1, &pixelBuffer->handle );
+	}
+
+	if( pixelBuffer->size < size )
+	{
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER, pixelBuffer->handle );
+		glBufferData( GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW );
+		glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+
+		pixelBuffer->size = size;
+	}
+
+	return pixelBuffer;
+}
+
+static void imappRendererDestroyPixelBuffers( ImAppRenderer* renderer )
+{
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( renderer->pixelBuffers ); ++i )
+	{
+		ImAppRendererPixelBuffer* pixelBuffer = &renderer->pixelBuffers[ i ];
+		if( pixelBuffer->fence != NULL )
+		{
+			glDeleteSync( pixelBuffer->fence );
+		}
+
+		if( pixelBuffer->handle != 0u )
+		{
+			glDeleteBuffers( 1, &pixelBuffer->handle );
+		}
+
+		memset( pixelBuffer, 0, sizeof( *pixelBuffer ) );
+	}
+}
+
+static void imappRendererUpdateUploads( ImAppRenderer* renderer )
+{
+	if( renderer->uploadCount == 0u )
+	{
+		return;
+	}
+
+	// retire uploads the GPU has finished, their textures are ready and the buffers free
+	uintsize uploadCount = 0u;
+	for( uintsize i = 0u; i < renderer->uploadCount; ++i )
+	{
+		ImAppRendererUpload* upload = &renderer->uploads[ i ];
+		if( upload->isIssued )
+		{
+			ImAppRendererPixelBuffer* pixelBuffer = &renderer->pixelBuffers[ upload->pixelBufferIndex ];
+			if( glClientWaitSync( pixelBuffer->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0u ) != GL_TIMEOUT_EXPIRED )
+			{
+				glDeleteSync( pixelBuffer->fence );
+				pixelBuffer->fence = NULL;
+
+				upload->texture->isUploading = false;
+				imappRendererReleaseUpload( renderer, upload );
+				continue;
+			}
+		}
+
+		renderer->uploads[ uploadCount++ ] = *upload;
+	}
+	renderer->uploadCount = uploadCount;
+
+	// issue queued uploads in order until the budget is used, but at least one per update so large textures can't starve
+	const sint64 startTick	= imappPlatformGetTickValue( renderer->platform );
+	uintsize issuedSize		= 0u;
+	for( uintsize i = 0u; i < renderer->uploadCount; ++i )
+	{
+		ImAppRendererUpload* upload = &renderer->uploads[ i ];
+		if( upload->isIssued )
+		{
+			continue;
+		}
+
+		if( issuedSize > 0u )
+		{
+			if( issuedSize + upload->dataSize > renderer->uploadBudget )
+			{
+				break;
+			}
+
+			const double elapsedMs = imappPlatformTicksToSeconds( renderer->platform, imappPlatformGetTickValue( renderer->platform ) - startTick ) * 1000.0;
+			if( renderer->uploadBudgetMs > 0.0f && elapsedMs >= renderer->uploadBudgetMs )
+			{
+				break;
+			}
+		}
+
+		// CPU copies wait until a buffer frees up
+		if( !imappRendererWriteUpload( renderer, upload ) )
+		{
+			break;
+		}
+
+		imappRendererIssueUpload( renderer, upload );
+		issuedSize += upload->dataSize;
+	}
+}
+
+// Moves the CPU copy of upload into a free pixel buffer. False when all buffers are used.
+static bool imappRendererWriteUpload( ImAppRenderer* renderer, ImAppRendererUpload* upload )
+{
+	if( upload->data == NULL )
+	{
+		return true;
+	}
+
+	ImAppRendererPixelBuffer* pixelBuffer = imappRendererAcquirePixelBuffer( renderer, upload->dataSize );
+	if( pixelBuffer == NULL )
+	{
+		return false;
+	}
+
+	const uintsize pixelCount = upload->dataSize / s_textureFormats[ upload->texture->format ].uploadBytesPerPixel;
+	if( !imappRendererWritePixelBuffer( renderer, pixelBuffer, upload->texture, upload->data, pixelCount, true ) )
+	{
+		// the buffer content got lost, try again with the next update
+		return false;
+	}
+
+	ImUiMemoryFree( renderer->allocator, upload->data );
+	upload->data				= NULL;
+	upload->pixelBufferIndex	= (uint32)(pixelBuffer - renderer->pixelBuffers);
+	pixelBuffer->isUsed			= true;
+
+	return true;
+}
+
+// Copies the pixel buffer to the texture. The GL orders draws after the copy, the texture is ready and the buffer reused once the fence signaled.
+static void imappRendererIssueUpload( ImAppRenderer* renderer, ImAppRendererUpload* upload )
+{
+	ImAppRendererTexture* texture			= upload->texture;
+	ImAppRendererPixelBuffer* pixelBuffer	= &renderer->pixelBuffers[ upload->pixelBufferIndex ];
+
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, pixelBuffer->handle );
+	glBindTexture( GL_TEXTURE_2D, texture->handle );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+	glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, (GLsizei)texture->width, (GLsizei)texture->height, s_textureFormats[ texture->format ].uploadFormat, GL_UNSIGNED_BYTE, NULL );
+	glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+	glBindTexture( GL_TEXTURE_2D, 0 );
+	glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+
+	imappRendererInvalidateTextureBinding( renderer );
+
+	pixelBuffer->fence	= glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0u );
+	upload->isIssued	= true;
+	texture->contentGeneration = ++renderer->contentGeneration;
+}
+
+// The pixel buffer gets free, a fence of an issued copy stays until acquire finds it signaled.
+static void imappRendererReleaseUpload( ImAppRenderer* renderer, ImAppRendererUpload* upload )
+{
+	if( upload->data != NULL )
+	{
+		ImUiMemoryFree( renderer->allocator, upload->data );
+		upload->data = NULL;
+	}
+	else
+	{
+		renderer->pixelBuffers[ upload->pixelBufferIndex ].isUsed = false;
+	}
+}
+
+// Drop the uploads of texture or all uploads when texture is NULL.
+static void imappRendererCancelUploads( ImAppRenderer* renderer, const ImAppRendererTexture* texture )
+{
+	uintsize uploadCount = 0u;
+	for( uintsize i = 0u; i < renderer->uploadCount; ++i )
+	{
+		ImAppRendererUpload* upload = &renderer->uploads[ i ];
+		if( texture == NULL || upload->texture == texture )
+		{
+			upload->texture->isUploading = false;
+			imappRendererReleaseUpload( renderer, upload );
+			continue;
+		}
+
+		renderer->uploads[ uploadCount++ ] = *upload;
+	}
+	renderer->uploadCount = uploadCount;
+}
+
+// Put the queued data of texture into the texture now, the GL orders following updates after it. The texture stays
+// uploading until the fence signaled.
+static void imappRendererFlushUploads( ImAppRenderer* renderer, const ImAppRendererTexture* texture )
+{
+	uintsize uploadCount = 0u;
+	for( uintsize i = 0u; i < renderer->uploadCount; ++i )
+	{
+		ImAppRendererUpload* upload = &renderer->uploads[ i ];
+		if( upload->texture != texture ||
+			upload->isIssued )
+		{
+			renderer->uploads[ uploadCount++ ] = *upload;
+			continue;
+		}
+
+		if( imappRendererWriteUpload( renderer, upload ) )
+		{
+			imappRendererIssueUpload( renderer, upload );
+			renderer->uploads[ uploadCount++ ] = *upload;
+			continue;
+		}
+
+		// no buffer is free, the region update has to land after this data
+		glBindTexture( GL_TEXTURE_2D, texture->handle );
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+		glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, (GLsizei)texture->width, (GLsizei)texture->height, s_textureFormats[ texture->format ].uploadFormat, GL_UNSIGNED_BYTE, upload->data );
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+		glBindTexture( GL_TEXTURE_2D, 0 );
+
+		imappRendererInvalidateTextureBinding( renderer );
+		upload->texture->isUploading = false;
+		imappRendererReleaseUpload( renderer, upload );
+	}
+	renderer->uploadCount = uploadCount;
+}
+
+void imappRendererTextureDestroyData( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+{
+	imappRendererLockContext( renderer );
+	imappRendererTextureDeleteData( renderer, texture );
+	imappRendererUnlockContext( renderer );
+}
+
+static void imappRendererTextureDeleteData( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+{
+	if( texture->isUploading )
+	{
+		imappRendererCancelUploads( renderer, texture );
+	}
+
+	if( texture->array != NULL )
+	{
+		imappRendererTextureArrayRemove( renderer, texture );
+		renderer->stateGeneration++;
+	}
+	else if( texture->handle != 0u )
+	{
+		glDeleteTextures( 1u, &texture->handle );
+		texture->handle = 0u;
+
+		// the name can be reused and is still bound in other contexts
+		renderer->stateGeneration++;
+	}
+
+	if( texture->dataSize > 0u )
+	{
+		renderer->textureCount--;
+		renderer->textureBytes[ texture->format ] -= texture->dataSize;
+		texture->dataSize = 0u;
+	}
+}
+
+void imappRendererTextureDestroy( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+{
+	if( texture == NULL )
+	{
+		return;
+	}
+
+	imappRendererLockContext( renderer );
+
+	// the render thread can still draw it with queued frames and the one in construction
+	if( renderer->contextMutex != NULL &&
+		IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->retiredTextures, renderer->retiredTextureCapacity, renderer->retiredTextureCount + 1u ) )
+	{
+		texture->retireFrameCount = renderer->queuedFrameCount + 1u;
+		renderer->retiredTextures[ renderer->retiredTextureCount++ ] = texture;
+	}
+	else
+	{
+		imappRendererTextureRelease( renderer, texture );
+	}
+
+	imappRendererUnlockContext( renderer );
+}
+
+// Doesn't lock, the context has to be current on the calling thread.
+static void imappRendererTextureRelease( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+{
+	imappRendererTextureDeleteData( renderer, texture );
+
+	ImUiMemoryFree( renderer->allocator, texture );
+}
+
+void imappRendererWindowRequestCache( ImAppRendererWindow* window, ImUiRect rect )
+{
+	for( uintsize i = 0u; i < window->cacheEntryCount; ++i )
+	{
+		ImAppRendererCacheEntry* entry = &window->cacheEntries[ i ];
+		if( memcmp( &entry->rect, &rect, sizeof( rect ) ) == 0 )
+		{
+			entry->isRequested = true;
+			return;
+		}
+	}
+
+	if( window->cacheEntryCount == IMAPP_RENDERER_MAX_CACHE_ENTRIES )
+	{
+		return;
+	}
+
+	ImAppRendererCacheEntry* entry = &window->cacheEntries[ window->cacheEntryCount++ ];
+	memset( entry, 0, sizeof( *entry ) );
+	entry->rect			= rect;
+	entry->isRequested	= true;
+}
+
+bool imappRendererDraw( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, int width, int height, float clearColor[ 4 ], int bufferAge, ImUiRect* outDamageRect )
+{
+	return imappRendererDrawFrame( renderer, window, surface, NULL, width, height, clearColor, bufferAge, outDamageRect );
+}
+
+bool imappRendererDrawPacket( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererDrawPacket* packet, int width, int height, const float* clearColor, int bufferAge, ImUiRect* outDamageRect )
+{
+	return imappRendererDrawFrame( renderer, window, NULL, packet, width, height, clearColor, bufferAge, outDamageRect );
+}
+
+static bool imappRendererDrawFrame( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, const ImAppRendererDrawPacket* packet, int width, int height, const float* clearColor, int bufferAge, ImUiRect* outDamageRect )
+{
+	imappRendererWindowValidateStateCache( renderer, window );
+
+	GLint damageRect[ 4u ] = { 0, 0, width, height };
+	const bool changed = imappRendererDrawCommands( renderer, window, surface, packet, width, height, clearColor, bufferAge, damageRect );
+	imappRendererWindowReleaseCaches( renderer, window );
+
+	// program, texture, blend and scissor stay bound for the state cache
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+	glBindVertexArray( 0 );
+
+	// back to window coordinates
+	outDamageRect->pos.x		= (float)damageRect[ 0u ];
+	outDamageRect->pos.y		= (float)(height - (damageRect[ 1u ] + damageRect[ 3u ]));
+	outDamageRect->size.width	= (float)damageRect[ 2u ];
+	outDamageRect->size.height	= (float)damageRect[ 3u ];
+
+	return changed;
+}
+
+static void imappRendererWindowValidateStateCache( ImAppRenderer* renderer, ImAppRendererWindow* window )
+{
+	ImAppRendererStateCache* cache = &window->stateCache;
+	if( renderer->stateWindow != window )
+	{
+		// the context still has the state the last window left behind
+		if( renderer->stateWindow != NULL )
+		{
+			*cache = renderer->stateWindow->stateCache;
+		}
+		else
+		{
+			cache->generation = renderer->stateGeneration - 1u;
+		}
+		renderer->stateWindow = window;
+	}
+
+	if( cache->generation == renderer->stateGeneration )
+	{
+		return;
+	}
+
+	glBlendEquation( GL_FUNC_ADD );
+	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+
+	glDisable( GL_CULL_FACE );
+	glDisable( GL_DEPTH_TEST );
+
+	cache->generation		= renderer->stateGeneration;
+	cache->program			= (GLuint)-1;
+	cache->texture			= (GLuint)-1;
+	cache->textureArray		= (GLuint)-1;
+	cache->alphaBlend		= -1;
+	cache->scissor[ 0u ]	= -1;
+	cache->scissor[ 1u ]	= -1;
+	cache->scissor[ 2u ]	= -1;
+	cache->scissor[ 3u ]	= -1;
+}
+
+// A texture got bound on unit 0 outside of a draw. Only that slot of the cache is stale, the context state left behind lives in the cache of stateWindow.
+static void imappRendererInvalidateTextureBinding( ImAppRenderer* renderer )
+{
+	if( renderer->stateWindow != NULL )
+	{
+		renderer->stateWindow->stateCache.texture = (GLuint)-1;
+	}
+}
+
+static void* imappRendererWindowMapBuffer( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererBuffer* buffer, GLenum target, uintsize size, uintsize* offset )
+{
+	*offset = 0u;
+	if( size == 0u )
+	{
+		return NULL;
+	}
+
+	glBindBuffer( target, buffer->buffer );
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_STREAMING )
+	if( window->isStreaming )
+	{
+		imappRendererBufferPrepareStream( buffer, target, size );
+		*offset = window->streamFrameIndex * buffer->size;
+
+		// the frame fence guarantees the GPU is done with this range, so no implicit synchronization is needed
+		const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+		return glMapBufferRange( target, (GLintptr)*offset, (GLsizeiptr)size, mapFlags );
+	}
+#else
+	IMAPP_USE( window );
+#endif
+
+	if( !imappRendererBufferPrepareData( renderer, buffer, size ) )
+	{
+		return NULL;
+	}
+
+	return buffer->data;
+}
+
+static bool imappRendererWindowUnmapBuffer( ImAppRendererWindow* window, ImAppRendererBuffer* buffer, GLenum target, uintsize mappedSize, uintsize usedSize )
+{
+	if( mappedSize == 0u )
+	{
+		return true;
+	}
+
+	if( target == GL_ELEMENT_ARRAY_BUFFER )
+	{
+		window->stats.indexBytesUploaded += (uint32_t)usedSize;
+	}
+	else
+	{
+		window->stats.vertexBytesUploaded += (uint32_t)usedSize;
+	}
+
+	glBindBuffer( target, buffer->buffer );
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_STREAMING )
+	if( window->isStreaming )
+	{
+		// false when the content got lost(e.g. display mode change)
+		return glUnmapBuffer( target ) == GL_TRUE;
+	}
+#endif
+
+	glBufferData( target, (GLsizeiptr)usedSize, buffer->data, GL_DYNAMIC_DRAW );
+	return true;
+}
+
+static bool imappRendererWindowGenerateFrame( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, const ImAppRendererDrawPacket* packet, ImAppRendererFrame* frame )
+{
+	if( packet != NULL )
+	{
+		// generated on the main thread, the copy gets converted like scratch data
+		frame->drawData		= &packet->drawData;
+		frame->vertices		= (const ImAppRendererVertex*)packet->vertexData;
+		frame->indices		= (const uint32_t*)packet->indexData;
+		frame->vertexCount	= packet->vertexDataSize / sizeof( ImAppRendererVertex );
+		frame->indexCount	= packet->indexDataSize / sizeof( uint32_t );
+
+		imappRendererFrameChooseFormat( renderer, frame );
+		return true;
+	}
+
+	uintsize vertexDataSize = 0u;
+	uintsize indexDataSize = 0u;
+	ImUiSurfaceGetMaxBufferSizes( surface, &vertexDataSize, &indexDataSize );
+
+	const uintsize maxVertexDataSize	= vertexDataSize;
+	const uintsize maxIndexDataSize		= indexDataSize;
+	const bool convertData				= (renderer->flags & (ImAppRendererFlags_InstancedQuads | ImAppRendererFlags_CompactBuffers | ImAppRendererFlags_DamageTracking)) != 0u || window->cacheEntryCount > 0u;
+	const bool readIndices				= convertData || window->drawInfoBuffer.buffer != 0u;
+
+	void* vertexData = NULL;
+	void* indexData = NULL;
+	void* indexCopyData = NULL;
+	if( convertData )
+	{
+		// converted before upload, generate into CPU memory
+		if( !imappRendererBufferPrepareData( renderer, &window->vertexScratch, maxVertexDataSize ) ||
+			!imappRendererBufferPrepareData( renderer, &window->elementScratch, maxIndexDataSize ) )
+		{
+			return false;
+		}
+
+		vertexData	= window->vertexScratch.data;
+		indexData	= window->elementScratch.data;
+	}
+	else
+	{
+		vertexData = imappRendererWindowMapBuffer( renderer, window, &window->vertexBuffer, GL_ARRAY_BUFFER, maxVertexDataSize, &frame->vertexOffset );
+		indexData = imappRendererWindowMapBuffer( renderer, window, &window->elementBuffer, GL_ELEMENT_ARRAY_BUFFER, maxIndexDataSize, &frame->elementOffset );
+
+		// draw info needs to read back the indices
+		if( readIndices && window->isStreaming && indexData )
+		{
+			if( !imappRendererBufferPrepareData( renderer, &window->elementScratch, maxIndexDataSize ) )
+			{
+				return false;
+			}
+
+			indexCopyData	= indexData;
+			indexData		= window->elementScratch.data;
+		}
+	}
+
+	if( (maxVertexDataSize > 0u && vertexData == NULL) ||
+		(maxIndexDataSize > 0u && indexData == NULL) )
+	{
+		ImAppTrace( "[renderer] Failed to map frame buffers.\n" );
+
+		if( window->isStreaming )
+		{
+			// unmap what got mapped and use staging buffers from now on
+			if( vertexData && !convertData )
+			{
+				imappRendererWindowUnmapBuffer( window, &window->vertexBuffer, GL_ARRAY_BUFFER, maxVertexDataSize, 0u );
+			}
+			if( (indexCopyData || indexData) && !convertData )
+			{
+				imappRendererWindowUnmapBuffer( window, &window->elementBuffer, GL_ELEMENT_ARRAY_BUFFER, maxIndexDataSize, 0u );
+			}
+
+			imappRendererWindowDestroyStreamFences( window );
+			window->isStreaming = false;
+		}
+
+		return false;
+	}
+
+	frame->drawData		= ImUiSurfaceGenerateDrawData( surface, vertexData, &vertexDataSize, indexData, &indexDataSize );
+	frame->vertices		= convertData ? (const ImAppRendererVertex*)vertexData : NULL;
+	frame->indices		= readIndices ? (const uint32_t*)indexData : NULL;
+	frame->vertexCount	= vertexDataSize / sizeof( ImAppRendererVertex );
+	frame->indexCount	= indexDataSize / sizeof( uint32_t );
+
+	if( convertData )
+	{
+		imappRendererFrameChooseFormat( renderer, frame );
+		return frame->drawData != NULL;
+	}
+
+	frame->vertexSize	= sizeof( ImAppRendererVertex );
+	frame->indexSize	= sizeof( uint32_t );
+
+	if( indexCopyData )
+	{
+		memcpy( indexCopyData, indexData, indexDataSize );
+	}
+
+	bool dataValid = frame->drawData != NULL;
+	dataValid &= imappRendererWindowUnmapBuffer( window, &window->vertexBuffer, GL_ARRAY_BUFFER, maxVertexDataSize, vertexDataSize );
+	dataValid &= imappRendererWindowUnmapBuffer( window, &window->elementBuffer, GL_ELEMENT_ARRAY_BUFFER, maxIndexDataSize, indexDataSize );
+	return dataValid;
+}
+
+static bool imappRendererWindowPrepareItems( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererFrame* frame )
+{
+	if( renderer->flags & ImAppRendererFlags_GpuClipping )
+	{
+		if( !imappRendererWindowPrepareClipRects( renderer, window, frame ) )
+		{
+			return false;
+		}
+
+		imappRendererWindowUploadClipRects( window );
+	}
+
+	if( renderer->flags & ImAppRendererFlags_InstancedQuads )
+	{
+		return imappRendererWindowConvertQuads( renderer, window, frame );
+	}
+	else if( frame->vertices &&
+		!imappRendererWindowConvertVertices( renderer, window, frame ) )
+	{
+		return false;
+	}
+
+	const ImUiDrawData* drawData = frame->drawData;
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->items, renderer->itemCapacity, drawData->commandCount ) )
+	{
+		return false;
+	}
+
+	uintsize elementOffset = frame->elementOffset;
+	for( uintsize i = 0u; i < drawData->commandCount; ++i )
+	{
+		ImAppRendererDrawItem* item = &renderer->items[ i ];
+		item->commandIndex	= (uint32)i;
+		item->instanced		= false;
+		item->first			= elementOffset;
+		item->count			= drawData->commands[ i ].count;
+
+		elementOffset += item->count * frame->indexSize;
+	}
+	frame->itemCount = drawData->commandCount;
+
+	if( window->drawInfoBuffer.buffer == 0u )
+	{
+		return true;
+	}
+
+	const uintsize drawInfoSize = frame->vertexCount * 4u;
+	uint8_t* drawInfo = (uint8_t*)imappRendererWindowMapBuffer( renderer, window, &window->drawInfoBuffer, GL_ARRAY_BUFFER, drawInfoSize, &frame->drawInfoOffset );
+	if( drawInfo == NULL )
+	{
+		return drawInfoSize == 0u;
+	}
+
+	imappRendererFillDrawInfo( renderer, frame, drawInfo );
+	return imappRendererWindowUnmapBuffer( window, &window->drawInfoBuffer, GL_ARRAY_BUFFER, drawInfoSize, drawInfoSize );
+}
+
+static uint8_t imappRendererGetDrawMode( const ImUiDrawCommand* command )
+{
+	const ImAppRendererTexture* texture = (const ImAppRendererTexture*)command->textureHandle;
+	if( texture == NULL )
+	{
+		return ImAppRendererDrawMode_Color;
+	}
+	else if( texture->flags & ImAppResPakTextureFlags_Font )
+	{
+		return ImAppRendererDrawMode_Font;
+	}
+	else if( texture->flags & ImAppResPakTextureFlags_FontSdf )
+	{
+		return ImAppRendererDrawMode_FontSdf;
+	}
+
+	return ImAppRendererDrawMode_Texture;
+}
+
+static uint8_t imappRendererGetDrawLayer( const ImUiDrawCommand* command )
+{
+	const ImAppRendererTexture* texture = (const ImAppRendererTexture*)command->textureHandle;
+	if( texture == NULL || texture->array == NULL )
+	{
+		return 0u;
+	}
+
+	return (uint8_t)(texture->layer + 1u);
+}
+
+static void imappRendererFillDrawInfo( ImAppRenderer* renderer, const ImAppRendererFrame* frame, uint8_t* drawInfo )
+{
+	const bool gpuClipping = (renderer->flags & ImAppRendererFlags_GpuClipping) != 0u;
+
+	const uint32_t* indices = frame->indices;
+	for( uintsize i = 0u; i < frame->drawData->commandCount; ++i )
+	{
+		const ImUiDrawCommand* command = &frame->drawData->commands[ i ];
+
+		const uint8_t mode = imappRendererGetDrawMode( command );
+		const uint8_t layer = imappRendererGetDrawLayer( command );
+		const uint16_t clipIndex = gpuClipping ? renderer->commandClipIndices[ i ] : 0u;
+
+		uint32_t minIndex = UINT32_MAX;
+		uint32_t maxIndex = 0u;
+		for( uintsize j = 0u; j < command->count; ++j )
+		{
+			const uint32_t index = indices[ j ];
+			minIndex = index < minIndex ? index : minIndex;
+			maxIndex = index > maxIndex ? index : maxIndex;
+		}
+		indices += command->count;
+
+		if( minIndex > maxIndex || maxIndex >= frame->vertexCount )
+		{
+			continue;
+		}
+
+		for( uint32_t vertexIndex = minIndex; vertexIndex <= maxIndex; ++vertexIndex )
+		{
+			uint8_t* vertexDrawInfo = &drawInfo[ vertexIndex * 4u ];
+			vertexDrawInfo[ 0u ] = mode;
+			vertexDrawInfo[ 1u ] = layer;
+			vertexDrawInfo[ 2u ] = (uint8_t)(clipIndex & 0xffu);
+			vertexDrawInfo[ 3u ] = (uint8_t)(clipIndex >> 8u);
+		}
+	}
+}
+
+static bool imappRendererBuildQuadInstance( const ImAppRendererVertex* vertices, uintsize vertexCount, const uint32_t* indices, ImAppRendererQuadInstance* instance )
+{
+	// two triangles over four distinct vertices
+	uint32_t quadIndices[ 4u ];
+	uintsize quadIndexCount = 0u;
+	for( uintsize i = 0u; i < 6u; ++i )
+	{
+		const uint32_t index = indices[ i ];
+		if( index >= vertexCount )
+		{
+			return false;
+		}
+
+		bool found = false;
+		for( uintsize j = 0u; j < quadIndexCount; ++j )
+		{
+			found |= quadIndices[ j ] == index;
+		}
+
+		if( found )
+		{
+			continue;
+		}
+		else if( quadIndexCount == 4u )
+		{
+			return false;
+		}
+
+		quadIndices[ quadIndexCount++ ] = index;
+	}
+
+	if( quadIndexCount != 4u )
+	{
+		return false;
+	}
+
+	const ImAppRendererVertex* firstVertex = &vertices[ quadIndices[ 0u ] ];
+	float left		= firstVertex->position[ 0u ];
+	float top		= firstVertex->position[ 1u ];
+	float right		= left;
+	float bottom	= top;
+	for( uintsize i = 1u; i < 4u; ++i )
+	{
+		const ImAppRendererVertex* vertex = &vertices[ quadIndices[ i ] ];
+		left	= IMUI_MIN( left, vertex->position[ 0u ] );
+		top		= IMUI_MIN( top, vertex->position[ 1u ] );
+		right	= IMUI_MAX( right, vertex->position[ 0u ] );
+		bottom	= IMUI_MAX( bottom, vertex->position[ 1u ] );
+	}
+
+	if( left == right || top == bottom )
+	{
+		return false;
+	}
+
+	// every vertex on its own corner with a uv that only depends on the corner and one color
+	float cornerUvs[ 4u ][ 2u ];
+	uint32 cornerMask = 0u;
+	uint32 vertexCorners[ 4u ];
+	for( uintsize i = 0u; i < 4u; ++i )
+	{
+		const ImAppRendererVertex* vertex = &vertices[ quadIndices[ i ] ];
+		if( (vertex->position[ 0u ] != left && vertex->position[ 0u ] != right) ||
+			(vertex->position[ 1u ] != top && vertex->position[ 1u ] != bottom) ||
+			vertex->color != firstVertex->color ||
+			vertex->uv[ 0u ] < 0.0f || vertex->uv[ 0u ] > 1.0f ||
+			vertex->uv[ 1u ] < 0.0f || vertex->uv[ 1u ] > 1.0f )
+		{
+			return false;
+		}
+
+		const uint32 corner = (vertex->position[ 0u ] == right ? 1u : 0u) | (vertex->position[ 1u ] == bottom ? 2u : 0u);
+		if( cornerMask & (1u << corner) )
+		{
+			return false;
+		}
+
+		cornerMask |= 1u << corner;
+		vertexCorners[ i ] = corner;
+		cornerUvs[ corner ][ 0u ] = vertex->uv[ 0u ];
+		cornerUvs[ corner ][ 1u ] = vertex->uv[ 1u ];
+	}
+
+	if( cornerUvs[ 0u ][ 0u ] != cornerUvs[ 2u ][ 0u ] || cornerUvs[ 1u ][ 0u ] != cornerUvs[ 3u ][ 0u ] ||
+		cornerUvs[ 0u ][ 1u ] != cornerUvs[ 1u ][ 1u ] || cornerUvs[ 2u ][ 1u ] != cornerUvs[ 3u ][ 1u ] )
+	{
+		return false;
+	}
+
+	// both triangles must leave out opposite corners, otherwise they overlap
+	uint32 missingCorners[ 2u ];
+	for( uintsize triangle = 0u; triangle < 2u; ++triangle )
+	{
+		uint32 triangleMask = 0u;
+		for( uintsize i = 0u; i < 3u; ++i )
+		{
+			const uint32_t index = indices[ (triangle * 3u) + i ];
+			for( uintsize j = 0u; j < 4u; ++j )
+			{
+				if( quadIndices[ j ] == index )
+				{
+					triangleMask |= 1u << vertexCorners[ j ];
+				}
+			}
+		}
+
+		switch( triangleMask ^ 0xfu )
+		{
+		case 1u: missingCorners[ triangle ] = 0u; break;
+		case 2u: missingCorners[ triangle ] = 1u; break;
+		case 4u: missingCorners[ triangle ] = 2u; break;
+		case 8u: missingCorners[ triangle ] = 3u; break;
+		default: return false;
+		}
+	}
+
+	if( (missingCorners[ 0u ] ^ missingCorners[ 1u ]) != 3u )
+	{
+		return false;
+	}
+
+	instance->rect[ 0u ]	= left;
+	instance->rect[ 1u ]	= top;
+	instance->rect[ 2u ]	= right;
+	instance->rect[ 3u ]	= bottom;
+	instance->uvRect[ 0u ]	= (uint16_t)(cornerUvs[ 0u ][ 0u ] * 65535.0f + 0.5f);
+	instance->uvRect[ 1u ]	= (uint16_t)(cornerUvs[ 0u ][ 1u ] * 65535.0f + 0.5f);
+	instance->uvRect[ 2u ]	= (uint16_t)(cornerUvs[ 3u ][ 0u ] * 65535.0f + 0.5f);
+	instance->uvRect[ 3u ]	= (uint16_t)(cornerUvs[ 3u ][ 1u ] * 65535.0f + 0.5f);
+	instance->color			= firstVertex->color;
+
+	return true;
+}
+
+static bool imappRendererAddItem( ImAppRenderer* renderer, ImAppRendererFrame* frame, uint32 commandIndex, bool instanced, uintsize first, uintsize count )
+{
+	if( frame->itemCount > 0u )
+	{
+		ImAppRendererDrawItem* lastItem = &renderer->items[ frame->itemCount - 1u ];
+		if( lastItem->commandIndex == commandIndex &&
+			lastItem->instanced == instanced )
+		{
+			lastItem->count += count;
+			return true;
+		}
+	}
+
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->items, renderer->itemCapacity, frame->itemCount + 1u ) )
+	{
+		return false;
+	}
+
+	ImAppRendererDrawItem* item = &renderer->items[ frame->itemCount++ ];
+	item->commandIndex	= commandIndex;
+	item->instanced		= instanced;
+	item->first			= first;
+	item->count			= count;
+	return true;
+}
+
+static bool imappRendererWindowConvertQuads( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererFrame* frame )
+{
+	const ImUiDrawData* drawData	= frame->drawData;
+	const bool gpuClipping			= (renderer->flags & ImAppRendererFlags_GpuClipping) != 0u;
+
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->vertexRemap, renderer->vertexRemapCapacity, frame->vertexCount ) )
+	{
+		return false;
+	}
+	memset( renderer->vertexRemap, 0xff, sizeof( *renderer->vertexRemap ) * frame->vertexCount );
+
+	// worst case sizes, only non quad geometry ends up in the vertex and index buffers
+	const uintsize maxVertexSize	= frame->vertexCount * frame->vertexSize;
+	const uintsize maxIndexSize		= frame->indexCount * frame->indexSize;
+	const uintsize maxInstanceSize	= (frame->indexCount / 6u) * sizeof( ImAppRendererQuadInstance );
+	const uintsize maxDrawInfoSize	= frame->vertexCount * 4u;
+
+	void* vertices							= imappRendererWindowMapBuffer( renderer, window, &window->vertexBuffer, GL_ARRAY_BUFFER, maxVertexSize, &frame->vertexOffset );
+	void* indices							= imappRendererWindowMapBuffer( renderer, window, &window->elementBuffer, GL_ELEMENT_ARRAY_BUFFER, maxIndexSize, &frame->elementOffset );
+	ImAppRendererQuadInstance* instances	= (ImAppRendererQuadInstance*)imappRendererWindowMapBuffer( renderer, window, &window->instanceBuffer, GL_ARRAY_BUFFER, maxInstanceSize, &frame->instanceOffset );
+	uint8_t* drawInfos						= (uint8_t*)imappRendererWindowMapBuffer( renderer, window, &window->drawInfoBuffer, GL_ARRAY_BUFFER, maxDrawInfoSize, &frame->drawInfoOffset );
+
+	bool dataValid = (vertices || maxVertexSize == 0u) &&
+		(indices || maxIndexSize == 0u) &&
+		(instances || maxInstanceSize == 0u) &&
+		(drawInfos || maxDrawInfoSize == 0u);
+
+	uintsize vertexCount = 0u;
+	uintsize indexCount = 0u;
+	uintsize instanceCount = 0u;
+	frame->itemCount = 0u;
+
+	const uint32_t* sourceIndices = frame->indices;
+	for( uintsize i = 0u; i < drawData->commandCount && dataValid; ++i )
+	{
+		const ImUiDrawCommand* command = &drawData->commands[ i ];
+
+		const uint8_t mode = imappRendererGetDrawMode( command );
+		const uint16_t clipIndex = gpuClipping ? renderer->commandClipIndices[ i ] : 0u;
+		const uint8_t drawInfo[ 4u ] = { mode, imappRendererGetDrawLayer( command ), (uint8_t)(clipIndex & 0xffu), (uint8_t)(clipIndex >> 8u) };
+
+		const bool isTriangleList		= command->topology != ImUiDrawTopology_LineList;
+		const uintsize primitiveSize	= isTriangleList ? 3u : 2u;
+
+		uintsize j = 0u;
+		while( j < command->count && dataValid )
+		{
+			if( isTriangleList &&
+				j + 6u <= command->count &&
+				imappRendererBuildQuadInstance( frame->vertices, frame->vertexCount, &sourceIndices[ j ], &instances[ instanceCount ] ) )
+			{
+				memcpy( instances[ instanceCount ].drawInfo, drawInfo, sizeof( drawInfo ) );
+				dataValid &= imappRendererAddItem( renderer, frame, (uint32)i, true, instanceCount, 1u );
+
+				instanceCount++;
+				j += 6u;
+				continue;
+			}
+
+			const uintsize primitiveIndexCount = IMUI_MIN( primitiveSize, command->count - j );
+			for( uintsize k = 0u; k < primitiveIndexCount; ++k )
+			{
+				const uint32_t sourceIndex = sourceIndices[ j + k ];
+				if( sourceIndex >= frame->vertexCount )
+				{
+					dataValid = false;
+					break;
+				}
+
+				uint32_t* remappedIndex = &renderer->vertexRemap[ sourceIndex ];
+				if( *remappedIndex == UINT32_MAX )
+				{
+					*remappedIndex = (uint32_t)vertexCount;
+					imappRendererFrameWriteVertex( frame, vertices, vertexCount, &frame->vertices[ sourceIndex ] );
+					memcpy( &drawInfos[ vertexCount * 4u ], drawInfo, sizeof( drawInfo ) );
+					vertexCount++;
+				}
+
+				imappRendererFrameWriteIndex( frame, indices, indexCount + k, *remappedIndex );
+			}
+
+			dataValid &= imappRendererAddItem( renderer, frame, (uint32)i, false, frame->elementOffset + (indexCount * frame->indexSize), primitiveIndexCount );
+
+			indexCount += primitiveIndexCount;
+			j += primitiveIndexCount;
+		}
+
+		sourceIndices += command->count;
+	}
+
+	if( vertices )
+	{
+		dataValid &= imappRendererWindowUnmapBuffer( window, &window->vertexBuffer, GL_ARRAY_BUFFER, maxVertexSize, vertexCount * frame->vertexSize );
+	}
+	if( indices )
+	{
+		dataValid &= imappRendererWindowUnmapBuffer( window, &window->elementBuffer, GL_ELEMENT_ARRAY_BUFFER, maxIndexSize, indexCount * frame->indexSize );
+	}
+	if( instances )
+	{
+		dataValid &= imappRendererWindowUnmapBuffer( window, &window->instanceBuffer, GL_ARRAY_BUFFER, maxInstanceSize, instanceCount * sizeof( ImAppRendererQuadInstance ) );
+	}
+	if( drawInfos )
+	{
+		dataValid &= imappRendererWindowUnmapBuffer( window, &window->drawInfoBuffer, GL_ARRAY_BUFFER, maxDrawInfoSize, vertexCount * 4u );
+	}
+
+	return dataValid;
+}
+
+static void imappRendererFrameChooseFormat( ImAppRenderer* renderer, ImAppRendererFrame* frame )
+{
+	frame->vertexSize	= sizeof( ImAppRendererVertex );
+	frame->indexSize	= sizeof( uint32_t );
+
+	if( (renderer->flags & ImAppRendererFlags_CompactBuffers) == 0u )
+	{
+		return;
+	}
+
+	if( frame->vertexCount <= 0x10000u )
+	{
+		frame->indexSize = sizeof( uint16_t );
+	}
+
+	// positions out of the fixed point range or repeating uvs need the full format
+	const float minPosition = -32768.0f / IMAPP_RENDERER_COMPACT_POSITION_SCALE;
+	const float maxPosition = 32767.0f / IMAPP_RENDERER_COMPACT_POSITION_SCALE;
+	for( uintsize i = 0u; i < frame->vertexCount; ++i )
+	{
+		const ImAppRendererVertex* vertex = &frame->vertices[ i ];
+		if( vertex->position[ 0u ] < minPosition || vertex->position[ 0u ] > maxPosition ||
+			vertex->position[ 1u ] < minPosition || vertex->position[ 1u ] > maxPosition ||
+			vertex->uv[ 0u ] < 0.0f || vertex->uv[ 0u ] > 1.0f ||
+			vertex->uv[ 1u ] < 0.0f || vertex->uv[ 1u ] > 1.0f )
+		{
+			return;
+		}
+	}
+
+	frame->vertexSize = sizeof( ImAppRendererCompactVertex );
+}
+
+static void imappRendererFrameWriteVertex( const ImAppRendererFrame* frame, void* vertices, uintsize index, const ImAppRendererVertex* sourceVertex )
+{
+	if( frame->vertexSize == sizeof( ImAppRendererVertex ) )
+	{
+		((ImAppRendererVertex*)vertices)[ index ] = *sourceVertex;
+		return;
+	}
+
+	ImAppRendererCompactVertex* vertex = &((ImAppRendererCompactVertex*)vertices)[ index ];
+	for( uintsize i = 0u; i < 2u; ++i )
+	{
+		const float position = sourceVertex->position[ i ] * IMAPP_RENDERER_COMPACT_POSITION_SCALE;
+		vertex->position[ i ]	= (int16_t)(position < 0.0f ? position - 0.5f : position + 0.5f);
+		vertex->uv[ i ]			= (uint16_t)((sourceVertex->uv[ i ] * 65535.0f) + 0.5f);
+	}
+	vertex->color = sourceVertex->color;
+}
+
+static void imappRendererFrameWriteIndex( const ImAppRendererFrame* frame, void* indices, uintsize index, uint32_t value )
+{
+	if( frame->indexSize == sizeof( uint16_t ) )
+	{
+		((uint16_t*)indices)[ index ] = (uint16_t)value;
+	}
+	else
+	{
+		((uint32_t*)indices)[ index ] = value;
+	}
+}
+
+static bool imappRendererWindowConvertVertices( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererFrame* frame )
+{
+	const uintsize vertexSize	= frame->vertexCount * frame->vertexSize;
+	const uintsize indexSize	= frame->indexCount * frame->indexSize;
+
+	void* vertices	= imappRendererWindowMapBuffer( renderer, window, &window->vertexBuffer, GL_ARRAY_BUFFER, vertexSize, &frame->vertexOffset );
+	void* indices	= imappRendererWindowMapBuffer( renderer, window, &window->elementBuffer, GL_ELEMENT_ARRAY_BUFFER, indexSize, &frame->elementOffset );
+
+	bool dataValid = (vertices || vertexSize == 0u) &&
+		(indices || indexSize == 0u);
+
+	if( dataValid )
+	{
+		for( uintsize i = 0u; i < frame->vertexCount; ++i )
+		{
+			imappRendererFrameWriteVertex( frame, vertices, i, &frame->vertices[ i ] );
+		}
+
+		for( uintsize i = 0u; i < frame->indexCount; ++i )
+		{
+			imappRendererFrameWriteIndex( frame, indices, i, frame->indices[ i ] );
+		}
+	}
+
+	if( vertices )
+	{
+		dataValid &= imappRendererWindowUnmapBuffer( window, &window->vertexBuffer, GL_ARRAY_BUFFER, vertexSize, vertexSize );
+	}
+	if( indices )
+	{
+		dataValid &= imappRendererWindowUnmapBuffer( window, &window->elementBuffer, GL_ELEMENT_ARRAY_BUFFER, indexSize, indexSize );
+	}
+
+	return dataValid;
+}
+
+static void imappRendererGetScissorRect( const ImUiDrawCommand* command, int height, GLint* scissor )
+{
+	scissor[ 0u ] = (GLint)(command->clipRect.pos.x);
+	scissor[ 1u ] = (GLint)((height - (GLint)(command->clipRect.pos.y + command->clipRect.size.height)));
+	scissor[ 2u ] = (GLint)(command->clipRect.size.width);
+	scissor[ 3u ] = (GLint)(command->clipRect.size.height);
+}
+
+static bool imappRendererWindowPrepareClipRects( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame )
+{
+	const ImUiDrawData* drawData = frame->drawData;
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->commandClipIndices, renderer->commandClipIndexCapacity, drawData->commandCount ) )
+	{
+		return false;
+	}
+
+	// index 0 is unclipped, commands past the index range fall back to scissoring
+	window->clipRectCount = 0u;
+	ImAppRendererClipRect unclipped = { -1.0e9f, -1.0e9f, 1.0e9f, 1.0e9f };
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, window->clipRects, window->clipRectCapacity, IMAPP_RENDERER_CLIP_TEXTURE_WIDTH ) )
+	{
+		return false;
+	}
+	window->clipRects[ window->clipRectCount++ ] = unclipped;
+
+	GLint lastScissor[ 4u ] = { -1, -1, -1, -1 };
+	uint16_t lastClipIndex = 0u;
+	for( uintsize i = 0u; i < drawData->commandCount; ++i )
+	{
+		GLint scissor[ 4u ];
+		imappRendererGetScissorRect( &drawData->commands[ i ], frame->height, scissor );
+
+		if( memcmp( scissor, lastScissor, sizeof( scissor ) ) == 0 )
+		{
+			renderer->commandClipIndices[ i ] = lastClipIndex;
+			continue;
+		}
+
+		memcpy( lastScissor, scissor, sizeof( scissor ) );
+		lastClipIndex = 0u;
+
+		if( window->clipRectCount < IMAPP_RENDERER_MAX_CLIP_RECTS )
+		{
+			const uintsize rowCount = (window->clipRectCount / IMAPP_RENDERER_CLIP_TEXTURE_WIDTH) + 1u;
+			if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, window->clipRects, window->clipRectCapacity, rowCount * IMAPP_RENDERER_CLIP_TEXTURE_WIDTH ) )
+			{
+				return false;
+			}
+
+			ImAppRendererClipRect* clipRect = &window->clipRects[ window->clipRectCount ];
+			clipRect->left		= (float)scissor[ 0u ];
+			clipRect->bottom	= (float)scissor[ 1u ];
+			clipRect->right		= (float)(scissor[ 0u ] + scissor[ 2u ]);
+			clipRect->top		= (float)(scissor[ 1u ] + scissor[ 3u ]);
+
+			lastClipIndex = (uint16_t)window->clipRectCount++;
+		}
+
+		renderer->commandClipIndices[ i ] = lastClipIndex;
+	}
+
+	return true;
+}
+
+static void imappRendererWindowUploadClipRects( ImAppRendererWindow* window )
+{
+	const uintsize rowCount = (window->clipRectCount + IMAPP_RENDERER_CLIP_TEXTURE_WIDTH - 1u) / IMAPP_RENDERER_CLIP_TEXTURE_WIDTH;
+
+	glActiveTexture( GL_TEXTURE1 );
+	glBindTexture( GL_TEXTURE_2D, window->clipTexture );
+
+	if( rowCount > window->clipTextureHeight )
+	{
+		window->clipTextureHeight = (uint32_t)IMUI_NEXT_POWER_OF_TWO( rowCount );
+		glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA32F, IMAPP_RENDERER_CLIP_TEXTURE_WIDTH, (GLsizei)window->clipTextureHeight, 0, GL_RGBA, GL_FLOAT, NULL );
+	}
+
+	glTexSubImage2D( GL_TEXTURE_2D, 0, 0, 0, IMAPP_RENDERER_CLIP_TEXTURE_WIDTH, (GLsizei)rowCount, GL_RGBA, GL_FLOAT, window->clipRects );
+	glActiveTexture( GL_TEXTURE0 );
+}
+
+static void imappRendererWindowResetFrameStats( ImAppRendererWindow* window )
+{
+	// cache hits and misses are totals, GPU times lag behind and are only replaced by new results
+	window->stats.commandCount			= 0u;
+	window->stats.drawCallCount			= 0u;
+	window->stats.programChangeCount	= 0u;
+	window->stats.textureChangeCount	= 0u;
+	window->stats.scissorChangeCount	= 0u;
+	window->stats.vertexBytesUploaded	= 0u;
+	window->stats.indexBytesUploaded	= 0u;
+}
+
+static bool imappRendererDrawCommands( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, const ImAppRendererDrawPacket* packet, int width, int height, const float* clearColor, int bufferAge, GLint* damageRect )
+{
+	width = width <= 0 ? 1 : width;
+	height = height <= 0 ? 1 : height;
+
+	imappRendererWindowResetFrameStats( window );
+
+	// bind buffers
+	glBindVertexArray( window->vertexArray );
+	glBindBuffer( GL_ARRAY_BUFFER, window->vertexBuffer.buffer );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, window->elementBuffer.buffer );
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_STREAMING )
+	if( window->isStreaming )
+	{
+		window->streamFrameIndex = (window->streamFrameIndex + 1u) % IMAPP_RENDERER_STREAM_FRAME_COUNT;
+		imappRendererWindowWaitStreamFence( window, window->streamFrameIndex );
+	}
+#endif
+
+	ImAppRendererFrame frame;
+	memset( &frame, 0, sizeof( frame ) );
+	frame.width				= width;
+	frame.height			= height;
+	frame.redrawRect[ 2u ]	= width;
+	frame.redrawRect[ 3u ]	= height;
+
+	const bool generated = imappRendererWindowGenerateFrame( renderer, window, surface, packet, &frame );
+
+	bool hasCommandHashes = false;
+	if( generated &&
+		((renderer->flags & ImAppRendererFlags_DamageTracking) || window->cacheEntryCount > 0u) )
+	{
+		hasCommandHashes = imappRendererHashCommands( renderer, &frame );
+	}
+
+	if( generated )
+	{
+		imappRendererWindowUpdateCache( renderer, window, &frame, hasCommandHashes );
+	}
+
+	if( generated &&
+		(renderer->flags & ImAppRendererFlags_DamageTracking) &&
+		!imappRendererWindowUpdateDamage( renderer, window, &frame, clearColor, bufferAge, damageRect, hasCommandHashes ) )
+	{
+		window->stats.commandCount	= 0u;
+		window->stats.drawCallCount	= 0u;
+		return false;
+	}
+
+	imappRendererWindowBeginTimer( renderer, window );
+
 	glViewport( 0, 0, width, height );
+	glClearColor( clearColor[ 0u ], clearColor[ 1u ], clearColor[ 2u ], clearColor[ 3u ] );
+
+	ImAppRendererStateCache* cache = &window->stateCache;
+	if( frame.redrawRect[ 0u ] == 0 && frame.redrawRect[ 1u ] == 0 &&
+		frame.redrawRect[ 2u ] == width && frame.redrawRect[ 3u ] == height )
+	{
+		glDisable( GL_SCISSOR_TEST );
+		glClear( GL_COLOR_BUFFER_BIT );
+		glEnable( GL_SCISSOR_TEST );
+	}
+	else
+	{
+		glScissor( frame.redrawRect[ 0u ], frame.redrawRect[ 1u ], frame.redrawRect[ 2u ], frame.redrawRect[ 3u ] );
+		memcpy( cache->scissor, frame.redrawRect, sizeof( cache->scissor ) );
+		glClear( GL_COLOR_BUFFER_BIT );
+	}
+	imappRendererWindowWriteTimestamp( renderer, window, ImAppRendererTimestamp_Cleared );
+
+	if( !generated ||
+		!imappRendererWindowPrepareItems( renderer, window, &frame ) )
+	{
+		imappRendererWindowWriteTimestamp( renderer, window, ImAppRendererTimestamp_End );
+		return true;
+	}
+
+	// every item can become a batch, merging can't fail after this
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->batches, renderer->batchCapacity, frame.itemCount ) )
+	{
+		ImAppTrace( "[renderer] Failed to allocate draw batches. Keeping the last frame.\n" );
+
+		// the next frame has to redraw everything
+		window->isDamageValid		= false;
+		window->stats.commandCount	= 0u;
+		window->stats.drawCallCount	= 0u;
+		imappRendererWindowWriteTimestamp( renderer, window, ImAppRendererTimestamp_End );
+		return false;
+	}
+
+	const bool compactVertices = frame.vertexSize == sizeof( ImAppRendererCompactVertex );
+	if( window->isStreaming || window->isCompactVertexFormat != compactVertices )
+	{
+		imappRendererWindowSetVertexOffset( window, frame.vertexOffset, frame.drawInfoOffset, compactVertices );
+	}
+
+	// render stable cached windows into their texture before they get composited
+	for( uintsize i = 0u; i < window->cacheEntryCount; ++i )
+	{
+		ImAppRendererCacheEntry* entry = &window->cacheEntries[ i ];
+		if( entry->commandCount == 0u )
+		{
+			continue;
+		}
+
+		if( entry->isValid )
+		{
+			window->stats.cacheHitCount++;
+			continue;
+		}
+
+		window->stats.cacheMissCount++;
+		if( entry->stableFrameCount >= IMAPP_RENDERER_CACHE_STABLE_FRAMES )
+		{
+			entry->isValid = imappRendererWindowFillCache( renderer, window, &frame, entry );
+		}
+	}
+	imappRendererWindowWriteTimestamp( renderer, window, ImAppRendererTimestamp_CacheFilled );
+
+	const uintsize batchCount = imappRendererMergeCommands( renderer, window, &frame, NULL );
+
+	window->stats.commandCount	= (uint32_t)frame.drawData->commandCount;
+	window->stats.drawCallCount	= (uint32_t)batchCount;
+
+	const GLint target[ 4u ] = { 0, 0, width, height };
+	imappRendererWindowDrawBatches( renderer, window, &frame, batchCount, target );
+	imappRendererWindowWriteTimestamp( renderer, window, ImAppRendererTimestamp_End );
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_STREAMING )
+	if( window->isStreaming )
+	{
+		window->streamFences[ window->streamFrameIndex ] = glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0u );
+	}
+#endif
+
+	return true;
+}
+
+static void imappRendererWindowBeginTimer( ImAppRenderer* renderer, ImAppRendererWindow* window )
+{
+	if( !(renderer->flags & ImAppRendererFlags_GpuTimers) )
+	{
+		return;
+	}
+
+	imappRendererWindowReadTimers( renderer, window );
+
+	// all frames of the ring are in flight, skip this one instead of waiting for a result
+	if( window->timerPending[ window->timerFrameIndex ] )
+	{
+		return;
+	}
+
+	window->timerStampCount = 0u;
+	imappRendererWindowWriteTimestamp( renderer, window, ImAppRendererTimestamp_Begin );
+}
+
+// Writes timestamp and all skipped before it, the frame is complete with ImAppRendererTimestamp_End.
+static void imappRendererWindowWriteTimestamp( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererTimestamp timestamp )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_TIMER_QUERIES )
+	if( window->timerStampCount >= IMAPP_RENDERER_TIMER_STAMP_COUNT )
+	{
+		// frame not measured
+		return;
+	}
+
+	const uintsize frameIndex = window->timerFrameIndex;
+	while( window->timerStampCount <= (uintsize)timestamp )
+	{
+#	if IMAPP_ENABLED( IMAPP_RENDERER_GLES )
+		renderer->queryCounter( window->timerQueries[ frameIndex ][ window->timerStampCount ], GL_TIMESTAMP_EXT );
+#	else
+		glQueryCounter( window->timerQueries[ frameIndex ][ window->timerStampCount ], GL_TIMESTAMP );
+#	endif
+		window->timerStampCount++;
+	}
+
+	if( timestamp == ImAppRendererTimestamp_End )
+	{
+		window->timerPending[ frameIndex ]	= true;
+		window->timerFrameIndex				= (frameIndex + 1u) % IMAPP_RENDERER_TIMER_FRAME_COUNT;
+	}
+#else
+	IMAPP_USE( renderer );
+	IMAPP_USE( window );
+	IMAPP_USE( timestamp );
+#endif
+}
+
+static void imappRendererWindowReadTimers( ImAppRenderer* renderer, ImAppRendererWindow* window )
+{
+#if IMAPP_ENABLED( IMAPP_RENDERER_TIMER_QUERIES )
+#	if IMAPP_ENABLED( IMAPP_RENDERER_GLES )
+	// timestamps around a disjoint event like a clock change are garbage, drop the frames in flight
+	GLint isDisjoint = 0;
+	glGetIntegerv( GL_GPU_DISJOINT_EXT, &isDisjoint );
+	if( isDisjoint )
+	{
+		memset( window->timerPending, 0, sizeof( window->timerPending ) );
+		return;
+	}
+#	endif
+
+	// oldest frame first, so the stats end up with the newest result
+	for( uintsize i = 0u; i < IMAPP_RENDERER_TIMER_FRAME_COUNT; ++i )
+	{
+		const uintsize frameIndex = (window->timerFrameIndex + i) % IMAPP_RENDERER_TIMER_FRAME_COUNT;
+		if( !window->timerPending[ frameIndex ] )
+		{
+			continue;
+		}
+
+		const GLuint* queries = window->timerQueries[ frameIndex ];
+
+		GLuint available = 0u;
+		glGetQueryObjectuiv( queries[ ImAppRendererTimestamp_End ], GL_QUERY_RESULT_AVAILABLE, &available );
+		if( !available )
+		{
+			// later frames can't be done either
+			break;
+		}
+
+		GLuint64 timestamps[ IMAPP_RENDERER_TIMER_STAMP_COUNT ];
+		for( uintsize j = 0u; j < IMAPP_RENDERER_TIMER_STAMP_COUNT; ++j )
+		{
+#	if IMAPP_ENABLED( IMAPP_RENDERER_GLES )
+			renderer->getQueryObjectui64v( queries[ j ], GL_QUERY_RESULT, &timestamps[ j ] );
+#	else
+			glGetQueryObjectui64v( queries[ j ], GL_QUERY_RESULT, &timestamps[ j ] );
+#	endif
+		}
+
+		window->stats.gpuTimeMs			= (float)((double)(timestamps[ ImAppRendererTimestamp_End ] - timestamps[ ImAppRendererTimestamp_Begin ]) / 1000000.0);
+		window->stats.gpuCacheTimeMs	= (float)((double)(timestamps[ ImAppRendererTimestamp_CacheFilled ] - timestamps[ ImAppRendererTimestamp_Cleared ]) / 1000000.0);
+		window->timerPending[ frameIndex ] = false;
+	}
+#else
+	IMAPP_USE( renderer );
+	IMAPP_USE( window );
+#endif
+}
+
+static uintsize imappRendererMergeCommands( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame, const ImAppRendererCacheEntry* fillEntry )
+{
+	const ImUiDrawData* drawData = frame->drawData;
+	const bool gpuClipping = (renderer->flags & ImAppRendererFlags_GpuClipping) != 0u;
+
+	// reserved by imappRendererDrawCommands, an empty result would present an empty frame
+	IMAPP_ASSERT( renderer->batchCapacity >= frame->itemCount );
+
+	// a fill pass draws only the commands of the entry in texture space, other passes replace valid entries
+	GLint targetRect[ 4u ];
+	if( fillEntry )
+	{
+		targetRect[ 0u ] = 0;
+		targetRect[ 1u ] = 0;
+		targetRect[ 2u ] = fillEntry->framebufferRect[ 2u ] - fillEntry->framebufferRect[ 0u ];
+		targetRect[ 3u ] = fillEntry->framebufferRect[ 3u ] - fillEntry->framebufferRect[ 1u ];
+	}
+	else
+	{
+		memcpy( targetRect, frame->redrawRect, sizeof( targetRect ) );
+	}
 
-	glClearColor( clearColor[ 0 ], clearColor[ 1 ], clearColor[ 2 ], clearColor[ 3 ] );
-	glClear( GL_COLOR_BUFFER_BIT );
+	uintsize batchCount = 0u;
+	ImAppRendererBatch* lastBatch = NULL;
+	for( uintsize i = 0u; i < frame->itemCount; ++i )
+	{
+		const ImAppRendererDrawItem* item = &renderer->items[ i ];
+		const ImUiDrawCommand* command = &drawData->commands[ item->commandIndex ];
 
-	glEnable( GL_BLEND );
-	glBlendEquation( GL_FUNC_ADD );
-	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+		ImAppRendererCacheEntry* cacheEntry = NULL;
+		if( fillEntry )
+		{
+			if( item->commandIndex < fillEntry->firstCommand ||
+				item->commandIndex >= fillEntry->firstCommand + fillEntry->commandCount )
+			{
+				continue;
+			}
+		}
+		else
+		{
+			for( uintsize j = 0u; j < window->cacheEntryCount; ++j )
+			{
+				ImAppRendererCacheEntry* entry = &window->cacheEntries[ j ];
+				if( entry->isValid &&
+					item->commandIndex >= entry->firstCommand &&
+					item->commandIndex < entry->firstCommand + entry->commandCount )
+				{
+					cacheEntry = entry;
+					break;
+				}
+			}
+		}
 
-	glDisable( GL_CULL_FACE );
-	glDisable( GL_DEPTH_TEST );
-	glEnable( GL_SCISSOR_TEST );
+		if( cacheEntry )
+		{
+			// the whole run is replaced by one composite at its first item
+			if( i > 0u && renderer->items[ i - 1u ].commandIndex >= cacheEntry->firstCommand )
+			{
+				continue;
+			}
 
-	glUseProgram( renderer->shaderTexture.program );
-	glUniform1i( renderer->programUniformTexture, 0 );
+			ImAppRendererBatch* cacheBatch = &renderer->batches[ batchCount++ ];
+			cacheBatch->shader		= &renderer->shaderCache;
+			cacheBatch->texture		= cacheEntry->texture;
+			cacheBatch->textureArray	= 0u;
+			cacheBatch->alphaBlend	= true;
+			cacheBatch->instanced	= false;
+			cacheBatch->cacheEntry	= cacheEntry;
+			cacheBatch->topology	= GL_TRIANGLE_STRIP;
+			cacheBatch->scissor[ 0u ]	= cacheEntry->framebufferRect[ 0u ];
+			cacheBatch->scissor[ 1u ]	= cacheEntry->framebufferRect[ 1u ];
+			cacheBatch->scissor[ 2u ]	= cacheEntry->framebufferRect[ 2u ] - cacheEntry->framebufferRect[ 0u ];
+			cacheBatch->scissor[ 3u ]	= cacheEntry->framebufferRect[ 3u ] - cacheEntry->framebufferRect[ 1u ];
+			cacheBatch->first		= 0u;
+			cacheBatch->count		= 4u;
+			imappRendererIntersectRect( cacheBatch->scissor, targetRect );
 
-	imappRendererDrawCommands( renderer, window, surface, width, height );
+			lastBatch = cacheBatch;
+			continue;
+		}
 
-	// reset OpenGL state
-	glUseProgram( 0 );
-	glBindBuffer( GL_ARRAY_BUFFER, 0 );
-	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
-	glBindVertexArray( 0 );
-	glDisable( GL_BLEND );
-	glDisable( GL_SCISSOR_TEST );
+		ImAppRendererBatch batch;
+		batch.instanced		= item->instanced;
+		batch.cacheEntry	= NULL;
+		batch.first			= item->first;
+		batch.count			= item->count;
+		batch.topology		= (command->topology == ImUiDrawTopology_LineList ? GL_LINES : GL_TRIANGLES);
+
+		// clipped in the shader, the scissor only stays for commands without clip rect index
+		if( gpuClipping && renderer->commandClipIndices[ item->commandIndex ] != 0u )
+		{
+			batch.scissor[ 0u ]	= 0;
+			batch.scissor[ 1u ]	= 0;
+			batch.scissor[ 2u ]	= frame->width;
+			batch.scissor[ 3u ]	= frame->height;
+		}
+		else
+		{
+			imappRendererGetScissorRect( command, frame->height, batch.scissor );
+		}
+
+		if( fillEntry )
+		{
+			batch.scissor[ 0u ] -= fillEntry->framebufferRect[ 0u ];
+			batch.scissor[ 1u ] -= fillEntry->framebufferRect[ 1u ];
+		}
+		imappRendererIntersectRect( batch.scissor, targetRect );
+
+		// layers of an array have no handle and keep the bound texture like color draws
+		ImAppRendererTexture* texture = (ImAppRendererTexture*)command->textureHandle;
+		batch.textureArray = texture != NULL && texture->array != NULL ? texture->array->handle : 0u;
+		if( texture == NULL )
+		{
+			batch.alphaBlend	= true;
+			batch.shader		= &renderer->shaderColor;
+			batch.texture		= 0u;
+		}
+		else if( texture->flags & ImAppResPakTextureFlags_Font )
+		{
+			batch.alphaBlend	= true;
+			batch.shader		= &renderer->shaderFont;
+			batch.texture		= texture->handle;
+		}
+		else if( texture->flags & ImAppResPakTextureFlags_FontSdf )
+		{
+			batch.alphaBlend	= true;
+			batch.shader		= &renderer->shaderFontSdf;
+			batch.texture		= texture->handle;
+		}
+		else if( texture->flags & ImAppResPakTextureFlags_Opaque )
+		{
+			batch.alphaBlend	= false;
+			batch.shader		= &renderer->shaderTexture;
+			batch.texture		= texture->handle;
+		}
+		else
+		{
+			batch.alphaBlend	= true;
+			batch.shader		= &renderer->shaderTexture;
+			batch.texture		= texture->handle;
+		}
+
+		// the uber shader selects the mode per vertex or instance
+		if( batch.instanced )
+		{
+			batch.shader = &renderer->shaderUberInstanced;
+		}
+		else if( renderer->flags & ImAppRendererFlags_UberShader )
+		{
+			batch.shader = &renderer->shaderUber;
+		}
+
+		// color draws don't sample, keep whatever texture is bound
+		if( batch.texture == 0u && lastBatch )
+		{
+			batch.texture = lastBatch->texture;
+		}
+
+		if( batch.textureArray == 0u && lastBatch )
+		{
+			batch.textureArray = lastBatch->textureArray;
+		}
+
+		if( lastBatch &&
+			lastBatch->shader == batch.shader &&
+			lastBatch->texture == batch.texture &&
+			(lastBatch->textureArray == batch.textureArray || lastBatch->textureArray == 0u) &&
+			lastBatch->alphaBlend == batch.alphaBlend &&
+			lastBatch->topology == batch.topology &&
+			lastBatch->instanced == batch.instanced &&
+			lastBatch->cacheEntry == NULL &&
+			memcmp( lastBatch->scissor, batch.scissor, sizeof( batch.scissor ) ) == 0 )
+		{
+			lastBatch->textureArray = batch.textureArray;
+			lastBatch->count += batch.count;
+			continue;
+		}
+
+		lastBatch = &renderer->batches[ batchCount++ ];
+		*lastBatch = batch;
+	}
+
+	return batchCount;
 }
 
-static void imappRendererDrawCommands( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, int width, int height )
+static bool imappRendererWindowUpdateDamage( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererFrame* frame, const float* clearColor, int bufferAge, GLint* damageRect, bool hasCommandHashes )
 {
-	width = width <= 0 ? 1 : width;
-	height = height <= 0 ? 1 : height;
+	const ImUiDrawData* drawData = frame->drawData;
 
-	// bind buffers
-	glBindVertexArray( window->vertexArray );
-	glBindBuffer( GL_ARRAY_BUFFER, window->vertexBuffer );
-	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, window->elementBuffer );
+	// everything that changes pixels without changing draw data
+	ImUiHash stateHash = ImUiHashCreate( clearColor, sizeof( float ) * 4u );
+	stateHash = ImUiHashMix( stateHash, (ImUiHash)frame->width );
+	stateHash = ImUiHashMix( stateHash, (ImUiHash)frame->height );
+	stateHash = ImUiHashMix( stateHash, (ImUiHash)renderer->stateGeneration );
 
-	uintsize vertexDataSize = 0u;
-	uintsize indexDataSize = 0u;
-	ImUiSurfaceGetMaxBufferSizes( surface, &vertexDataSize, &indexDataSize );
+	const int fullRect[ 4u ] = { 0, 0, frame->width, frame->height };
+	int dirtyRect[ 4u ] = { INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+	bool fullDamage = !window->isDamageValid || window->damageStateHash != stateHash;
+
+	if( !hasCommandHashes )
+	{
+		window->isDamageValid = false;
+		return true;
+	}
+
+	const uintsize compareCount = IMUI_MAX( drawData->commandCount, window->damageCommandCount );
+	for( uintsize i = 0u; i < compareCount && !fullDamage; ++i )
+	{
+		const ImAppRendererDamageCommand* oldCommand = i < window->damageCommandCount ? &window->damageCommands[ i ] : NULL;
+		const ImAppRendererDamageCommand* newCommand = i < drawData->commandCount ? &renderer->damageCommands[ i ] : NULL;
+		if( oldCommand && newCommand &&
+			oldCommand->hash == newCommand->hash &&
+			memcmp( oldCommand->bounds, newCommand->bounds, sizeof( oldCommand->bounds ) ) == 0 )
+		{
+			continue;
+		}
+
+		// the old content has to disappear and the new content appear
+		for( uintsize j = 0u; j < 2u; ++j )
+		{
+			const ImAppRendererDamageCommand* damageCommand = j == 0u ? oldCommand : newCommand;
+			if( damageCommand == NULL )
+			{
+				continue;
+			}
+
+			dirtyRect[ 0u ] = IMUI_MIN( dirtyRect[ 0u ], damageCommand->bounds[ 0u ] );
+			dirtyRect[ 1u ] = IMUI_MIN( dirtyRect[ 1u ], damageCommand->bounds[ 1u ] );
+			dirtyRect[ 2u ] = IMUI_MAX( dirtyRect[ 2u ], damageCommand->bounds[ 2u ] );
+			dirtyRect[ 3u ] = IMUI_MAX( dirtyRect[ 3u ], damageCommand->bounds[ 3u ] );
+		}
+	}
+
+	// keep the new frame for the next compare
+	ImAppRendererDamageCommand* lastCommands	= window->damageCommands;
+	const uintsize lastCapacity					= window->damageCommandCapacity;
+	window->damageCommands						= renderer->damageCommands;
+	window->damageCommandCapacity				= renderer->damageCommandCapacity;
+	window->damageCommandCount					= drawData->commandCount;
+	window->damageStateHash						= stateHash;
+	window->isDamageValid						= true;
+	renderer->damageCommands					= lastCommands;
+	renderer->damageCommandCapacity				= lastCapacity;
+
+	if( fullDamage )
+	{
+		memcpy( dirtyRect, fullRect, sizeof( dirtyRect ) );
+		window->damageHistoryCount = 0u;
+	}
+	else
+	{
+		dirtyRect[ 0u ] = IMUI_MAX( dirtyRect[ 0u ], 0 );
+		dirtyRect[ 1u ] = IMUI_MAX( dirtyRect[ 1u ], 0 );
+		dirtyRect[ 2u ] = IMUI_MIN( dirtyRect[ 2u ], frame->width );
+		dirtyRect[ 3u ] = IMUI_MIN( dirtyRect[ 3u ], frame->height );
 
-	if( vertexDataSize > window->vertexBufferSize ||
-		window->vertexBufferSize > vertexDataSize * 2 )
+		if( dirtyRect[ 0u ] >= dirtyRect[ 2u ] ||
+			dirtyRect[ 1u ] >= dirtyRect[ 3u ] )
+		{
+			return false;
+		}
+	}
+
+	// the back buffer misses the damage of all frames presented since it was used the last time
+	int redrawRect[ 4u ];
+	memcpy( redrawRect, dirtyRect, sizeof( redrawRect ) );
+	if( bufferAge <= 0 || (uintsize)bufferAge - 1u > window->damageHistoryCount )
+	{
+		memcpy( redrawRect, fullRect, sizeof( redrawRect ) );
+	}
+	else
+	{
+		for( uintsize i = 0u; i < (uintsize)bufferAge - 1u; ++i )
+		{
+			const int* historyRect = window->damageHistory[ i ];
+			redrawRect[ 0u ] = IMUI_MIN( redrawRect[ 0u ], historyRect[ 0u ] );
+			redrawRect[ 1u ] = IMUI_MIN( redrawRect[ 1u ], historyRect[ 1u ] );
+			redrawRect[ 2u ] = IMUI_MAX( redrawRect[ 2u ], historyRect[ 2u ] );
+			redrawRect[ 3u ] = IMUI_MAX( redrawRect[ 3u ], historyRect[ 3u ] );
+		}
+	}
+
+	memmove( &window->damageHistory[ 1u ], &window->damageHistory[ 0u ], sizeof( window->damageHistory[ 0u ] ) * (IMAPP_RENDERER_DAMAGE_HISTORY_COUNT - 1u) );
+	memcpy( window->damageHistory[ 0u ], dirtyRect, sizeof( window->damageHistory[ 0u ] ) );
+	window->damageHistoryCount = IMUI_MIN( window->damageHistoryCount + 1u, IMAPP_RENDERER_DAMAGE_HISTORY_COUNT );
+
+	frame->redrawRect[ 0u ]	= redrawRect[ 0u ];
+	frame->redrawRect[ 1u ]	= redrawRect[ 1u ];
+	frame->redrawRect[ 2u ]	= redrawRect[ 2u ] - redrawRect[ 0u ];
+	frame->redrawRect[ 3u ]	= redrawRect[ 3u ] - redrawRect[ 1u ];
+
+	damageRect[ 0u ]	= dirtyRect[ 0u ];
+	damageRect[ 1u ]	= dirtyRect[ 1u ];
+	damageRect[ 2u ]	= dirtyRect[ 2u ] - dirtyRect[ 0u ];
+	damageRect[ 3u ]	= dirtyRect[ 3u ] - dirtyRect[ 1u ];
+	return true;
+}
+
+static void imappRendererGetCommandBounds( const ImAppRendererFrame* frame, const ImUiDrawCommand* command, const uint32_t* indices, int* bounds )
+{
+	float left		= FLT_MAX;
+	float top		= FLT_MAX;
+	float right		= -FLT_MAX;
+	float bottom	= -FLT_MAX;
+	for( uintsize i = 0u; i < command->count; ++i )
 	{
-		vertexDataSize = IMUI_NEXT_POWER_OF_TWO( vertexDataSize );
-		window->vertexBufferData = ImUiMemoryRealloc( renderer->allocator, window->vertexBufferData, window->vertexBufferSize, vertexDataSize );
-		window->vertexBufferSize = vertexDataSize;
+		if( indices[ i ] >= frame->vertexCount )
+		{
+			continue;
+		}
+
+		const ImAppRendererVertex* vertex = &frame->vertices[ indices[ i ] ];
+		left	= IMUI_MIN( left, vertex->position[ 0u ] );
+		top		= IMUI_MIN( top, vertex->position[ 1u ] );
+		right	= IMUI_MAX( right, vertex->position[ 0u ] );
+		bottom	= IMUI_MAX( bottom, vertex->position[ 1u ] );
 	}
 
-	if( indexDataSize > window->elementBufferSize ||
-		window->elementBufferSize > indexDataSize * 2 )
+	if( left > right )
 	{
-		indexDataSize = IMUI_NEXT_POWER_OF_TWO( indexDataSize );
-		window->elementBufferData = ImUiMemoryRealloc( renderer->allocator, window->elementBufferData, window->elementBufferSize, indexDataSize );
-		window->elementBufferSize = indexDataSize;
+		bounds[ 0u ] = bounds[ 1u ] = bounds[ 2u ] = bounds[ 3u ] = 0;
+		return;
 	}
 
-	const ImUiDrawData* drawData = ImUiSurfaceGenerateDrawData( surface, window->vertexBufferData, &vertexDataSize, window->elementBufferData, &indexDataSize );
-	glBufferData( GL_ARRAY_BUFFER, (GLsizeiptr)vertexDataSize, window->vertexBufferData, GL_DYNAMIC_DRAW );
-	glBufferData( GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)indexDataSize, window->elementBufferData, GL_DYNAMIC_DRAW );
+	imappRendererGetFramebufferBounds( frame, left, top, right, bottom, bounds );
+
+	GLint rect[ 4u ] = { bounds[ 0u ], bounds[ 1u ], bounds[ 2u ] - bounds[ 0u ], bounds[ 3u ] - bounds[ 1u ] };
+
+	GLint scissor[ 4u ];
+	imappRendererGetScissorRect( command, frame->height, scissor );
+	imappRendererIntersectRect( rect, scissor );
+
+	bounds[ 0u ] = rect[ 0u ];
+	bounds[ 1u ] = rect[ 1u ];
+	bounds[ 2u ] = rect[ 0u ] + rect[ 2u ];
+	bounds[ 3u ] = rect[ 1u ] + rect[ 3u ];
+}
+
+static void imappRendererGetFramebufferBounds( const ImAppRendererFrame* frame, float left, float top, float right, float bottom, int* bounds )
+{
+	// one pixel margin for anti aliased edges, flipped to framebuffer coordinates
+	left	= IMUI_MAX( left, -1.0f );
+	top		= IMUI_MAX( top, -1.0f );
+	right	= IMUI_MIN( right, (float)frame->width + 1.0f );
+	bottom	= IMUI_MIN( bottom, (float)frame->height + 1.0f );
+
+	bounds[ 0u ] = (int)left - 1;
+	bounds[ 1u ] = frame->height - ((int)bottom + 2);
+	bounds[ 2u ] = (int)right + 2;
+	bounds[ 3u ] = frame->height - ((int)top - 1);
+}
+
+static void imappRendererIntersectRect( GLint* rect, const GLint* otherRect )
+{
+	const GLint left	= IMUI_MAX( rect[ 0u ], otherRect[ 0u ] );
+	const GLint bottom	= IMUI_MAX( rect[ 1u ], otherRect[ 1u ] );
+	const GLint right	= IMUI_MIN( rect[ 0u ] + rect[ 2u ], otherRect[ 0u ] + otherRect[ 2u ] );
+	const GLint top		= IMUI_MIN( rect[ 1u ] + rect[ 3u ], otherRect[ 1u ] + otherRect[ 3u ] );
+
+	rect[ 0u ] = left;
+	rect[ 1u ] = bottom;
+	rect[ 2u ] = IMUI_MAX( right - left, 0 );
+	rect[ 3u ] = IMUI_MAX( top - bottom, 0 );
+}
+
+static void imappRendererWindowDrawBatches( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame, uintsize batchCount, const GLint* target )
+{
+	// target x, y, width, height in window coordinates
+	const float targetX			= (float)target[ 0u ];
+	const float targetY			= (float)target[ 1u ];
+	const float targetWidth		= (float)target[ 2u ];
+	const float targetHeight	= (float)target[ 3u ];
 
 	const GLfloat projectionMatrix[ 4 ][ 4 ] = {
-		{  2.0f / (float)width,	0.0f,					 0.0f,	0.0f },
-		{  0.0f,				-2.0f / (float)height,	 0.0f,	0.0f },
-		{  0.0f,				0.0f,					-1.0f,	0.0f },
-		{ -1.0f,				1.0f,					 0.0f,	1.0f }
+		{  2.0f / targetWidth,						0.0f,									 0.0f,	0.0f },
+		{  0.0f,									-2.0f / targetHeight,					 0.0f,	0.0f },
+		{  0.0f,									0.0f,									-1.0f,	0.0f },
+		{ -1.0f - (2.0f * targetX / targetWidth),	1.0f + (2.0f * targetY / targetHeight),	 0.0f,	1.0f }
+	};
+
+	const bool compactVertices = frame->vertexSize == sizeof( ImAppRendererCompactVertex );
+	const float positionScale = compactVertices ? 1.0f / IMAPP_RENDERER_COMPACT_POSITION_SCALE : 1.0f;
+	const GLfloat vertexProjectionMatrix[ 4 ][ 4 ] = {
+		{  positionScale * 2.0f / targetWidth,		0.0f,									 0.0f,	0.0f },
+		{  0.0f,									positionScale * -2.0f / targetHeight,	 0.0f,	0.0f },
+		{  0.0f,									0.0f,									-1.0f,	0.0f },
+		{ -1.0f - (2.0f * targetX / targetWidth),	1.0f + (2.0f * targetY / targetHeight),	 0.0f,	1.0f }
 	};
+	const GLenum indexType = frame->indexSize == sizeof( uint16_t ) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+	// programs are shared between windows, so the projection has to be set once per pass
+	ImAppRendererStateCache* cache = &window->stateCache;
+	uint32 projectionMask = 0u;
+	GLuint vertexArray = window->vertexArray;
+	for( uintsize i = 0u; i < batchCount; ++i )
+	{
+		const ImAppRendererBatch* batch = &renderer->batches[ i ];
+
+		if( cache->program != batch->shader->program )
+		{
+			glUseProgram( batch->shader->program );
+			cache->program = batch->shader->program;
+			window->stats.programChangeCount++;
+		}
+
+		if( (projectionMask & batch->shader->mask) == 0u )
+		{
+			// instances are never compact
+			const GLfloat* matrix = batch->instanced ? &projectionMatrix[ 0u ][ 0u ] : &vertexProjectionMatrix[ 0u ][ 0u ];
+			glUniformMatrix4fv( batch->shader->uniformProjection, 1, GL_FALSE, matrix );
+			projectionMask |= batch->shader->mask;
+		}
+
+		if( cache->alphaBlend != (int)batch->alphaBlend )
+		{
+			(batch->alphaBlend ? glEnable : glDisable)( GL_BLEND );
+			cache->alphaBlend = batch->alphaBlend;
+		}
+
+		if( cache->texture != batch->texture )
+		{
+			glBindTexture( GL_TEXTURE_2D, batch->texture );
+			cache->texture = batch->texture;
+			window->stats.textureChangeCount++;
+		}
+
+		if( batch->textureArray != 0u &&
+			cache->textureArray != batch->textureArray )
+		{
+			glActiveTexture( GL_TEXTURE2 );
+			glBindTexture( GL_TEXTURE_2D_ARRAY, batch->textureArray );
+			glActiveTexture( GL_TEXTURE0 );
+			cache->textureArray = batch->textureArray;
+			window->stats.textureChangeCount++;
+		}
+
+		if( memcmp( cache->scissor, batch->scissor, sizeof( cache->scissor ) ) != 0 )
+		{
+			glScissor( batch->scissor[ 0u ], batch->scissor[ 1u ], batch->scissor[ 2u ], batch->scissor[ 3u ] );
+			memcpy( cache->scissor, batch->scissor, sizeof( cache->scissor ) );
+			window->stats.scissorChangeCount++;
+		}
+
+		if( batch->cacheEntry )
+		{
+			if( vertexArray != window->cacheArray )
+			{
+				glBindVertexArray( window->cacheArray );
+				vertexArray = window->cacheArray;
+			}
+
+			const int* rect = batch->cacheEntry->framebufferRect;
+			glUniform4f( renderer->uniformCacheRect,
+				(2.0f * (float)rect[ 0u ] / (float)frame->width) - 1.0f,
+				(2.0f * (float)rect[ 1u ] / (float)frame->height) - 1.0f,
+				(2.0f * (float)rect[ 2u ] / (float)frame->width) - 1.0f,
+				(2.0f * (float)rect[ 3u ] / (float)frame->height) - 1.0f );
+
+			// the texture is premultiplied
+			glBlendFunc( GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
+			glDrawArrays( GL_TRIANGLE_STRIP, 0, 4 );
+			glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+		}
+		else if( batch->instanced )
+		{
+			if( vertexArray != window->instanceArray )
+			{
+				glBindVertexArray( window->instanceArray );
+				vertexArray = window->instanceArray;
+			}
+
+			// ES 3.0 has no base instance, move the instance attributes instead
+			imappRendererWindowSetInstanceOffset( window, frame->instanceOffset + (batch->first * sizeof( ImAppRendererQuadInstance )) );
+			glDrawArraysInstanced( GL_TRIANGLE_STRIP, 0, 4, (GLsizei)batch->count );
+		}
+		else
+		{
+			if( vertexArray != window->vertexArray )
+			{
+				glBindVertexArray( window->vertexArray );
+				vertexArray = window->vertexArray;
+			}
+
+			glDrawElements( batch->topology, (GLsizei)batch->count, indexType, (const void*)batch->first );
+		}
+	}
 
-	bool alphaBlend = true;
-	GLuint programHandle = 0;
-	GLuint textureHandle = 0;
+	if( vertexArray != window->vertexArray )
+	{
+		glBindVertexArray( window->vertexArray );
+	}
+}
 
-	bool lastAlphaBlend = true;
-	GLuint lastProgramHandle = 0;
+static bool imappRendererHashCommands( ImAppRenderer* renderer, const ImAppRendererFrame* frame )
+{
+	const ImUiDrawData* drawData = frame->drawData;
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->damageCommands, renderer->damageCommandCapacity, drawData->commandCount ) )
+	{
+		return false;
+	}
 
-	const uint32_t* elementOffset = NULL;
-	for( size_t i = 0u; i < drawData->commandCount; ++i )
+	const uint32_t* indices = frame->indices;
+	for( uintsize i = 0u; i < drawData->commandCount; ++i )
 	{
 		const ImUiDrawCommand* command = &drawData->commands[ i ];
+		ImAppRendererDamageCommand* damageCommand = &renderer->damageCommands[ i ];
 
-		ImAppRendererTexture* texture = (ImAppRendererTexture*)command->textureHandle;
-		if( texture == NULL )
+		uint32_t minIndex = UINT32_MAX;
+		uint32_t maxIndex = 0u;
+		for( uintsize j = 0u; j < command->count; ++j )
 		{
-			alphaBlend		= true;
-			programHandle	= renderer->shaderColor.program;
-			textureHandle	= 0u;
+			minIndex = IMUI_MIN( minIndex, indices[ j ] );
+			maxIndex = IMUI_MAX( maxIndex, indices[ j ] );
 		}
-		else if( texture->flags & ImAppResPakTextureFlags_Font )
+
+		// indices relative to the first vertex, so shifted vertices of unchanged commands hash equal
+		uint32_t indexHash = (uint32_t)command->count;
+		for( uintsize j = 0u; j < command->count; ++j )
 		{
-			alphaBlend		= true;
-			programHandle	= renderer->shaderFont.program;
-			textureHandle	= texture->handle;
+			indexHash = (indexHash * 16777619u) ^ (indices[ j ] - minIndex);
 		}
-		else if( texture->flags & ImAppResPakTextureFlags_FontSdf )
+
+		ImUiHash hash = ImUiHashCreate( &command->clipRect, sizeof( command->clipRect ) );
+		hash = ImUiHashCreateSeed( &command->textureHandle, sizeof( command->textureHandle ), hash );
+		if( command->textureHandle != IMUI_TEXTURE_HANDLE_INVALID )
 		{
-			alphaBlend		= true;
-			programHandle	= renderer->shaderFontSdf.program;
-			textureHandle	= texture->handle;
+			// updated texture data only damages the commands sampling it
+			const ImAppRendererTexture* texture = (const ImAppRendererTexture*)command->textureHandle;
+			hash = ImUiHashMix( hash, (ImUiHash)texture->contentGeneration );
 		}
-		else if( texture->flags & ImAppResPakTextureFlags_Opaque )
+		hash = ImUiHashMix( hash, (ImUiHash)command->topology );
+		hash = ImUiHashMix( hash, indexHash );
+		if( minIndex <= maxIndex && maxIndex < frame->vertexCount )
 		{
-			alphaBlend		= false;
-			programHandle	= renderer->shaderTexture.program;
-			textureHandle	= texture->handle;
+			hash = ImUiHashCreateSeed( &frame->vertices[ minIndex ], (maxIndex - minIndex + 1u) * sizeof( ImAppRendererVertex ), hash );
 		}
-		else
+
+		damageCommand->hash = hash;
+		imappRendererGetCommandBounds( frame, command, indices, damageCommand->bounds );
+
+		indices += command->count;
+	}
+
+	return true;
+}
+
+static void imappRendererWindowUpdateCache( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame, bool hasCommandHashes )
+{
+	// GPU clipping compares with window coordinates, which don't match the cache texture
+	const bool canCache = hasCommandHashes && (renderer->flags & ImAppRendererFlags_GpuClipping) == 0u;
+	const ImUiDrawData* drawData = frame->drawData;
+
+	for( uintsize i = 0u; i < window->cacheEntryCount; ++i )
+	{
+		ImAppRendererCacheEntry* entry = &window->cacheEntries[ i ];
+		entry->commandCount = 0u;
+
+		if( !entry->isRequested || !canCache )
+		{
+			entry->isValid			= false;
+			entry->stableFrameCount	= 0u;
+			continue;
+		}
+
+		const ImUiRect* rect = &entry->rect;
+		imappRendererGetFramebufferBounds( frame, rect->pos.x, rect->pos.y, rect->pos.x + rect->size.width, rect->pos.y + rect->size.height, entry->framebufferRect );
+
+		// the window is the first run of commands inside of the rect, commands keep their order
+		uintsize firstCommand = drawData->commandCount;
+		uintsize commandCount = 0u;
+		for( uintsize j = 0u; j < drawData->commandCount; ++j )
+		{
+			const int* bounds = renderer->damageCommands[ j ].bounds;
+			const bool isEmpty = bounds[ 0u ] >= bounds[ 2u ] || bounds[ 1u ] >= bounds[ 3u ];
+			const bool isInside = bounds[ 0u ] >= entry->framebufferRect[ 0u ] && bounds[ 1u ] >= entry->framebufferRect[ 1u ] &&
+				bounds[ 2u ] <= entry->framebufferRect[ 2u ] && bounds[ 3u ] <= entry->framebufferRect[ 3u ];
+
+			if( isInside && !isEmpty )
+			{
+				firstCommand = commandCount == 0u ? j : firstCommand;
+				commandCount = (j - firstCommand) + 1u;
+			}
+			else if( commandCount > 0u && !isEmpty )
+			{
+				break;
+			}
+		}
+
+		for( uintsize j = 0u; j < i && commandCount > 0u; ++j )
+		{
+			const ImAppRendererCacheEntry* otherEntry = &window->cacheEntries[ j ];
+			if( otherEntry->commandCount > 0u &&
+				firstCommand < otherEntry->firstCommand + otherEntry->commandCount &&
+				otherEntry->firstCommand < firstCommand + commandCount )
+			{
+				commandCount = 0u;
+			}
+		}
+
+		ImUiHash hash = (ImUiHash)commandCount;
+		for( uintsize j = 0u; j < commandCount; ++j )
 		{
-			alphaBlend		= true;
-			programHandle	= renderer->shaderTexture.program;
-			textureHandle	= texture->handle;
+			hash = ImUiHashMix( hash, renderer->damageCommands[ firstCommand + j ].hash );
 		}
 
-		if( lastProgramHandle != programHandle )
+		if( commandCount == 0u || hash != entry->hash )
+		{
+			entry->hash				= hash;
+			entry->isValid			= false;
+			entry->stableFrameCount	= 0u;
+		}
+		else
 		{
-			glUseProgram( programHandle );
-			glUniformMatrix4fv( renderer->programUniformProjection, 1, GL_FALSE, &projectionMatrix[ 0u ][ 0u ] );
+			entry->stableFrameCount++;
+		}
+
+		entry->firstCommand	= firstCommand;
+		entry->commandCount	= commandCount;
+	}
+}
+
+static bool imappRendererWindowFillCache( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererFrame* frame, ImAppRendererCacheEntry* entry )
+{
+	const int* rect		= entry->framebufferRect;
+	const int width		= rect[ 2u ] - rect[ 0u ];
+	const int height	= rect[ 3u ] - rect[ 1u ];
+	if( width <= 0 || height <= 0 )
+	{
+		return false;
+	}
 
-			lastProgramHandle = programHandle;
+	ImAppRendererStateCache* cache = &window->stateCache;
+	if( entry->texture == 0u ||
+		entry->textureWidth != width ||
+		entry->textureHeight != height )
+	{
+		if( entry->texture == 0u )
+		{
+			glGenTextures( 1, &entry->texture );
+			glGenFramebuffers( 1, &entry->framebuffer );
 		}
 
-		if( lastAlphaBlend != alphaBlend )
+		glBindTexture( GL_TEXTURE_2D, entry->texture );
+		glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+		cache->texture = entry->texture;
+
+		glBindFramebuffer( GL_FRAMEBUFFER, entry->framebuffer );
+		glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, entry->texture, 0 );
+		if( glCheckFramebufferStatus( GL_FRAMEBUFFER ) != GL_FRAMEBUFFER_COMPLETE )
 		{
-			(alphaBlend ? glEnable : glDisable)( GL_BLEND );
+			ImAppTrace( "[renderer] Failed to create window cache framebuffer.\n" );
+			glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+			entry->stableFrameCount = 0u;
+			return false;
+		}
+
+		entry->textureWidth		= width;
+		entry->textureHeight	= height;
+	}
+
+	if( window->cacheArray == 0u )
+	{
+		glGenVertexArrays( 1, &window->cacheArray );
+	}
+
+	glBindFramebuffer( GL_FRAMEBUFFER, entry->framebuffer );
+	glViewport( 0, 0, width, height );
+
+	glClearColor( 0.0f, 0.0f, 0.0f, 0.0f );
+	glDisable( GL_SCISSOR_TEST );
+	glClear( GL_COLOR_BUFFER_BIT );
+	glEnable( GL_SCISSOR_TEST );
+	cache->scissor[ 0u ] = -1;
+
+	// premultiplied, so the texture composites like the commands would blend
+	glBlendFuncSeparate( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA );
+
+	const uintsize batchCount = imappRendererMergeCommands( renderer, window, frame, entry );
+	const GLint target[ 4u ] = { rect[ 0u ], frame->height - rect[ 3u ], width, height };
+	imappRendererWindowDrawBatches( renderer, window, frame, batchCount, target );
+
+	glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+	glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+	glViewport( 0, 0, frame->width, frame->height );
+
+	return true;
+}
 
-			lastAlphaBlend = alphaBlend;
+static void imappRendererWindowReleaseCaches( ImAppRenderer* renderer, ImAppRendererWindow* window )
+{
+	for( uintsize i = 0u; i < window->cacheEntryCount; ++i )
+	{
+		ImAppRendererCacheEntry* entry = &window->cacheEntries[ i ];
+		if( entry->isRequested )
+		{
+			entry->isRequested = false;
+			continue;
 		}
 
-		glBindTexture( GL_TEXTURE_2D, textureHandle );
+		if( entry->texture != 0u )
+		{
+			glDeleteFramebuffers( 1, &entry->framebuffer );
+			glDeleteTextures( 1, &entry->texture );
 
-		glScissor(
-			(GLint)(command->clipRect.pos.x),
-			(GLint)((height - (GLint)(command->clipRect.pos.y + command->clipRect.size.height))),
-			(GLint)(command->clipRect.size.width),
-			(GLint)(command->clipRect.size.height)
-		);
+			// the texture name can get reused
+			renderer->stateGeneration++;
+		}
 
-		const GLenum topology = (command->topology == ImUiDrawTopology_LineList ? GL_LINES : GL_TRIANGLES);
-		glDrawElements( topology, (GLsizei)command->count, GL_UNSIGNED_INT, elementOffset );
-		elementOffset += command->count;
+		*entry = window->cacheEntries[ --window->cacheEntryCount ];
+		i--;
 	}
 }
+
+#endif
@@ -1,11 +1,18 @@
 #pragma once
 
+#include "imapp/imapp.h"
+
 #include "imapp_types.h"
 
 #include <imui/imui.h>
 
 #include <stdbool.h>
 
+#if IMAPP_ENABLED( IMAPP_RENDERER_VULKAN )
+#	include <vulkan/vulkan.h>
+#endif
+
+typedef struct ImAppMutex ImAppMutex;
 typedef struct ImAppPlatform ImAppPlatform;
 typedef struct ImAppRenderer ImAppRenderer;
 typedef struct ImAppRendererTexture ImAppRendererTexture;
@@ -22,34 +29,233 @@ enum ImAppRendererFormat
 	ImAppRendererFormat_RGBA8
 };
 
+#define IMAPP_RENDERER_STREAM_FRAME_COUNT	3u
+#define IMAPP_RENDERER_DAMAGE_HISTORY_COUNT	4u
+#define IMAPP_RENDERER_MAX_CACHE_ENTRIES	8u
+#define IMAPP_RENDERER_VULKAN_FRAME_COUNT	2u
+#define IMAPP_RENDERER_TIMER_FRAME_COUNT	4u
+#define IMAPP_RENDERER_TIMER_STAMP_COUNT	4u
+
+typedef struct ImAppRendererBuffer
+{
+	unsigned int				buffer;
+	uintsize					size;			// streaming: size of one frame range
+	void*						data;			// CPU staging copy, scratch memory when streaming
+	uintsize					dataSize;
+} ImAppRendererBuffer;
+
+typedef struct ImAppRendererStateCache
+{
+	uint32_t					generation;
+	unsigned int				program;
+	unsigned int				texture;
+	unsigned int				textureArray;	// bound to unit 2
+	int							alphaBlend;		// -1: unknown
+	int							scissor[ 4u ];
+} ImAppRendererStateCache;
+
+typedef struct ImAppRendererClipRect
+{
+	float						left;
+	float						bottom;
+	float						right;
+	float						top;
+} ImAppRendererClipRect;
+
+typedef struct ImAppRendererDamageCommand
+{
+	ImUiHash					hash;			// state, relative indices and vertices of the command
+	int							bounds[ 4u ];	// left, bottom, right, top in framebuffer coordinates
+} ImAppRendererDamageCommand;
+
+typedef struct ImAppRendererCacheEntry
+{
+	ImUiRect					rect;				// ImUi window rect, identifies the entry
+	bool						isRequested;		// requested since the last draw
+	bool						isValid;			// texture content matches the commands
+	ImUiHash					hash;				// commands of the last frame
+	uint32_t					stableFrameCount;
+	unsigned int				framebuffer;
+	unsigned int				texture;
+	int							textureWidth;
+	int							textureHeight;
+	int							framebufferRect[ 4u ];	// left, bottom, right, top in framebuffer coordinates
+	uintsize					firstCommand;
+	uintsize					commandCount;
+} ImAppRendererCacheEntry;
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+struct ImAppRendererWindow
+{
+	uint32_t*					pixels;				// BGRA8, top row first. Kept between frames, only damage gets redrawn.
+	uintsize					pixelCapacity;
+	int							width;
+	int							height;
+
+	void*						vertexData;
+	uintsize					vertexDataSize;
+	void*						indexData;
+	uintsize					indexDataSize;
+
+	ImAppRendererStats			stats;
+
+	bool						isDamageValid;
+	ImUiHash					damageStateHash;	// size, clear color and texture generation of the last drawn frame
+	ImAppRendererDamageCommand*	damageCommands;		// bounds are left, top, right, bottom in window coordinates
+	uintsize					damageCommandCapacity;
+	uintsize					damageCommandCount;
+};
+#elif IMAPP_ENABLED( IMAPP_RENDERER_VULKAN )
+typedef struct ImAppRendererVulkanFrame
+{
+	VkCommandBuffer				commandBuffer;
+	VkFence						fence;
+	VkSemaphore					acquireSemaphore;
+	VkDescriptorPool			descriptorPool;		// reset every frame, one set per texture
+	uint32_t					descriptorPoolSize;
+	VkBuffer					arenaBuffer;		// vertices followed by indices, persistently mapped
+	VkDeviceMemory				arenaMemory;
+	void*						arenaData;
+	VkDeviceSize				arenaSize;
+} ImAppRendererVulkanFrame;
+
+struct ImAppRendererWindow
+{
+	ImAppWindow*				platformWindow;
+	VkSurfaceKHR				surface;			// VK_NULL_HANDLE: render offscreen and read back into pixels
+	VkSwapchainKHR				swapchain;
+	bool						isSwapchainOutdated;
+	VkImage*					images;
+	VkImageView*				imageViews;
+	VkFramebuffer*				framebuffers;
+	VkSemaphore*				renderSemaphores;	// per swapchain image, waited by present
+	uint32_t					imageCount;
+	VkExtent2D					extent;				// size of the images, can differ from the window size
+
+	VkImage						offscreenImage;
+	VkDeviceMemory				offscreenMemory;
+	VkImageView					offscreenView;
+	VkFramebuffer				offscreenFramebuffer;
+	VkBuffer					readbackBuffer;
+	VkDeviceMemory				readbackMemory;
+
+	uint32_t*					pixels;				// offscreen: BGRA8 of the last frame, top row first
+	int							width;				// window size the images got created for
+	int							height;
+
+	ImAppRendererVulkanFrame	frames[ IMAPP_RENDERER_VULKAN_FRAME_COUNT ];
+	uintsize					frameIndex;
+
+	bool						hasFrameHash;
+	ImUiHash					frameHash;			// draw data of the last presented frame
+
+	ImAppRendererStats			stats;
+};
+#else
 struct ImAppRendererWindow
 {
 	unsigned int				vertexArray;
-	unsigned int				vertexBuffer;
-	uintsize					vertexBufferSize;
-	void*						vertexBufferData;
-	unsigned int				elementBuffer;
-	uintsize					elementBufferSize;
-	void*						elementBufferData;
+	ImAppRendererBuffer			vertexBuffer;
+	ImAppRendererBuffer			elementBuffer;
+	ImAppRendererBuffer			drawInfoBuffer;		// per vertex draw mode and clip rect index for the uber shader
+	ImAppRendererBuffer			instanceBuffer;		// instanced quads: one record per quad
+	ImAppRendererBuffer			vertexScratch;		// CPU copy of generated data that gets converted before upload
+	ImAppRendererBuffer			elementScratch;
+	unsigned int				instanceArray;
+
+	unsigned int				clipTexture;		// GPU clipping: one RGBA32F texel per clip rect
+	uint32_t					clipTextureHeight;
+	ImAppRendererClipRect*		clipRects;
+	uintsize					clipRectCapacity;
+	uintsize					clipRectCount;
+
+	bool						isStreaming;
+	bool						isCompactVertexFormat;	// format the vertex attributes currently point to
+	uintsize					streamFrameIndex;
+	void*						streamFences[ IMAPP_RENDERER_STREAM_FRAME_COUNT ];	// GLsync
+
+	ImAppRendererStateCache		stateCache;
+	ImAppRendererStats			stats;
+
+	bool						isDamageValid;
+	ImUiHash					damageStateHash;	// size, clear color and texture generation of the last drawn frame
+	ImAppRendererDamageCommand*	damageCommands;
+	uintsize					damageCommandCapacity;
+	uintsize					damageCommandCount;
+	int							damageHistory[ IMAPP_RENDERER_DAMAGE_HISTORY_COUNT ][ 4u ];	// damage of the last presented frames, newest first
+	uintsize					damageHistoryCount;
+
+	ImAppRendererCacheEntry		cacheEntries[ IMAPP_RENDERER_MAX_CACHE_ENTRIES ];
+	uintsize					cacheEntryCount;
+	unsigned int				cacheArray;			// empty vertex array to composite cache textures
+
+	unsigned int				timerQueries[ IMAPP_RENDERER_TIMER_FRAME_COUNT ][ IMAPP_RENDERER_TIMER_STAMP_COUNT ];	// GL_TIMESTAMP queries, a ring of frames
+	bool						timerPending[ IMAPP_RENDERER_TIMER_FRAME_COUNT ];	// written, result not read yet
+	uintsize					timerFrameIndex;
+	uintsize					timerStampCount;	// stamps written for the current frame, IMAPP_RENDERER_TIMER_STAMP_COUNT when not measured
 };
 
+// Draw data of a surface copied out of the ImUi frame, so an other thread can draw it later
+typedef struct ImAppRendererDrawPacket
+{
+	ImUiDrawData				drawData;			// commands point into commands
+	ImUiDrawCommand*			commands;
+	uintsize					commandCapacity;
+	uint8*						vertexData;
+	uintsize					vertexCapacity;
+	uintsize					vertexDataSize;
+	uint8*						indexData;
+	uintsize					indexCapacity;
+	uintsize					indexDataSize;
+} ImAppRendererDrawPacket;
+#endif
+
 ImUiVertexFormat		imappRendererGetVertexFormat();
 
-ImAppRenderer*			imappRendererCreate( ImUiAllocator* allocator, ImAppPlatform* platform );
+ImAppRenderer*			imappRendererCreate( ImUiAllocator* allocator, ImAppPlatform* platform, uint32_t flags );
 void					imappRendererDestroy( ImAppRenderer* renderer );
 
 void					imappRendererUpdate( ImAppRenderer* renderer );
 
+// Texture data gets uploaded in imappRendererUpdate with at most budget bytes (at least one texture) and budgetMs per update. budget 0 uploads synchronously.
+void					imappRendererSetUploadBudget( ImAppRenderer* renderer, uint32_t budget, float budgetMs );
+bool					imappRendererHasPendingUploads( const ImAppRenderer* renderer );
+
+// Fills the texture fields of stats, the per window fields are kept.
+void					imappRendererGetTextureStats( const ImAppRenderer* renderer, ImAppRendererStats* stats );
+
 bool					imappRendererCreateResources( ImAppRenderer* renderer );
 void					imappRendererDestroyResources( ImAppRenderer* renderer );
 
-void					imappRendererConstructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window );
+void					imappRendererConstructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppWindow* platformWindow );
 void					imappRendererDestructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window );
 
 ImAppRendererTexture*	imappRendererTextureCreate( ImAppRenderer* renderer );
 ImAppRendererTexture*	imappRendererTextureCreateFromMemory( ImAppRenderer* renderer, const void* data, uint32_t width, uint32_t height, ImAppRendererFormat format, uint8_t flags );
 bool					imappRendererTextureInitializeDataFromMemory( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t width, uint32_t height, ImAppRendererFormat format, uint8_t flags );
 void					imappRendererTextureDestroyData( ImAppRenderer* renderer, ImAppRendererTexture* texture );
+bool					imappRendererTextureIsReady( ImAppRenderer* renderer, const ImAppRendererTexture* texture );	// false while the data upload is pending
+// data has the format of the texture with tightly packed rows.
+bool					imappRendererTextureUpdateRegion( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height );
 void					imappRendererTextureDestroy( ImAppRenderer* renderer, ImAppRendererTexture* texture );
 
-void					imappRendererDraw( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, int width, int height, float clearColor[ 4 ] );
+// Cache the commands inside of rect in a texture for the next draw. Entries not requested before a draw get released.
+void					imappRendererWindowRequestCache( ImAppRendererWindow* window, ImUiRect rect );
+
+// Returns false when the frame is unchanged and doesn't need to be presented. bufferAge is the age of the back buffer content in frames, 0 if undefined.
+bool					imappRendererDraw( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, int width, int height, float clearColor[ 4 ], int bufferAge, ImUiRect* outDamageRect );
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_OPENGL )
+// Render thread: the context and the renderer state are guarded by mutex, the thread holding it has the context current.
+// Texture functions and imappRendererUpdate lock it on their own, everything else runs on the render thread or while it is idle.
+// mutex NULL: back to one thread, the context has to be current on the calling thread.
+void					imappRendererSetContextMutex( ImAppRenderer* renderer, ImAppMutex* mutex );
+void					imappRendererLockContext( ImAppRenderer* renderer );		// borrows the context, nests
+void					imappRendererUnlockContext( ImAppRenderer* renderer );
+
+// Destroyed textures stay alive until the render thread finished the queued frames and the one in construction.
+void					imappRendererQueueFrame( ImAppRenderer* renderer );		// main thread
+void					imappRendererFinishFrame( ImAppRenderer* renderer );		// render thread with the context current
+
+bool					imappRendererDrawPacket( ImAppRenderer* renderer, ImAppRendererWindow* window, const ImAppRendererDrawPacket* packet, int width, int height, const float* clearColor, int bufferAge, ImUiRect* outDamageRect );
+#endif
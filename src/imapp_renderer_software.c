@@ -0,0 +1,1263 @@
+#include "imapp_renderer.h"
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_SOFTWARE )
+
+#include "imapp_debug.h"
+#include "imapp_internal.h"
+#include "imapp_platform.h"
+#include "imapp_res_pak.h"
+
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+#if IMAPP_ENABLED( IMAPP_ARCH_X64 ) || defined( __SSE2__ ) || (defined( _M_IX86_FP ) && _M_IX86_FP >= 2)
+#	define IMAPP_RENDERER_SSE2			TIKI_ON
+#	include <emmintrin.h>
+#else
+#	define IMAPP_RENDERER_SSE2			TIKI_OFF
+#endif
+
+#if IMAPP_ENABLED( IMAPP_ARCH_ARM64 ) || defined( __ARM_NEON )
+#	define IMAPP_RENDERER_NEON			TIKI_ON
+#	include <arm_neon.h>
+#else
+#	define IMAPP_RENDERER_NEON			TIKI_OFF
+#endif
+
+#define IMAPP_RENDERER_SOFTWARE_BAND_HEIGHT		32
+#define IMAPP_RENDERER_SOFTWARE_WORKER_COUNT	3u
+
+typedef enum ImAppRendererDrawMode
+{
+	ImAppRendererDrawMode_Color,
+	ImAppRendererDrawMode_Texture,
+	ImAppRendererDrawMode_Font,
+	ImAppRendererDrawMode_FontSdf
+} ImAppRendererDrawMode;
+
+typedef struct ImAppRendererVertex
+{
+	float						position[ 2u ];
+	float						uv[ 2u ];
+	uint32_t					color;
+} ImAppRendererVertex;
+
+typedef struct ImAppRendererRasterCommand
+{
+	uintsize					firstIndex;
+	int							clipRect[ 4u ];		// left, top, right, bottom of the scissor rect
+	int							bounds[ 4u ];		// left, top, right, bottom of the geometry inside of the scissor rect
+} ImAppRendererRasterCommand;
+
+// State of one frame, shared read only by all bands
+typedef struct ImAppRendererJob
+{
+	const ImUiDrawData*			drawData;
+	const ImAppRendererVertex*	vertices;
+	const uint32_t*				indices;
+	uintsize					vertexCount;
+	const ImAppRendererRasterCommand*	commands;
+	uint32_t*					pixels;
+	int							width;
+	int							height;
+	uint32_t					clearPixel;
+	int							redrawRect[ 4u ];	// left, top, right, bottom
+	uintsize					bandCount;
+} ImAppRendererJob;
+
+typedef struct ImAppRendererRasterState
+{
+	const ImAppRendererTexture*	texture;
+	ImAppRendererDrawMode		mode;
+	bool						alphaBlend;
+	int							clip[ 4u ];			// left, top, right, bottom
+	uint32_t*					pixels;
+	int							stride;
+} ImAppRendererRasterState;
+
+struct ImAppRenderer
+{
+	ImUiAllocator*				allocator;
+	ImAppPlatform*				platform;
+	uint32_t					flags;
+
+	uint32						contentGeneration;	// last generation handed to a texture, unique so reused texture memory can't match
+
+	ImAppThread*				workers[ IMAPP_RENDERER_SOFTWARE_WORKER_COUNT ];
+	uintsize					workerCount;
+	ImAppSemaphore*				workSemaphore;
+	ImAppSemaphore*				doneSemaphore;
+	ImAppMutex*					bandMutex;
+	bool						stopWorkers;
+
+	ImAppRendererJob			job;
+	uintsize					nextBand;
+
+	ImAppRendererRasterCommand*	rasterCommands;
+	uintsize					rasterCommandCapacity;
+
+	ImAppRendererDamageCommand*	damageCommands;		// swapped with the window after every compare
+	uintsize					damageCommandCapacity;
+
+	uint32_t					textureCount;
+	uint64_t					textureBytes[ ImAppRendererFormat_RGBA8 + 1u ];	// by ImAppRendererFormat
+};
+
+struct ImAppRendererTexture
+{
+	uint8_t*					data;				// one channel for R8, four for RGB8 and RGBA8
+
+	uint32						width;
+	uint32						height;
+	uint32						channels;
+
+	uint8						flags;
+
+	ImAppRendererFormat			format;
+	uintsize					dataSize;			// counted in the renderer stats, 0 without data
+	uint32						contentGeneration;	// changes with the data, commands sampling the texture get damaged
+};
+
+static const struct ImUiVertexElement s_vertexLayout[] = {
+	{ 1u,	ImUiVertexElementType_Float2,	ImUiVertexElementSemantic_PositionScreenSpace },
+	{ 1u,	ImUiVertexElementType_Float2,	ImUiVertexElementSemantic_TextureCoordinate },
+	{ 1u,	ImUiVertexElementType_UInt,		ImUiVertexElementSemantic_ColorABGR },
+};
+
+static void		imappRendererWorkerEntry( void* arg );
+static void		imappRendererStopWorkers( ImAppRenderer* renderer );
+static bool		imappRendererWindowGenerateFrame( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, ImAppRendererJob* job );
+static bool		imappRendererPrepareCommands( ImAppRenderer* renderer, const ImAppRendererJob* job );
+static bool		imappRendererWindowUpdateDamage( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererJob* job );
+static void		imappRendererRasterizeBands( ImAppRenderer* renderer );
+static void		imappRendererRasterizeBand( const ImAppRendererJob* job, int top, int bottom );
+static void		imappRendererRasterizeTriangle( const ImAppRendererRasterState* state, const ImAppRendererVertex* vertex0, const ImAppRendererVertex* vertex1, const ImAppRendererVertex* vertex2 );
+static void		imappRendererRasterizeLine( const ImAppRendererRasterState* state, const ImAppRendererVertex* vertex0, const ImAppRendererVertex* vertex1 );
+static void		imappRendererSampleTexture( const ImAppRendererTexture* texture, float u, float v, float* outTexel );
+static void		imappRendererFillSpan( uint32_t* pixels, int count, uint32_t color, bool alphaBlend );
+static uint32_t	imappRendererBlendPixel( uint32_t target, int r, int g, int b, int a, bool alphaBlend );
+
+ImUiVertexFormat imappRendererGetVertexFormat()
+{
+	const ImUiVertexFormat result = { s_vertexLayout, IMAPP_ARRAY_COUNT( s_vertexLayout ) };
+	return result;
+}
+
+ImAppRenderer* imappRendererCreate( ImUiAllocator* allocator, ImAppPlatform* platform, uint32_t flags )
+{
+	IMAPP_ASSERT( platform != NULL );
+
+	ImAppRenderer* renderer = IMUI_MEMORY_NEW_ZERO( allocator, ImAppRenderer );
+	if( renderer == NULL )
+	{
+		return NULL;
+	}
+
+	renderer->allocator	= allocator;
+	renderer->platform	= platform;
+	renderer->flags		= flags;
+
+	renderer->workSemaphore	= imappPlatformSemaphoreCreate( platform );
+	renderer->doneSemaphore	= imappPlatformSemaphoreCreate( platform );
+	renderer->bandMutex		= imappPlatformMutexCreate( platform );
+	if( !renderer->workSemaphore || !renderer->doneSemaphore || !renderer->bandMutex )
+	{
+		imappRendererDestroy( renderer );
+		return NULL;
+	}
+
+	// the calling thread rasterizes as well, without workers everything runs on it
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( renderer->workers ); ++i )
+	{
+		ImAppThread* worker = imappPlatformThreadCreate( platform, "imapp raster", imappRendererWorkerEntry, renderer );
+		if( !worker )
+		{
+			ImAppTrace( "[renderer] Failed to create raster thread. Using %d.\n", (int)renderer->workerCount );
+			break;
+		}
+
+		renderer->workers[ renderer->workerCount++ ] = worker;
+	}
+
+	return renderer;
+}
+
+void imappRendererDestroy( ImAppRenderer* renderer )
+{
+	imappRendererStopWorkers( renderer );
+
+	if( renderer->bandMutex )
+	{
+		imappPlatformMutexDestroy( renderer->platform, renderer->bandMutex );
+		renderer->bandMutex = NULL;
+	}
+
+	if( renderer->doneSemaphore )
+	{
+		imappPlatformSemaphoreDestroy( renderer->platform, renderer->doneSemaphore );
+		renderer->doneSemaphore = NULL;
+	}
+
+	if( renderer->workSemaphore )
+	{
+		imappPlatformSemaphoreDestroy( renderer->platform, renderer->workSemaphore );
+		renderer->workSemaphore = NULL;
+	}
+
+	IMUI_MEMORY_ARRAY_FREE( renderer->allocator, renderer->rasterCommands, renderer->rasterCommandCapacity );
+	IMUI_MEMORY_ARRAY_FREE( renderer->allocator, renderer->damageCommands, renderer->damageCommandCapacity );
+
+	ImUiMemoryFree( renderer->allocator, renderer );
+}
+
+static void imappRendererStopWorkers( ImAppRenderer* renderer )
+{
+	renderer->stopWorkers = true;
+	for( uintsize i = 0u; i < renderer->workerCount; ++i )
+	{
+		imappPlatformSemaphoreInc( renderer->workSemaphore );
+	}
+
+	for( uintsize i = 0u; i < renderer->workerCount; ++i )
+	{
+		imappPlatformThreadDestroy( renderer->workers[ i ] );
+		renderer->workers[ i ] = NULL;
+	}
+	renderer->workerCount = 0u;
+}
+
+static void imappRendererWorkerEntry( void* arg )
+{
+	ImAppRenderer* renderer = (ImAppRenderer*)arg;
+
+	while( true )
+	{
+		imappPlatformSemaphoreDec( renderer->workSemaphore, true );
+		if( renderer->stopWorkers )
+		{
+			break;
+		}
+
+		imappRendererRasterizeBands( renderer );
+
+		imappPlatformSemaphoreInc( renderer->doneSemaphore );
+	}
+}
+
+void imappRendererUpdate( ImAppRenderer* renderer )
+{
+	IMAPP_USE( renderer );
+}
+
+void imappRendererSetUploadBudget( ImAppRenderer* renderer, uint32_t budget, float budgetMs )
+{
+	// textures are copied synchronously, there is nothing to spread over updates
+	IMAPP_USE( renderer );
+	IMAPP_USE( budget );
+	IMAPP_USE( budgetMs );
+}
+
+bool imappRendererHasPendingUploads( const ImAppRenderer* renderer )
+{
+	IMAPP_USE( renderer );
+
+	return false;
+}
+
+void imappRendererGetTextureStats( const ImAppRenderer* renderer, ImAppRendererStats* stats )
+{
+	stats->textureCount			= renderer->textureCount;
+	stats->textureBytesR8		= renderer->textureBytes[ ImAppRendererFormat_R8 ];
+	stats->textureBytesRgb8		= renderer->textureBytes[ ImAppRendererFormat_RGB8 ];
+	stats->textureBytesRgba8	= renderer->textureBytes[ ImAppRendererFormat_RGBA8 ];
+}
+
+bool imappRendererCreateResources( ImAppRenderer* renderer )
+{
+	// no device resources
+	IMAPP_USE( renderer );
+	return true;
+}
+
+void imappRendererDestroyResources( ImAppRenderer* renderer )
+{
+	IMAPP_USE( renderer );
+}
+
+void imappRendererConstructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppWindow* platformWindow )
+{
+	IMAPP_USE( renderer );
+	IMAPP_USE( platformWindow );
+	memset( window, 0, sizeof( *window ) );
+}
+
+void imappRendererDestructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window )
+{
+	ImUiMemoryFree( renderer->allocator, window->pixels );
+	ImUiMemoryFree( renderer->allocator, window->vertexData );
+	ImUiMemoryFree( renderer->allocator, window->indexData );
+	IMUI_MEMORY_ARRAY_FREE( renderer->allocator, window->damageCommands, window->damageCommandCapacity );
+
+	memset( window, 0, sizeof( *window ) );
+}
+
+ImAppRendererTexture* imappRendererTextureCreate( ImAppRenderer* renderer )
+{
+	return IMUI_MEMORY_NEW_ZERO( renderer->allocator, ImAppRendererTexture );
+}
+
+ImAppRendererTexture* imappRendererTextureCreateFromMemory( ImAppRenderer* renderer, const void* data, uint32_t width, uint32_t height, ImAppRendererFormat format, uint8_t flags )
+{
+	ImAppRendererTexture* texture = imappRendererTextureCreate( renderer );
+	if( !texture )
+	{
+		return NULL;
+	}
+
+	if( !imappRendererTextureInitializeDataFromMemory( renderer, texture, data, width, height, format, flags ) )
+	{
+		imappRendererTextureDestroy( renderer, texture );
+		return NULL;
+	}
+
+	return texture;
+}
+
+bool imappRendererTextureInitializeDataFromMemory( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t width, uint32_t height, ImAppRendererFormat format, uint8_t flags )
+{
+	if( texture == NULL )
+	{
+		return false;
+	}
+
+	imappRendererTextureDestroyData( renderer, texture );
+
+	const uint32 channels = format == ImAppRendererFormat_R8 ? 1u : 4u;
+	const uintsize pixelCount = (uintsize)width * height;
+	texture->data = (uint8_t*)ImUiMemoryAlloc( renderer->allocator, pixelCount * channels );
+	if( texture->data == NULL )
+	{
+		return false;
+	}
+
+	texture->width		= width;
+	texture->height		= height;
+	texture->channels	= channels;
+	texture->flags		= flags;
+
+	const uint8_t* sourceData = (const uint8_t*)data;
+	if( format == ImAppRendererFormat_RGB8 )
+	{
+		// sampling only handles one and four channels
+		for( uintsize i = 0u; i < pixelCount; ++i )
+		{
+			texture->data[ (i * 4u) + 0u ] = sourceData[ (i * 3u) + 0u ];
+			texture->data[ (i * 4u) + 1u ] = sourceData[ (i * 3u) + 1u ];
+			texture->data[ (i * 4u) + 2u ] = sourceData[ (i * 3u) + 2u ];
+			texture->data[ (i * 4u) + 3u ] = 0xffu;
+		}
+	}
+	else
+	{
+		memcpy( texture->data, sourceData, pixelCount * channels );
+	}
+
+	// pixels drawn with the old content are invalid
+	texture->contentGeneration = ++renderer->contentGeneration;
+
+	texture->format		= format;
+	texture->dataSize	= pixelCount * channels;
+	renderer->textureCount++;
+	renderer->textureBytes[ format ] += texture->dataSize;
+
+	return true;
+}
+
+bool imappRendererTextureIsReady( ImAppRenderer* renderer, const ImAppRendererTexture* texture )
+{
+	IMAPP_USE( renderer );
+	IMAPP_USE( texture );
+
+	return true;
+}
+
+bool imappRendererTextureUpdateRegion( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height )
+{
+	if( texture->data == NULL ||
+		x + width > texture->width ||
+		y + height > texture->height )
+	{
+		return false;
+	}
+
+	const uint8_t* sourceData = (const uint8_t*)data;
+	for( uint32_t row = 0u; row < height; ++row )
+	{
+		uint8_t* targetRow = texture->data + ((((uintsize)(y + row) * texture->width) + x) * texture->channels);
+		if( texture->format == ImAppRendererFormat_RGB8 )
+		{
+			const uint8_t* sourceRow = sourceData + ((uintsize)row * width * 3u);
+			for( uintsize i = 0u; i < width; ++i )
+			{
+				targetRow[ (i * 4u) + 0u ] = sourceRow[ (i * 3u) + 0u ];
+				targetRow[ (i * 4u) + 1u ] = sourceRow[ (i * 3u) + 1u ];
+				targetRow[ (i * 4u) + 2u ] = sourceRow[ (i * 3u) + 2u ];
+				targetRow[ (i * 4u) + 3u ] = 0xffu;
+			}
+		}
+		else
+		{
+			const uintsize rowSize = (uintsize)width * texture->channels;
+			memcpy( targetRow, sourceData + (row * rowSize), rowSize );
+		}
+	}
+
+	// pixels drawn with the old content are invalid
+	texture->contentGeneration = ++renderer->contentGeneration;
+
+	return true;
+}
+
+void imappRendererTextureDestroyData( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+{
+	if( texture->data != NULL )
+	{
+		ImUiMemoryFree( renderer->allocator, texture->data );
+		texture->data = NULL;
+
+		renderer->textureCount--;
+		renderer->textureBytes[ texture->format ] -= texture->dataSize;
+		texture->dataSize = 0u;
+	}
+}
+
+void imappRendererTextureDestroy( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+{
+	if( texture == NULL )
+	{
+		return;
+	}
+
+	imappRendererTextureDestroyData( renderer, texture );
+
+	ImUiMemoryFree( renderer->allocator, texture );
+}
+
+void imappRendererWindowRequestCache( ImAppRendererWindow* window, ImUiRect rect )
+{
+	// the frame buffer is kept between frames and only damage gets redrawn, unchanged windows cost nothing
+	IMAPP_USE( window );
+	IMAPP_USE( rect );
+}
+
+bool imappRendererDraw( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, int width, int height, float clearColor[ 4 ], int bufferAge, ImUiRect* outDamageRect )
+{
+	// rasterizes into window->pixels, which is never given back to the platform
+	IMAPP_USE( bufferAge );
+
+	width	= IMUI_MAX( width, 0 );
+	height	= IMUI_MAX( height, 0 );
+
+	const uintsize pixelCount = (uintsize)width * (uintsize)height;
+	if( pixelCount > window->pixelCapacity )
+	{
+		ImUiMemoryFree( renderer->allocator, window->pixels );
+		window->pixels = (uint32_t*)ImUiMemoryAlloc( renderer->allocator, pixelCount * sizeof( uint32_t ) );
+		window->pixelCapacity = window->pixels ? pixelCount : 0u;
+		window->isDamageValid = false;
+	}
+	if( window->pixels == NULL )
+	{
+		return false;
+	}
+
+	ImAppRendererJob* job = &renderer->job;
+	memset( job, 0, sizeof( *job ) );
+	job->pixels		= window->pixels;
+	job->width		= width;
+	job->height		= height;
+
+	int clearChannels[ 4u ];
+	for( uintsize i = 0u; i < 4u; ++i )
+	{
+		const float channel = IMUI_MAX( 0.0f, IMUI_MIN( clearColor[ i ], 1.0f ) );
+		clearChannels[ i ] = (int)(channel * 255.0f + 0.5f);
+	}
+	job->clearPixel = ((uint32_t)clearChannels[ 3u ] << 24u) | ((uint32_t)clearChannels[ 0u ] << 16u) | ((uint32_t)clearChannels[ 1u ] << 8u) | (uint32_t)clearChannels[ 2u ];
+
+	if( !imappRendererWindowGenerateFrame( renderer, window, surface, job ) ||
+		!imappRendererPrepareCommands( renderer, job ) )
+	{
+		window->isDamageValid = false;
+		return false;
+	}
+	job->commands	= renderer->rasterCommands;
+
+	window->width	= width;
+	window->height	= height;
+
+	window->stats.commandCount	= (uint32_t)job->drawData->commandCount;
+	window->stats.drawCallCount	= 0u;
+
+	if( !imappRendererWindowUpdateDamage( renderer, window, job ) )
+	{
+		return false;
+	}
+
+	for( uintsize i = 0u; i < job->drawData->commandCount; ++i )
+	{
+		const int* bounds = renderer->rasterCommands[ i ].bounds;
+		if( bounds[ 0u ] < job->redrawRect[ 2u ] && bounds[ 2u ] > job->redrawRect[ 0u ] &&
+			bounds[ 1u ] < job->redrawRect[ 3u ] && bounds[ 3u ] > job->redrawRect[ 1u ] )
+		{
+			window->stats.drawCallCount++;
+		}
+	}
+
+	const int redrawHeight = job->redrawRect[ 3u ] - job->redrawRect[ 1u ];
+	job->bandCount = (uintsize)((redrawHeight + IMAPP_RENDERER_SOFTWARE_BAND_HEIGHT - 1) / IMAPP_RENDERER_SOFTWARE_BAND_HEIGHT);
+	renderer->nextBand = 0u;
+
+	// small damage isn't worth waking up the workers
+	const uintsize workerCount = IMUI_MIN( renderer->workerCount, job->bandCount - 1u );
+	for( uintsize i = 0u; i < workerCount; ++i )
+	{
+		imappPlatformSemaphoreInc( renderer->workSemaphore );
+	}
+
+	imappRendererRasterizeBands( renderer );
+
+	for( uintsize i = 0u; i < workerCount; ++i )
+	{
+		imappPlatformSemaphoreDec( renderer->doneSemaphore, true );
+	}
+
+	outDamageRect->pos.x		= (float)job->redrawRect[ 0u ];
+	outDamageRect->pos.y		= (float)job->redrawRect[ 1u ];
+	outDamageRect->size.width	= (float)(job->redrawRect[ 2u ] - job->redrawRect[ 0u ]);
+	outDamageRect->size.height	= (float)redrawHeight;
+
+	return true;
+}
+
+static bool imappRendererWindowGenerateFrame( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, ImAppRendererJob* job )
+{
+	uintsize vertexDataSize = 0u;
+	uintsize indexDataSize = 0u;
+	ImUiSurfaceGetMaxBufferSizes( surface, &vertexDataSize, &indexDataSize );
+
+	if( vertexDataSize > window->vertexDataSize )
+	{
+		const uintsize size = IMUI_NEXT_POWER_OF_TWO( vertexDataSize );
+		void* data = ImUiMemoryRealloc( renderer->allocator, window->vertexData, window->vertexDataSize, size );
+		if( data == NULL )
+		{
+			return false;
+		}
+
+		window->vertexData		= data;
+		window->vertexDataSize	= size;
+	}
+
+	if( indexDataSize > window->indexDataSize )
+	{
+		const uintsize size = IMUI_NEXT_POWER_OF_TWO( indexDataSize );
+		void* data = ImUiMemoryRealloc( renderer->allocator, window->indexData, window->indexDataSize, size );
+		if( data == NULL )
+		{
+			return false;
+		}
+
+		window->indexData		= data;
+		window->indexDataSize	= size;
+	}
+
+	job->drawData		= ImUiSurfaceGenerateDrawData( surface, window->vertexData, &vertexDataSize, window->indexData, &indexDataSize );
+	job->vertices		= (const ImAppRendererVertex*)window->vertexData;
+	job->indices		= (const uint32_t*)window->indexData;
+	job->vertexCount	= vertexDataSize / sizeof( ImAppRendererVertex );
+
+	return job->drawData != NULL;
+}
+
+static bool imappRendererPrepareCommands( ImAppRenderer* renderer, const ImAppRendererJob* job )
+{
+	const ImUiDrawData* drawData = job->drawData;
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->rasterCommands, renderer->rasterCommandCapacity, drawData->commandCount ) )
+	{
+		return false;
+	}
+
+	uintsize firstIndex = 0u;
+	for( uintsize i = 0u; i < drawData->commandCount; ++i )
+	{
+		const ImUiDrawCommand* command = &drawData->commands[ i ];
+		ImAppRendererRasterCommand* rasterCommand = &renderer->rasterCommands[ i ];
+
+		rasterCommand->firstIndex = firstIndex;
+
+		int* clipRect = rasterCommand->clipRect;
+		clipRect[ 0u ] = IMUI_MAX( (int)command->clipRect.pos.x, 0 );
+		clipRect[ 1u ] = IMUI_MAX( (int)command->clipRect.pos.y, 0 );
+		clipRect[ 2u ] = IMUI_MIN( (int)(command->clipRect.pos.x + command->clipRect.size.width), job->width );
+		clipRect[ 3u ] = IMUI_MIN( (int)(command->clipRect.pos.y + command->clipRect.size.height), job->height );
+
+		float left		= FLT_MAX;
+		float top		= FLT_MAX;
+		float right		= -FLT_MAX;
+		float bottom	= -FLT_MAX;
+		for( uintsize j = 0u; j < command->count; ++j )
+		{
+			const uint32_t index = job->indices[ firstIndex + j ];
+			if( index >= job->vertexCount )
+			{
+				continue;
+			}
+
+			const ImAppRendererVertex* vertex = &job->vertices[ index ];
+			left	= IMUI_MIN( left, vertex->position[ 0u ] );
+			top		= IMUI_MIN( top, vertex->position[ 1u ] );
+			right	= IMUI_MAX( right, vertex->position[ 0u ] );
+			bottom	= IMUI_MAX( bottom, vertex->position[ 1u ] );
+		}
+
+		// one pixel margin for lines and rounding
+		int* bounds = rasterCommand->bounds;
+		if( left > right )
+		{
+			bounds[ 0u ] = bounds[ 1u ] = bounds[ 2u ] = bounds[ 3u ] = 0;
+		}
+		else
+		{
+			bounds[ 0u ] = IMUI_MAX( (int)floorf( IMUI_MAX( left, -1.0f ) ) - 1, clipRect[ 0u ] );
+			bounds[ 1u ] = IMUI_MAX( (int)floorf( IMUI_MAX( top, -1.0f ) ) - 1, clipRect[ 1u ] );
+			bounds[ 2u ] = IMUI_MIN( (int)ceilf( IMUI_MIN( right, (float)job->width + 1.0f ) ) + 1, clipRect[ 2u ] );
+			bounds[ 3u ] = IMUI_MIN( (int)ceilf( IMUI_MIN( bottom, (float)job->height + 1.0f ) ) + 1, clipRect[ 3u ] );
+		}
+
+		firstIndex += command->count;
+	}
+
+	return true;
+}
+
+static bool imappRendererWindowUpdateDamage( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererJob* job )
+{
+	const ImUiDrawData* drawData = job->drawData;
+	int* redrawRect = job->redrawRect;
+
+	redrawRect[ 0u ] = 0;
+	redrawRect[ 1u ] = 0;
+	redrawRect[ 2u ] = job->width;
+	redrawRect[ 3u ] = job->height;
+
+	if( (renderer->flags & ImAppRendererFlags_DamageTracking) == 0u ||
+		!IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->damageCommands, renderer->damageCommandCapacity, drawData->commandCount ) )
+	{
+		window->isDamageValid = false;
+		return job->width > 0 && job->height > 0;
+	}
+
+	// everything that changes pixels without changing draw data
+	ImUiHash stateHash = ImUiHashMix( (ImUiHash)job->clearPixel, (ImUiHash)job->width );
+	stateHash = ImUiHashMix( stateHash, (ImUiHash)job->height );
+
+	const uint32_t* indices = job->indices;
+	for( uintsize i = 0u; i < drawData->commandCount; ++i )
+	{
+		const ImUiDrawCommand* command = &drawData->commands[ i ];
+		ImAppRendererDamageCommand* damageCommand = &renderer->damageCommands[ i ];
+
+		uint32_t minIndex = UINT32_MAX;
+		uint32_t maxIndex = 0u;
+		for( uintsize j = 0u; j < command->count; ++j )
+		{
+			minIndex = IMUI_MIN( minIndex, indices[ j ] );
+			maxIndex = IMUI_MAX( maxIndex, indices[ j ] );
+		}
+
+		// indices relative to the first vertex, so shifted vertices of unchanged commands hash equal
+		uint32_t indexHash = (uint32_t)command->count;
+		for( uintsize j = 0u; j < command->count; ++j )
+		{
+			indexHash = (indexHash * 16777619u) ^ (indices[ j ] - minIndex);
+		}
+
+		ImUiHash hash = ImUiHashCreate( &command->clipRect, sizeof( command->clipRect ) );
+		hash = ImUiHashCreateSeed( &command->textureHandle, sizeof( command->textureHandle ), hash );
+		if( command->textureHandle != IMUI_TEXTURE_HANDLE_INVALID )
+		{
+			// updated texture data only damages the commands sampling it
+			const ImAppRendererTexture* texture = (const ImAppRendererTexture*)command->textureHandle;
+			hash = ImUiHashMix( hash, (ImUiHash)texture->contentGeneration );
+		}
+		hash = ImUiHashMix( hash, (ImUiHash)command->topology );
+		hash = ImUiHashMix( hash, indexHash );
+		if( minIndex <= maxIndex && maxIndex < job->vertexCount )
+		{
+			hash = ImUiHashCreateSeed( &job->vertices[ minIndex ], (maxIndex - minIndex + 1u) * sizeof( ImAppRendererVertex ), hash );
+		}
+
+		damageCommand->hash = hash;
+		memcpy( damageCommand->bounds, renderer->rasterCommands[ i ].bounds, sizeof( damageCommand->bounds ) );
+
+		indices += command->count;
+	}
+
+	int dirtyRect[ 4u ] = { INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+	const bool fullDamage = !window->isDamageValid || window->damageStateHash != stateHash;
+
+	const uintsize compareCount = IMUI_MAX( drawData->commandCount, window->damageCommandCount );
+	for( uintsize i = 0u; i < compareCount && !fullDamage; ++i )
+	{
+		const ImAppRendererDamageCommand* oldCommand = i < window->damageCommandCount ? &window->damageCommands[ i ] : NULL;
+		const ImAppRendererDamageCommand* newCommand = i < drawData->commandCount ? &renderer->damageCommands[ i ] : NULL;
+		if( oldCommand && newCommand &&
+			oldCommand->hash == newCommand->hash &&
+			memcmp( oldCommand->bounds, newCommand->bounds, sizeof( oldCommand->bounds ) ) == 0 )
+		{
+			continue;
+		}
+
+		// the old content has to disappear and the new content appear
+		for( uintsize j = 0u; j < 2u; ++j )
+		{
+			const ImAppRendererDamageCommand* damageCommand = j == 0u ? oldCommand : newCommand;
+			if( damageCommand == NULL || damageCommand->bounds[ 0u ] >= damageCommand->bounds[ 2u ] || damageCommand->bounds[ 1u ] >= damageCommand->bounds[ 3u ] )
+			{
+				continue;
+			}
+
+			dirtyRect[ 0u ] = IMUI_MIN( dirtyRect[ 0u ], damageCommand->bounds[ 0u ] );
+			dirtyRect[ 1u ] = IMUI_MIN( dirtyRect[ 1u ], damageCommand->bounds[ 1u ] );
+			dirtyRect[ 2u ] = IMUI_MAX( dirtyRect[ 2u ], damageCommand->bounds[ 2u ] );
+			dirtyRect[ 3u ] = IMUI_MAX( dirtyRect[ 3u ], damageCommand->bounds[ 3u ] );
+		}
+	}
+
+	// keep the new frame for the next compare
+	ImAppRendererDamageCommand* lastCommands	= window->damageCommands;
+	const uintsize lastCapacity					= window->damageCommandCapacity;
+	window->damageCommands						= renderer->damageCommands;
+	window->damageCommandCapacity				= renderer->damageCommandCapacity;
+	window->damageCommandCount					= drawData->commandCount;
+	window->damageStateHash						= stateHash;
+	window->isDamageValid						= true;
+	renderer->damageCommands					= lastCommands;
+	renderer->damageCommandCapacity				= lastCapacity;
+
+	if( fullDamage )
+	{
+		return job->width > 0 && job->height > 0;
+	}
+
+	redrawRect[ 0u ] = IMUI_MAX( dirtyRect[ 0u ], 0 );
+	redrawRect[ 1u ] = IMUI_MAX( dirtyRect[ 1u ], 0 );
+	redrawRect[ 2u ] = IMUI_MIN( dirtyRect[ 2u ], job->width );
+	redrawRect[ 3u ] = IMUI_MIN( dirtyRect[ 3u ], job->height );
+
+	return redrawRect[ 0u ] < redrawRect[ 2u ] && redrawRect[ 1u ] < redrawRect[ 3u ];
+}
+
+static void imappRendererRasterizeBands( ImAppRenderer* renderer )
+{
+	const ImAppRendererJob* job = &renderer->job;
+
+	while( true )
+	{
+		imappPlatformMutexLock( renderer->bandMutex );
+		const uintsize band = renderer->nextBand++;
+		imappPlatformMutexUnlock( renderer->bandMutex );
+
+		if( band >= job->bandCount )
+		{
+			break;
+		}
+
+		const int top		= job->redrawRect[ 1u ] + ((int)band * IMAPP_RENDERER_SOFTWARE_BAND_HEIGHT);
+		const int bottom	= IMUI_MIN( top + IMAPP_RENDERER_SOFTWARE_BAND_HEIGHT, job->redrawRect[ 3u ] );
+		imappRendererRasterizeBand( job, top, bottom );
+	}
+}
+
+static void imappRendererRasterizeBand( const ImAppRendererJob* job, int top, int bottom )
+{
+	// every band draws all commands in order, so blending stays correct without synchronization
+	const int area[ 4u ] = { job->redrawRect[ 0u ], top, job->redrawRect[ 2u ], bottom };
+
+	for( int y = area[ 1u ]; y < area[ 3u ]; ++y )
+	{
+		imappRendererFillSpan( job->pixels + ((uintsize)y * (uintsize)job->width) + area[ 0u ], area[ 2u ] - area[ 0u ], job->clearPixel, false );
+	}
+
+	const ImUiDrawData* drawData = job->drawData;
+	for( uintsize i = 0u; i < drawData->commandCount; ++i )
+	{
+		const ImUiDrawCommand* command = &drawData->commands[ i ];
+		const ImAppRendererRasterCommand* rasterCommand = &job->commands[ i ];
+
+		const int* bounds = rasterCommand->bounds;
+		if( bounds[ 0u ] >= area[ 2u ] || bounds[ 2u ] <= area[ 0u ] ||
+			bounds[ 1u ] >= area[ 3u ] || bounds[ 3u ] <= area[ 1u ] )
+		{
+			continue;
+		}
+
+		ImAppRendererRasterState state;
+		state.texture		= (const ImAppRendererTexture*)command->textureHandle;
+		state.mode			= ImAppRendererDrawMode_Color;
+		state.alphaBlend	= true;
+		state.clip[ 0u ]	= IMUI_MAX( rasterCommand->clipRect[ 0u ], area[ 0u ] );
+		state.clip[ 1u ]	= IMUI_MAX( rasterCommand->clipRect[ 1u ], area[ 1u ] );
+		state.clip[ 2u ]	= IMUI_MIN( rasterCommand->clipRect[ 2u ], area[ 2u ] );
+		state.clip[ 3u ]	= IMUI_MIN( rasterCommand->clipRect[ 3u ], area[ 3u ] );
+		state.pixels		= job->pixels;
+		state.stride		= job->width;
+
+		if( state.texture != NULL )
+		{
+			if( state.texture->data == NULL )
+			{
+				continue;
+			}
+			else if( state.texture->flags & ImAppResPakTextureFlags_Font )
+			{
+				state.mode = ImAppRendererDrawMode_Font;
+			}
+			else if( state.texture->flags & ImAppResPakTextureFlags_FontSdf )
+			{
+				state.mode = ImAppRendererDrawMode_FontSdf;
+			}
+			else
+			{
+				state.mode			= ImAppRendererDrawMode_Texture;
+				state.alphaBlend	= (state.texture->flags & ImAppResPakTextureFlags_Opaque) == 0u;
+			}
+		}
+
+		const uint32_t* indices = job->indices + rasterCommand->firstIndex;
+		const uintsize primitiveSize = command->topology == ImUiDrawTopology_LineList ? 2u : 3u;
+		for( uintsize j = 0u; j + primitiveSize <= command->count; j += primitiveSize )
+		{
+			if( indices[ j ] >= job->vertexCount ||
+				indices[ j + 1u ] >= job->vertexCount ||
+				(primitiveSize == 3u && indices[ j + 2u ] >= job->vertexCount) )
+			{
+				continue;
+			}
+
+			if( primitiveSize == 2u )
+			{
+				imappRendererRasterizeLine( &state, &job->vertices[ indices[ j ] ], &job->vertices[ indices[ j + 1u ] ] );
+			}
+			else
+			{
+				imappRendererRasterizeTriangle( &state, &job->vertices[ indices[ j ] ], &job->vertices[ indices[ j + 1u ] ], &job->vertices[ indices[ j + 2u ] ] );
+			}
+		}
+	}
+}
+
+static void imappRendererRasterizeTriangle( const ImAppRendererRasterState* state, const ImAppRendererVertex* vertex0, const ImAppRendererVertex* vertex1, const ImAppRendererVertex* vertex2 )
+{
+	const ImAppRendererVertex* vertices[ 3u ] = { vertex0, vertex1, vertex2 };
+
+	float area = ((vertex1->position[ 0u ] - vertex0->position[ 0u ]) * (vertex2->position[ 1u ] - vertex0->position[ 1u ])) -
+		((vertex2->position[ 0u ] - vertex0->position[ 0u ]) * (vertex1->position[ 1u ] - vertex0->position[ 1u ]));
+	if( area == 0.0f || area != area )
+	{
+		return;
+	}
+	else if( area < 0.0f )
+	{
+		vertices[ 1u ]	= vertex2;
+		vertices[ 2u ]	= vertex1;
+		area			= -area;
+	}
+
+	const float x0 = vertices[ 0u ]->position[ 0u ];
+	const float y0 = vertices[ 0u ]->position[ 1u ];
+
+	// edge functions a * x + b * y + c, positive inside. Shared edges are exact negations, so the tie rule can't draw a pixel twice.
+	float edgeA[ 3u ];
+	float edgeB[ 3u ];
+	float edgeC[ 3u ];
+	float minY = FLT_MAX;
+	float maxY = -FLT_MAX;
+	for( uintsize i = 0u; i < 3u; ++i )
+	{
+		const float* from	= vertices[ i ]->position;
+		const float* to		= vertices[ (i + 1u) % 3u ]->position;
+		edgeA[ i ] = from[ 1u ] - to[ 1u ];
+		edgeB[ i ] = to[ 0u ] - from[ 0u ];
+		edgeC[ i ] = (from[ 0u ] * to[ 1u ]) - (from[ 1u ] * to[ 0u ]);
+
+		minY = IMUI_MIN( minY, from[ 1u ] );
+		maxY = IMUI_MAX( maxY, from[ 1u ] );
+	}
+
+	// attribute planes: u, v, r, g, b, a
+	float attributes[ 3u ][ 6u ];
+	for( uintsize i = 0u; i < 3u; ++i )
+	{
+		const ImAppRendererVertex* vertex = vertices[ i ];
+		attributes[ i ][ 0u ] = vertex->uv[ 0u ];
+		attributes[ i ][ 1u ] = vertex->uv[ 1u ];
+		attributes[ i ][ 2u ] = (float)(vertex->color & 0xffu);
+		attributes[ i ][ 3u ] = (float)((vertex->color >> 8u) & 0xffu);
+		attributes[ i ][ 4u ] = (float)((vertex->color >> 16u) & 0xffu);
+		attributes[ i ][ 5u ] = (float)(vertex->color >> 24u);
+	}
+
+	const float deltaX1 = vertices[ 1u ]->position[ 0u ] - x0;
+	const float deltaY1 = vertices[ 1u ]->position[ 1u ] - y0;
+	const float deltaX2 = vertices[ 2u ]->position[ 0u ] - x0;
+	const float deltaY2 = vertices[ 2u ]->position[ 1u ] - y0;
+	const float inverseArea = 1.0f / area;
+
+	float attributeDx[ 6u ];
+	float attributeDy[ 6u ];
+	for( uintsize i = 0u; i < 6u; ++i )
+	{
+		const float delta1 = attributes[ 1u ][ i ] - attributes[ 0u ][ i ];
+		const float delta2 = attributes[ 2u ][ i ] - attributes[ 0u ][ i ];
+		attributeDx[ i ] = ((delta1 * deltaY2) - (delta2 * deltaY1)) * inverseArea;
+		attributeDy[ i ] = ((delta2 * deltaX1) - (delta1 * deltaX2)) * inverseArea;
+	}
+
+	const bool constantColor	= vertices[ 0u ]->color == vertices[ 1u ]->color && vertices[ 0u ]->color == vertices[ 2u ]->color;
+	const uint32_t color		= vertices[ 0u ]->color;
+	const uint32_t colorPixel	= (color & 0xff00ff00u) | ((color & 0xffu) << 16u) | ((color >> 16u) & 0xffu);
+
+	// fwidth of the texture coordinates is constant over a triangle
+	float screenPixelRange = 1.0f;
+	if( state->mode == ImAppRendererDrawMode_FontSdf )
+	{
+		const float widthU = fabsf( attributeDx[ 0u ] ) + fabsf( attributeDy[ 0u ] );
+		const float widthV = fabsf( attributeDx[ 1u ] ) + fabsf( attributeDy[ 1u ] );
+		const float rangeU = widthU > 0.0f ? (2.0f / (float)state->texture->width) / widthU : 0.0f;
+		const float rangeV = widthV > 0.0f ? (2.0f / (float)state->texture->height) / widthV : 0.0f;
+		screenPixelRange = IMUI_MAX( 0.5f * (rangeU + rangeV), 1.0f );
+	}
+
+	const int clipLeft		= state->clip[ 0u ];
+	const int clipRight		= state->clip[ 2u ];
+	const int startY		= IMUI_MAX( state->clip[ 1u ], (int)ceilf( IMUI_MAX( minY, -1.0f ) - 0.5f ) );
+	const int endY			= IMUI_MIN( state->clip[ 3u ], (int)floorf( IMUI_MIN( maxY, 1.0e9f ) - 0.5f ) + 1 );
+	for( int y = startY; y < endY; ++y )
+	{
+		const float pixelY = (float)y + 0.5f;
+
+		int spanStart	= clipLeft;
+		int spanEnd		= clipRight;
+		for( uintsize i = 0u; i < 3u && spanStart < spanEnd; ++i )
+		{
+			const float rowValue = (edgeB[ i ] * pixelY) + edgeC[ i ];
+			if( edgeA[ i ] == 0.0f )
+			{
+				// horizontal edge, owned when b is positive
+				if( rowValue < 0.0f || (rowValue == 0.0f && edgeB[ i ] < 0.0f) )
+				{
+					spanEnd = spanStart;
+				}
+				continue;
+			}
+
+			// pixel centers x + 0.5 >= t for edges facing right, < t for edges facing left
+			float t = -rowValue / edgeA[ i ];
+			t = IMUI_MAX( t, (float)clipLeft - 1.0f );
+			t = IMUI_MIN( t, (float)clipRight + 1.0f );
+			const int boundary = (int)ceilf( t - 0.5f );
+			if( edgeA[ i ] > 0.0f )
+			{
+				spanStart = IMUI_MAX( spanStart, boundary );
+			}
+			else
+			{
+				spanEnd = IMUI_MIN( spanEnd, boundary );
+			}
+		}
+
+		if( spanStart >= spanEnd )
+		{
+			continue;
+		}
+
+		uint32_t* row = state->pixels + ((uintsize)y * (uintsize)state->stride);
+		if( state->mode == ImAppRendererDrawMode_Color && constantColor )
+		{
+			imappRendererFillSpan( row + spanStart, spanEnd - spanStart, colorPixel, true );
+			continue;
+		}
+
+		const float offsetX = ((float)spanStart + 0.5f) - x0;
+		const float offsetY = pixelY - y0;
+		float values[ 6u ];
+		for( uintsize i = 0u; i < 6u; ++i )
+		{
+			values[ i ] = attributes[ 0u ][ i ] + (attributeDx[ i ] * offsetX) + (attributeDy[ i ] * offsetY);
+		}
+
+		for( int x = spanStart; x < spanEnd; ++x )
+		{
+			float r = values[ 2u ];
+			float g = values[ 3u ];
+			float b = values[ 4u ];
+			float a = values[ 5u ];
+
+			if( state->mode != ImAppRendererDrawMode_Color )
+			{
+				float texel[ 4u ];
+				imappRendererSampleTexture( state->texture, values[ 0u ], values[ 1u ], texel );
+
+				switch( state->mode )
+				{
+				case ImAppRendererDrawMode_Color:
+					break;
+
+				case ImAppRendererDrawMode_Texture:
+					r *= texel[ 0u ] * (1.0f / 255.0f);
+					g *= texel[ 1u ] * (1.0f / 255.0f);
+					b *= texel[ 2u ] * (1.0f / 255.0f);
+					a *= texel[ 3u ] * (1.0f / 255.0f);
+					break;
+
+				case ImAppRendererDrawMode_Font:
+					a *= texel[ 3u ] * (1.0f / 255.0f);
+					break;
+
+				case ImAppRendererDrawMode_FontSdf:
+					{
+						const float median = IMUI_MAX( IMUI_MIN( texel[ 0u ], texel[ 1u ] ), IMUI_MIN( IMUI_MAX( texel[ 0u ], texel[ 1u ] ), texel[ 2u ] ) ) * (1.0f / 255.0f);
+						const float charDistance = screenPixelRange * (median - 0.5f);
+						a *= IMUI_MAX( 0.0f, IMUI_MIN( charDistance + 0.5f, 1.0f ) );
+					}
+					break;
+				}
+			}
+
+			row[ x ] = imappRendererBlendPixel( row[ x ], (int)(r + 0.5f), (int)(g + 0.5f), (int)(b + 0.5f), (int)(a + 0.5f), state->alphaBlend );
+
+			for( uintsize i = 0u; i < 6u; ++i )
+			{
+				values[ i ] += attributeDx[ i ];
+			}
+		}
+	}
+}
+
+static void imappRendererRasterizeLine( const ImAppRendererRasterState* state, const ImAppRendererVertex* vertex0, const ImAppRendererVertex* vertex1 )
+{
+	// one pixel wide, color only
+	const float deltaX	= vertex1->position[ 0u ] - vertex0->position[ 0u ];
+	const float deltaY	= vertex1->position[ 1u ] - vertex0->position[ 1u ];
+	const bool xMajor	= fabsf( deltaX ) >= fabsf( deltaY );
+	const float length	= xMajor ? fabsf( deltaX ) : fabsf( deltaY );
+	if( length == 0.0f || length != length )
+	{
+		return;
+	}
+
+	const uint32_t color	= vertex0->color;
+	const int r				= (int)(color & 0xffu);
+	const int g				= (int)((color >> 8u) & 0xffu);
+	const int b				= (int)((color >> 16u) & 0xffu);
+	const int a				= (int)(color >> 24u);
+
+	const float majorStart	= xMajor ? IMUI_MIN( vertex0->position[ 0u ], vertex1->position[ 0u ] ) : IMUI_MIN( vertex0->position[ 1u ], vertex1->position[ 1u ] );
+	const float majorEnd	= majorStart + length;
+	const float slope		= xMajor ? deltaY / deltaX : deltaX / deltaY;
+	const float* origin		= vertex0->position;
+
+	const int clipMajorStart	= xMajor ? state->clip[ 0u ] : state->clip[ 1u ];
+	const int clipMajorEnd		= xMajor ? state->clip[ 2u ] : state->clip[ 3u ];
+	const int clipMinorStart	= xMajor ? state->clip[ 1u ] : state->clip[ 0u ];
+	const int clipMinorEnd		= xMajor ? state->clip[ 3u ] : state->clip[ 2u ];
+
+	const int start	= IMUI_MAX( clipMajorStart, (int)ceilf( IMUI_MAX( majorStart, -1.0f ) - 0.5f ) );
+	const int end	= IMUI_MIN( clipMajorEnd, (int)ceilf( IMUI_MIN( majorEnd, 1.0e9f ) - 0.5f ) );
+	for( int major = start; major < end; ++major )
+	{
+		const float majorCenter	= (float)major + 0.5f;
+		const float minorCenter	= xMajor ?
+			origin[ 1u ] + ((majorCenter - origin[ 0u ]) * slope) :
+			origin[ 0u ] + ((majorCenter - origin[ 1u ]) * slope);
+		const int minor = (int)floorf( minorCenter );
+		if( minor < clipMinorStart || minor >= clipMinorEnd )
+		{
+			continue;
+		}
+
+		const int x = xMajor ? major : minor;
+		const int y = xMajor ? minor : major;
+		uint32_t* pixel = state->pixels + ((uintsize)y * (uintsize)state->stride) + x;
+		*pixel = imappRendererBlendPixel( *pixel, r, g, b, a, true );
+	}
+}
+
+static void imappRendererSampleTexture( const ImAppRendererTexture* texture, float u, float v, float* outTexel )
+{
+	// bilinear like GL_LINEAR, one channel textures sample as alpha
+	const float x = (u * (float)texture->width) - 0.5f;
+	const float y = (v * (float)texture->height) - 0.5f;
+	const float floorX = floorf( IMUI_MAX( IMUI_MIN( x, 1.0e7f ), -1.0e7f ) );
+	const float floorY = floorf( IMUI_MAX( IMUI_MIN( y, 1.0e7f ), -1.0e7f ) );
+	const float weightX = x - floorX;
+	const float weightY = y - floorY;
+
+	const int width		= (int)texture->width;
+	const int height	= (int)texture->height;
+	int coordsX[ 2u ] = { (int)floorX, (int)floorX + 1 };
+	int coordsY[ 2u ] = { (int)floorY, (int)floorY + 1 };
+	for( uintsize i = 0u; i < 2u; ++i )
+	{
+		if( texture->flags & ImAppResPakTextureFlags_Repeat )
+		{
+			coordsX[ i ] = ((coordsX[ i ] % width) + width) % width;
+			coordsY[ i ] = ((coordsY[ i ] % height) + height) % height;
+		}
+		else
+		{
+			coordsX[ i ] = IMUI_MAX( 0, IMUI_MIN( coordsX[ i ], width - 1 ) );
+			coordsY[ i ] = IMUI_MAX( 0, IMUI_MIN( coordsY[ i ], height - 1 ) );
+		}
+	}
+
+	const float weights[ 4u ] = {
+		(1.0f - weightX) * (1.0f - weightY),
+		weightX * (1.0f - weightY),
+		(1.0f - weightX) * weightY,
+		weightX * weightY
+	};
+
+	outTexel[ 0u ] = outTexel[ 1u ] = outTexel[ 2u ] = outTexel[ 3u ] = 0.0f;
+	for( uintsize i = 0u; i < 4u; ++i )
+	{
+		const uintsize offset = ((uintsize)coordsY[ i >> 1u ] * (uintsize)width) + (uintsize)coordsX[ i & 1u ];
+		if( texture->channels == 1u )
+		{
+			outTexel[ 3u ] += weights[ i ] * (float)texture->data[ offset ];
+			continue;
+		}
+
+		const uint8_t* texel = &texture->data[ offset * 4u ];
+		outTexel[ 0u ] += weights[ i ] * (float)texel[ 0u ];
+		outTexel[ 1u ] += weights[ i ] * (float)texel[ 1u ];
+		outTexel[ 2u ] += weights[ i ] * (float)texel[ 2u ];
+		outTexel[ 3u ] += weights[ i ] * (float)texel[ 3u ];
+	}
+}
+
+// (x + 128 + ((x + 128) >> 8)) >> 8 is x / 255 rounded for all products of two bytes
+static IMAPP_INLINE uint32_t imappRendererDiv255( uint32_t value )
+{
+	value += 128u;
+	return (value + (value >> 8u)) >> 8u;
+}
+
+static void imappRendererFillSpan( uint32_t* pixels, int count, uint32_t color, bool alphaBlend )
+{
+	const uint32_t alpha = color >> 24u;
+	if( alphaBlend && alpha == 0u )
+	{
+		return;
+	}
+
+	int i = 0;
+	if( !alphaBlend || alpha == 0xffu )
+	{
+#if IMAPP_ENABLED( IMAPP_RENDERER_SSE2 )
+		const __m128i source = _mm_set1_epi32( (int)color );
+		for( ; i + 4 <= count; i += 4 )
+		{
+			_mm_storeu_si128( (__m128i*)&pixels[ i ], source );
+		}
+#elif IMAPP_ENABLED( IMAPP_RENDERER_NEON )
+		const uint32x4_t source = vdupq_n_u32( color );
+		for( ; i + 4 <= count; i += 4 )
+		{
+			vst1q_u32( &pixels[ i ], source );
+		}
+#endif
+		for( ; i < count; ++i )
+		{
+			pixels[ i ] = color;
+		}
+		return;
+	}
+
+	// SRC_ALPHA, ONE_MINUS_SRC_ALPHA for all channels, so every byte uses the same factors
+	const uint32_t inverseAlpha = 0xffu - alpha;
+#if IMAPP_ENABLED( IMAPP_RENDERER_SSE2 )
+	{
+		const __m128i zero			= _mm_setzero_si128();
+		const __m128i source		= _mm_unpacklo_epi8( _mm_set1_epi32( (int)color ), zero );
+		const __m128i sourceScaled	= _mm_mullo_epi16( source, _mm_set1_epi16( (short)alpha ) );
+		const __m128i targetFactor	= _mm_set1_epi16( (short)inverseAlpha );
+		const __m128i rounding		= _mm_set1_epi16( 128 );
+		for( ; i + 4 <= count; i += 4 )
+		{
+			const __m128i target = _mm_loadu_si128( (const __m128i*)&pixels[ i ] );
+
+			__m128i low		= _mm_add_epi16( _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( target, zero ), targetFactor ), sourceScaled ), rounding );
+			__m128i high	= _mm_add_epi16( _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( target, zero ), targetFactor ), sourceScaled ), rounding );
+			low		= _mm_srli_epi16( _mm_add_epi16( low, _mm_srli_epi16( low, 8 ) ), 8 );
+			high	= _mm_srli_epi16( _mm_add_epi16( high, _mm_srli_epi16( high, 8 ) ), 8 );
+
+			_mm_storeu_si128( (__m128i*)&pixels[ i ], _mm_packus_epi16( low, high ) );
+		}
+	}
+#elif IMAPP_ENABLED( IMAPP_RENDERER_NEON )
+	{
+		const uint8x8_t source			= vreinterpret_u8_u32( vdup_n_u32( color ) );
+		const uint16x8_t sourceScaled	= vmull_u8( source, vdup_n_u8( (uint8_t)alpha ) );
+		const uint8x8_t targetFactor	= vdup_n_u8( (uint8_t)inverseAlpha );
+		for( ; i + 4 <= count; i += 4 )
+		{
+			const uint8x16_t target = vreinterpretq_u8_u32( vld1q_u32( &pixels[ i ] ) );
+
+			const uint16x8_t low	= vmlal_u8( sourceScaled, vget_low_u8( target ), targetFactor );
+			const uint16x8_t high	= vmlal_u8( sourceScaled, vget_high_u8( target ), targetFactor );
+			const uint8x16_t result	= vcombine_u8( vraddhn_u16( low, vrshrq_n_u16( low, 8 ) ), vraddhn_u16( high, vrshrq_n_u16( high, 8 ) ) );
+
+			vst1q_u32( &pixels[ i ], vreinterpretq_u32_u8( result ) );
+		}
+	}
+#endif
+
+	for( ; i < count; ++i )
+	{
+		const uint32_t target = pixels[ i ];
+		uint32_t result = 0u;
+		for( uint32_t shift = 0u; shift < 32u; shift += 8u )
+		{
+			const uint32_t channel = imappRendererDiv255( (((color >> shift) & 0xffu) * alpha) + (((target >> shift) & 0xffu) * inverseAlpha) );
+			result |= channel << shift;
+		}
+		pixels[ i ] = result;
+	}
+}
+
+static uint32_t imappRendererBlendPixel( uint32_t target, int r, int g, int b, int a, bool alphaBlend )
+{
+	r = IMUI_MAX( 0, IMUI_MIN( r, 255 ) );
+	g = IMUI_MAX( 0, IMUI_MIN( g, 255 ) );
+	b = IMUI_MAX( 0, IMUI_MIN( b, 255 ) );
+	a = IMUI_MAX( 0, IMUI_MIN( a, 255 ) );
+
+	if( alphaBlend )
+	{
+		const uint32_t alpha		= (uint32_t)a;
+		const uint32_t inverseAlpha	= 0xffu - alpha;
+		r = (int)imappRendererDiv255( ((uint32_t)r * alpha) + (((target >> 16u) & 0xffu) * inverseAlpha) );
+		g = (int)imappRendererDiv255( ((uint32_t)g * alpha) + (((target >> 8u) & 0xffu) * inverseAlpha) );
+		b = (int)imappRendererDiv255( ((uint32_t)b * alpha) + ((target & 0xffu) * inverseAlpha) );
+		a = (int)imappRendererDiv255( (alpha * alpha) + ((target >> 24u) * inverseAlpha) );
+	}
+
+	return ((uint32_t)a << 24u) | ((uint32_t)r << 16u) | ((uint32_t)g << 8u) | (uint32_t)b;
+}
+
+#endif
@@ -0,0 +1,2095 @@
+#include "imapp_renderer.h"
+
+#if IMAPP_ENABLED( IMAPP_RENDERER_VULKAN )
+
+#include "imapp_debug.h"
+#include "imapp_internal.h"
+#include "imapp_platform.h"
+#include "imapp_res_pak.h"
+
+#include <shaderc/shaderc.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#define IMAPP_RENDERER_VULKAN_COLOR_FORMAT		VK_FORMAT_B8G8R8A8_UNORM
+#define IMAPP_RENDERER_VULKAN_MIN_ARENA_SIZE	(64u * 1024u)
+#define IMAPP_RENDERER_VULKAN_MIN_DESCRIPTORS	16u
+
+typedef enum ImAppRendererPipeline
+{
+	ImAppRendererPipeline_Color,
+	ImAppRendererPipeline_Texture,
+	ImAppRendererPipeline_TextureOpaque,
+	ImAppRendererPipeline_Font,
+	ImAppRendererPipeline_FontSdf,
+
+	ImAppRendererPipeline_MAX
+} ImAppRendererPipeline;
+
+typedef struct ImAppRendererVertex
+{
+	float						position[ 2u ];
+	float						uv[ 2u ];
+	uint32_t					color;
+} ImAppRendererVertex;
+
+// Consecutive commands with equal state and contiguous indices, drawn with one call
+typedef struct ImAppRendererBatch
+{
+	ImAppRendererPipeline		pipeline;
+	ImUiDrawTopology			topology;
+	ImAppRendererTexture*		texture;
+	VkRect2D					scissor;
+	uint32_t					firstIndex;
+	uint32_t					indexCount;
+} ImAppRendererBatch;
+
+// Objects the GPU could still use, destroyed once the fence signaled
+typedef struct ImAppRendererRelease
+{
+	VkFence						fence;
+	VkCommandBuffer				commandBuffer;		// from the renderer command pool
+	VkBuffer					buffer;
+	VkDeviceMemory				bufferMemory;
+	VkImageView					imageView;
+	VkImage						image;
+	VkDeviceMemory				imageMemory;
+} ImAppRendererRelease;
+
+struct ImAppRenderer
+{
+	ImUiAllocator*				allocator;
+	ImAppPlatform*				platform;
+	uint32_t					flags;
+
+	uint32						stateGeneration;	// changes when texture content changes
+
+	VkInstance					instance;
+	VkPhysicalDevice			physicalDevice;
+	VkPhysicalDeviceMemoryProperties	memoryProperties;
+	VkDevice					device;
+	uint32_t					queueFamily;
+	VkQueue						queue;
+	bool						hasSwapchain;		// false: all windows render offscreen
+
+	VkCommandPool				commandPool;
+	VkRenderPass				offscreenRenderPass;
+	VkRenderPass				presentRenderPass;	// compatible with the offscreen pass, so pipelines work with both
+	VkDescriptorSetLayout		descriptorSetLayout;
+	VkPipelineLayout			pipelineLayout;
+	VkSampler					samplerClamp;
+	VkSampler					samplerRepeat;
+	VkPipeline					pipelines[ ImAppRendererPipeline_MAX ][ 2u ];	// triangle and line list
+
+	ImAppRendererRelease*		releases;			// staging buffers and destroyed textures of frames in flight
+	uintsize					releaseCapacity;
+	uintsize					releaseCount;
+
+	uint32_t					textureCount;
+	uint64_t					textureBytes[ ImAppRendererFormat_RGBA8 + 1u ];	// by ImAppRendererFormat
+};
+
+struct ImAppRendererTexture
+{
+	VkImage						image;
+	VkDeviceMemory				memory;
+	VkImageView					view;
+
+	uint32						width;
+	uint32						height;
+
+	uint8						flags;
+
+	ImAppRendererFormat			format;
+	uintsize					dataSize;			// counted in the renderer stats, 0 without data
+};
+
+static const struct ImUiVertexElement s_vertexLayout[] = {
+	{ 1u,	ImUiVertexElementType_Float2,	ImUiVertexElementSemantic_PositionScreenSpace },
+	{ 1u,	ImUiVertexElementType_Float2,	ImUiVertexElementSemantic_TextureCoordinate },
+	{ 1u,	ImUiVertexElementType_UInt,		ImUiVertexElementSemantic_ColorABGR },
+};
+
+static const char s_vertexShader[] =
+	"#version 450\n"
+	"layout(push_constant) uniform Constants {\n"
+	"	vec2 Scale;\n"
+	"} constants;\n"
+	"layout(location = 0) in vec2 Position;\n"
+	"layout(location = 1) in vec2 TexCoord;\n"
+	"layout(location = 2) in vec4 Color;\n"
+	"layout(location = 0) out vec2 vtfUV;\n"
+	"layout(location = 1) out vec4 vtfColor;\n"
+	"void main() {\n"
+	"	vtfUV		= TexCoord;\n"
+	"	vtfColor	= Color;\n"
+	"	gl_Position	= vec4((Position * constants.Scale) - vec2(1.0), 0.0, 1.0);\n"
+	"}\n";
+
+// IMAPP_MODE selects the shading: 0 color, 1 texture, 2 font, 3 SDF font
+static const char s_fragmentShader[] =
+	"#version 450\n"
+	"layout(set = 0, binding = 0) uniform sampler2D Texture;\n"
+	"layout(location = 0) in vec2 vtfUV;\n"
+	"layout(location = 1) in vec4 vtfColor;\n"
+	"layout(location = 0) out vec4 fbColor;\n"
+	"float median(vec3 v) {\n"
+	"	return max(min(v.r, v.g), min(max(v.r, v.g), v.b));\n"
+	"}\n"
+	"void main() {\n"
+	"#if IMAPP_MODE == 0\n"
+	"	fbColor = vtfColor;\n"
+	"#elif IMAPP_MODE == 1\n"
+	"	fbColor = vtfColor * texture(Texture, vtfUV);\n"
+	"#elif IMAPP_MODE == 2\n"
+	"	fbColor = vec4(vtfColor.rgb, vtfColor.a * texture(Texture, vtfUV).a);\n"
+	"#else\n"
+	"	vec2 unitRange = vec2(2.0) / vec2(textureSize(Texture, 0));\n"
+	"	vec2 screenTexSize = vec2(1.0) / fwidth(vtfUV);\n"
+	"	float screenPixelRange = max(0.5 * dot(unitRange, screenTexSize), 1.0);\n"
+	"	float charDistance = screenPixelRange * (median(texture(Texture, vtfUV).rgb) - 0.5);\n"
+	"	fbColor = vec4(vtfColor.rgb, vtfColor.a * clamp(charDistance + 0.5, 0.0, 1.0));\n"
+	"#endif\n"
+	"}\n";
+
+static bool		imappRendererCreateInstance( ImAppRenderer* renderer );
+static bool		imappRendererSelectDevice( ImAppRenderer* renderer );
+static bool		imappRendererCreateDevice( ImAppRenderer* renderer );
+static bool		imappRendererCreateRenderPass( ImAppRenderer* renderer, VkRenderPass* outRenderPass, bool present );
+static bool		imappRendererCreatePipelines( ImAppRenderer* renderer );
+static bool		imappRendererCompileShader( ImAppRenderer* renderer, shaderc_compiler_t compiler, VkShaderModule* outModule, shaderc_shader_kind kind, const char* source, uintsize sourceLength, const char* mode );
+static bool		imappRendererFindMemoryType( ImAppRenderer* renderer, uint32_t typeBits, VkMemoryPropertyFlags properties, uint32_t* outTypeIndex );
+static bool		imappRendererCreateBuffer( ImAppRenderer* renderer, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer* outBuffer, VkDeviceMemory* outMemory );
+static bool		imappRendererCreateImage( ImAppRenderer* renderer, uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, VkImage* outImage, VkDeviceMemory* outMemory );
+static bool		imappRendererWindowCreateFrames( ImAppRenderer* renderer, ImAppRendererWindow* window );
+static bool		imappRendererWindowPrepareArena( ImAppRenderer* renderer, ImAppRendererVulkanFrame* frame, VkDeviceSize size );
+static bool		imappRendererWindowPrepareDescriptorPool( ImAppRenderer* renderer, ImAppRendererVulkanFrame* frame, uint32_t setCount );
+static bool		imappRendererWindowCreateSwapchain( ImAppRenderer* renderer, ImAppRendererWindow* window, int width, int height );
+static void		imappRendererWindowDestroySwapchainImages( ImAppRenderer* renderer, ImAppRendererWindow* window );
+static bool		imappRendererWindowCreateOffscreen( ImAppRenderer* renderer, ImAppRendererWindow* window, int width, int height );
+static void		imappRendererWindowDestroyOffscreen( ImAppRenderer* renderer, ImAppRendererWindow* window );
+static bool		imappRendererTextureStageUpload( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, VkRect2D rect, bool isInitialized );
+static bool		imappRendererTextureUpload( ImAppRenderer* renderer, ImAppRendererTexture* texture, VkBuffer stagingBuffer, VkDeviceMemory stagingMemory, VkRect2D rect, bool isInitialized );
+static bool		imappRendererSubmitFence( ImAppRenderer* renderer, VkFence* outFence );
+static void		imappRendererQueueRelease( ImAppRenderer* renderer, ImAppRendererRelease* release );
+static void		imappRendererUpdateReleases( ImAppRenderer* renderer, bool wait );
+static void		imappRendererDestroyRelease( ImAppRenderer* renderer, ImAppRendererRelease* release );
+static void		imappRendererWindowDiscardFrame( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererVulkanFrame* frame, bool hasAcquired );
+static void		imappRendererWindowDrawBatch( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererVulkanFrame* frame, const ImAppRendererBatch* batch, ImAppRendererBatch* boundState );
+
+ImUiVertexFormat imappRendererGetVertexFormat()
+{
+	const ImUiVertexFormat result = { s_vertexLayout, IMAPP_ARRAY_COUNT( s_vertexLayout ) };
+	return result;
+}
+
+ImAppRenderer* imappRendererCreate( ImUiAllocator* allocator, ImAppPlatform* platform, uint32_t flags )
+{
+	IMAPP_ASSERT( platform != NULL );
+
+	ImAppRenderer* renderer = IMUI_MEMORY_NEW_ZERO( allocator, ImAppRenderer );
+	if( renderer == NULL )
+	{
+		return NULL;
+	}
+
+	renderer->allocator	= allocator;
+	renderer->platform	= platform;
+	renderer->flags		= flags;
+
+	if( !imappRendererCreateInstance( renderer ) ||
+		!imappRendererSelectDevice( renderer ) ||
+		!imappRendererCreateDevice( renderer ) )
+	{
+		imappRendererDestroy( renderer );
+		return NULL;
+	}
+
+	return renderer;
+}
+
+void imappRendererDestroy( ImAppRenderer* renderer )
+{
+	imappRendererDestroyResources( renderer );
+	IMUI_MEMORY_ARRAY_FREE( renderer->allocator, renderer->releases, renderer->releaseCapacity );
+
+	if( renderer->device )
+	{
+		vkDestroyDevice( renderer->device, NULL );
+		renderer->device = VK_NULL_HANDLE;
+	}
+
+	if( renderer->instance )
+	{
+		vkDestroyInstance( renderer->instance, NULL );
+		renderer->instance = VK_NULL_HANDLE;
+	}
+
+	ImUiMemoryFree( renderer->allocator, renderer );
+}
+
+static bool imappRendererCreateInstance( ImAppRenderer* renderer )
+{
+	uint32_t extensionCount = 0u;
+	const char* const* extensions = imappPlatformGetVulkanInstanceExtensions( renderer->platform, &extensionCount );
+
+	VkApplicationInfo applicationInfo;
+	memset( &applicationInfo, 0, sizeof( applicationInfo ) );
+	applicationInfo.sType				= VK_STRUCTURE_TYPE_APPLICATION_INFO;
+	applicationInfo.pApplicationName	= "imapp";
+	applicationInfo.pEngineName			= "imapp";
+	applicationInfo.apiVersion			= VK_API_VERSION_1_0;
+
+	VkInstanceCreateInfo createInfo;
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType					= VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+	createInfo.pApplicationInfo			= &applicationInfo;
+	createInfo.enabledExtensionCount	= extensionCount;
+	createInfo.ppEnabledExtensionNames	= extensions;
+
+#if IMAPP_ENABLED( IMAPP_DEBUG )
+	static const char* s_validationLayer = "VK_LAYER_KHRONOS_validation";
+
+	VkLayerProperties layers[ 64u ];
+	uint32_t layerCount = IMAPP_ARRAY_COUNT( layers );
+	vkEnumerateInstanceLayerProperties( &layerCount, layers );
+	for( uint32_t i = 0u; i < layerCount; ++i )
+	{
+		if( strcmp( layers[ i ].layerName, s_validationLayer ) == 0 )
+		{
+			createInfo.enabledLayerCount	= 1u;
+			createInfo.ppEnabledLayerNames	= &s_validationLayer;
+			break;
+		}
+	}
+#endif
+
+	const VkResult result = vkCreateInstance( &createInfo, NULL, &renderer->instance );
+	if( result != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan instance. Result: %d\n", result );
+		return false;
+	}
+
+	renderer->hasSwapchain = extensionCount > 0u;
+	return true;
+}
+
+static bool imappRendererSelectDevice( ImAppRenderer* renderer )
+{
+	VkPhysicalDevice devices[ 16u ];
+	uint32_t deviceCount = IMAPP_ARRAY_COUNT( devices );
+	const VkResult result = vkEnumeratePhysicalDevices( renderer->instance, &deviceCount, devices );
+	if( (result != VK_SUCCESS && result != VK_INCOMPLETE) || deviceCount == 0u )
+	{
+		ImAppTrace( "[renderer] No Vulkan device found.\n" );
+		return false;
+	}
+
+	// hardware first, CPU implementations like lavapipe only when nothing else is there
+	static const VkPhysicalDeviceType s_deviceTypeOrder[] =
+	{
+		VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU,
+		VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU,
+		VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU,
+		VK_PHYSICAL_DEVICE_TYPE_OTHER,
+		VK_PHYSICAL_DEVICE_TYPE_CPU
+	};
+
+	for( uintsize typeIndex = 0u; typeIndex < IMAPP_ARRAY_COUNT( s_deviceTypeOrder ); ++typeIndex )
+	{
+		for( uint32_t i = 0u; i < deviceCount; ++i )
+		{
+			VkPhysicalDeviceProperties properties;
+			vkGetPhysicalDeviceProperties( devices[ i ], &properties );
+			if( properties.deviceType != s_deviceTypeOrder[ typeIndex ] )
+			{
+				continue;
+			}
+
+			VkQueueFamilyProperties queueFamilies[ 16u ];
+			uint32_t queueFamilyCount = IMAPP_ARRAY_COUNT( queueFamilies );
+			vkGetPhysicalDeviceQueueFamilyProperties( devices[ i ], &queueFamilyCount, queueFamilies );
+
+			for( uint32_t j = 0u; j < queueFamilyCount; ++j )
+			{
+				if( (queueFamilies[ j ].queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0u )
+				{
+					continue;
+				}
+
+				renderer->physicalDevice	= devices[ i ];
+				renderer->queueFamily		= j;
+				vkGetPhysicalDeviceMemoryProperties( devices[ i ], &renderer->memoryProperties );
+
+				ImAppTrace( "[renderer] Using Vulkan device '%s'.\n", properties.deviceName );
+				return true;
+			}
+		}
+	}
+
+	ImAppTrace( "[renderer] No Vulkan device with graphics queue found.\n" );
+	return false;
+}
+
+static bool imappRendererCreateDevice( ImAppRenderer* renderer )
+{
+	if( renderer->hasSwapchain )
+	{
+		VkExtensionProperties extensions[ 256u ];
+		uint32_t extensionCount = IMAPP_ARRAY_COUNT( extensions );
+		vkEnumerateDeviceExtensionProperties( renderer->physicalDevice, NULL, &extensionCount, extensions );
+
+		renderer->hasSwapchain = false;
+		for( uint32_t i = 0u; i < extensionCount; ++i )
+		{
+			if( strcmp( extensions[ i ].extensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME ) == 0 )
+			{
+				renderer->hasSwapchain = true;
+				break;
+			}
+		}
+
+		if( !renderer->hasSwapchain )
+		{
+			ImAppTrace( "[renderer] Vulkan device can't present. Rendering offscreen.\n" );
+		}
+	}
+
+	const float queuePriority = 1.0f;
+	VkDeviceQueueCreateInfo queueCreateInfo;
+	memset( &queueCreateInfo, 0, sizeof( queueCreateInfo ) );
+	queueCreateInfo.sType				= VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+	queueCreateInfo.queueFamilyIndex	= renderer->queueFamily;
+	queueCreateInfo.queueCount			= 1u;
+	queueCreateInfo.pQueuePriorities	= &queuePriority;
+
+	const char* swapchainExtension = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+
+	VkDeviceCreateInfo createInfo;
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType					= VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	createInfo.queueCreateInfoCount		= 1u;
+	createInfo.pQueueCreateInfos		= &queueCreateInfo;
+	createInfo.enabledExtensionCount	= renderer->hasSwapchain ? 1u : 0u;
+	createInfo.ppEnabledExtensionNames	= &swapchainExtension;
+
+	const VkResult result = vkCreateDevice( renderer->physicalDevice, &createInfo, NULL, &renderer->device );
+	if( result != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan device. Result: %d\n", result );
+		return false;
+	}
+
+	vkGetDeviceQueue( renderer->device, renderer->queueFamily, 0u, &renderer->queue );
+	return true;
+}
+
+void imappRendererUpdate( ImAppRenderer* renderer )
+{
+	imappRendererUpdateReleases( renderer, false );
+}
+
+void imappRendererSetUploadBudget( ImAppRenderer* renderer, uint32_t budget, float budgetMs )
+{
+	// textures are copied right away through a staging buffer, released when the copy finished
+	IMAPP_USE( renderer );
+	IMAPP_USE( budget );
+	IMAPP_USE( budgetMs );
+}
+
+bool imappRendererHasPendingUploads( const ImAppRenderer* renderer )
+{
+	IMAPP_USE( renderer );
+
+	return false;
+}
+
+void imappRendererGetTextureStats( const ImAppRenderer* renderer, ImAppRendererStats* stats )
+{
+	stats->textureCount			= renderer->textureCount;
+	stats->textureBytesR8		= renderer->textureBytes[ ImAppRendererFormat_R8 ];
+	stats->textureBytesRgb8		= renderer->textureBytes[ ImAppRendererFormat_RGB8 ];
+	stats->textureBytesRgba8	= renderer->textureBytes[ ImAppRendererFormat_RGBA8 ];
+}
+
+bool imappRendererCreateResources( ImAppRenderer* renderer )
+{
+	VkCommandPoolCreateInfo poolCreateInfo;
+	memset( &poolCreateInfo, 0, sizeof( poolCreateInfo ) );
+	poolCreateInfo.sType			= VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolCreateInfo.flags			= VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	poolCreateInfo.queueFamilyIndex	= renderer->queueFamily;
+	if( vkCreateCommandPool( renderer->device, &poolCreateInfo, NULL, &renderer->commandPool ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan command pool.\n" );
+		return false;
+	}
+
+	if( !imappRendererCreateRenderPass( renderer, &renderer->offscreenRenderPass, false ) ||
+		!imappRendererCreateRenderPass( renderer, &renderer->presentRenderPass, true ) )
+	{
+		return false;
+	}
+
+	VkDescriptorSetLayoutBinding binding;
+	memset( &binding, 0, sizeof( binding ) );
+	binding.binding			= 0u;
+	binding.descriptorType	= VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	binding.descriptorCount	= 1u;
+	binding.stageFlags		= VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	VkDescriptorSetLayoutCreateInfo setLayoutCreateInfo;
+	memset( &setLayoutCreateInfo, 0, sizeof( setLayoutCreateInfo ) );
+	setLayoutCreateInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	setLayoutCreateInfo.bindingCount	= 1u;
+	setLayoutCreateInfo.pBindings		= &binding;
+	if( vkCreateDescriptorSetLayout( renderer->device, &setLayoutCreateInfo, NULL, &renderer->descriptorSetLayout ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan descriptor set layout.\n" );
+		return false;
+	}
+
+	VkPushConstantRange pushConstantRange;
+	pushConstantRange.stageFlags	= VK_SHADER_STAGE_VERTEX_BIT;
+	pushConstantRange.offset		= 0u;
+	pushConstantRange.size			= sizeof( float ) * 2u;
+
+	VkPipelineLayoutCreateInfo layoutCreateInfo;
+	memset( &layoutCreateInfo, 0, sizeof( layoutCreateInfo ) );
+	layoutCreateInfo.sType					= VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	layoutCreateInfo.setLayoutCount			= 1u;
+	layoutCreateInfo.pSetLayouts			= &renderer->descriptorSetLayout;
+	layoutCreateInfo.pushConstantRangeCount	= 1u;
+	layoutCreateInfo.pPushConstantRanges	= &pushConstantRange;
+	if( vkCreatePipelineLayout( renderer->device, &layoutCreateInfo, NULL, &renderer->pipelineLayout ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan pipeline layout.\n" );
+		return false;
+	}
+
+	for( uintsize i = 0u; i < 2u; ++i )
+	{
+		const VkSamplerAddressMode addressMode = i == 0u ? VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE : VK_SAMPLER_ADDRESS_MODE_REPEAT;
+
+		VkSamplerCreateInfo samplerCreateInfo;
+		memset( &samplerCreateInfo, 0, sizeof( samplerCreateInfo ) );
+		samplerCreateInfo.sType			= VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerCreateInfo.magFilter		= VK_FILTER_LINEAR;
+		samplerCreateInfo.minFilter		= VK_FILTER_LINEAR;
+		samplerCreateInfo.mipmapMode	= VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerCreateInfo.addressModeU	= addressMode;
+		samplerCreateInfo.addressModeV	= addressMode;
+		samplerCreateInfo.addressModeW	= addressMode;
+		samplerCreateInfo.maxLod		= 0.0f;
+
+		VkSampler* sampler = i == 0u ? &renderer->samplerClamp : &renderer->samplerRepeat;
+		if( vkCreateSampler( renderer->device, &samplerCreateInfo, NULL, sampler ) != VK_SUCCESS )
+		{
+			ImAppTrace( "[renderer] Failed to create Vulkan sampler.\n" );
+			return false;
+		}
+	}
+
+	return imappRendererCreatePipelines( renderer );
+}
+
+void imappRendererDestroyResources( ImAppRenderer* renderer )
+{
+	if( renderer->device == VK_NULL_HANDLE )
+	{
+		return;
+	}
+
+	vkDeviceWaitIdle( renderer->device );
+	imappRendererUpdateReleases( renderer, true );
+
+	for( uintsize i = 0u; i < ImAppRendererPipeline_MAX; ++i )
+	{
+		for( uintsize j = 0u; j < 2u; ++j )
+		{
+			vkDestroyPipeline( renderer->device, renderer->pipelines[ i ][ j ], NULL );
+			renderer->pipelines[ i ][ j ] = VK_NULL_HANDLE;
+		}
+	}
+
+	vkDestroySampler( renderer->device, renderer->samplerRepeat, NULL );
+	vkDestroySampler( renderer->device, renderer->samplerClamp, NULL );
+	vkDestroyPipelineLayout( renderer->device, renderer->pipelineLayout, NULL );
+	vkDestroyDescriptorSetLayout( renderer->device, renderer->descriptorSetLayout, NULL );
+	vkDestroyRenderPass( renderer->device, renderer->presentRenderPass, NULL );
+	vkDestroyRenderPass( renderer->device, renderer->offscreenRenderPass, NULL );
+	vkDestroyCommandPool( renderer->device, renderer->commandPool, NULL );
+
+	renderer->samplerRepeat			= VK_NULL_HANDLE;
+	renderer->samplerClamp			= VK_NULL_HANDLE;
+	renderer->pipelineLayout		= VK_NULL_HANDLE;
+	renderer->descriptorSetLayout	= VK_NULL_HANDLE;
+	renderer->presentRenderPass		= VK_NULL_HANDLE;
+	renderer->offscreenRenderPass	= VK_NULL_HANDLE;
+	renderer->commandPool			= VK_NULL_HANDLE;
+}
+
+static bool imappRendererCreateRenderPass( ImAppRenderer* renderer, VkRenderPass* outRenderPass, bool present )
+{
+	VkAttachmentDescription attachment;
+	memset( &attachment, 0, sizeof( attachment ) );
+	attachment.format			= IMAPP_RENDERER_VULKAN_COLOR_FORMAT;
+	attachment.samples			= VK_SAMPLE_COUNT_1_BIT;
+	attachment.loadOp			= VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachment.storeOp			= VK_ATTACHMENT_STORE_OP_STORE;
+	attachment.stencilLoadOp	= VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachment.stencilStoreOp	= VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachment.initialLayout	= VK_IMAGE_LAYOUT_UNDEFINED;
+	attachment.finalLayout		= present ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+	VkAttachmentReference colorReference;
+	colorReference.attachment	= 0u;
+	colorReference.layout		= VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+	VkSubpassDescription subpass;
+	memset( &subpass, 0, sizeof( subpass ) );
+	subpass.pipelineBindPoint		= VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass.colorAttachmentCount	= 1u;
+	subpass.pColorAttachments		= &colorReference;
+
+	// wait for the acquire semaphore or the readback of the last frame, then for the readback copy of this one
+	VkSubpassDependency dependencies[ 2u ];
+	memset( dependencies, 0, sizeof( dependencies ) );
+	dependencies[ 0u ].srcSubpass		= VK_SUBPASS_EXTERNAL;
+	dependencies[ 0u ].dstSubpass		= 0u;
+	dependencies[ 0u ].srcStageMask		= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependencies[ 0u ].dstStageMask		= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[ 0u ].dstAccessMask	= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[ 1u ].srcSubpass		= 0u;
+	dependencies[ 1u ].dstSubpass		= VK_SUBPASS_EXTERNAL;
+	dependencies[ 1u ].srcStageMask		= VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[ 1u ].dstStageMask		= present ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT;
+	dependencies[ 1u ].srcAccessMask	= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[ 1u ].dstAccessMask	= present ? 0u : VK_ACCESS_TRANSFER_READ_BIT;
+
+	VkRenderPassCreateInfo createInfo;
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType			= VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	createInfo.attachmentCount	= 1u;
+	createInfo.pAttachments		= &attachment;
+	createInfo.subpassCount		= 1u;
+	createInfo.pSubpasses		= &subpass;
+	createInfo.dependencyCount	= IMAPP_ARRAY_COUNT( dependencies );
+	createInfo.pDependencies	= dependencies;
+
+	if( vkCreateRenderPass( renderer->device, &createInfo, NULL, outRenderPass ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan render pass.\n" );
+		return false;
+	}
+
+	return true;
+}
+
+static bool imappRendererCreatePipelines( ImAppRenderer* renderer )
+{
+	shaderc_compiler_t compiler = shaderc_compiler_initialize();
+	if( compiler == NULL )
+	{
+		ImAppTrace( "[renderer] Failed to initialize shader compiler.\n" );
+		return false;
+	}
+
+	static const char* s_fragmentModes[] = { "0", "1", "2", "3" };
+
+	VkShaderModule vertexModule = VK_NULL_HANDLE;
+	VkShaderModule fragmentModules[ IMAPP_ARRAY_COUNT( s_fragmentModes ) ];
+	memset( fragmentModules, 0, sizeof( fragmentModules ) );
+
+	bool result = imappRendererCompileShader( renderer, compiler, &vertexModule, shaderc_vertex_shader, s_vertexShader, sizeof( s_vertexShader ) - 1u, NULL );
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( s_fragmentModes ) && result; ++i )
+	{
+		result = imappRendererCompileShader( renderer, compiler, &fragmentModules[ i ], shaderc_fragment_shader, s_fragmentShader, sizeof( s_fragmentShader ) - 1u, s_fragmentModes[ i ] );
+	}
+
+	shaderc_compiler_release( compiler );
+
+	VkPipelineShaderStageCreateInfo stages[ 2u ];
+	memset( stages, 0, sizeof( stages ) );
+	stages[ 0u ].sType	= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stages[ 0u ].stage	= VK_SHADER_STAGE_VERTEX_BIT;
+	stages[ 0u ].module	= vertexModule;
+	stages[ 0u ].pName	= "main";
+	stages[ 1u ].sType	= VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	stages[ 1u ].stage	= VK_SHADER_STAGE_FRAGMENT_BIT;
+	stages[ 1u ].pName	= "main";
+
+	VkVertexInputBindingDescription vertexBinding;
+	vertexBinding.binding	= 0u;
+	vertexBinding.stride	= sizeof( ImAppRendererVertex );
+	vertexBinding.inputRate	= VK_VERTEX_INPUT_RATE_VERTEX;
+
+	VkVertexInputAttributeDescription vertexAttributes[ 3u ];
+	vertexAttributes[ 0u ].location	= 0u;
+	vertexAttributes[ 0u ].binding	= 0u;
+	vertexAttributes[ 0u ].format	= VK_FORMAT_R32G32_SFLOAT;
+	vertexAttributes[ 0u ].offset	= offsetof( ImAppRendererVertex, position );
+	vertexAttributes[ 1u ].location	= 1u;
+	vertexAttributes[ 1u ].binding	= 0u;
+	vertexAttributes[ 1u ].format	= VK_FORMAT_R32G32_SFLOAT;
+	vertexAttributes[ 1u ].offset	= offsetof( ImAppRendererVertex, uv );
+	vertexAttributes[ 2u ].location	= 2u;
+	vertexAttributes[ 2u ].binding	= 0u;
+	vertexAttributes[ 2u ].format	= VK_FORMAT_R8G8B8A8_UNORM;
+	vertexAttributes[ 2u ].offset	= offsetof( ImAppRendererVertex, color );
+
+	VkPipelineVertexInputStateCreateInfo vertexInputState;
+	memset( &vertexInputState, 0, sizeof( vertexInputState ) );
+	vertexInputState.sType								= VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+	vertexInputState.vertexBindingDescriptionCount		= 1u;
+	vertexInputState.pVertexBindingDescriptions			= &vertexBinding;
+	vertexInputState.vertexAttributeDescriptionCount	= IMAPP_ARRAY_COUNT( vertexAttributes );
+	vertexInputState.pVertexAttributeDescriptions		= vertexAttributes;
+
+	VkPipelineInputAssemblyStateCreateInfo inputAssemblyState;
+	memset( &inputAssemblyState, 0, sizeof( inputAssemblyState ) );
+	inputAssemblyState.sType	= VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+
+	VkPipelineViewportStateCreateInfo viewportState;
+	memset( &viewportState, 0, sizeof( viewportState ) );
+	viewportState.sType			= VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+	viewportState.viewportCount	= 1u;
+	viewportState.scissorCount	= 1u;
+
+	VkPipelineRasterizationStateCreateInfo rasterizationState;
+	memset( &rasterizationState, 0, sizeof( rasterizationState ) );
+	rasterizationState.sType		= VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+	rasterizationState.polygonMode	= VK_POLYGON_MODE_FILL;
+	rasterizationState.cullMode		= VK_CULL_MODE_NONE;
+	rasterizationState.frontFace	= VK_FRONT_FACE_COUNTER_CLOCKWISE;
+	rasterizationState.lineWidth	= 1.0f;
+
+	VkPipelineMultisampleStateCreateInfo multisampleState;
+	memset( &multisampleState, 0, sizeof( multisampleState ) );
+	multisampleState.sType					= VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+	multisampleState.rasterizationSamples	= VK_SAMPLE_COUNT_1_BIT;
+
+	VkPipelineColorBlendAttachmentState blendAttachment;
+	memset( &blendAttachment, 0, sizeof( blendAttachment ) );
+	blendAttachment.srcColorBlendFactor	= VK_BLEND_FACTOR_SRC_ALPHA;
+	blendAttachment.dstColorBlendFactor	= VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	blendAttachment.colorBlendOp		= VK_BLEND_OP_ADD;
+	blendAttachment.srcAlphaBlendFactor	= VK_BLEND_FACTOR_SRC_ALPHA;
+	blendAttachment.dstAlphaBlendFactor	= VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+	blendAttachment.alphaBlendOp		= VK_BLEND_OP_ADD;
+	blendAttachment.colorWriteMask		= VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+	VkPipelineColorBlendStateCreateInfo blendState;
+	memset( &blendState, 0, sizeof( blendState ) );
+	blendState.sType			= VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+	blendState.attachmentCount	= 1u;
+	blendState.pAttachments		= &blendAttachment;
+
+	const VkDynamicState dynamicStates[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+	VkPipelineDynamicStateCreateInfo dynamicState;
+	memset( &dynamicState, 0, sizeof( dynamicState ) );
+	dynamicState.sType				= VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+	dynamicState.dynamicStateCount	= IMAPP_ARRAY_COUNT( dynamicStates );
+	dynamicState.pDynamicStates		= dynamicStates;
+
+	VkGraphicsPipelineCreateInfo createInfo;
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType				= VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+	createInfo.stageCount			= IMAPP_ARRAY_COUNT( stages );
+	createInfo.pStages				= stages;
+	createInfo.pVertexInputState	= &vertexInputState;
+	createInfo.pInputAssemblyState	= &inputAssemblyState;
+	createInfo.pViewportState		= &viewportState;
+	createInfo.pRasterizationState	= &rasterizationState;
+	createInfo.pMultisampleState	= &multisampleState;
+	createInfo.pColorBlendState		= &blendState;
+	createInfo.pDynamicState		= &dynamicState;
+	createInfo.layout				= renderer->pipelineLayout;
+	createInfo.renderPass			= renderer->offscreenRenderPass;
+
+	// every state combination up front, drawing never creates pipelines
+	static const uintsize s_pipelineModes[ ImAppRendererPipeline_MAX ] = { 0u, 1u, 1u, 2u, 3u };
+	for( uintsize i = 0u; i < ImAppRendererPipeline_MAX && result; ++i )
+	{
+		stages[ 1u ].module				= fragmentModules[ s_pipelineModes[ i ] ];
+		blendAttachment.blendEnable		= i == ImAppRendererPipeline_TextureOpaque ? VK_FALSE : VK_TRUE;
+
+		for( uintsize j = 0u; j < 2u && result; ++j )
+		{
+			inputAssemblyState.topology = j == 0u ? VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST : VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+
+			if( vkCreateGraphicsPipelines( renderer->device, VK_NULL_HANDLE, 1u, &createInfo, NULL, &renderer->pipelines[ i ][ j ] ) != VK_SUCCESS )
+			{
+				ImAppTrace( "[renderer] Failed to create Vulkan pipeline.\n" );
+				result = false;
+			}
+		}
+	}
+
+	vkDestroyShaderModule( renderer->device, vertexModule, NULL );
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( fragmentModules ); ++i )
+	{
+		vkDestroyShaderModule( renderer->device, fragmentModules[ i ], NULL );
+	}
+
+	return result;
+}
+
+static bool imappRendererCompileShader( ImAppRenderer* renderer, shaderc_compiler_t compiler, VkShaderModule* outModule, shaderc_shader_kind kind, const char* source, uintsize sourceLength, const char* mode )
+{
+	shaderc_compile_options_t options = shaderc_compile_options_initialize();
+	if( mode )
+	{
+		shaderc_compile_options_add_macro_definition( options, "IMAPP_MODE", 10u, mode, strlen( mode ) );
+	}
+	shaderc_compile_options_set_optimization_level( options, shaderc_optimization_level_performance );
+
+	shaderc_compilation_result_t compileResult = shaderc_compile_into_spv( compiler, source, sourceLength, kind, "imapp", "main", options );
+	shaderc_compile_options_release( options );
+
+	if( shaderc_result_get_compilation_status( compileResult ) != shaderc_compilation_status_success )
+	{
+		ImAppTrace( "[renderer] Failed to compile Shader.\n" );
+		ImAppTrace( "%s\n", shaderc_result_get_error_message( compileResult ) );
+		shaderc_result_release( compileResult );
+		return false;
+	}
+
+	VkShaderModuleCreateInfo createInfo;
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType	= VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+	createInfo.codeSize	= shaderc_result_get_length( compileResult );
+	createInfo.pCode	= (const uint32_t*)shaderc_result_get_bytes( compileResult );
+
+	const VkResult result = vkCreateShaderModule( renderer->device, &createInfo, NULL, outModule );
+	shaderc_result_release( compileResult );
+
+	if( result != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan shader module.\n" );
+		return false;
+	}
+
+	return true;
+}
+
+static bool imappRendererFindMemoryType( ImAppRenderer* renderer, uint32_t typeBits, VkMemoryPropertyFlags properties, uint32_t* outTypeIndex )
+{
+	const VkPhysicalDeviceMemoryProperties* memoryProperties = &renderer->memoryProperties;
+	for( uint32_t i = 0u; i < memoryProperties->memoryTypeCount; ++i )
+	{
+		if( (typeBits & (1u << i)) != 0u &&
+			(memoryProperties->memoryTypes[ i ].propertyFlags & properties) == properties )
+		{
+			*outTypeIndex = i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static bool imappRendererCreateBuffer( ImAppRenderer* renderer, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer* outBuffer, VkDeviceMemory* outMemory )
+{
+	VkBufferCreateInfo createInfo;
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType		= VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+	createInfo.size			= size;
+	createInfo.usage		= usage;
+	createInfo.sharingMode	= VK_SHARING_MODE_EXCLUSIVE;
+	if( vkCreateBuffer( renderer->device, &createInfo, NULL, outBuffer ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan buffer.\n" );
+		return false;
+	}
+
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements( renderer->device, *outBuffer, &requirements );
+
+	VkMemoryAllocateInfo allocateInfo;
+	memset( &allocateInfo, 0, sizeof( allocateInfo ) );
+	allocateInfo.sType				= VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize		= requirements.size;
+	if( !imappRendererFindMemoryType( renderer, requirements.memoryTypeBits, properties, &allocateInfo.memoryTypeIndex ) ||
+		vkAllocateMemory( renderer->device, &allocateInfo, NULL, outMemory ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to allocate Vulkan buffer memory.\n" );
+		vkDestroyBuffer( renderer->device, *outBuffer, NULL );
+		*outBuffer = VK_NULL_HANDLE;
+		return false;
+	}
+
+	vkBindBufferMemory( renderer->device, *outBuffer, *outMemory, 0u );
+	return true;
+}
+
+static bool imappRendererCreateImage( ImAppRenderer* renderer, uint32_t width, uint32_t height, VkFormat format, VkImageUsageFlags usage, VkImage* outImage, VkDeviceMemory* outMemory )
+{
+	VkImageCreateInfo createInfo;
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType			= VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	createInfo.imageType		= VK_IMAGE_TYPE_2D;
+	createInfo.format			= format;
+	createInfo.extent.width		= width;
+	createInfo.extent.height	= height;
+	createInfo.extent.depth		= 1u;
+	createInfo.mipLevels		= 1u;
+	createInfo.arrayLayers		= 1u;
+	createInfo.samples			= VK_SAMPLE_COUNT_1_BIT;
+	createInfo.tiling			= VK_IMAGE_TILING_OPTIMAL;
+	createInfo.usage			= usage;
+	createInfo.sharingMode		= VK_SHARING_MODE_EXCLUSIVE;
+	createInfo.initialLayout	= VK_IMAGE_LAYOUT_UNDEFINED;
+	if( vkCreateImage( renderer->device, &createInfo, NULL, outImage ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan image.\n" );
+		return false;
+	}
+
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements( renderer->device, *outImage, &requirements );
+
+	VkMemoryAllocateInfo allocateInfo;
+	memset( &allocateInfo, 0, sizeof( allocateInfo ) );
+	allocateInfo.sType				= VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize		= requirements.size;
+	if( !imappRendererFindMemoryType( renderer, requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, &allocateInfo.memoryTypeIndex ) ||
+		vkAllocateMemory( renderer->device, &allocateInfo, NULL, outMemory ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to allocate Vulkan image memory.\n" );
+		vkDestroyImage( renderer->device, *outImage, NULL );
+		*outImage = VK_NULL_HANDLE;
+		return false;
+	}
+
+	vkBindImageMemory( renderer->device, *outImage, *outMemory, 0u );
+	return true;
+}
+
+void imappRendererConstructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppWindow* platformWindow )
+{
+	memset( window, 0, sizeof( *window ) );
+	window->platformWindow = platformWindow;
+
+	if( renderer->hasSwapchain &&
+		imappPlatformWindowCreateVulkanSurface( platformWindow, renderer->instance, &window->surface ) )
+	{
+		VkBool32 isSupported = VK_FALSE;
+		vkGetPhysicalDeviceSurfaceSupportKHR( renderer->physicalDevice, renderer->queueFamily, window->surface, &isSupported );
+		if( !isSupported )
+		{
+			ImAppTrace( "[renderer] Queue can't present to window. Rendering offscreen.\n" );
+			vkDestroySurfaceKHR( renderer->instance, window->surface, NULL );
+			window->surface = VK_NULL_HANDLE;
+		}
+	}
+
+	imappRendererWindowCreateFrames( renderer, window );
+}
+
+void imappRendererDestructWindow( ImAppRenderer* renderer, ImAppRendererWindow* window )
+{
+	vkDeviceWaitIdle( renderer->device );
+
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( window->frames ); ++i )
+	{
+		ImAppRendererVulkanFrame* frame = &window->frames[ i ];
+
+		if( frame->arenaBuffer )
+		{
+			vkDestroyBuffer( renderer->device, frame->arenaBuffer, NULL );
+			vkFreeMemory( renderer->device, frame->arenaMemory, NULL );
+		}
+
+		vkDestroyDescriptorPool( renderer->device, frame->descriptorPool, NULL );
+		vkDestroySemaphore( renderer->device, frame->acquireSemaphore, NULL );
+		vkDestroyFence( renderer->device, frame->fence, NULL );
+		if( frame->commandBuffer )
+		{
+			vkFreeCommandBuffers( renderer->device, renderer->commandPool, 1u, &frame->commandBuffer );
+		}
+	}
+
+	imappRendererWindowDestroySwapchainImages( renderer, window );
+	vkDestroySwapchainKHR( renderer->device, window->swapchain, NULL );
+	imappRendererWindowDestroyOffscreen( renderer, window );
+
+	if( window->surface )
+	{
+		vkDestroySurfaceKHR( renderer->instance, window->surface, NULL );
+	}
+
+	memset( window, 0, sizeof( *window ) );
+}
+
+static bool imappRendererWindowCreateFrames( ImAppRenderer* renderer, ImAppRendererWindow* window )
+{
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( window->frames ); ++i )
+	{
+		ImAppRendererVulkanFrame* frame = &window->frames[ i ];
+
+		VkCommandBufferAllocateInfo allocateInfo;
+		memset( &allocateInfo, 0, sizeof( allocateInfo ) );
+		allocateInfo.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.commandPool		= renderer->commandPool;
+		allocateInfo.level				= VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocateInfo.commandBufferCount	= 1u;
+
+		// signaled, so the first wait returns immediately
+		VkFenceCreateInfo fenceCreateInfo;
+		memset( &fenceCreateInfo, 0, sizeof( fenceCreateInfo ) );
+		fenceCreateInfo.sType	= VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceCreateInfo.flags	= VK_FENCE_CREATE_SIGNALED_BIT;
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo;
+		memset( &semaphoreCreateInfo, 0, sizeof( semaphoreCreateInfo ) );
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		if( vkAllocateCommandBuffers( renderer->device, &allocateInfo, &frame->commandBuffer ) != VK_SUCCESS ||
+			vkCreateFence( renderer->device, &fenceCreateInfo, NULL, &frame->fence ) != VK_SUCCESS ||
+			vkCreateSemaphore( renderer->device, &semaphoreCreateInfo, NULL, &frame->acquireSemaphore ) != VK_SUCCESS )
+		{
+			ImAppTrace( "[renderer] Failed to create Vulkan frame objects.\n" );
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static bool imappRendererWindowPrepareArena( ImAppRenderer* renderer, ImAppRendererVulkanFrame* frame, VkDeviceSize size )
+{
+	if( size <= frame->arenaSize )
+	{
+		return true;
+	}
+
+	// the frame fence is signaled, nothing uses the old arena anymore
+	if( frame->arenaBuffer )
+	{
+		vkDestroyBuffer( renderer->device, frame->arenaBuffer, NULL );
+		vkFreeMemory( renderer->device, frame->arenaMemory, NULL );
+		frame->arenaBuffer	= VK_NULL_HANDLE;
+		frame->arenaMemory	= VK_NULL_HANDLE;
+		frame->arenaData	= NULL;
+		frame->arenaSize	= 0u;
+	}
+
+	const VkDeviceSize arenaSize = (VkDeviceSize)IMUI_NEXT_POWER_OF_TWO( IMUI_MAX( (uintsize)size, IMAPP_RENDERER_VULKAN_MIN_ARENA_SIZE ) );
+	if( !imappRendererCreateBuffer( renderer, arenaSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &frame->arenaBuffer, &frame->arenaMemory ) )
+	{
+		return false;
+	}
+
+	if( vkMapMemory( renderer->device, frame->arenaMemory, 0u, arenaSize, 0u, &frame->arenaData ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to map Vulkan arena.\n" );
+		vkDestroyBuffer( renderer->device, frame->arenaBuffer, NULL );
+		vkFreeMemory( renderer->device, frame->arenaMemory, NULL );
+		frame->arenaBuffer	= VK_NULL_HANDLE;
+		frame->arenaMemory	= VK_NULL_HANDLE;
+		return false;
+	}
+
+	frame->arenaSize = arenaSize;
+	return true;
+}
+
+static bool imappRendererWindowPrepareDescriptorPool( ImAppRenderer* renderer, ImAppRendererVulkanFrame* frame, uint32_t setCount )
+{
+	if( frame->descriptorPool && setCount <= frame->descriptorPoolSize )
+	{
+		vkResetDescriptorPool( renderer->device, frame->descriptorPool, 0u );
+		return true;
+	}
+
+	vkDestroyDescriptorPool( renderer->device, frame->descriptorPool, NULL );
+	frame->descriptorPool		= VK_NULL_HANDLE;
+	frame->descriptorPoolSize	= 0u;
+
+	const uint32_t poolSize = IMUI_NEXT_POWER_OF_TWO( IMUI_MAX( setCount, IMAPP_RENDERER_VULKAN_MIN_DESCRIPTORS ) );
+
+	VkDescriptorPoolSize descriptorSize;
+	descriptorSize.type				= VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorSize.descriptorCount	= poolSize;
+
+	VkDescriptorPoolCreateInfo createInfo;
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType			= VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	createInfo.maxSets			= poolSize;
+	createInfo.poolSizeCount	= 1u;
+	createInfo.pPoolSizes		= &descriptorSize;
+	if( vkCreateDescriptorPool( renderer->device, &createInfo, NULL, &frame->descriptorPool ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan descriptor pool.\n" );
+		return false;
+	}
+
+	frame->descriptorPoolSize = poolSize;
+	return true;
+}
+
+static bool imappRendererWindowCreateSwapchain( ImAppRenderer* renderer, ImAppRendererWindow* window, int width, int height )
+{
+	vkDeviceWaitIdle( renderer->device );
+	imappRendererWindowDestroySwapchainImages( renderer, window );
+
+	VkSurfaceCapabilitiesKHR capabilities;
+	if( vkGetPhysicalDeviceSurfaceCapabilitiesKHR( renderer->physicalDevice, window->surface, &capabilities ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to get Vulkan surface capabilities.\n" );
+		return false;
+	}
+
+	VkExtent2D extent = capabilities.currentExtent;
+	if( extent.width == UINT32_MAX )
+	{
+		extent.width	= IMUI_MAX( capabilities.minImageExtent.width, IMUI_MIN( (uint32_t)width, capabilities.maxImageExtent.width ) );
+		extent.height	= IMUI_MAX( capabilities.minImageExtent.height, IMUI_MIN( (uint32_t)height, capabilities.maxImageExtent.height ) );
+	}
+
+	if( extent.width == 0u || extent.height == 0u )
+	{
+		// minimized
+		return false;
+	}
+
+	uint32_t imageCount = capabilities.minImageCount + 1u;
+	if( capabilities.maxImageCount > 0u )
+	{
+		imageCount = IMUI_MIN( imageCount, capabilities.maxImageCount );
+	}
+
+	VkCompositeAlphaFlagBitsKHR compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+	if( (capabilities.supportedCompositeAlpha & compositeAlpha) == 0u )
+	{
+		compositeAlpha = (VkCompositeAlphaFlagBitsKHR)(capabilities.supportedCompositeAlpha & ~(capabilities.supportedCompositeAlpha - 1u));
+	}
+
+	VkSwapchainKHR oldSwapchain = window->swapchain;
+
+	VkSwapchainCreateInfoKHR createInfo;
+	memset( &createInfo, 0, sizeof( createInfo ) );
+	createInfo.sType			= VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+	createInfo.surface			= window->surface;
+	createInfo.minImageCount	= imageCount;
+	createInfo.imageFormat		= IMAPP_RENDERER_VULKAN_COLOR_FORMAT;
+	createInfo.imageColorSpace	= VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+	createInfo.imageExtent		= extent;
+	createInfo.imageArrayLayers	= 1u;
+	createInfo.imageUsage		= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	createInfo.imageSharingMode	= VK_SHARING_MODE_EXCLUSIVE;
+	createInfo.preTransform		= capabilities.currentTransform;
+	createInfo.compositeAlpha	= compositeAlpha;
+	createInfo.presentMode		= VK_PRESENT_MODE_FIFO_KHR;
+	createInfo.clipped			= VK_TRUE;
+	createInfo.oldSwapchain		= oldSwapchain;
+
+	const VkResult result = vkCreateSwapchainKHR( renderer->device, &createInfo, NULL, &window->swapchain );
+	vkDestroySwapchainKHR( renderer->device, oldSwapchain, NULL );
+	if( result != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan swapchain. Result: %d\n", result );
+		window->swapchain = VK_NULL_HANDLE;
+		return false;
+	}
+
+	vkGetSwapchainImagesKHR( renderer->device, window->swapchain, &imageCount, NULL );
+	window->images				= IMUI_MEMORY_ARRAY_NEW_ZERO( renderer->allocator, VkImage, imageCount );
+	window->imageViews			= IMUI_MEMORY_ARRAY_NEW_ZERO( renderer->allocator, VkImageView, imageCount );
+	window->framebuffers		= IMUI_MEMORY_ARRAY_NEW_ZERO( renderer->allocator, VkFramebuffer, imageCount );
+	window->renderSemaphores	= IMUI_MEMORY_ARRAY_NEW_ZERO( renderer->allocator, VkSemaphore, imageCount );
+	if( !window->images || !window->imageViews || !window->framebuffers || !window->renderSemaphores )
+	{
+		imappRendererWindowDestroySwapchainImages( renderer, window );
+		return false;
+	}
+
+	window->imageCount = imageCount;
+	vkGetSwapchainImagesKHR( renderer->device, window->swapchain, &imageCount, window->images );
+
+	for( uint32_t i = 0u; i < imageCount; ++i )
+	{
+		VkImageViewCreateInfo viewCreateInfo;
+		memset( &viewCreateInfo, 0, sizeof( viewCreateInfo ) );
+		viewCreateInfo.sType						= VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewCreateInfo.image						= window->images[ i ];
+		viewCreateInfo.viewType						= VK_IMAGE_VIEW_TYPE_2D;
+		viewCreateInfo.format						= IMAPP_RENDERER_VULKAN_COLOR_FORMAT;
+		viewCreateInfo.subresourceRange.aspectMask	= VK_IMAGE_ASPECT_COLOR_BIT;
+		viewCreateInfo.subresourceRange.levelCount	= 1u;
+		viewCreateInfo.subresourceRange.layerCount	= 1u;
+
+		VkFramebufferCreateInfo framebufferCreateInfo;
+		memset( &framebufferCreateInfo, 0, sizeof( framebufferCreateInfo ) );
+		framebufferCreateInfo.sType				= VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferCreateInfo.renderPass		= renderer->presentRenderPass;
+		framebufferCreateInfo.attachmentCount	= 1u;
+		framebufferCreateInfo.pAttachments		= &window->imageViews[ i ];
+		framebufferCreateInfo.width				= extent.width;
+		framebufferCreateInfo.height			= extent.height;
+		framebufferCreateInfo.layers			= 1u;
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo;
+		memset( &semaphoreCreateInfo, 0, sizeof( semaphoreCreateInfo ) );
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		if( vkCreateImageView( renderer->device, &viewCreateInfo, NULL, &window->imageViews[ i ] ) != VK_SUCCESS ||
+			vkCreateFramebuffer( renderer->device, &framebufferCreateInfo, NULL, &window->framebuffers[ i ] ) != VK_SUCCESS ||
+			vkCreateSemaphore( renderer->device, &semaphoreCreateInfo, NULL, &window->renderSemaphores[ i ] ) != VK_SUCCESS )
+		{
+			ImAppTrace( "[renderer] Failed to create Vulkan swapchain image objects.\n" );
+			return false;
+		}
+	}
+
+	window->extent				= extent;
+	window->width				= width;
+	window->height				= height;
+	window->isSwapchainOutdated	= false;
+	window->hasFrameHash		= false;
+
+	return true;
+}
+
+static void imappRendererWindowDestroySwapchainImages( ImAppRenderer* renderer, ImAppRendererWindow* window )
+{
+	for( uint32_t i = 0u; i < window->imageCount; ++i )
+	{
+		vkDestroySemaphore( renderer->device, window->renderSemaphores[ i ], NULL );
+		vkDestroyFramebuffer( renderer->device, window->framebuffers[ i ], NULL );
+		vkDestroyImageView( renderer->device, window->imageViews[ i ], NULL );
+	}
+
+	IMUI_MEMORY_ARRAY_FREE( renderer->allocator, window->renderSemaphores, window->imageCount );
+	IMUI_MEMORY_ARRAY_FREE( renderer->allocator, window->framebuffers, window->imageCount );
+	IMUI_MEMORY_ARRAY_FREE( renderer->allocator, window->imageViews, window->imageCount );
+	IMUI_MEMORY_ARRAY_FREE( renderer->allocator, window->images, window->imageCount );
+	window->renderSemaphores	= NULL;
+	window->framebuffers		= NULL;
+	window->imageViews			= NULL;
+	window->images				= NULL;
+	window->imageCount			= 0u;
+}
+
+static bool imappRendererWindowCreateOffscreen( ImAppRenderer* renderer, ImAppRendererWindow* window, int width, int height )
+{
+	vkDeviceWaitIdle( renderer->device );
+	imappRendererWindowDestroyOffscreen( renderer, window );
+
+	const VkDeviceSize pixelsSize = (VkDeviceSize)width * (VkDeviceSize)height * sizeof( uint32_t );
+	if( !imappRendererCreateImage( renderer, (uint32_t)width, (uint32_t)height, IMAPP_RENDERER_VULKAN_COLOR_FORMAT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, &window->offscreenImage, &window->offscreenMemory ) ||
+		!imappRendererCreateBuffer( renderer, pixelsSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &window->readbackBuffer, &window->readbackMemory ) )
+	{
+		return false;
+	}
+
+	VkImageViewCreateInfo viewCreateInfo;
+	memset( &viewCreateInfo, 0, sizeof( viewCreateInfo ) );
+	viewCreateInfo.sType						= VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewCreateInfo.image						= window->offscreenImage;
+	viewCreateInfo.viewType						= VK_IMAGE_VIEW_TYPE_2D;
+	viewCreateInfo.format						= IMAPP_RENDERER_VULKAN_COLOR_FORMAT;
+	viewCreateInfo.subresourceRange.aspectMask	= VK_IMAGE_ASPECT_COLOR_BIT;
+	viewCreateInfo.subresourceRange.levelCount	= 1u;
+	viewCreateInfo.subresourceRange.layerCount	= 1u;
+	if( vkCreateImageView( renderer->device, &viewCreateInfo, NULL, &window->offscreenView ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan image view.\n" );
+		return false;
+	}
+
+	VkFramebufferCreateInfo framebufferCreateInfo;
+	memset( &framebufferCreateInfo, 0, sizeof( framebufferCreateInfo ) );
+	framebufferCreateInfo.sType				= VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebufferCreateInfo.renderPass		= renderer->offscreenRenderPass;
+	framebufferCreateInfo.attachmentCount	= 1u;
+	framebufferCreateInfo.pAttachments		= &window->offscreenView;
+	framebufferCreateInfo.width				= (uint32_t)width;
+	framebufferCreateInfo.height			= (uint32_t)height;
+	framebufferCreateInfo.layers			= 1u;
+	if( vkCreateFramebuffer( renderer->device, &framebufferCreateInfo, NULL, &window->offscreenFramebuffer ) != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan framebuffer.\n" );
+		return false;
+	}
+
+	window->pixels = (uint32_t*)ImUiMemoryAlloc( renderer->allocator, (uintsize)pixelsSize );
+	if( window->pixels == NULL )
+	{
+		return false;
+	}
+
+	window->extent.width	= (uint32_t)width;
+	window->extent.height	= (uint32_t)height;
+	window->width			= width;
+	window->height			= height;
+	window->hasFrameHash	= false;
+
+	return true;
+}
+
+static void imappRendererWindowDestroyOffscreen( ImAppRenderer* renderer, ImAppRendererWindow* window )
+{
+	vkDestroyFramebuffer( renderer->device, window->offscreenFramebuffer, NULL );
+	vkDestroyImageView( renderer->device, window->offscreenView, NULL );
+	if( window->offscreenImage )
+	{
+		vkDestroyImage( renderer->device, window->offscreenImage, NULL );
+		vkFreeMemory( renderer->device, window->offscreenMemory, NULL );
+	}
+	if( window->readbackBuffer )
+	{
+		vkDestroyBuffer( renderer->device, window->readbackBuffer, NULL );
+		vkFreeMemory( renderer->device, window->readbackMemory, NULL );
+	}
+	ImUiMemoryFree( renderer->allocator, window->pixels );
+
+	window->offscreenFramebuffer	= VK_NULL_HANDLE;
+	window->offscreenView			= VK_NULL_HANDLE;
+	window->offscreenImage			= VK_NULL_HANDLE;
+	window->offscreenMemory			= VK_NULL_HANDLE;
+	window->readbackBuffer			= VK_NULL_HANDLE;
+	window->readbackMemory			= VK_NULL_HANDLE;
+	window->pixels					= NULL;
+	window->width					= 0;
+	window->height					= 0;
+}
+
+ImAppRendererTexture* imappRendererTextureCreate( ImAppRenderer* renderer )
+{
+	return IMUI_MEMORY_NEW_ZERO( renderer->allocator, ImAppRendererTexture );
+}
+
+ImAppRendererTexture* imappRendererTextureCreateFromMemory( ImAppRenderer* renderer, const void* data, uint32_t width, uint32_t height, ImAppRendererFormat format, uint8_t flags )
+{
+	ImAppRendererTexture* texture = imappRendererTextureCreate( renderer );
+	if( !texture )
+	{
+		return NULL;
+	}
+
+	if( !imappRendererTextureInitializeDataFromMemory( renderer, texture, data, width, height, format, flags ) )
+	{
+		imappRendererTextureDestroy( renderer, texture );
+		return NULL;
+	}
+
+	return texture;
+}
+
+bool imappRendererTextureInitializeDataFromMemory( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t width, uint32_t height, ImAppRendererFormat format, uint8_t flags )
+{
+	if( texture == NULL )
+	{
+		return false;
+	}
+
+	imappRendererTextureDestroyData( renderer, texture );
+
+	texture->width		= width;
+	texture->height		= height;
+	texture->flags		= flags;
+	texture->format		= format;
+
+	// three channel formats are rarely sampleable, RGB8 gets expanded
+	const bool isAlpha				= format == ImAppRendererFormat_R8;
+	const VkFormat imageFormat		= isAlpha ? VK_FORMAT_R8_UNORM : VK_FORMAT_R8G8B8A8_UNORM;
+	const uintsize imageSize		= (uintsize)width * height * (isAlpha ? 1u : 4u);
+
+	VkRect2D rect;
+	memset( &rect, 0, sizeof( rect ) );
+	rect.extent.width	= width;
+	rect.extent.height	= height;
+
+	bool result = imappRendererCreateImage( renderer, width, height, imageFormat, VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, &texture->image, &texture->memory ) &&
+		imappRendererTextureStageUpload( renderer, texture, data, rect, false );
+
+	if( result )
+	{
+		// R8 reads like GL_ALPHA
+		VkImageViewCreateInfo viewCreateInfo;
+		memset( &viewCreateInfo, 0, sizeof( viewCreateInfo ) );
+		viewCreateInfo.sType						= VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewCreateInfo.image						= texture->image;
+		viewCreateInfo.viewType						= VK_IMAGE_VIEW_TYPE_2D;
+		viewCreateInfo.format						= imageFormat;
+		viewCreateInfo.components.r					= isAlpha ? VK_COMPONENT_SWIZZLE_ZERO : VK_COMPONENT_SWIZZLE_IDENTITY;
+		viewCreateInfo.components.g					= isAlpha ? VK_COMPONENT_SWIZZLE_ZERO : VK_COMPONENT_SWIZZLE_IDENTITY;
+		viewCreateInfo.components.b					= isAlpha ? VK_COMPONENT_SWIZZLE_ZERO : VK_COMPONENT_SWIZZLE_IDENTITY;
+		viewCreateInfo.components.a					= isAlpha ? VK_COMPONENT_SWIZZLE_R : VK_COMPONENT_SWIZZLE_IDENTITY;
+		viewCreateInfo.subresourceRange.aspectMask	= VK_IMAGE_ASPECT_COLOR_BIT;
+		viewCreateInfo.subresourceRange.levelCount	= 1u;
+		viewCreateInfo.subresourceRange.layerCount	= 1u;
+
+		result = vkCreateImageView( renderer->device, &viewCreateInfo, NULL, &texture->view ) == VK_SUCCESS;
+	}
+
+	if( !result )
+	{
+		ImAppTrace( "[renderer] Failed to create Vulkan texture.\n" );
+		imappRendererTextureDestroyData( renderer, texture );
+		return false;
+	}
+
+	// frames drawn with the old content are invalid
+	renderer->stateGeneration++;
+
+	texture->dataSize	= imageSize;
+	renderer->textureCount++;
+	renderer->textureBytes[ format ] += texture->dataSize;
+
+	return true;
+}
+
+bool imappRendererTextureUpdateRegion( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, uint32_t x, uint32_t y, uint32_t width, uint32_t height )
+{
+	if( texture->image == VK_NULL_HANDLE ||
+		x + width > texture->width ||
+		y + height > texture->height )
+	{
+		return false;
+	}
+
+	if( width == 0u || height == 0u )
+	{
+		return true;
+	}
+
+	VkRect2D rect;
+	rect.offset.x		= (int32_t)x;
+	rect.offset.y		= (int32_t)y;
+	rect.extent.width	= width;
+	rect.extent.height	= height;
+
+	// frames in flight could still sample it, the barrier of the copy waits for them on the GPU
+	const bool result = imappRendererTextureStageUpload( renderer, texture, data, rect, true );
+
+	// frames drawn with the old content are invalid
+	renderer->stateGeneration++;
+
+	return result;
+}
+
+// Copies data into a new staging buffer, the buffer gets copied to rect of texture.
+static bool imappRendererTextureStageUpload( ImAppRenderer* renderer, ImAppRendererTexture* texture, const void* data, VkRect2D rect, bool isInitialized )
+{
+	const bool isAlpha			= texture->format == ImAppRendererFormat_R8;
+	const uintsize pixelCount	= (uintsize)rect.extent.width * rect.extent.height;
+	const uintsize stagingSize	= pixelCount * (isAlpha ? 1u : 4u);
+
+	VkBuffer stagingBuffer;
+	VkDeviceMemory stagingMemory;
+	if( !imappRendererCreateBuffer( renderer, (VkDeviceSize)stagingSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, &stagingBuffer, &stagingMemory ) )
+	{
+		return false;
+	}
+
+	uint8_t* stagingData = NULL;
+	if( vkMapMemory( renderer->device, stagingMemory, 0u, (VkDeviceSize)stagingSize, 0u, (void**)&stagingData ) != VK_SUCCESS )
+	{
+		vkDestroyBuffer( renderer->device, stagingBuffer, NULL );
+		vkFreeMemory( renderer->device, stagingMemory, NULL );
+		return false;
+	}
+
+	const uint8_t* sourceData = (const uint8_t*)data;
+	if( texture->format == ImAppRendererFormat_RGB8 )
+	{
+		for( uintsize i = 0u; i < pixelCount; ++i )
+		{
+			stagingData[ (i * 4u) + 0u ] = sourceData[ (i * 3u) + 0u ];
+			stagingData[ (i * 4u) + 1u ] = sourceData[ (i * 3u) + 1u ];
+			stagingData[ (i * 4u) + 2u ] = sourceData[ (i * 3u) + 2u ];
+			stagingData[ (i * 4u) + 3u ] = 0xffu;
+		}
+	}
+	else
+	{
+		memcpy( stagingData, sourceData, stagingSize );
+	}
+	vkUnmapMemory( renderer->device, stagingMemory );
+
+	return imappRendererTextureUpload( renderer, texture, stagingBuffer, stagingMemory, rect, isInitialized );
+}
+
+// Takes the staging buffer, it gets released when the copy finished.
+static bool imappRendererTextureUpload( ImAppRenderer* renderer, ImAppRendererTexture* texture, VkBuffer stagingBuffer, VkDeviceMemory stagingMemory, VkRect2D rect, bool isInitialized )
+{
+	ImAppRendererRelease release;
+	memset( &release, 0, sizeof( release ) );
+	release.buffer			= stagingBuffer;
+	release.bufferMemory	= stagingMemory;
+
+	VkCommandBufferAllocateInfo allocateInfo;
+	memset( &allocateInfo, 0, sizeof( allocateInfo ) );
+	allocateInfo.sType				= VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+	allocateInfo.commandPool		= renderer->commandPool;
+	allocateInfo.level				= VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	allocateInfo.commandBufferCount	= 1u;
+
+	if( vkAllocateCommandBuffers( renderer->device, &allocateInfo, &release.commandBuffer ) != VK_SUCCESS )
+	{
+		imappRendererDestroyRelease( renderer, &release );
+		return false;
+	}
+
+	const VkCommandBuffer commandBuffer = release.commandBuffer;
+
+	VkCommandBufferBeginInfo beginInfo;
+	memset( &beginInfo, 0, sizeof( beginInfo ) );
+	beginInfo.sType	= VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags	= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer( commandBuffer, &beginInfo );
+
+	VkImageMemoryBarrier barrier;
+	memset( &barrier, 0, sizeof( barrier ) );
+	barrier.sType							= VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	barrier.srcAccessMask					= isInitialized ? VK_ACCESS_SHADER_READ_BIT : 0u;
+	barrier.dstAccessMask					= VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout						= isInitialized ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout						= VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex				= VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex				= VK_QUEUE_FAMILY_IGNORED;
+	barrier.image							= texture->image;
+	barrier.subresourceRange.aspectMask		= VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.levelCount		= 1u;
+	barrier.subresourceRange.layerCount		= 1u;
+	vkCmdPipelineBarrier( commandBuffer, isInitialized ? VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0u, 0u, NULL, 0u, NULL, 1u, &barrier );
+
+	VkBufferImageCopy region;
+	memset( &region, 0, sizeof( region ) );
+	region.imageSubresource.aspectMask	= VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.layerCount	= 1u;
+	region.imageOffset.x				= rect.offset.x;
+	region.imageOffset.y				= rect.offset.y;
+	region.imageExtent.width			= rect.extent.width;
+	region.imageExtent.height			= rect.extent.height;
+	region.imageExtent.depth			= 1u;
+	vkCmdCopyBufferToImage( commandBuffer, stagingBuffer, texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1u, &region );
+
+	barrier.srcAccessMask	= VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask	= VK_ACCESS_SHADER_READ_BIT;
+	barrier.oldLayout		= VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout		= VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0u, 0u, NULL, 0u, NULL, 1u, &barrier );
+
+	vkEndCommandBuffer( commandBuffer );
+
+	VkSubmitInfo submitInfo;
+	memset( &submitInfo, 0, sizeof( submitInfo ) );
+	submitInfo.sType				= VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount	= 1u;
+	submitInfo.pCommandBuffers		= &commandBuffer;
+
+	VkFenceCreateInfo fenceCreateInfo;
+	memset( &fenceCreateInfo, 0, sizeof( fenceCreateInfo ) );
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	if( vkCreateFence( renderer->device, &fenceCreateInfo, NULL, &release.fence ) != VK_SUCCESS ||
+		vkQueueSubmit( renderer->queue, 1u, &submitInfo, release.fence ) != VK_SUCCESS )
+	{
+		imappRendererDestroyRelease( renderer, &release );
+		return false;
+	}
+
+	// draws submitted later are ordered after the copy by the barrier
+	imappRendererQueueRelease( renderer, &release );
+	return true;
+}
+
+// Signals when all work submitted so far has finished.
+static bool imappRendererSubmitFence( ImAppRenderer* renderer, VkFence* outFence )
+{
+	VkFenceCreateInfo fenceCreateInfo;
+	memset( &fenceCreateInfo, 0, sizeof( fenceCreateInfo ) );
+	fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+	if( vkCreateFence( renderer->device, &fenceCreateInfo, NULL, outFence ) != VK_SUCCESS )
+	{
+		*outFence = VK_NULL_HANDLE;
+		return false;
+	}
+
+	return vkQueueSubmit( renderer->queue, 0u, NULL, *outFence ) == VK_SUCCESS;
+}
+
+static void imappRendererQueueRelease( ImAppRenderer* renderer, ImAppRendererRelease* release )
+{
+	if( !IMUI_MEMORY_ARRAY_CHECK_CAPACITY( renderer->allocator, renderer->releases, renderer->releaseCapacity, renderer->releaseCount + 1u ) )
+	{
+		// no memory to keep it, wait instead
+		vkWaitForFences( renderer->device, 1u, &release->fence, VK_TRUE, UINT64_MAX );
+		imappRendererDestroyRelease( renderer, release );
+		return;
+	}
+
+	renderer->releases[ renderer->releaseCount++ ] = *release;
+}
+
+static void imappRendererUpdateReleases( ImAppRenderer* renderer, bool wait )
+{
+	uintsize releaseCount = 0u;
+	for( uintsize i = 0u; i < renderer->releaseCount; ++i )
+	{
+		ImAppRendererRelease* release = &renderer->releases[ i ];
+		if( wait ||
+			vkGetFenceStatus( renderer->device, release->fence ) != VK_NOT_READY )
+		{
+			imappRendererDestroyRelease( renderer, release );
+			continue;
+		}
+
+		renderer->releases[ releaseCount++ ] = *release;
+	}
+	renderer->releaseCount = releaseCount;
+}
+
+static void imappRendererDestroyRelease( ImAppRenderer* renderer, ImAppRendererRelease* release )
+{
+	if( release->commandBuffer )
+	{
+		vkFreeCommandBuffers( renderer->device, renderer->commandPool, 1u, &release->commandBuffer );
+	}
+
+	vkDestroyBuffer( renderer->device, release->buffer, NULL );
+	vkFreeMemory( renderer->device, release->bufferMemory, NULL );
+	vkDestroyImageView( renderer->device, release->imageView, NULL );
+	vkDestroyImage( renderer->device, release->image, NULL );
+	vkFreeMemory( renderer->device, release->imageMemory, NULL );
+	vkDestroyFence( renderer->device, release->fence, NULL );
+
+	memset( release, 0, sizeof( *release ) );
+}
+
+bool imappRendererTextureIsReady( ImAppRenderer* renderer, const ImAppRendererTexture* texture )
+{
+	IMAPP_USE( renderer );
+	IMAPP_USE( texture );
+
+	return true;
+}
+
+void imappRendererTextureDestroyData( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+{
+	if( texture->image == VK_NULL_HANDLE )
+	{
+		return;
+	}
+
+	ImAppRendererRelease release;
+	memset( &release, 0, sizeof( release ) );
+	release.imageView	= texture->view;
+	release.image		= texture->image;
+	release.imageMemory	= texture->memory;
+
+	// frames in flight could still sample it, destroyed once they finished
+	if( imappRendererSubmitFence( renderer, &release.fence ) )
+	{
+		imappRendererQueueRelease( renderer, &release );
+	}
+	else
+	{
+		vkDeviceWaitIdle( renderer->device );
+		imappRendererDestroyRelease( renderer, &release );
+	}
+
+	texture->view	= VK_NULL_HANDLE;
+	texture->image	= VK_NULL_HANDLE;
+	texture->memory	= VK_NULL_HANDLE;
+
+	renderer->stateGeneration++;
+
+	if( texture->dataSize > 0u )
+	{
+		renderer->textureCount--;
+		renderer->textureBytes[ texture->format ] -= texture->dataSize;
+		texture->dataSize = 0u;
+	}
+}
+
+void imappRendererTextureDestroy( ImAppRenderer* renderer, ImAppRendererTexture* texture )
+{
+	if( texture == NULL )
+	{
+		return;
+	}
+
+	imappRendererTextureDestroyData( renderer, texture );
+
+	ImUiMemoryFree( renderer->allocator, texture );
+}
+
+void imappRendererWindowRequestCache( ImAppRendererWindow* window, ImUiRect rect )
+{
+	// unchanged frames are skipped as a whole, there is nothing cheaper to cache per window
+	IMAPP_USE( window );
+	IMAPP_USE( rect );
+}
+
+bool imappRendererDraw( ImAppRenderer* renderer, ImAppRendererWindow* window, ImUiSurface* surface, int width, int height, float clearColor[ 4 ], int bufferAge, ImUiRect* outDamageRect )
+{
+	// every frame is drawn completely and reports full damage, the content of older buffers doesn't matter
+	IMAPP_USE( bufferAge );
+
+	ImAppRendererVulkanFrame* frame = &window->frames[ window->frameIndex ];
+	if( frame->fence == VK_NULL_HANDLE || width <= 0 || height <= 0 )
+	{
+		return false;
+	}
+
+	// the frame used this slot two frames ago, after this its arena and descriptors are free
+	vkWaitForFences( renderer->device, 1u, &frame->fence, VK_TRUE, UINT64_MAX );
+
+	uintsize vertexDataSize = 0u;
+	uintsize indexDataSize = 0u;
+	ImUiSurfaceGetMaxBufferSizes( surface, &vertexDataSize, &indexDataSize );
+
+	// vertices and indices share one buffer
+	const uintsize indexOffset = (vertexDataSize + 15u) & ~(uintsize)15u;
+	if( !imappRendererWindowPrepareArena( renderer, frame, (VkDeviceSize)(indexOffset + indexDataSize) ) )
+	{
+		return false;
+	}
+
+	uint8_t* arenaData = (uint8_t*)frame->arenaData;
+	const ImUiDrawData* drawData = ImUiSurfaceGenerateDrawData( surface, arenaData, &vertexDataSize, arenaData + indexOffset, &indexDataSize );
+	if( drawData == NULL )
+	{
+		return false;
+	}
+
+	// the arena is host visible, writing the draw data is the upload
+	window->stats.commandCount			= (uint32_t)drawData->commandCount;
+	window->stats.drawCallCount			= 0u;
+	window->stats.programChangeCount	= 0u;
+	window->stats.textureChangeCount	= 0u;
+	window->stats.scissorChangeCount	= 0u;
+	window->stats.vertexBytesUploaded	= (uint32_t)vertexDataSize;
+	window->stats.indexBytesUploaded	= (uint32_t)indexDataSize;
+
+	// everything that changes pixels: draw data, size, clear color and texture content
+	ImUiHash frameHash = ImUiHashCreate( arenaData, vertexDataSize );
+	frameHash = ImUiHashCreateSeed( arenaData + indexOffset, indexDataSize, frameHash );
+	frameHash = ImUiHashCreateSeed( clearColor, sizeof( float ) * 4u, frameHash );
+	frameHash = ImUiHashMix( frameHash, (ImUiHash)width );
+	frameHash = ImUiHashMix( frameHash, (ImUiHash)height );
+	frameHash = ImUiHashMix( frameHash, (ImUiHash)renderer->stateGeneration );
+
+	uint32_t textureCommandCount = 0u;
+	for( uintsize i = 0u; i < drawData->commandCount; ++i )
+	{
+		const ImUiDrawCommand* command = &drawData->commands[ i ];
+		frameHash = ImUiHashCreateSeed( &command->clipRect, sizeof( command->clipRect ), frameHash );
+		frameHash = ImUiHashCreateSeed( &command->textureHandle, sizeof( command->textureHandle ), frameHash );
+		frameHash = ImUiHashMix( frameHash, (ImUiHash)command->topology );
+		frameHash = ImUiHashMix( frameHash, (ImUiHash)command->count );
+
+		if( command->textureHandle != IMUI_TEXTURE_HANDLE_INVALID )
+		{
+			textureCommandCount++;
+		}
+	}
+
+	// damage tracking only skips unchanged frames, nothing gets presented so the visible image stays valid
+	if( (renderer->flags & ImAppRendererFlags_DamageTracking) != 0u &&
+		window->hasFrameHash &&
+		window->frameHash == frameHash &&
+		!window->isSwapchainOutdated )
+	{
+		return false;
+	}
+
+	// before acquiring, an acquired image has to be submitted
+	if( !imappRendererWindowPrepareDescriptorPool( renderer, frame, textureCommandCount ) )
+	{
+		return false;
+	}
+
+	VkRenderPass renderPass;
+	VkFramebuffer framebuffer;
+	uint32_t imageIndex = 0u;
+	if( window->surface )
+	{
+		if( window->swapchain == VK_NULL_HANDLE ||
+			window->isSwapchainOutdated ||
+			window->width != width ||
+			window->height != height )
+		{
+			if( !imappRendererWindowCreateSwapchain( renderer, window, width, height ) )
+			{
+				return false;
+			}
+		}
+
+		const VkResult acquireResult = vkAcquireNextImageKHR( renderer->device, window->swapchain, UINT64_MAX, frame->acquireSemaphore, VK_NULL_HANDLE, &imageIndex );
+		if( acquireResult == VK_ERROR_OUT_OF_DATE_KHR )
+		{
+			window->isSwapchainOutdated = true;
+			return false;
+		}
+		else if( acquireResult == VK_SUBOPTIMAL_KHR )
+		{
+			// the semaphore is signaled, draw this frame and recreate with the next
+			window->isSwapchainOutdated = true;
+		}
+		else if( acquireResult != VK_SUCCESS )
+		{
+			ImAppTrace( "[renderer] Failed to acquire Vulkan swapchain image. Result: %d\n", acquireResult );
+			return false;
+		}
+
+		renderPass	= renderer->presentRenderPass;
+		framebuffer	= window->framebuffers[ imageIndex ];
+	}
+	else
+	{
+		if( window->offscreenFramebuffer == VK_NULL_HANDLE ||
+			window->width != width ||
+			window->height != height )
+		{
+			if( !imappRendererWindowCreateOffscreen( renderer, window, width, height ) )
+			{
+				imappRendererWindowDestroyOffscreen( renderer, window );
+				return false;
+			}
+		}
+
+		renderPass	= renderer->offscreenRenderPass;
+		framebuffer	= window->offscreenFramebuffer;
+	}
+
+	VkCommandBuffer commandBuffer = frame->commandBuffer;
+	vkResetCommandBuffer( commandBuffer, 0u );
+
+	VkCommandBufferBeginInfo beginInfo;
+	memset( &beginInfo, 0, sizeof( beginInfo ) );
+	beginInfo.sType	= VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags	= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	vkBeginCommandBuffer( commandBuffer, &beginInfo );
+
+	VkClearValue clearValue;
+	memcpy( clearValue.color.float32, clearColor, sizeof( clearValue.color.float32 ) );
+
+	VkRenderPassBeginInfo renderPassBeginInfo;
+	memset( &renderPassBeginInfo, 0, sizeof( renderPassBeginInfo ) );
+	renderPassBeginInfo.sType				= VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+	renderPassBeginInfo.renderPass			= renderPass;
+	renderPassBeginInfo.framebuffer			= framebuffer;
+	renderPassBeginInfo.renderArea.extent	= window->extent;
+	renderPassBeginInfo.clearValueCount		= 1u;
+	renderPassBeginInfo.pClearValues		= &clearValue;
+	vkCmdBeginRenderPass( commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE );
+
+	const VkDeviceSize vertexOffset = 0u;
+	vkCmdBindVertexBuffers( commandBuffer, 0u, 1u, &frame->arenaBuffer, &vertexOffset );
+	vkCmdBindIndexBuffer( commandBuffer, frame->arenaBuffer, (VkDeviceSize)indexOffset, VK_INDEX_TYPE_UINT32 );
+
+	VkViewport viewport;
+	viewport.x			= 0.0f;
+	viewport.y			= 0.0f;
+	viewport.width		= (float)window->extent.width;
+	viewport.height		= (float)window->extent.height;
+	viewport.minDepth	= 0.0f;
+	viewport.maxDepth	= 1.0f;
+	vkCmdSetViewport( commandBuffer, 0u, 1u, &viewport );
+
+	// screen space to clip space, Vulkan has y pointing down like ImUi
+	const float scale[ 2u ] = { 2.0f / (float)width, 2.0f / (float)height };
+	vkCmdPushConstants( commandBuffer, renderer->pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0u, sizeof( scale ), scale );
+
+	ImAppRendererBatch batch;
+	memset( &batch, 0, sizeof( batch ) );
+
+	ImAppRendererBatch boundState;
+	memset( &boundState, 0, sizeof( boundState ) );
+	boundState.pipeline = ImAppRendererPipeline_MAX;
+
+	uint32_t firstIndex = 0u;
+	for( uintsize i = 0u; i < drawData->commandCount; ++i )
+	{
+		const ImUiDrawCommand* command = &drawData->commands[ i ];
+		const uint32_t commandFirstIndex = firstIndex;
+		firstIndex += (uint32_t)command->count;
+
+		ImAppRendererTexture* texture = (ImAppRendererTexture*)command->textureHandle;
+		ImAppRendererPipeline pipeline = ImAppRendererPipeline_Color;
+		if( texture != NULL )
+		{
+			if( texture->view == VK_NULL_HANDLE )
+			{
+				continue;
+			}
+			else if( texture->flags & ImAppResPakTextureFlags_Font )
+			{
+				pipeline = ImAppRendererPipeline_Font;
+			}
+			else if( texture->flags & ImAppResPakTextureFlags_FontSdf )
+			{
+				pipeline = ImAppRendererPipeline_FontSdf;
+			}
+			else
+			{
+				pipeline = texture->flags & ImAppResPakTextureFlags_Opaque ? ImAppRendererPipeline_TextureOpaque : ImAppRendererPipeline_Texture;
+			}
+		}
+
+		const int left		= IMUI_MAX( (int)command->clipRect.pos.x, 0 );
+		const int top		= IMUI_MAX( (int)command->clipRect.pos.y, 0 );
+		const int right		= IMUI_MIN( (int)(command->clipRect.pos.x + command->clipRect.size.width), (int)window->extent.width );
+		const int bottom	= IMUI_MIN( (int)(command->clipRect.pos.y + command->clipRect.size.height), (int)window->extent.height );
+		if( command->count == 0u || left >= right || top >= bottom )
+		{
+			continue;
+		}
+
+		VkRect2D scissor;
+		scissor.offset.x		= left;
+		scissor.offset.y		= top;
+		scissor.extent.width	= (uint32_t)(right - left);
+		scissor.extent.height	= (uint32_t)(bottom - top);
+
+		if( batch.indexCount > 0u &&
+			batch.pipeline == pipeline &&
+			batch.topology == command->topology &&
+			batch.texture == texture &&
+			memcmp( &batch.scissor, &scissor, sizeof( scissor ) ) == 0 &&
+			batch.firstIndex + batch.indexCount == commandFirstIndex )
+		{
+			batch.indexCount += (uint32_t)command->count;
+			continue;
+		}
+
+		if( batch.indexCount > 0u )
+		{
+			imappRendererWindowDrawBatch( renderer, window, frame, &batch, &boundState );
+		}
+
+		batch.pipeline		= pipeline;
+		batch.topology		= command->topology;
+		batch.texture		= texture;
+		batch.scissor		= scissor;
+		batch.firstIndex	= commandFirstIndex;
+		batch.indexCount	= (uint32_t)command->count;
+	}
+
+	if( batch.indexCount > 0u )
+	{
+		imappRendererWindowDrawBatch( renderer, window, frame, &batch, &boundState );
+	}
+
+	vkCmdEndRenderPass( commandBuffer );
+
+	if( window->surface == VK_NULL_HANDLE )
+	{
+		VkBufferImageCopy region;
+		memset( &region, 0, sizeof( region ) );
+		region.imageSubresource.aspectMask	= VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.layerCount	= 1u;
+		region.imageExtent.width			= window->extent.width;
+		region.imageExtent.height			= window->extent.height;
+		region.imageExtent.depth			= 1u;
+		vkCmdCopyImageToBuffer( commandBuffer, window->offscreenImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, window->readbackBuffer, 1u, &region );
+
+		VkBufferMemoryBarrier barrier;
+		memset( &barrier, 0, sizeof( barrier ) );
+		barrier.sType				= VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask		= VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask		= VK_ACCESS_HOST_READ_BIT;
+		barrier.srcQueueFamilyIndex	= VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex	= VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer				= window->readbackBuffer;
+		barrier.size				= VK_WHOLE_SIZE;
+		vkCmdPipelineBarrier( commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0u, 0u, NULL, 1u, &barrier, 0u, NULL );
+	}
+
+	vkEndCommandBuffer( commandBuffer );
+
+	const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+
+	VkSubmitInfo submitInfo;
+	memset( &submitInfo, 0, sizeof( submitInfo ) );
+	submitInfo.sType				= VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount	= 1u;
+	submitInfo.pCommandBuffers		= &commandBuffer;
+	if( window->surface )
+	{
+		submitInfo.waitSemaphoreCount	= 1u;
+		submitInfo.pWaitSemaphores		= &frame->acquireSemaphore;
+		submitInfo.pWaitDstStageMask	= &waitStage;
+		submitInfo.signalSemaphoreCount	= 1u;
+		submitInfo.pSignalSemaphores	= &window->renderSemaphores[ imageIndex ];
+	}
+
+	vkResetFences( renderer->device, 1u, &frame->fence );
+	const VkResult submitResult = vkQueueSubmit( renderer->queue, 1u, &submitInfo, frame->fence );
+	if( submitResult != VK_SUCCESS )
+	{
+		ImAppTrace( "[renderer] Failed to submit Vulkan commands. Result: %d\n", submitResult );
+		imappRendererWindowDiscardFrame( renderer, window, frame, window->surface != VK_NULL_HANDLE );
+		return false;
+	}
+
+	window->frameIndex		= (window->frameIndex + 1u) % IMAPP_ARRAY_COUNT( window->frames );
+	window->frameHash		= frameHash;
+	window->hasFrameHash	= true;
+
+	if( window->surface )
+	{
+		VkPresentInfoKHR presentInfo;
+		memset( &presentInfo, 0, sizeof( presentInfo ) );
+		presentInfo.sType				= VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+		presentInfo.waitSemaphoreCount	= 1u;
+		presentInfo.pWaitSemaphores		= &window->renderSemaphores[ imageIndex ];
+		presentInfo.swapchainCount		= 1u;
+		presentInfo.pSwapchains			= &window->swapchain;
+		presentInfo.pImageIndices		= &imageIndex;
+
+		const VkResult presentResult = vkQueuePresentKHR( renderer->queue, &presentInfo );
+		if( presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR )
+		{
+			window->isSwapchainOutdated = true;
+		}
+		else if( presentResult != VK_SUCCESS )
+		{
+			ImAppTrace( "[renderer] Failed to present Vulkan swapchain. Result: %d\n", presentResult );
+			window->hasFrameHash = false;
+		}
+	}
+	else
+	{
+		// the platform reads pixels right after the draw
+		vkWaitForFences( renderer->device, 1u, &frame->fence, VK_TRUE, UINT64_MAX );
+
+		void* readbackData = NULL;
+		if( vkMapMemory( renderer->device, window->readbackMemory, 0u, VK_WHOLE_SIZE, 0u, &readbackData ) != VK_SUCCESS )
+		{
+			window->hasFrameHash = false;
+			return false;
+		}
+		memcpy( window->pixels, readbackData, (uintsize)window->extent.width * window->extent.height * sizeof( uint32_t ) );
+		vkUnmapMemory( renderer->device, window->readbackMemory );
+	}
+
+	outDamageRect->pos.x		= 0.0f;
+	outDamageRect->pos.y		= 0.0f;
+	outDamageRect->size.width	= (float)width;
+	outDamageRect->size.height	= (float)height;
+
+	return true;
+}
+
+// A frame that didn't get submitted: waits the acquire semaphore and signals the fence with an empty batch, so both
+// can be used again. The acquired image gets released with the recreated swapchain.
+static void imappRendererWindowDiscardFrame( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererVulkanFrame* frame, bool hasAcquired )
+{
+	const VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+	VkSubmitInfo submitInfo;
+	memset( &submitInfo, 0, sizeof( submitInfo ) );
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	if( hasAcquired )
+	{
+		submitInfo.waitSemaphoreCount	= 1u;
+		submitInfo.pWaitSemaphores		= &frame->acquireSemaphore;
+		submitInfo.pWaitDstStageMask	= &waitStage;
+	}
+
+	vkResetFences( renderer->device, 1u, &frame->fence );
+	if( vkQueueSubmit( renderer->queue, 1u, &submitInfo, frame->fence ) != VK_SUCCESS )
+	{
+		// the queue doesn't take work anymore, start over with new objects
+		vkDeviceWaitIdle( renderer->device );
+		vkDestroySemaphore( renderer->device, frame->acquireSemaphore, NULL );
+		vkDestroyFence( renderer->device, frame->fence, NULL );
+
+		VkFenceCreateInfo fenceCreateInfo;
+		memset( &fenceCreateInfo, 0, sizeof( fenceCreateInfo ) );
+		fenceCreateInfo.sType	= VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+		fenceCreateInfo.flags	= VK_FENCE_CREATE_SIGNALED_BIT;
+
+		VkSemaphoreCreateInfo semaphoreCreateInfo;
+		memset( &semaphoreCreateInfo, 0, sizeof( semaphoreCreateInfo ) );
+		semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+		if( vkCreateFence( renderer->device, &fenceCreateInfo, NULL, &frame->fence ) != VK_SUCCESS )
+		{
+			frame->fence = VK_NULL_HANDLE;
+		}
+
+		if( vkCreateSemaphore( renderer->device, &semaphoreCreateInfo, NULL, &frame->acquireSemaphore ) != VK_SUCCESS )
+		{
+			frame->acquireSemaphore = VK_NULL_HANDLE;
+		}
+	}
+
+	if( hasAcquired )
+	{
+		window->isSwapchainOutdated = true;
+	}
+	window->hasFrameHash = false;
+}
+
+static void imappRendererWindowDrawBatch( ImAppRenderer* renderer, ImAppRendererWindow* window, ImAppRendererVulkanFrame* frame, const ImAppRendererBatch* batch, ImAppRendererBatch* boundState )
+{
+	VkCommandBuffer commandBuffer = frame->commandBuffer;
+
+	if( batch->texture && batch->texture != boundState->texture )
+	{
+		VkDescriptorSetAllocateInfo allocateInfo;
+		memset( &allocateInfo, 0, sizeof( allocateInfo ) );
+		allocateInfo.sType				= VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocateInfo.descriptorPool		= frame->descriptorPool;
+		allocateInfo.descriptorSetCount	= 1u;
+		allocateInfo.pSetLayouts		= &renderer->descriptorSetLayout;
+
+		VkDescriptorSet descriptorSet;
+		if( vkAllocateDescriptorSets( renderer->device, &allocateInfo, &descriptorSet ) != VK_SUCCESS )
+		{
+			return;
+		}
+
+		VkDescriptorImageInfo imageInfo;
+		imageInfo.sampler		= batch->texture->flags & ImAppResPakTextureFlags_Repeat ? renderer->samplerRepeat : renderer->samplerClamp;
+		imageInfo.imageView		= batch->texture->view;
+		imageInfo.imageLayout	= VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		VkWriteDescriptorSet write;
+		memset( &write, 0, sizeof( write ) );
+		write.sType				= VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		write.dstSet			= descriptorSet;
+		write.dstBinding		= 0u;
+		write.descriptorCount	= 1u;
+		write.descriptorType	= VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		write.pImageInfo		= &imageInfo;
+		vkUpdateDescriptorSets( renderer->device, 1u, &write, 0u, NULL );
+
+		vkCmdBindDescriptorSets( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->pipelineLayout, 0u, 1u, &descriptorSet, 0u, NULL );
+		boundState->texture = batch->texture;
+		window->stats.textureChangeCount++;
+	}
+
+	if( batch->pipeline != boundState->pipeline ||
+		batch->topology != boundState->topology )
+	{
+		const uintsize topologyIndex = batch->topology == ImUiDrawTopology_LineList ? 1u : 0u;
+		vkCmdBindPipeline( commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->pipelines[ batch->pipeline ][ topologyIndex ] );
+		boundState->pipeline = batch->pipeline;
+		boundState->topology = batch->topology;
+		window->stats.programChangeCount++;
+	}
+
+	if( memcmp( &batch->scissor, &boundState->scissor, sizeof( batch->scissor ) ) != 0 )
+	{
+		vkCmdSetScissor( commandBuffer, 0u, 1u, &batch->scissor );
+		boundState->scissor = batch->scissor;
+		window->stats.scissorChangeCount++;
+	}
+
+	vkCmdDrawIndexed( commandBuffer, batch->indexCount, 1u, batch->firstIndex, 0, 0u );
+	window->stats.drawCallCount++;
+}
+
+#endif
@@ -12,6 +12,13 @@
 #include <stdlib.h>
 #include <string.h>
 
+#define IMAPP_RES_SYS_ATLAS_PAGE_SIZE		1024u
+#define IMAPP_RES_SYS_ATLAS_PAGE_COUNT		4u
+#define IMAPP_RES_SYS_ATLAS_MAX_IMAGE_SIZE	128u	// larger images keep a dedicated texture
+#define IMAPP_RES_SYS_ATLAS_PADDING			1u		// edge pixels get repeated, so linear filtering doesn't bleed into neighbours
+#define IMAPP_RES_SYS_TEXTURE_POOL_SIZE		8u
+#define IMAPP_RES_SYS_TEXTURE_POOL_MAX_AGE	120u	// updates a released texture waits for a new image of its size
+
 static const byte s_pngHeader[] = { 0x89u, 0x50u, 0x4eu, 0x47u, 0x0du, 0x0au, 0x1au, 0x0au };
 static const byte s_jpegHeader[] = { 0xffu, 0xd8u, 0xffu, 0xe0u, 0x00u, 0x10u, 0x4au, 0x46u, 0x49u, 0x46u, 0x00u };
 
@@ -31,6 +38,12 @@ struct ImAppResSys
 	ImUiHashMap			imageMap;
 	ImAppFont*			firstFont;
 
+	ImAppResAtlasPage	atlasPages[ IMAPP_RES_SYS_ATLAS_PAGE_COUNT ];
+
+	ImAppResTexturePoolEntry	texturePool[ IMAPP_RES_SYS_TEXTURE_POOL_SIZE ];	// oldest first
+	uintsize					texturePoolCount;
+	uint32						updateIndex;
+
 	ImAppThread*		thread;
 
 	ImAppResEventQueue	sendQueue;
@@ -44,10 +57,21 @@ static void			ImAppResSysHandleLoadResData( ImAppResSys* ressys, ImAppResEvent*
 static void			ImAppResSysHandleImage( ImAppResSys* ressys, ImAppResEvent* resEvent );
 
 static ImAppRes*	ImAppResSysLoad( ImAppResPak* pak, uint16 resIndex );
+static bool			ImAppResSysIsTextureReady( ImAppResSys* ressys, ImAppRes* textureRes );
 static void			ImAppResSysUnload( ImAppResPak* pak, ImAppRes* res );
 
 static bool			ImAppResSysFontInitialize( ImAppResSys* ressys, ImAppFont* font );
 
+static bool			ImAppResSysImageCreateTexture( ImAppResSys* ressys, ImAppImage* image, const void* pixelData, uint32 width, uint32 height, ImAppRendererFormat format );
+static bool			ImAppResSysAtlasAdd( ImAppResSys* ressys, ImAppImage* image, const void* pixelData, uint32 width, uint32 height, ImAppRendererFormat format );
+static bool			ImAppResSysAtlasWrite( ImAppResSys* ressys, const ImAppImage* image, const void* pixelData, ImAppRendererFormat format, uint32 x, uint32 y, uint32 width, uint32 height );
+static bool			ImAppResSysAtlasAllocate( ImAppResSys* ressys, ImAppResAtlasPage* page, uint16 width, uint16 height, ImAppResAtlasSlot* outSlot );
+static void			ImAppResSysAtlasRemove( ImAppResSys* ressys, ImAppImage* image );
+static void			ImAppResSysAtlasDestroyPage( ImAppResSys* ressys, ImAppResAtlasPage* page );
+static ImAppRendererTexture*	ImAppResSysTexturePoolAcquire( ImAppResSys* ressys, uint32 width, uint32 height, ImAppRendererFormat format );
+static void			ImAppResSysTexturePoolRelease( ImAppResSys* ressys, ImAppRendererTexture* texture, uint32 width, uint32 height, ImAppRendererFormat format );
+static void			ImAppResSysTexturePoolTrim( ImAppResSys* ressys, bool all );
+
 static void			ImAppResThreadEntry( void* arg );
 static void			ImAppResThreadHandleOpenResPak( ImAppResSys* ressys, ImAppResEvent* resEvent );
 static void			ImAppResThreadHandleLoadResData( ImAppResSys* ressys, ImAppResEvent* resEvent );
@@ -110,6 +134,13 @@ void imappResSysDestroy( ImAppResSys* ressys )
 		imappResSysImageFree( ressys, image );
 	}
 
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( ressys->atlasPages ); ++i )
+	{
+		ImAppResSysAtlasDestroyPage( ressys, &ressys->atlasPages[ i ] );
+	}
+
+	ImAppResSysTexturePoolTrim( ressys, true );
+
 	ImAppResEventQueueDestruct( ressys, &ressys->sendQueue );
 	ImAppResEventQueueDestruct( ressys, &ressys->receiveQueue );
 
@@ -123,6 +154,9 @@ void imappResSysDestroy( ImAppResSys* ressys )
 
 void imappResSysUpdate( ImAppResSys* ressys, bool wait )
 {
+	ressys->updateIndex++;
+	ImAppResSysTexturePoolTrim( ressys, false );
+
 	if( ressys->watcher )
 	{
 		ImAppFileWatchEvent watchEvent;
@@ -278,6 +312,12 @@ static void ImAppResSysHandleLoadResData( ImAppResSys* ressys, ImAppResEvent* re
 				res->state = ImAppResState_Error;
 				return;
 			}
+
+			if( !imappRendererTextureIsReady( ressys->renderer, res->data.texture.texture ) )
+			{
+				// stays loading until ImAppResSysIsTextureReady sees the finished upload
+				return;
+			}
 		}
 		break;
 
@@ -337,17 +377,17 @@ static void ImAppResSysHandleImage( ImAppResSys* ressys, ImAppResEvent* resEvent
 	}
 
 	const ImAppResEventResultImageData* result = &resEvent->result.image;
-	image->uiImage.textureHandle	= (uint64)imappRendererTextureCreateFromMemory( ressys->renderer, result->data.data, result->width, result->height, result->format, 0u );
-	image->uiImage.width			= result->width;
-	image->uiImage.height			= result->height;
-	image->uiImage.uv.u0			= 0.0f;
-	image->uiImage.uv.v0			= 0.0f;
-	image->uiImage.uv.u1			= 1.0f;
-	image->uiImage.uv.v1			= 1.0f;
+	const bool textureOk = ImAppResSysImageCreateTexture( ressys, image, result->data.data, result->width, result->height, result->format );
 
 	ImUiMemoryFree( ressys->allocator, result->data.data );
 
-	image->state = ImAppResState_Ready;
+	if( !textureOk )
+	{
+		image->state = ImAppResState_Error;
+		return;
+	}
+
+	image->state = imappRendererTextureIsReady( ressys->renderer, (ImAppRendererTexture*)image->uiImage.textureHandle ) ? ImAppResState_Ready : ImAppResState_Loading;
 }
 
 static ImAppRes* ImAppResSysLoad( ImAppResPak* pak, uint16 resIndex )
@@ -394,6 +434,10 @@ static ImAppRes* ImAppResSysLoad( ImAppResPak* pak, uint16 resIndex )
 
 				textureData->loading = true;
 			}
+			else if( ImAppResSysIsTextureReady( pak->ressys, res ) )
+			{
+				break;
+			}
 
 			return res;
 		}
@@ -419,7 +463,7 @@ static ImAppRes* ImAppResSysLoad( ImAppResPak* pak, uint16 resIndex )
 				res->state = ImAppResState_Error;
 				return NULL;
 			}
-			else if( imageData->textureRes->state != ImAppResState_Ready )
+			else if( !ImAppResSysIsTextureReady( pak->ressys, imageData->textureRes ) )
 			{
 				return res;
 			}
@@ -458,7 +502,7 @@ static ImAppRes* ImAppResSysLoad( ImAppResPak* pak, uint16 resIndex )
 					res->state = ImAppResState_Error;
 					return NULL;
 				}
-				else if( skinData->textureRes->state != ImAppResState_Ready )
+				else if( !ImAppResSysIsTextureReady( pak->ressys, skinData->textureRes ) )
 				{
 					return res;
 				}
@@ -503,7 +547,7 @@ static ImAppRes* ImAppResSysLoad( ImAppResPak* pak, uint16 resIndex )
 				res->state = ImAppResState_Error;
 				return NULL;
 			}
-			else if( fontData->textureRes->state != ImAppResState_Ready )
+			else if( !ImAppResSysIsTextureReady( pak->ressys, fontData->textureRes ) )
 			{
 				return res;
 			}
@@ -766,6 +810,8 @@ void imappResSysDestroyDeviceResources( ImAppResSys* ressys )
 	{
 		imappRendererTextureDestroyData( ressys->renderer, font->texture );
 	}
+
+	ImAppResSysTexturePoolTrim( ressys, true );
 }
 
 void imappResSysCreateDeviceResources( ImAppResSys* ressys )
@@ -1059,23 +1105,19 @@ ImAppBlob ImAppResPakGetBlobIndex( ImAppResPak* pak, uint16_t resIndex )
 
 ImAppImage* imappResSysImageCreateRaw( ImAppResSys* ressys, const void* pixelData, int width, int height )
 {
-	ImAppImage* image = IMUI_MEMORY_NEW( ressys->allocator, ImAppImage );
+	ImAppImage* image = IMUI_MEMORY_NEW_ZERO( ressys->allocator, ImAppImage );
 	image->resourceName			= ImUiStringViewCreateEmpty();
-	image->uiImage.textureHandle	= (uint64)imappRendererTextureCreateFromMemory( ressys->renderer, pixelData, (uint32)width, (uint32)height, ImAppRendererFormat_RGBA8, 0u );
-	image->uiImage.width			= (uint32)width;
-	image->uiImage.height			= (uint32)height;
-	image->uiImage.uv.u0			= 0.0f;
-	image->uiImage.uv.v0			= 0.0f;
-	image->uiImage.uv.u1			= 1.0f;
-	image->uiImage.uv.v1			= 1.0f;
-	image->state				= ImAppResState_Ready;
+	image->state				= ImAppResState_Loading;
 
-	if( image->uiImage.textureHandle == IMUI_TEXTURE_HANDLE_INVALID )
+	if( !ImAppResSysImageCreateTexture( ressys, image, pixelData, (uint32)width, (uint32)height, ImAppRendererFormat_RGBA8 ) )
 	{
 		ImUiMemoryFree( ressys->allocator, image );
 		return NULL;
 	}
 
+	// ready right away with synchronous uploads, otherwise ImAppImageGetState sees the finished upload
+	image->state = imappRendererTextureIsReady( ressys->renderer, (ImAppRendererTexture*)image->uiImage.textureHandle ) ? ImAppResState_Ready : ImAppResState_Loading;
+
 	return image;
 }
 
@@ -1163,21 +1205,370 @@ ImAppImage* imappResSysImageCreateJpeg( ImAppResSys* ressys, const void* imageDa
 
 ImAppResState imappResSysImageGetState( ImAppResSys* ressys, ImAppImage* image )
 {
-	IMAPP_USE( ressys );
+	if( image->state == ImAppResState_Loading &&
+		image->uiImage.textureHandle != IMUI_TEXTURE_HANDLE_INVALID &&
+		imappRendererTextureIsReady( ressys->renderer, (ImAppRendererTexture*)image->uiImage.textureHandle ) )
+	{
+		image->state = ImAppResState_Ready;
+	}
 
 	return image->state;
 }
 
+bool imappResSysImageUpdate( ImAppResSys* ressys, ImAppImage* image, const void* pixelData, uint32 x, uint32 y, uint32 width, uint32 height )
+{
+	if( image->uiImage.textureHandle == IMUI_TEXTURE_HANDLE_INVALID ||
+		image->textureFormat != ImAppRendererFormat_RGBA8 ||
+		x + width > image->uiImage.width ||
+		y + height > image->uiImage.height )
+	{
+		return false;
+	}
+
+	if( image->atlasSlot.page != 0u )
+	{
+		return ImAppResSysAtlasWrite( ressys, image, pixelData, ImAppRendererFormat_RGBA8, x, y, width, height );
+	}
+
+	return imappRendererTextureUpdateRegion( ressys->renderer, (ImAppRendererTexture*)image->uiImage.textureHandle, pixelData, x, y, width, height );
+}
+
 void imappResSysImageFree( ImAppResSys* ressys, ImAppImage* image )
 {
-	if( image->uiImage.textureHandle != IMUI_TEXTURE_HANDLE_INVALID )
+	if( image->atlasSlot.page != 0u )
+	{
+		ImAppResSysAtlasRemove( ressys, image );
+	}
+	else if( image->uiImage.textureHandle != IMUI_TEXTURE_HANDLE_INVALID )
 	{
-		imappRendererTextureDestroy( ressys->renderer, (ImAppRendererTexture*)image->uiImage.textureHandle );
+		ImAppResSysTexturePoolRelease( ressys, (ImAppRendererTexture*)image->uiImage.textureHandle, image->uiImage.width, image->uiImage.height, (ImAppRendererFormat)image->textureFormat );
 	}
 
 	ImUiMemoryFree( ressys->allocator, image );
 }
 
+static bool ImAppResSysImageCreateTexture( ImAppResSys* ressys, ImAppImage* image, const void* pixelData, uint32 width, uint32 height, ImAppRendererFormat format )
+{
+	image->uiImage.width	= width;
+	image->uiImage.height	= height;
+	image->textureFormat	= (uint8)format;
+
+	if( ImAppResSysAtlasAdd( ressys, image, pixelData, width, height, format ) )
+	{
+		return true;
+	}
+
+	memset( &image->atlasSlot, 0, sizeof( image->atlasSlot ) );
+
+	ImAppRendererTexture* texture = ImAppResSysTexturePoolAcquire( ressys, width, height, format );
+	if( texture != NULL &&
+		!imappRendererTextureUpdateRegion( ressys->renderer, texture, pixelData, 0u, 0u, width, height ) )
+	{
+		imappRendererTextureDestroy( ressys->renderer, texture );
+		texture = NULL;
+	}
+
+	if( texture == NULL )
+	{
+		texture = imappRendererTextureCreateFromMemory( ressys->renderer, pixelData, width, height, format, 0u );
+	}
+
+	image->uiImage.textureHandle	= (uint64)texture;
+	image->uiImage.uv.u0			= 0.0f;
+	image->uiImage.uv.v0			= 0.0f;
+	image->uiImage.uv.u1			= 1.0f;
+	image->uiImage.uv.v1			= 1.0f;
+
+	return image->uiImage.textureHandle != IMUI_TEXTURE_HANDLE_INVALID;
+}
+
+static bool ImAppResSysAtlasAdd( ImAppResSys* ressys, ImAppImage* image, const void* pixelData, uint32 width, uint32 height, ImAppRendererFormat format )
+{
+	// alpha images sample differently than RGBA pages
+	if( format == ImAppRendererFormat_R8 ||
+		width == 0u ||
+		height == 0u ||
+		width > IMAPP_RES_SYS_ATLAS_MAX_IMAGE_SIZE ||
+		height > IMAPP_RES_SYS_ATLAS_MAX_IMAGE_SIZE )
+	{
+		return false;
+	}
+
+	const uint16 paddedWidth	= (uint16)(width + (IMAPP_RES_SYS_ATLAS_PADDING * 2u));
+	const uint16 paddedHeight	= (uint16)(height + (IMAPP_RES_SYS_ATLAS_PADDING * 2u));
+
+	ImAppResAtlasSlot slot;
+	ImAppResAtlasPage* page = NULL;
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( ressys->atlasPages ) && page == NULL; ++i )
+	{
+		ImAppResAtlasPage* candidate = &ressys->atlasPages[ i ];
+		if( candidate->texture != NULL &&
+			ImAppResSysAtlasAllocate( ressys, candidate, paddedWidth, paddedHeight, &slot ) )
+		{
+			slot.page	= (uint16)(i + 1u);
+			page		= candidate;
+		}
+	}
+
+	for( uintsize i = 0u; i < IMAPP_ARRAY_COUNT( ressys->atlasPages ) && page == NULL; ++i )
+	{
+		ImAppResAtlasPage* candidate = &ressys->atlasPages[ i ];
+		if( candidate->texture != NULL )
+		{
+			continue;
+		}
+
+		const uintsize pageDataSize = IMAPP_RES_SYS_ATLAS_PAGE_SIZE * IMAPP_RES_SYS_ATLAS_PAGE_SIZE * 4u;
+		void* pageData = ImUiMemoryAllocZero( ressys->allocator, pageDataSize );
+		if( !pageData )
+		{
+			return false;
+		}
+
+		candidate->texture = imappRendererTextureCreateFromMemory( ressys->renderer, pageData, IMAPP_RES_SYS_ATLAS_PAGE_SIZE, IMAPP_RES_SYS_ATLAS_PAGE_SIZE, ImAppRendererFormat_RGBA8, 0u );
+		ImUiMemoryFree( ressys->allocator, pageData );
+
+		if( candidate->texture == NULL ||
+			!ImAppResSysAtlasAllocate( ressys, candidate, paddedWidth, paddedHeight, &slot ) )
+		{
+			ImAppResSysAtlasDestroyPage( ressys, candidate );
+			return false;
+		}
+
+		slot.page	= (uint16)(i + 1u);
+		page		= candidate;
+	}
+
+	if( page == NULL )
+	{
+		return false;
+	}
+
+	image->atlasSlot = slot;
+
+	if( !ImAppResSysAtlasWrite( ressys, image, pixelData, format, 0u, 0u, width, height ) )
+	{
+		ImAppResSysAtlasRemove( ressys, image );
+		return false;
+	}
+
+	const uint16 slotY = page->shelves[ slot.shelf ].y;
+	const float pageSize = (float)IMAPP_RES_SYS_ATLAS_PAGE_SIZE;
+	image->uiImage.textureHandle	= (uint64)page->texture;
+	image->uiImage.uv.u0			= (slot.x + IMAPP_RES_SYS_ATLAS_PADDING) / pageSize;
+	image->uiImage.uv.v0			= (slotY + IMAPP_RES_SYS_ATLAS_PADDING) / pageSize;
+	image->uiImage.uv.u1			= (slot.x + IMAPP_RES_SYS_ATLAS_PADDING + width) / pageSize;
+	image->uiImage.uv.v1			= (slotY + IMAPP_RES_SYS_ATLAS_PADDING + height) / pageSize;
+
+	return true;
+}
+
+// Copies a region of the image into its page. The padding gets updated on the sides the region touches the image border.
+static bool ImAppResSysAtlasWrite( ImAppResSys* ressys, const ImAppImage* image, const void* pixelData, ImAppRendererFormat format, uint32 x, uint32 y, uint32 width, uint32 height )
+{
+	const ImAppResAtlasSlot* slot	= &image->atlasSlot;
+	const ImAppResAtlasPage* page	= &ressys->atlasPages[ slot->page - 1u ];
+
+	const uint32 padLeft		= x == 0u ? IMAPP_RES_SYS_ATLAS_PADDING : 0u;
+	const uint32 padTop			= y == 0u ? IMAPP_RES_SYS_ATLAS_PADDING : 0u;
+	const uint32 padRight		= x + width == image->uiImage.width ? IMAPP_RES_SYS_ATLAS_PADDING : 0u;
+	const uint32 padBottom		= y + height == image->uiImage.height ? IMAPP_RES_SYS_ATLAS_PADDING : 0u;
+	const uint32 targetWidth	= padLeft + width + padRight;
+	const uint32 targetHeight	= padTop + height + padBottom;
+
+	uint8* paddedData = (uint8*)ImUiMemoryAlloc( ressys->allocator, (uintsize)targetWidth * targetHeight * 4u );
+	if( !paddedData )
+	{
+		return false;
+	}
+
+	const uint8* sourceData		= (const uint8*)pixelData;
+	const uintsize sourceStride	= format == ImAppRendererFormat_RGB8 ? 3u : 4u;
+	for( uint32 targetY = 0u; targetY < targetHeight; ++targetY )
+	{
+		const uint32 sourceY = (uint32)IMUI_MIN( IMUI_MAX( (int)targetY - (int)padTop, 0 ), (int)height - 1 );
+		for( uint32 targetX = 0u; targetX < targetWidth; ++targetX )
+		{
+			const uint32 sourceX = (uint32)IMUI_MIN( IMUI_MAX( (int)targetX - (int)padLeft, 0 ), (int)width - 1 );
+			const uint8* sourcePixel = &sourceData[ (((uintsize)sourceY * width) + sourceX) * sourceStride ];
+
+			uint8* targetPixel = &paddedData[ (((uintsize)targetY * targetWidth) + targetX) * 4u ];
+			targetPixel[ 0u ] = sourcePixel[ 0u ];
+			targetPixel[ 1u ] = sourcePixel[ 1u ];
+			targetPixel[ 2u ] = sourcePixel[ 2u ];
+			targetPixel[ 3u ] = sourceStride == 4u ? sourcePixel[ 3u ] : 0xffu;
+		}
+	}
+
+	const uint32 pageX		= slot->x + IMAPP_RES_SYS_ATLAS_PADDING + x - padLeft;
+	const uint32 pageY		= page->shelves[ slot->shelf ].y + IMAPP_RES_SYS_ATLAS_PADDING + y - padTop;
+	const bool updated		= imappRendererTextureUpdateRegion( ressys->renderer, page->texture, paddedData, pageX, pageY, targetWidth, targetHeight );
+	ImUiMemoryFree( ressys->allocator, paddedData );
+
+	return updated;
+}
+
+static bool ImAppResSysAtlasAllocate( ImAppResSys* ressys, ImAppResAtlasPage* page, uint16 width, uint16 height, ImAppResAtlasSlot* outSlot )
+{
+	// best fitting shelf, shelves a lot higher than the image are only used when they are empty
+	uintsize shelfIndex = IMUI_SIZE_MAX;
+	for( uintsize i = 0u; i < page->shelfCount; ++i )
+	{
+		const ImAppResAtlasShelf* shelf = &page->shelves[ i ];
+		if( shelf->height < height ||
+			(shelf->imageCount > 0u && shelf->height > height + (height / 2u)) ||
+			IMAPP_RES_SYS_ATLAS_PAGE_SIZE - shelf->usedWidth < width )
+		{
+			continue;
+		}
+
+		if( shelfIndex == IMUI_SIZE_MAX ||
+			shelf->height < page->shelves[ shelfIndex ].height )
+		{
+			shelfIndex = i;
+		}
+	}
+
+	if( shelfIndex == IMUI_SIZE_MAX )
+	{
+		if( IMAPP_RES_SYS_ATLAS_PAGE_SIZE - page->usedHeight < height ||
+			!IMUI_MEMORY_ARRAY_CHECK_CAPACITY( ressys->allocator, page->shelves, page->shelfCapacity, page->shelfCount + 1u ) )
+		{
+			return false;
+		}
+
+		ImAppResAtlasShelf* shelf = &page->shelves[ page->shelfCount ];
+		shelf->y			= page->usedHeight;
+		shelf->height		= height;
+		shelf->usedWidth	= 0u;
+		shelf->imageCount	= 0u;
+
+		shelfIndex = page->shelfCount++;
+		page->usedHeight += height;
+	}
+
+	ImAppResAtlasShelf* shelf = &page->shelves[ shelfIndex ];
+	outSlot->page	= 0u;
+	outSlot->shelf	= (uint16)shelfIndex;
+	outSlot->x		= shelf->usedWidth;
+	outSlot->width	= width;
+
+	shelf->usedWidth += width;
+	shelf->imageCount++;
+	page->imageCount++;
+
+	return true;
+}
+
+static void ImAppResSysAtlasRemove( ImAppResSys* ressys, ImAppImage* image )
+{
+	const ImAppResAtlasSlot slot = image->atlasSlot;
+	memset( &image->atlasSlot, 0, sizeof( image->atlasSlot ) );
+	image->uiImage.textureHandle = IMUI_TEXTURE_HANDLE_INVALID;
+
+	ImAppResAtlasPage* page = &ressys->atlasPages[ slot.page - 1u ];
+	ImAppResAtlasShelf* shelf = &page->shelves[ slot.shelf ];
+	IMAPP_ASSERT( shelf->imageCount > 0u );
+
+	shelf->imageCount--;
+	page->imageCount--;
+
+	if( shelf->imageCount == 0u )
+	{
+		shelf->usedWidth = 0u;
+	}
+	else if( slot.x + slot.width == shelf->usedWidth )
+	{
+		shelf->usedWidth = slot.x;
+	}
+
+	// empty shelves at the end give their height back
+	while( page->shelfCount > 0u &&
+		page->shelves[ page->shelfCount - 1u ].imageCount == 0u )
+	{
+		page->usedHeight = page->shelves[ page->shelfCount - 1u ].y;
+		page->shelfCount--;
+	}
+
+	if( page->imageCount == 0u )
+	{
+		ImAppResSysAtlasDestroyPage( ressys, page );
+	}
+}
+
+static void ImAppResSysAtlasDestroyPage( ImAppResSys* ressys, ImAppResAtlasPage* page )
+{
+	if( page->texture != NULL )
+	{
+		imappRendererTextureDestroy( ressys->renderer, page->texture );
+	}
+
+	ImUiMemoryFree( ressys->allocator, page->shelves );
+	memset( page, 0, sizeof( *page ) );
+}
+
+static ImAppRendererTexture* ImAppResSysTexturePoolAcquire( ImAppResSys* ressys, uint32 width, uint32 height, ImAppRendererFormat format )
+{
+	// newest first, it's most likely still in the GPU caches
+	for( uintsize i = ressys->texturePoolCount; i > 0u; --i )
+	{
+		const ImAppResTexturePoolEntry* entry = &ressys->texturePool[ i - 1u ];
+		if( entry->width != width ||
+			entry->height != height ||
+			entry->format != (uint8)format )
+		{
+			continue;
+		}
+
+		ImAppRendererTexture* texture = entry->texture;
+
+		ressys->texturePoolCount--;
+		memmove( &ressys->texturePool[ i - 1u ], &ressys->texturePool[ i ], sizeof( ressys->texturePool[ 0u ] ) * (ressys->texturePoolCount - (i - 1u)) );
+
+		return texture;
+	}
+
+	return NULL;
+}
+
+static void ImAppResSysTexturePoolRelease( ImAppResSys* ressys, ImAppRendererTexture* texture, uint32 width, uint32 height, ImAppRendererFormat format )
+{
+	if( ressys->texturePoolCount == IMAPP_ARRAY_COUNT( ressys->texturePool ) )
+	{
+		imappRendererTextureDestroy( ressys->renderer, ressys->texturePool[ 0u ].texture );
+
+		ressys->texturePoolCount--;
+		memmove( &ressys->texturePool[ 0u ], &ressys->texturePool[ 1u ], sizeof( ressys->texturePool[ 0u ] ) * ressys->texturePoolCount );
+	}
+
+	ImAppResTexturePoolEntry* entry = &ressys->texturePool[ ressys->texturePoolCount++ ];
+	entry->texture			= texture;
+	entry->width			= width;
+	entry->height			= height;
+	entry->format			= (uint8)format;
+	entry->releaseUpdate	= ressys->updateIndex;
+}
+
+// Destroys textures nobody picked up within IMAPP_RES_SYS_TEXTURE_POOL_MAX_AGE updates or all of them.
+static void ImAppResSysTexturePoolTrim( ImAppResSys* ressys, bool all )
+{
+	uintsize trimCount = 0u;
+	while( trimCount < ressys->texturePoolCount &&
+		(all || ressys->updateIndex - ressys->texturePool[ trimCount ].releaseUpdate > IMAPP_RES_SYS_TEXTURE_POOL_MAX_AGE) )
+	{
+		imappRendererTextureDestroy( ressys->renderer, ressys->texturePool[ trimCount ].texture );
+		trimCount++;
+	}
+
+	if( trimCount == 0u )
+	{
+		return;
+	}
+
+	ressys->texturePoolCount -= trimCount;
+	memmove( &ressys->texturePool[ 0u ], &ressys->texturePool[ trimCount ], sizeof( ressys->texturePool[ 0u ] ) * ressys->texturePoolCount );
+}
+
 ImAppFont* imappResSysFontCreateSystem( ImAppResSys* ressys, const char* fontName, float fontSize )
 {
 	const uintsize fontNameLength = strlen( fontName );
@@ -1365,7 +1756,22 @@ static void ImAppResThreadEntry( void* arg )
 		}
 
 		ImAppResEventQueuePush( ressys, &ressys->receiveQueue, &resEvent );
+
+		// the main loop may sleep until the next input
+		imappPlatformWakeUp( ressys->platform );
+	}
+}
+
+static bool ImAppResSysIsTextureReady( ImAppResSys* ressys, ImAppRes* textureRes )
+{
+	if( textureRes->state == ImAppResState_Loading &&
+		textureRes->data.texture.texture &&
+		imappRendererTextureIsReady( ressys->renderer, textureRes->data.texture.texture ) )
+	{
+		textureRes->state = ImAppResState_Ready;
 	}
+
+	return textureRes->state == ImAppResState_Ready;
 }
 
 static void ImAppResSysUnload( ImAppResPak* pak, ImAppRes* res )
@@ -1646,11 +2052,7 @@ static void ImAppResThreadHandleDecodePng( ImAppResSys* ressys, ImAppResEvent* r
 		break;
 
 	case SPNG_COLOR_TYPE_INDEXED:
-	case SPNG_COLOR_TYPE_TRUECOLOR:
-		sourceImageFormat				= SPNG_FMT_RGB8;
-		resEvent->result.image.format	= ImAppRendererFormat_RGB8;
-		break;
-
+	case SPNG_COLOR_TYPE_TRUECOLOR:	// padded to RGBA, GPUs have no native 24 bit format
 	case SPNG_COLOR_TYPE_TRUECOLOR_ALPHA:
 		sourceImageFormat				= SPNG_FMT_RGBA8;
 		resEvent->result.image.format	= ImAppRendererFormat_RGBA8;
@@ -13,6 +13,14 @@ typedef struct ImAppResSys ImAppResSys;
 typedef struct ImUiAllocator ImUiAllocator;
 typedef struct ImUiContext ImUiContext;
 
+typedef struct ImAppResAtlasSlot
+{
+	uint16					page;			// page index + 1, 0: the image has a dedicated texture
+	uint16					shelf;
+	uint16					x;
+	uint16					width;			// including padding
+} ImAppResAtlasSlot;
+
 struct ImAppImage
 {
 	ImUiStringView			resourceName;
@@ -20,6 +28,8 @@ struct ImAppImage
 	ImUiImage				uiImage;
 	ImAppBlob				data;
 	ImAppResState			state;
+	ImAppResAtlasSlot		atlasSlot;
+	uint8					textureFormat;	// ImAppRendererFormat
 };
 
 typedef struct ImAppFont ImAppFont;
@@ -52,6 +62,7 @@ ImAppImage*		imappResSysImageCreatePng( ImAppResSys* ressys, const void* imageDa
 ImAppImage*		imappResSysImageCreateJpeg( ImAppResSys* ressys, const void* imageData, uintsize imageDataSize );
 ImAppImage*		imappResSysImageLoadResource( ImAppResSys* ressys, const char* resourceName );
 ImAppResState	imappResSysImageGetState( ImAppResSys* ressys, ImAppImage* image );
+bool			imappResSysImageUpdate( ImAppResSys* ressys, ImAppImage* image, const void* pixelData, uint32 x, uint32 y, uint32 width, uint32 height );
 void			imappResSysImageFree( ImAppResSys* ressys, ImAppImage* image );
 
 ImAppFont*		imappResSysFontCreateSystem( ImAppResSys* ressys, const char* fontName, float fontSize );
@@ -184,3 +184,30 @@ typedef struct ImAppResEventQueue
 	uintsize			count;
 	uintsize			capacity;
 } ImAppResEventQueue;
+
+typedef struct ImAppResAtlasShelf
+{
+	uint16				y;
+	uint16				height;
+	uint16				usedWidth;		// images are appended, only the last one gives its space back
+	uint16				imageCount;
+} ImAppResAtlasShelf;
+
+typedef struct ImAppResAtlasPage
+{
+	ImAppRendererTexture*	texture;		// NULL when the page is unused
+	ImAppResAtlasShelf*		shelves;
+	uintsize				shelfCapacity;
+	uintsize				shelfCount;
+	uint16					usedHeight;
+	uint32					imageCount;
+} ImAppResAtlasPage;
+
+typedef struct ImAppResTexturePoolEntry
+{
+	ImAppRendererTexture*	texture;
+	uint32					width;
+	uint32					height;
+	uint8					format;			// ImAppRendererFormat
+	uint32					releaseUpdate;	// update index the texture got released in
+} ImAppResTexturePoolEntry;
@@ -10,6 +10,36 @@ newoption {
 	}
 }
 
+newoption {
+	trigger     = "use_headless",
+	description = "Choose to render offscreen without a window system",
+	default     = "off",
+	allowed = {
+		{ "off",	"Disabled" },
+		{ "on",		"Enabled" }
+	}
+}
+
+newoption {
+	trigger     = "use_software_renderer",
+	description = "Choose to rasterize on the CPU instead of using OpenGL",
+	default     = "off",
+	allowed = {
+		{ "off",	"Disabled" },
+		{ "on",		"Enabled" }
+	}
+}
+
+newoption {
+	trigger     = "use_vulkan",
+	description = "Choose to render with Vulkan instead of OpenGL",
+	default     = "off",
+	allowed = {
+		{ "off",	"Disabled" },
+		{ "on",		"Enabled" }
+	}
+}
+
 newoption {
 	trigger     = "use_livepp",
 	description = "Choose to enable Live++ or not",
@@ -22,8 +52,11 @@ newoption {
 
 local imapp_path = module.config.base_path
 
-tiki.use_sdl	= _OPTIONS[ "use_sdl" ] == "on" and (tiki.target_platform == Platforms.Windows or tiki.target_platform == Platforms.Linux)
-tiki.use_livepp	= _OPTIONS[ "use_livepp" ] == "on" and tiki.target_platform == Platforms.Windows
+tiki.use_headless	= _OPTIONS[ "use_headless" ] == "on" and tiki.target_platform == Platforms.Linux
+tiki.use_sdl		= _OPTIONS[ "use_sdl" ] == "on" and (tiki.target_platform == Platforms.Windows or tiki.target_platform == Platforms.Linux) and not tiki.use_headless
+tiki.use_livepp		= _OPTIONS[ "use_livepp" ] == "on" and tiki.target_platform == Platforms.Windows
+tiki.use_software_renderer	= _OPTIONS[ "use_software_renderer" ] == "on" and (tiki.target_platform == Platforms.Windows or tiki.target_platform == Platforms.Linux) and not tiki.use_sdl
+tiki.use_vulkan				= _OPTIONS[ "use_vulkan" ] == "on" and (tiki.target_platform == Platforms.Windows or tiki.use_headless) and not tiki.use_sdl and not tiki.use_software_renderer
 --tiki.use_lib = false
 
 module:add_include_dir( "include" )
@@ -36,6 +69,13 @@ module:add_external( "local://submodules/imui" )
 module:add_external( "local://submodules/libspng" )
 
 module:set_define( "IMAPP_LIVEPP", iff( tiki.use_livepp, "TIKI_ON", "TIKI_OFF" ) );
+module:set_define( "IMAPP_RENDERER_SOFTWARE", iff( tiki.use_software_renderer, "TIKI_ON", "TIKI_OFF" ) );
+module:set_define( "IMAPP_RENDERER_VULKAN", iff( tiki.use_vulkan, "TIKI_ON", "TIKI_OFF" ) );
+
+if tiki.use_vulkan and os.getenv( "VULKAN_SDK" ) then
+	module:add_include_dir( path.join( os.getenv( "VULKAN_SDK" ), "Include" ) )
+	module:add_library_dir( path.join( os.getenv( "VULKAN_SDK" ), "Lib" ) )
+end
 
 if tiki.use_livepp then
 	module:add_external( "https://liveplusplus.tech@2.11.1" )
@@ -48,13 +88,23 @@ if tiki.use_sdl then
 end
 
 if tiki.target_platform == Platforms.Windows then
-	module:add_external( "https://github.com/nigels-com/glew@2.2.0" )
+	if tiki.use_software_renderer then
+		module:add_library_file( "gdi32" )
+	elseif tiki.use_vulkan then
+		module:set_define( "VK_USE_PLATFORM_WIN32_KHR" )
+
+		module:add_library_file( "vulkan-1" )
+		module:add_library_file( "shaderc_shared" )
+	else
+		module:add_external( "https://github.com/nigels-com/glew@2.2.0" )
+
+		module:add_library_file( "opengl32" )
+	end
 
 	module:set_define( "NOMINMAX" )
 	module:set_define( "WIN32_LEAN_AND_MEAN" )
 
 	module:add_library_file( "dwmapi" )
-	module:add_library_file( "opengl32" )
 	module:add_library_file( "xinput" )
 elseif tiki.target_platform == Platforms.Android then
 	module:add_library_file( "m" )
@@ -93,12 +143,53 @@ elseif tiki.target_platform == Platforms.Android then
 		
 		solution:add_project( package_project )
 	end 
+elseif tiki.target_platform == Platforms.Linux and tiki.use_headless then
+	module:set_define( "IMAPP_PLATFORM_HEADLESS", "TIKI_ON" );
+
+	if tiki.use_vulkan then
+		module:add_library_file( "vulkan" )
+		module:add_library_file( "shaderc_shared" )
+	elseif not tiki.use_software_renderer then
+		module:add_library_file( "EGL" )
+		module:add_library_file( "GLESv2" )
+	end
+	module:add_library_file( "pthread" )
+	module:add_library_file( "m" )
+
+	module:set_define( "_POSIX_C_SOURCE", "200112L" )
 elseif tiki.target_platform == Platforms.Linux then
-	module:add_library_file( "GL" )
-	module:add_library_file( "EGL" )
-	module:add_library_file( "GLEW" )
-	module:add_library_file( "wayland-egl" )
+	-- client code of the Wayland protocols, the XML comes with wayland-protocols
+	local protocols_path	= os.outputof( "pkg-config --variable=pkgdatadir wayland-protocols" )
+	local generated_path	= path.join( os.getcwd(), "build/wayland_protocols" )
+	local protocols = {
+		{ "stable/xdg-shell/xdg-shell.xml",							"xdg-shell" },
+		{ "unstable/xdg-decoration/xdg-decoration-unstable-v1.xml",	"xdg-decoration-unstable-v1-client-protocol" },
+		{ "stable/presentation-time/presentation-time.xml",			"presentation-time-client-protocol" }
+	}
+
+	os.mkdir( generated_path )
+	for _, protocol in ipairs( protocols ) do
+		local xml_file = path.join( protocols_path, protocol[ 1 ] )
+		local target_file = path.join( generated_path, protocol[ 2 ] )
+
+		if not os.execute( "wayland-scanner client-header " .. xml_file .. " " .. target_file .. ".h" ) or
+		   not os.execute( "wayland-scanner private-code " .. xml_file .. " " .. target_file .. ".c" ) then
+			error( "wayland-scanner failed for " .. xml_file )
+		end
+	end
+
+	module:add_include_dir( generated_path )
+	module:add_files( path.join( generated_path, "*.c" ) )
+
+	if not tiki.use_software_renderer then
+		module:add_library_file( "EGL" )
+		module:add_library_file( "GLESv2" )
+		module:add_library_file( "wayland-egl" )
+	end
 	module:add_library_file( "wayland-client" )
-	
+	module:add_library_file( "xkbcommon" )
+	module:add_library_file( "pthread" )
+	module:add_library_file( "m" )
+
 	module:set_define( "_POSIX_C_SOURCE", "200112L" )
 end